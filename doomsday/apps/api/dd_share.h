@@ -480,11 +480,17 @@ typedef ddmobj_base_t SoundEmitter;
 /// Momentum axis indices. @ingroup mobj
 enum { MX, MY, MZ };
 
-/// Base mobj_t elements. Games MUST use this as the basis for mobj_t. @ingroup mobj
+/**
+ * Base mobj_t elements. Games MUST use this as the basis for mobj_t. @ingroup mobj
+ *
+ * Changing these changes the layout of every game's mobj_t, so the map API
+ * version (DE_API_MAP) must be incremented at the same time.
+ */
 #define DD_BASE_MOBJ_ELEMENTS() \
     DD_BASE_DDMOBJ_ELEMENTS() \
 \
     nodeindex_t     lineRoot; /* lines to which this is linked */ \
+    int             blockmapSlot; /* position in the blockmap cell (if linked) */ \
     struct mobj_s  *sNext, **sPrev; /* links in sector (if needed) */ \
 \
     coord_t         mom[3]; \
@@ -295,6 +295,12 @@ extern int sfxBits, sfxRate;
 #ifdef __CLIENT__
 extern int sfxVolume, musVolume;
 
+/**
+ * Interpolation used when samples are upsampled to the playback rate: 0 = none
+ * (samples are used as-is), 1 = linear, 2 = cubic.
+ */
+extern int sfxResample;
+
 /**
  * Usually the display player.
  */
@@ -0,0 +1,66 @@
+/** @file resampler.h  Sound sample rate and format conversion.
+ * @ingroup audio
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef AUDIO_RESAMPLER_H
+#define AUDIO_RESAMPLER_H
+
+#include <de/libcore.h>
+
+namespace audio {
+
+/**
+ * Interpolation used when resampling a sound to a higher rate.
+ */
+enum ResampleInterpolation
+{
+    ResampleLinear,
+    ResampleCubic    ///< Catmull-Rom spline through the four nearest samples.
+};
+
+/**
+ * Returns the number of samples that @a numSamples samples at @a srcRate are
+ * resampled to at @a dstRate.
+ */
+de::dint resampledSampleCount(de::dint numSamples, de::dint srcRate, de::dint dstRate);
+
+/**
+ * Converts mono sample data to another rate and/or sample size. 8-bit samples are
+ * unsigned and 16-bit samples are signed (as in WAV files).
+ *
+ * When the destination rate is a small integer multiple of the source rate (e.g.,
+ * 11025 Hz to 44100 Hz), the samples are interpolated four at a time with SSE2.
+ * Other ratios are interpolated one sample at a time; the results are the same.
+ *
+ * @param dst            Destination buffer. Must have room for
+ *                       resampledSampleCount() samples of @a dstBytesPer bytes.
+ * @param dstBytesPer    Bytes per destination sample (1 or 2).
+ * @param dstRate        Destination samples per second.
+ * @param src            Source samples.
+ * @param srcBytesPer    Bytes per source sample (1 or 2).
+ * @param srcRate        Source samples per second.
+ * @param srcNumSamples  Number of source samples.
+ * @param interpolation  Interpolation to use when changing the rate.
+ */
+void resampleSound(void *dst, de::dint dstBytesPer, de::dint dstRate,
+                   void const *src, de::dint srcBytesPer, de::dint srcRate,
+                   de::dint srcNumSamples, ResampleInterpolation interpolation);
+
+}  // namespace audio
+
+#endif  // AUDIO_RESAMPLER_H
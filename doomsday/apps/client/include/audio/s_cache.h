@@ -23,6 +23,7 @@
 
 #include "api_audiod_sfx.h"  // sfxsample_t
 #include <de/Observers>
+#include <QSet>
 
 namespace audio {
 
@@ -64,6 +65,18 @@ public:
         void replaceSample(sfxsample_t &newSample);
     };
 
+    /**
+     * Statistics about sample conversions and the sample buffer pool (for debug).
+     */
+    struct Statistics
+    {
+        uint convertedCount = 0;        ///< Samples converted to the playback format.
+        double convertSeconds = 0;      ///< Total time spent converting samples.
+        uint lastPrecacheCount = 0;     ///< Samples loaded by the latest precache().
+        double lastPrecacheSeconds = 0; ///< Duration of the latest precache().
+        uint pooledBytes = 0;           ///< Released sample buffers kept for reuse.
+    };
+
 public:
     /**
      * Construct a new (empty) sound sample cache.
@@ -90,6 +103,15 @@ public:
      */
     sfxsample_t *cache(int soundId);
 
+    /**
+     * Caches all the given sound samples that are not already in the cache. The
+     * samples are loaded in the calling thread, while the conversions to the playback
+     * format are done in parallel in background threads.
+     *
+     * @param soundIds  Sound sample identifiers.
+     */
+    void precache(QSet<int> const &soundIds);
+
     /**
      * Register a cache hit on the sound sample associated with @a id.
      *
@@ -105,8 +127,9 @@ public:
      *
      * @param cacheBytes   Total number of bytes used is written here.
      * @param sampleCount  Total number of cached samples is written here.
+     * @param stats        Conversion statistics are written here (optional).
      */
-    void info(uint *cacheBytes, uint *sampleCount);
+    void info(uint *cacheBytes, uint *sampleCount, Statistics *stats = nullptr);
 
 private:
     DENG2_PRIVATE(d)
@@ -28,6 +28,23 @@ void Cl_ResetFrame();
  */
 void Cl_Frame2Received(int packetType);
 
+/**
+ * Sets the number of first frames that the server has sent (from its datagram
+ * offer). Datagram frames must have the same epoch to be accepted.
+ */
+void Cl_SetFrameEpoch(byte epoch);
+
+/**
+ * Called for every PSV_FIRST_FRAME2 packet, even if the client isn't ready for it.
+ */
+void Cl_FirstFrameArrived();
+
+/**
+ * Read a PSV_DATAGRAM_FRAME2 packet. Frames that arrive late or belong to an
+ * earlier map are discarded; the others are acknowledged to the server.
+ */
+void Cl_DatagramFrameReceived();
+
 float Cl_FrameGameTime();
 
 #endif // DENG_CLIENT_FRAME_H
@@ -25,8 +25,12 @@
 /**
  * Read a sound delta from the message buffer and play it.
  * Only used with PSV_FRAME2 packets.
+ *
+ * @param type       Type of the delta.
+ * @param duplicate  The delta has already been received (resent by the server).
+ *                   It is read but not played again.
  */
-void Cl_ReadSoundDelta(deltatype_t type);
+void Cl_ReadSoundDelta(deltatype_t type, bool duplicate = false);
 
 /**
  * Called when a PSV_FRAME sound packet is received.
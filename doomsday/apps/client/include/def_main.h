@@ -102,6 +102,8 @@ struct stateinfo_t
     mobjinfo_t *owner;
     ded_light_t *light;
     ded_ptcgen_t *ptcGens;
+    int name;             ///< Offset of the state's ID in RuntimeDefs::strings.
+    int execute;          ///< Offset of the console commands executed when entering the state.
 };
 
 /**
@@ -116,7 +118,23 @@ struct RuntimeDefs
     Array<sfxinfo_t>   sounds;     ///< Sound effect list.
     Array<ddtext_t>    texts;      ///< Text string list.
 
+    /// Texts compiled from the definitions (UTF-8), so that they can be used without
+    /// looking them up from the definition records. Each is terminated by a null
+    /// character, and offset zero is an empty string.
+    QByteArray strings;
+
     void clear();
+
+    /**
+     * Appends @a text to the compiled texts.
+     *
+     * @return  Offset of the text in @ref strings (zero, if @a text is empty).
+     */
+    int addString(de::String const &text);
+
+    inline char const *string(int offset) const {
+        return strings.constData() + offset;
+    }
 };
 
 extern RuntimeDefs runtimeDefs;
@@ -0,0 +1,94 @@
+/** @file gl_texkernels.h  Vectorized inner loops of the image manipulation algorithms.
+ *
+ * @ingroup gl
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef DENG_GL_TEXKERNELS_H
+#define DENG_GL_TEXKERNELS_H
+
+#include <cstdint>
+
+/**
+ * Inner loops of the algorithms in gl_tex.cpp. Each kernel has a scalar
+ * version, and most have SSE2 and AVX2 versions as well. The vectorized
+ * versions produce exactly the same results as the scalar ones (the same
+ * operations are done in the same order and at the same precision), so the
+ * choice of kernels is not visible in the output.
+ *
+ * The vectorized versions only handle pixels with four 8-bit components (or
+ * four floats); other pixel formats are passed to the scalar versions.
+ */
+struct TexKernels
+{
+    enum Level { Scalar, SSE2, AVX2 };
+
+    Level level;
+
+    /// Averages 2x2 blocks of pixels into @a outH rows of @a outW pixels (see
+    /// GL_DownMipmap32()); @a out may be the same as @a in.
+    void (*downMipmap)(uint8_t *out, uint8_t const *in, int width, int outW, int outH, int comps);
+
+    /// Sums the R, G and B components of @a count pixels.
+    void (*sumRgb)(uint8_t const *pixels, long count, int pixelSize, long sums[3]);
+
+    /// Finds the minimum, maximum and sum of @a count 8-bit values.
+    void (*lumaRange)(uint8_t const *values, long count, uint8_t *min, uint8_t *max, long *sum);
+
+    /// Balances and amplifies @a count 8-bit values (see EqualizeLuma()).
+    void (*equalizeLuma)(uint8_t *values, long count, float baMul, float hiMul, float loMul);
+
+    /// Sharpens pixels 1...width-2 of row @a in into @a out (see SharpenPixels()).
+    void (*sharpenRow)(uint8_t *out, uint8_t const *in, int width, int comps,
+                       float A, float B, float C);
+
+    /// Converts @a count 8-bit values to floating point.
+    void (*bytesToFloats)(float *out, uint8_t const *in, long count);
+
+    /// Converts @a count floating point values in the range [0, 256) to 8-bit values.
+    void (*floatsToBytes)(uint8_t *out, float const *in, long count);
+
+    /// Bilinear magnification of one output row (see GL_ScaleBufferEx()).
+    void (*magnifyRow)(float *out, float const *row0, float const *row1, int widthIn,
+                       int widthOut, float sx, float alpha, int bpp);
+
+    /// Box filtered minification of one output row from one or two input @a rows
+    /// (see GL_ScaleBufferEx()).
+    void (*shrinkRow)(float *out, float const *row0, float const *row1, int widthIn,
+                      int widthOut, float sx, int rows, int bpp);
+
+    /// Linearly interpolates @a count pixels of a line in 16.16 fixed point (see
+    /// scaleLine()). Returns the input position after the last pixel.
+    int32_t (*lerpLine)(uint8_t *out, int outStride, uint8_t const *in, int inStride,
+                        int count, int32_t inPos, int32_t inPosDelta, int comps);
+
+    /**
+     * Returns the kernels best suited for the CPU. The choice is made when this is
+     * first called.
+     */
+    static TexKernels const &get();
+
+    /**
+     * Returns the kernels of a specific level. If the level is not supported by
+     * the compiler or the CPU, the kernels of the best supported lower level are
+     * returned.
+     */
+    static TexKernels const &forLevel(Level level);
+};
+
+#endif // DENG_GL_TEXKERNELS_H
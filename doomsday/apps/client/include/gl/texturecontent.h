@@ -38,6 +38,9 @@
 #define TXCF_UPLOAD_ARG_NOSTRETCH       0x20
 #define TXCF_UPLOAD_ARG_NOSMARTFILTER   0x40
 #define TXCF_NEVER_DEFER                0x80
+#define TXCF_TRANSLATED                 0x100 ///< See GL_TranslateTextureContent().
+#define TXCF_FINALIZED                  0x200 ///< See GL_FinalizeTextureContent().
+#define TXCF_MIPMAP_LEVELS              0x400 ///< Pixels of the smaller mipmap levels follow.
 /*@}*/
 
 /**
@@ -57,6 +60,8 @@ typedef struct texturecontent_s {
     int wrap[2];
     int grayMipmap;
     int flags; /// @ref textureContentFlags
+    int uploadWidth;  ///< Final dimensions of the texture (once translated).
+    int uploadHeight;
 } texturecontent_t;
 
 /**
@@ -87,6 +92,28 @@ void GL_PrepareTextureContent(texturecontent_t &c,
                               TextureVariantSpec const &spec,
                               res::TextureManifest const &textureManifest);
 
+/**
+ * Translates paletted pixels of @a content to truecolor and applies gamma
+ * correction. The final dimensions of the texture are chosen here as well.
+ * Uses the color palettes and the texture configuration, so this must be
+ * called in the main thread. Afterwards the content is flagged TXCF_TRANSLATED.
+ *
+ * @param content  Texture content to translate. Must own its pixel buffer,
+ *                 which may be replaced.
+ */
+void GL_TranslateTextureContent(texturecontent_t &content);
+
+/**
+ * Processes the pixels of translated @a content for uploading: smart filtering,
+ * scaling to the final dimensions, and generation of the mipmap levels. Only
+ * the content itself is used, so this can be called in a background thread.
+ * Afterwards the content is flagged TXCF_FINALIZED and is uploaded as-is.
+ *
+ * @param content  Texture content to finalize. Must own its pixel buffer,
+ *                 which may be replaced.
+ */
+void GL_FinalizeTextureContent(texturecontent_t &content);
+
 /**
  * @param method  GL upload method. By default the upload is deferred.
  *
@@ -0,0 +1,103 @@
+/** @file datagramchannel.h  Unreliable channel for sending game messages.
+ * @ingroup network
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef CLIENT_NETWORK_DATAGRAMCHANNEL_H
+#define CLIENT_NETWORK_DATAGRAMCHANNEL_H
+
+#include <de/Address>
+#include <de/Block>
+#include <de/Error>
+#include <QObject>
+
+/// Percentage of outgoing datagrams to drop (cvar).
+extern int netSimulatedDatagramLoss;
+
+/**
+ * UDP socket for game messages that can be lost or arrive out of order without
+ * holding up the messages after them (see SPF_DATAGRAM). The server and the
+ * client negotiate the channel over their TCP connection, and keep using TCP if
+ * datagrams don't get through.
+ *
+ * Each datagram carries one message and the session token that the server gave
+ * to the client, identifying the sender. Messages may be Huffman coded.
+ *
+ * The @c net-dev-datagram-loss cvar drops a percentage of the outgoing datagrams
+ * for testing.
+ *
+ * @ingroup network
+ */
+class DatagramChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// The UDP port was unavailable. @ingroup errors
+    DENG2_ERROR(PortError);
+
+    /// Largest message that fits in one datagram without fragmentation.
+    enum { MAX_MESSAGE_SIZE = 1400 };
+
+public:
+    DatagramChannel();
+
+    /**
+     * Opens the UDP socket.
+     *
+     * @param port  Port to bind to. If zero, any available port is used.
+     */
+    void open(de::duint16 port = 0);
+
+    void close();
+
+    bool isOpen() const;
+
+    /**
+     * Returns the port that the channel is bound to.
+     */
+    de::duint16 port() const;
+
+    /**
+     * Sends a message. Messages larger than MAX_MESSAGE_SIZE are not sent.
+     *
+     * @param to       Recipient.
+     * @param token    Session token.
+     * @param message  Message to send.
+     *
+     * @return @c true, if the message was sent (or dropped to simulate loss).
+     */
+    bool send(de::Address const &to, de::duint32 token, de::IByteArray const &message);
+
+    /**
+     * Checks if two addresses are on the same host. An IPv4 address mapped to
+     * IPv6 matches the plain IPv4 address. Port numbers are ignored, because NAT
+     * may use a different port for datagrams than for the TCP connection.
+     */
+    static bool isSameHost(de::Address const &a, de::Address const &b);
+
+signals:
+    void messageReceived(de::Address from, de::duint32 token, de::Block message);
+
+protected slots:
+    void readIncoming();
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+#endif // CLIENT_NETWORK_DATAGRAMCHANNEL_H
@@ -32,6 +32,7 @@ extern "C" {
 // Send Packet flags:
 #define SPF_REBOUND     0x00020000 // Write only to local loopback
 #define SPF_DONT_SEND   0x00040000 // Don't really send out anything
+#define SPF_DATAGRAM    0x00080000 // Send as a datagram, if the recipient has a datagram channel
 
 #define NETBUFFER_MAXSIZE    0x7ffff  // 512 KB
 
@@ -106,6 +106,10 @@ enum {
     PCL_GOODBYE = 31,
     PSV_MOBJ_TYPE_ID_LIST = 32,
     PSV_MOBJ_STATE_ID_LIST = 33,
+    PCL_DATAGRAM_REQUEST = 34,      // Client would like to use a datagram channel.
+    PSV_DATAGRAM_OFFER = 35,        // Datagram port and session token of the server.
+    PKT_DATAGRAM_HELLO = 36,        // Opens a datagram channel (only sent as a datagram).
+    PSV_DATAGRAM_FRAME2 = 37,       // PSV_FRAME2 with epoch and set numbers, acked with PCL_ACK_SETS.
 
     // Game specific events.
     PKT_GAME_MARKER = DDPT_FIRST_GAME_EVENT, // 64
@@ -149,6 +153,7 @@ extern int      realTics, availableTics;
 extern int      isServer, isClient;
 extern dd_bool  allowNetTraffic; // Should net traffic be allowed?
 extern float    netSimulatedLatencySeconds;
+extern byte     netDatagrams;
 extern int      gotFrame;
 
 void            Net_Register(void);
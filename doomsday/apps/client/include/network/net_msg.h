@@ -43,6 +43,22 @@ void Msg_End(void);
 
 dd_bool Msg_BeingWritten(void);
 
+/**
+ * Returns statistics about writing messages. Writers and their buffers are
+ * reused, so after the first few messages no memory needs to be allocated.
+ *
+ * @param messages     Number of messages written. Can be @c NULL.
+ * @param allocations  Number of writers allocated. Can be @c NULL.
+ * @param bufferBytes  Total size of the buffers of the unused writers. Can be @c NULL.
+ */
+void Msg_WriterStats(size_t *messages, size_t *allocations, size_t *bufferBytes);
+
+/**
+ * Frees the writers kept for reuse. No message may be in the middle of being
+ * written.
+ */
+void Msg_ReleaseWriters(void);
+
 /**
  * Begin reading a message from netBuffer. If a message is currently being
  * written, the writing will be ended.
@@ -50,6 +50,10 @@ typedef enum {
     NUM_DELTA_TYPES
 } deltatype_t;
 
+// OR'd with the type number when resending Unacked deltas. The original set
+// number and the resend ID of the delta follow the type.
+#define DT_RESENT               0x80
+
 // Mobj delta flags. These are used to determine what a delta contains.
 // (Which parts of a delta mobj_t are used.)
 #define MDF_ORIGIN_X            0x0001
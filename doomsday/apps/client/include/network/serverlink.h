@@ -151,6 +151,26 @@ public:
 
     bool isServerOnLocalNetwork(de::Address const &host) const;
 
+    /**
+     * Opens a datagram channel to the server for sending frames and coordinates
+     * (see DatagramChannel). Messages are sent over TCP until the server has
+     * answered a datagram.
+     *
+     * @param port   UDP port of the server.
+     * @param token  Session token given by the server.
+     */
+    void openDatagramChannel(de::duint16 port, de::duint32 token);
+
+    void closeDatagramChannel();
+
+    /**
+     * Sends a message to the server as a datagram.
+     *
+     * @return @c true, if the message was sent. @c false if the datagram channel
+     * is not open, or the message is too large.
+     */
+    bool sendDatagram(de::IByteArray const &message);
+
 signals:
     void serversDiscovered();
 
@@ -160,6 +180,8 @@ public slots:
 protected slots:
     void localServersFound();
     void linkDisconnected();
+    void datagramReceived(de::Address from, de::duint32 token, de::Block message);
+    void sendDatagramHello();
 
 protected:
     de::Packet *interpret(de::Message const &msg) override;
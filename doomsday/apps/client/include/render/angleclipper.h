@@ -64,6 +64,10 @@ struct AngleRange
  * Oranges (occlusion ranges) clip a half-space on an angle range. These are produced
  * by horizontal edges that have empty space behind.
  *
+ * The clipped ranges are kept either in a list or in a bitmap (see ClipRanges); the
+ * "rend-dev-cull-bitmap" cvar selects which one is used, starting from the next
+ * clearRanges().
+ *
  * @ingroup render
  */
 class AngleClipper
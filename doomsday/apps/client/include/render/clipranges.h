@@ -0,0 +1,127 @@
+/** @file clipranges.h  Clipped angle ranges of the Angle Clipper.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef CLIENT_RENDER_CLIPRANGES_H
+#define CLIENT_RENDER_CLIPRANGES_H
+
+#include <de/binangle.h>
+#include <de/libcore.h>
+
+/**
+ * Set of clipped angle ranges around the viewer, i.e., the directions that are
+ * already covered by solid geometry. Added ranges are inclusive; ranges that touch
+ * or overlap are merged.
+ *
+ * There are two implementations with identical results: ClipRangeList keeps a
+ * sorted list of ranges, and ClipRangeBitmap marks the covered parts of the circle
+ * in a bitmap.
+ *
+ * @ingroup render
+ */
+class ClipRanges
+{
+public:
+    virtual ~ClipRanges() {}
+
+    /**
+     * Removes all the ranges.
+     */
+    virtual void clear() = 0;
+
+    /**
+     * Adds a range. The range must not wrap around (@a from <= @a to).
+     */
+    virtual void addRange(binangle_t from, binangle_t to) = 0;
+
+    /**
+     * Determines if a range is @em not contained by the clipped ranges. The range
+     * must not wrap around (@a from <= @a to).
+     */
+    virtual bool isRangeVisible(binangle_t from, binangle_t to) const = 0;
+
+    /**
+     * Determines if @a angle is @em not inside (excluding the ends) a clipped range.
+     */
+    virtual bool isAngleVisible(binangle_t angle) const = 0;
+
+    /**
+     * Determines if the ranges cover the whole circle [0..360] degrees.
+     */
+    virtual bool isFull() const = 0;
+
+    /**
+     * Adds a range that may wrap around (@a from > @a to).
+     */
+    void safeAddRange(binangle_t from, binangle_t to);
+
+    /**
+     * Determines if a range that may wrap around (@a from > @a to) is @em not
+     * entirely clipped.
+     */
+    bool safeCheckRange(binangle_t from, binangle_t to) const;
+};
+
+/**
+ * Clipped ranges as a list of nodes sorted by the start angles.
+ */
+class ClipRangeList : public ClipRanges
+{
+public:
+    ClipRangeList();
+
+    void clear() override;
+    void addRange(binangle_t from, binangle_t to) override;
+    bool isRangeVisible(binangle_t from, binangle_t to) const override;
+    bool isAngleVisible(binangle_t angle) const override;
+    bool isFull() const override;
+
+#ifdef DENG2_DEBUG
+    /**
+     * A debugging aid: checks if clipnode links are valid.
+     */
+    void validate() const;
+#endif
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+/**
+ * Clipped ranges as a two-level coverage bitmap of the binary angle circle. Each bit
+ * of the lower level marks the gap between two consecutive angles as covered, and
+ * each bit of the upper level marks a full word of the lower level. Ranges are filled
+ * and tested a word at a time, with full words skipped using the upper level.
+ */
+class ClipRangeBitmap : public ClipRanges
+{
+public:
+    ClipRangeBitmap();
+
+    void clear() override;
+    void addRange(binangle_t from, binangle_t to) override;
+    bool isRangeVisible(binangle_t from, binangle_t to) const override;
+    bool isAngleVisible(binangle_t angle) const override;
+    bool isFull() const override;
+
+private:
+    DENG2_PRIVATE(d)
+};
+
+#endif  // CLIENT_RENDER_CLIPRANGES_H
@@ -0,0 +1,135 @@
+/** @file elementpool.h  Pool of POD elements.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#ifndef CLIENT_RENDER_ELEMENTPOOL_H
+#define CLIENT_RENDER_ELEMENTPOOL_H
+
+#include <de/libcore.h>
+
+namespace internal {
+
+/**
+ * Simple data structure for pooling POD elements. Note that unlike a traditional
+ * ObjectPool (pattern), the pooled elements are @em not owned by the pool!
+ */
+class ElementPool
+{
+public:
+    /**
+     * Base for POD elements.
+     */
+    struct Element
+    {
+    private:
+        Element *_prev, *_next;
+
+        friend class ElementPool;
+    };
+
+    /**
+     * Begin reusing elements in the pool.
+     */
+    void rewind() {
+        _rover = _first;
+    }
+
+    /**
+     * Add a new @em unused object to the pool.
+     *
+     * @param elem  Element to be linked in the pool. Ownership is unaffected.
+     */
+    void add(Element *elem)
+    {
+        // Link it to the start of the rover's list.
+        if(!_last) _last = elem;
+        if(_first) _first->_prev = elem;
+
+        elem->_next = _first;
+        elem->_prev = nullptr;
+
+        _first = elem;
+    }
+
+    /**
+     * Returns a pointer to the next unused element in the pool; otherwise @c nullptr.
+     */
+    void *get() {
+        if(!_rover) return nullptr;
+
+        // We'll use this.
+        Element *next = _rover;
+        _rover = _rover->_next;
+        return next;
+    }
+
+    /**
+     * Release the element @a elem (@important which is assumed to have been added
+     * previously!), moving it to the list of used elements, for later reuse.
+     */
+    void release(Element *elem)
+    {
+        DENG2_ASSERT(_last);
+
+        if(elem == _last)
+        {
+            DENG2_ASSERT(!_rover);
+
+            // We can only remove the last if all elements are already in use.
+            _rover = elem;
+            return;
+        }
+
+        DENG2_ASSERT(elem->_next);
+
+        // Unlink from the list entirely.
+        elem->_next->_prev = elem->_prev;
+        if(elem->_prev)
+        {
+            elem->_prev->_next = elem->_next;
+        }
+        else
+        {
+            _first = _first->_next;
+            _first->_prev = nullptr;
+        }
+
+        // Put it back to the end of the list.
+        _last->_next = elem;
+        elem->_prev = _last;
+        elem->_next = nullptr;
+        _last = elem;
+
+        // If all were in use, set the rover here. Otherwise the rover can stay
+        // where it is.
+        if(!_rover)
+        {
+            _rover = _last;
+        }
+    }
+
+private:
+    Element *_first = nullptr;
+    Element *_last  = nullptr;
+    Element *_rover = nullptr;
+};
+
+}  // namespace internal
+
+#endif  // CLIENT_RENDER_ELEMENTPOOL_H
@@ -137,6 +137,7 @@ DENG_EXTERN_C dd_bool fillOutlines;
 DENG_EXTERN_C byte loadExtAlways;
 
 DENG_EXTERN_C int devNoCulling;
+DENG_EXTERN_C byte angleClipBitmap;
 DENG_EXTERN_C byte devRendSkyAlways;
 DENG_EXTERN_C byte rendInfoLums;
 DENG_EXTERN_C byte devDrawLums;
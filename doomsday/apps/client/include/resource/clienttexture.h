@@ -80,6 +80,11 @@ public:
          * GL texture will result in "uninitialized" white texels being used
          * instead.
          *
+         * When not busy, the content of map surface and model skin variants
+         * is finalized for uploading in a background thread. Until the content
+         * has been uploaded with uploadFinalizedContent(), the variant remains
+         * unprepared and @c 0 is returned.
+         *
          * @return  GL-name of the uploaded texture.
          */
         uint prepare();
@@ -135,6 +140,16 @@ public:
          */
         void glCoords(float *s, float *t) const;
 
+        /**
+         * Uploads content that has been finalized in background threads to GL.
+         * This must be called from the main thread.
+         *
+         * @param maxCount  Maximum number of variants to upload.
+         *
+         * @return  Number of variants that were prepared.
+         */
+        static int uploadFinalizedContent(int maxCount);
+
     private:
         DENG2_PRIVATE(d)
     };
@@ -0,0 +1,46 @@
+/** @file hq2xfilter.h  The hq2x filter algorithm.
+ *
+ * @authors Copyright © 2003 Maxim Stepin <maxst@hiend3d.com>
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef DENG_RESOURCE_HQ2XFILTER_H
+#define DENG_RESOURCE_HQ2XFILTER_H
+
+#include <cstdint>
+
+/**
+ * Initializes the lookup table used for comparing colors. Must be called
+ * before HQ2x_Filter().
+ */
+void HQ2x_InitLookupTable(void);
+
+/**
+ * Filters an image to twice its original size (see GL_SmartFilterHQ2x()). Large
+ * images are filtered in parallel bands of rows.
+ *
+ * @param dst     Output R8G8B8A8 image of @a width*2 by @a height*2 pixels.
+ * @param src     R8G8B8A8 source image.
+ * @param yuv     Work buffer of @a width*@a height values.
+ * @param width   Width of the source image in pixels.
+ * @param height  Height of the source image in pixels.
+ * @param wrapH   The neighbors of pixels at the left and right edges wrap around.
+ * @param wrapV   The neighbors of pixels at the top and bottom edges wrap around.
+ */
+void HQ2x_Filter(uint8_t *dst, uint8_t const *src, uint32_t *yuv, int width, int height,
+                 bool wrapH, bool wrapV);
+
+#endif // DENG_RESOURCE_HQ2XFILTER_H
@@ -136,11 +136,28 @@ public:
      */
     de::dint cellElementCount(Cell const &cell) const;
 
-    bool link(Cell const &cell, void *elem);
+    /**
+     * Links @a elem into @a cell.
+     *
+     * @param cell  Cell to link to.
+     * @param elem  Element to link.
+     * @param slot  If not @c nullptr, the position of the element in the cell is
+     *              stored here and kept up to date while the element remains
+     *              linked, so it can be unlinked without searching the cell.
+     *              Usually a member of the element itself.
+     */
+    bool link(Cell const &cell, void *elem, de::dint *slot = nullptr);
 
     bool link(AABoxd const &region, void *elem);
 
-    bool unlink(Cell const &cell, void *elem);
+    /**
+     * Unlinks @a elem from @a cell.
+     *
+     * @param cell  Cell to unlink from.
+     * @param elem  Element to unlink.
+     * @param slot  The position given to link(), if any.
+     */
+    bool unlink(Cell const &cell, void *elem, de::dint *slot = nullptr);
 
     bool unlink(AABoxd const &region, void *elem);
 
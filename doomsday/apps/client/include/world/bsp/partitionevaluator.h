@@ -41,11 +41,25 @@ public:
     /**
      * Find the best line segment to use as the next partition.
      *
-     * @param node  Block tree node containing the remaining line segments.
+     * @param node     Block tree node containing the remaining line segments.
+     * @param ordinal  If not @c nullptr, the ordinal of the chosen candidate is
+     *                 written here (-1 if no partition was chosen).
      *
      * @return  The chosen partition line.
      */
-    LineSegmentSide *choose(LineSegmentBlockTreeNode &node);
+    LineSegmentSide *choose(LineSegmentBlockTreeNode &node, int *ordinal = nullptr);
+
+    /**
+     * Returns the partition candidate with the given ordinal, without evaluating
+     * any costs. Used for repeating a previously made choice.
+     *
+     * @param node     Block tree node containing the remaining line segments.
+     * @param ordinal  Ordinal of the candidate (see choose()).
+     *
+     * @return  The candidate partition line; otherwise @c nullptr if there is no
+     * candidate with that ordinal.
+     */
+    LineSegmentSide *candidate(LineSegmentBlockTreeNode &node, int ordinal);
 
 private:
     DENG2_PRIVATE(d)
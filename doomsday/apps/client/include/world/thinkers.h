@@ -85,6 +85,13 @@ public:
      */
     de::LoopResult forAll(thinkfunc_t thinkFunc, de::dbyte flags, std::function<de::LoopResult (thinker_t *th)> func) const;
 
+    /**
+     * Runs all thinkers that are not in stasis. Thinkers are run one think function
+     * at a time, in the order they were added. Thinkers that have been removed are
+     * released at this point.
+     */
+    void runAll();
+
     /**
      * Locates a mobj by its unique identifier in the map.
      *
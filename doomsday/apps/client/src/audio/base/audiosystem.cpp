@@ -76,6 +76,9 @@ dint musVolume = 255 * 2/3;
 
 dint sfxBits = 8;
 dint sfxRate = 11025;
+#ifdef __CLIENT__
+dint sfxResample = 2;  // Cubic.
+#endif
 
 #ifdef __CLIENT__
 #  if defined(MACOSX) && defined(MACOS_HAVE_QTKIT)
@@ -2651,6 +2654,7 @@ void AudioSystem::consoleRegister()  // static
     C_VAR_BYTE    ("sound-overlap-stop",  &sfxOneSoundPerEmitter, 0, 0, 1);
 #ifdef __CLIENT__
     //C_VAR_INT     ("sound-rate",          &sfxSampleRate,         0, 11025, 44100);
+    C_VAR_INT     ("sound-resample",      &sfxResample,           0, 0, 2);
     C_VAR_FLOAT2  ("sound-reverb-volume", &sfxReverbStrength,     0, 0, 1.5f, sfxReverbStrengthChanged);
     C_VAR_INT     ("sound-volume",        &sfxVolume,             0, 0, 255);
 
@@ -0,0 +1,298 @@
+/** @file resampler.cpp  Sound sample rate and format conversion.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "audio/resampler.h"
+
+#include <de/math.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG_RESAMPLER_SSE2
+#  include <emmintrin.h>
+#endif
+
+using namespace de;
+
+namespace audio {
+
+/// Largest rate ratio that is interpolated in phases (see interpolatePhases()).
+static dint const MAX_RESAMPLE_PHASES = 8;
+
+/**
+ * Returns sample @a index of @a src as a float in the range of 16-bit samples.
+ */
+static inline dfloat sampleAsFloat(void const *src, dint bytesPer, dint index)
+{
+    if (bytesPer == 1)
+    {
+        return dfloat((dint(((duint8 const *) src)[index]) - 0x80) << 8);
+    }
+    return dfloat(((dint16 const *) src)[index]);
+}
+
+/**
+ * Determines the weights of the four samples around an interpolated position,
+ * which is @a t (0...1) past the second of the samples.
+ */
+static void interpolationWeights(dfloat t, ResampleInterpolation interpolation, dfloat w[4])
+{
+    if (interpolation == ResampleCubic)
+    {
+        dfloat const t2 = t * t;
+        dfloat const t3 = t2 * t;
+        w[0] = .5f * (-t3 + 2 * t2 - t);
+        w[1] = .5f * (3 * t3 - 5 * t2 + 2);
+        w[2] = .5f * (-3 * t3 + 4 * t2 + t);
+        w[3] = .5f * (t3 - t2);
+    }
+    else
+    {
+        w[0] = 0;
+        w[1] = 1 - t;
+        w[2] = t;
+        w[3] = 0;
+    }
+}
+
+static inline dfloat interpolate(dfloat const *p, dfloat const w[4])
+{
+    // Note: the SSE2 version adds up the terms in the same order.
+    return ((w[0] * p[0] + w[1] * p[1]) + w[2] * p[2]) + w[3] * p[3];
+}
+
+/**
+ * Interpolates each output sample separately. Works with any ratio of rates.
+ *
+ * @param out      Output samples.
+ * @param count    Number of output samples.
+ * @param padded   Source samples, preceded by one and followed by two extra samples.
+ */
+static void interpolateEach(dfloat *out, dint count, dfloat const *padded,
+                            dint srcRate, dint dstRate, ResampleInterpolation interpolation)
+{
+    dfloat w[4];
+    for (dint i = 0; i < count; ++i)
+    {
+        dint64 const pos = dint64(i) * srcRate;
+        interpolationWeights(dfloat(pos % dstRate) / dfloat(dstRate), interpolation, w);
+        out[i] = interpolate(padded + pos / dstRate, w);
+    }
+}
+
+/**
+ * Interpolates the output when the destination rate is @a phases times the source
+ * rate. Each source sample is followed by the same @a phases interpolated positions,
+ * so the weights are only determined once and four source samples are processed at
+ * a time.
+ *
+ * @param out         Output samples (@a srcCount * @a phases).
+ * @param padded      Source samples, preceded by one and followed by two extra samples.
+ * @param srcCount    Number of source samples.
+ */
+static void interpolatePhases(dfloat *out, dfloat const *padded, dint srcCount, dint phases,
+                              dint srcRate, dint dstRate, ResampleInterpolation interpolation)
+{
+    DENG2_ASSERT(phases >= 1 && phases <= MAX_RESAMPLE_PHASES);
+
+    // Same positions as in interpolateEach().
+    dfloat w[MAX_RESAMPLE_PHASES][4];
+    for (dint j = 0; j < phases; ++j)
+    {
+        interpolationWeights(dfloat(dint64(j) * srcRate % dstRate) / dfloat(dstRate),
+                             interpolation, w[j]);
+    }
+
+    dint k = 0;
+#ifdef DENG_RESAMPLER_SSE2
+    __m128 wv[MAX_RESAMPLE_PHASES][4];
+    for (dint j = 0; j < phases; ++j)
+    {
+        for (dint t = 0; t < 4; ++t) wv[j][t] = _mm_set1_ps(w[j][t]);
+    }
+    for (; k + 4 <= srcCount; k += 4)
+    {
+        __m128 const p0 = _mm_loadu_ps(padded + k);
+        __m128 const p1 = _mm_loadu_ps(padded + k + 1);
+        __m128 const p2 = _mm_loadu_ps(padded + k + 2);
+        __m128 const p3 = _mm_loadu_ps(padded + k + 3);
+
+        // Each vector has one phase of four consecutive source samples.
+        __m128 o[MAX_RESAMPLE_PHASES];
+        for (dint j = 0; j < phases; ++j)
+        {
+            o[j] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(wv[j][0], p0),
+                                                    _mm_mul_ps(wv[j][1], p1)),
+                                         _mm_mul_ps(wv[j][2], p2)),
+                              _mm_mul_ps(wv[j][3], p3));
+        }
+
+        dfloat *dp = out + k * phases;
+        switch (phases)
+        {
+        case 1:
+            _mm_storeu_ps(dp, o[0]);
+            break;
+
+        case 2:
+            _mm_storeu_ps(dp,     _mm_unpacklo_ps(o[0], o[1]));
+            _mm_storeu_ps(dp + 4, _mm_unpackhi_ps(o[0], o[1]));
+            break;
+
+        case 4:
+            _MM_TRANSPOSE4_PS(o[0], o[1], o[2], o[3]);
+            for (dint m = 0; m < 4; ++m) _mm_storeu_ps(dp + 4 * m, o[m]);
+            break;
+
+        default: {
+            dfloat phased[MAX_RESAMPLE_PHASES][4];
+            for (dint j = 0; j < phases; ++j) _mm_storeu_ps(phased[j], o[j]);
+            for (dint m = 0; m < 4; ++m)
+            for (dint j = 0; j < phases; ++j)
+            {
+                dp[m * phases + j] = phased[j][m];
+            }
+            break; }
+        }
+    }
+#endif
+    for (; k < srcCount; ++k)
+    {
+        for (dint j = 0; j < phases; ++j)
+        {
+            out[k * phases + j] = interpolate(padded + k, w[j]);
+        }
+    }
+}
+
+/**
+ * Rounds the interpolated samples to 8-bit or 16-bit samples.
+ */
+static void floatsToSamples(void *dst, dint bytesPer, dfloat const *in, dint count)
+{
+    dint i = 0;
+    if (bytesPer == 2)
+    {
+        dint16 *out = (dint16 *) dst;
+#ifdef DENG_RESAMPLER_SSE2
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i const lo = _mm_cvtps_epi32(_mm_loadu_ps(in + i));
+            __m128i const hi = _mm_cvtps_epi32(_mm_loadu_ps(in + i + 4));
+            _mm_storeu_si128((__m128i *) (out + i), _mm_packs_epi32(lo, hi));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i] = dint16(de::clamp(-32768L, std::lrint(in[i]), 32767L));
+        }
+    }
+    else
+    {
+        duint8 *out = (duint8 *) dst;
+#ifdef DENG_RESAMPLER_SSE2
+        __m128 const scale  = _mm_set1_ps(1.f / 256);
+        __m128i const bias  = _mm_set1_epi32(0x80);
+        for (; i + 16 <= count; i += 16)
+        {
+            __m128i v[4];
+            for (dint m = 0; m < 4; ++m)
+            {
+                v[m] = _mm_add_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4 * m),
+                                                                scale)), bias);
+            }
+            _mm_storeu_si128((__m128i *) (out + i),
+                             _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]),
+                                              _mm_packs_epi32(v[2], v[3])));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            out[i] = duint8(de::clamp(0L, std::lrint(in[i] * (1.f / 256)) + 0x80, 255L));
+        }
+    }
+}
+
+dint resampledSampleCount(dint numSamples, dint srcRate, dint dstRate)
+{
+    if (srcRate <= 0 || dstRate == srcRate) return numSamples;
+    return dint(dint64(numSamples) * dstRate / srcRate);
+}
+
+void resampleSound(void *dst, dint dstBytesPer, dint dstRate,
+                   void const *src, dint srcBytesPer, dint srcRate, dint srcNumSamples,
+                   ResampleInterpolation interpolation)
+{
+    DENG2_ASSERT(dst && src);
+    DENG2_ASSERT(srcBytesPer == 1 || srcBytesPer == 2);
+    DENG2_ASSERT(dstBytesPer == 1 || dstBytesPer == 2);
+    DENG2_ASSERT(srcRate > 0 && dstRate > 0);
+
+    if (srcNumSamples <= 0) return;
+
+    // Let's first check for the easy cases.
+    if (dstRate == srcRate)
+    {
+        if (srcBytesPer == dstBytesPer)
+        {
+            // A simple copy will suffice.
+            std::memcpy(dst, src, dsize(srcNumSamples) * srcBytesPer);
+            return;
+        }
+        if (srcBytesPer == 1)
+        {
+            // Just changing the bytes won't do much good...
+            duint8 const *sp = (duint8 const *) src;
+            dint16 *dp       = (dint16 *) dst;
+            for (dint i = 0; i < srcNumSamples; ++i)
+            {
+                dp[i] = dint16((dint(sp[i]) - 0x80) << 8);
+            }
+            return;
+        }
+    }
+
+    // The edge samples are repeated so that all positions have four neighbors.
+    std::vector<dfloat> padded(dsize(srcNumSamples) + 3);
+    for (dint i = 0; i < srcNumSamples; ++i)
+    {
+        padded[i + 1] = sampleAsFloat(src, srcBytesPer, i);
+    }
+    padded[0] = padded[1];
+    padded[srcNumSamples + 1] = padded[srcNumSamples + 2] = padded[srcNumSamples];
+
+    dint const dstNumSamples = resampledSampleCount(srcNumSamples, srcRate, dstRate);
+    std::vector<dfloat> interpolated(static_cast<dsize>(dstNumSamples));
+
+    if (dstRate % srcRate == 0 && dstRate / srcRate <= MAX_RESAMPLE_PHASES)
+    {
+        interpolatePhases(interpolated.data(), padded.data(), srcNumSamples,
+                          dstRate / srcRate, srcRate, dstRate, interpolation);
+    }
+    else
+    {
+        interpolateEach(interpolated.data(), dstNumSamples, padded.data(),
+                        srcRate, dstRate, interpolation);
+    }
+
+    floatsToSamples(dst, dstBytesPer, interpolated.data(), dstNumSamples);
+}
+
+}  // namespace audio
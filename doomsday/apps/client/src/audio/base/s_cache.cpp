@@ -23,11 +23,18 @@
 #include "dd_main.h"  // App_AudioSystem()
 #include "def_main.h"  // Def_Get*()
 #include "audio/audiosystem.h"
+#include "audio/resampler.h"
 
 #include <doomsday/filesys/fs_main.h>
 #include <doomsday/resource/wav.h>
+#include <de/Block>
+#include <de/Guard>
+#include <de/Lockable>
+#include <de/TaskPool>
+#include <de/Time>
 #include <de/timer.h>
 #include <cstring>
+#include <memory>
 
 using namespace de;
 
@@ -50,229 +57,164 @@ static dint const MAX_CACHE_KB     = 4096;
 // Even one minute of silence is quite a long time during gameplay.
 static dint const MAX_CACHE_TICS   = TICSPERSEC * 60 * 4;  // 4 minutes.
 
-#if 0
 /**
- * Determines the necessary upsample factor for the given sample @a rate.
- */
-static dint upsampleFactor(dint rate)
-{
-    dint factor = 1;
-#ifdef __CLIENT__
-    // The (up)sampling factor.
-    if (App_AudioSystem().mustUpsampleToSfxRate())
-    {
-        factor = de::max(1, ::sfxRate / rate);
-    }
-#else
-    DENG2_UNUSED(rate);
-#endif
-    return factor;
-}
-
-// Utility for converting an unsigned byte to signed short (for resampling).
-static dshort inline U8_S16(duchar b)
-{
-    return (b - 0x80) << 8;
-}
-
-/**
- * Simple linear resampling with possible conversion to 16 bits. The destination sample
- * must be initialized and it must have a large enough buffer. We won't reduce rate or
- * bits here.
+ * Buffers for sample data in power-of-two size classes. Released buffers are kept for
+ * reuse (up to a limit), so sounds that get recached after a purge or a format change
+ * do not need new allocations. Buffers larger than the largest class are allocated
+ * separately.
  *
- * @note This is not a clean way to resample a sound. If you read about DSP a bit, you'll
- * find out that interpolation adds a lot of extra frequencies in the sample. It should
- * be low-pass filtered after the interpolation.
+ * Each buffer is preceded by a header that records its size class. Buffers may be
+ * allocated in any thread.
  */
-static void resample(void *dst, dint dstBytesPer, dint dstRate, void const *src,
-    dint srcBytesPer, dint srcRate, dint srcNumSamples, duint srcSize)
+class SampleBufferPool : public Lockable
 {
-    DENG2_ASSERT(src && dst);
+public:
+    SampleBufferPool() : pooledBytes(0) {}
 
-    // Let's first check for the easy cases.
-    if (dstRate == srcRate)
+    ~SampleBufferPool()
     {
-        if (srcBytesPer == dstBytesPer)
-        {
-            // A simple copy will suffice.
-            std::memcpy(dst, src, srcSize);
-        }
-        else if (srcBytesPer == 1 && dstBytesPer == 2)
+        for (auto &freeList : classes)
+        for (void *buf : freeList)
         {
-            // Just changing the bytes won't do much good...
-            duchar const *sp = (duchar const *) src;
-            dshort *dp       = (dshort *) dst;
-
-            for (dint i = 0; i < srcNumSamples; ++i)
-            {
-                *dp++ = (*sp++ - 0x80) << 8;
-            }
+            M_Free(buf);
         }
-        return;
     }
 
-    // 2x resampling.
-    if (dstRate == 2 * srcRate)
+    void *alloc(dsize size)
     {
-        if (dstBytesPer == 1)
+        dint const sizeClass = sizeClassFor(size);
+        dbyte *buf = nullptr;
+        if (sizeClass >= 0)
         {
-            // The source has a byte per sample as well.
-            duchar const *sp = (duchar const *) src;
-            duchar *dp       = (duchar *) dst;
-
-            for (dint i = 0; i < srcNumSamples - 1; ++i, sp++)
+            DENG2_GUARD(this);
+            auto &freeList = classes[sizeClass];
+            if (!freeList.isEmpty())
             {
-                *dp++ = *sp;
-                *dp++ = (*sp + sp[1]) >> 1;
+                buf = (dbyte *) freeList.takeLast();
+                pooledBytes -= classSize(sizeClass);
             }
-
-            // Fill in the last two as well.
-            dp[0] = dp[1] = *sp;
         }
-        else if (srcBytesPer == 1)
+        if (!buf)
         {
-            // Destination is signed 16bit. Source is 8bit.
-            duchar const *sp = (duchar const *) src;
-            dshort *dp       = (dshort *) dst;
-
-            for (dint i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                dshort const first = U8_S16(*sp);
+            buf = (dbyte *) M_Malloc(sizeClass >= 0? classSize(sizeClass) : HEADER_SIZE + size);
+        }
+        *(dint *) buf = sizeClass;
+        return buf + HEADER_SIZE;
+    }
 
-                *dp++ = first;
-                *dp++ = (first + U8_S16(sp[1])) >> 1;
-            }
+    void release(void *data)
+    {
+        if (!data) return;
 
-            // Fill in the last two as well.
-            dp[0] = dp[1] = U8_S16(*sp);
-        }
-        else if (srcBytesPer == 2)
+        dbyte *buf = (dbyte *) data - HEADER_SIZE;
+        dint const sizeClass = *(dint *) buf;
+        if (sizeClass >= 0)
         {
-            // Destination is signed 16bit. Source is 16bit.
-            dshort const *sp = (dshort const *) src;
-            dshort *dp       = (dshort *) dst;
-
-            for (dint i = 0; i < srcNumSamples - 1; ++i, sp++)
+            DENG2_GUARD(this);
+            if (pooledBytes + classSize(sizeClass) <= MAX_POOLED_BYTES)
             {
-                *dp++ = *sp;
-                *dp++ = (*sp + sp[1]) >> 1;
+                classes[sizeClass].append(buf);
+                pooledBytes += classSize(sizeClass);
+                return;
             }
-
-            dp[0] = dp[1] = *sp;
         }
-        return;
+        M_Free(buf);
     }
 
-    // 4x resampling (11Khz => 44KHz only).
-    if (dstRate == 4 * srcRate)
+    dsize pooledSize() const
     {
-        if (dstBytesPer == 1)
-        {
-            // The source has a byte per sample as well.
-            duchar const *sp = (duchar const *) src;
-            duchar *dp       = (duchar *) dst;
+        DENG2_GUARD(this);
+        return pooledBytes;
+    }
 
-            for (dint i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                duchar const mid = (*sp + sp[1]) >> 1;
+private:
+    static dsize const HEADER_SIZE      = 16;  // Keeps the sample data aligned.
+    static dint const MIN_CLASS_BITS    = 10;  // 1 KB
+    static dint const CLASS_COUNT       = 11;  // ...up to 1 MB
+    static dsize const MAX_POOLED_BYTES = 4 * 1024 * 1024;
 
-                *dp++ = *sp;
-                *dp++ = (*sp + mid) >> 1;
-                *dp++ = mid;
-                *dp++ = (mid + sp[1]) >> 1;
-            }
+    static dsize classSize(dint sizeClass)
+    {
+        return dsize(1) << (MIN_CLASS_BITS + sizeClass);
+    }
 
-            // Fill in the last four as well.
-            dp[0] = dp[1] = dp[2] = dp[3] = *sp;
-        }
-        else if (srcBytesPer == 1)
+    static dint sizeClassFor(dsize size)
+    {
+        for (dint i = 0; i < CLASS_COUNT; ++i)
         {
-            // Destination is signed 16bit. Source is 8bit.
-            duchar const *sp = (duchar const *) src;
-            dshort *dp       = (dshort *) dst;
-
-            for (int i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                dshort const first = U8_S16(*sp);
-                dshort const last  = U8_S16(sp[1]);
-                dshort const mid   = (first + last) >> 1;
-
-                *dp++ = first;
-                *dp++ = (first + mid) >> 1;
-                *dp++ = mid;
-                *dp++ = (mid + last) >> 1;
-            }
-
-            // Fill in the last four as well.
-            dp[0] = dp[1] = dp[2] = dp[3] = U8_S16(*sp);
+            if (HEADER_SIZE + size <= classSize(i)) return i;
         }
-        else if (srcBytesPer == 2)
-        {
-            // Destination is signed 16bit. Source is 16bit.
-            dshort const *sp = (dshort const *) src;
-            dshort *dp       = (dshort *) dst;
-
-            for (dint i = 0; i < srcNumSamples - 1; ++i, sp++)
-            {
-                dshort const mid = (*sp + sp[1]) >> 1;
+        return -1;  // Too large.
+    }
 
-                *dp++ = *sp;
-                *dp++ = (*sp + mid) >> 1;
-                *dp++ = mid;
-                *dp++ = (mid + sp[1]) >> 1;
-            }
+    QList<void *> classes[CLASS_COUNT];
+    dsize pooledBytes;
+};
 
-            // Fill in the last four as well.
-            dp[0] = dp[1] = dp[2] = dp[3] = *sp;
-        }
-    }
+static SampleBufferPool &sampleBuffers()
+{
+    static SampleBufferPool pool;
+    return pool;
 }
+
+/**
+ * Format that cached samples are converted to. Determined in the main thread before
+ * the sample data is converted.
+ */
+struct SampleConversion
+{
+    bool resample = false;  ///< Upsample to @ref rate.
+    dint rate     = 0;
+    dint bytesPer = 0;      ///< Minimum bytes per sample.
+    ResampleInterpolation interpolation = ResampleLinear;
+
+    static SampleConversion current()
+    {
+        SampleConversion conv;
+#ifdef __CLIENT__
+        conv.resample      = ::sfxResample > 0 && App_AudioSystem().mustUpsampleToSfxRate();
+        conv.rate          = ::sfxRate;
+        conv.bytesPer      = ::sfxBits / 8;
+        conv.interpolation = (::sfxResample >= 2? ResampleCubic : ResampleLinear);
 #endif
+        return conv;
+    }
+};
 
 /**
  * Prepare the given sound sample @a smp for caching.
  *
- * If the sample @a data is already in the right format, just make a copy of it.
+ * If the sample is already in the right format, the sample data is used as is.
  *
- * If necessary, resample the sound @a data upwards to the minimum resolution and
- * bits (specified in the user Config). (You can play higher resolution sounds
- * than the current setting, but not lower resolution ones.)
+ * If necessary, resample the sound upwards to the minimum resolution and bits
+ * (specified in the user Config). (You can play higher resolution sounds than the
+ * current setting, but not lower resolution ones.)
  *
- * Converts the sample @a data and writes it to the (M_Malloc() allocated) buffer in @a smp
- * (ownership is given to the sfxsample_t).
- *
- * @param data        Actual sample data.
- * @param size        Size in bytes.
  * @param numSamples  Number of samples.
  * @param bytesPer    Bytes per sample (1 or 2).
  * @param rate        Samples per second.
+ * @param conv        Playback format.
  */
-void configureSample(sfxsample_t &smp, void const *data, duint size,
-                     dint numSamples, dint bytesPer, dint rate)
+void configureSample(sfxsample_t &smp, dint numSamples, dint bytesPer, dint rate,
+                     SampleConversion const &conv)
 {
-    DENG2_UNUSED(data);
-    DENG2_UNUSED(size);
-
     zap(smp);
     smp.bytesPer   = bytesPer;
-    smp.size       = numSamples * bytesPer;
     smp.rate       = rate;
     smp.numSamples = numSamples;
 
-#if 0
-    // Apply the upsample factor.
-    dint const rsfactor = upsampleFactor(rate);
-    smp.rate       *= rsfactor;
-    smp.numSamples *= rsfactor;
-    smp.size       *= rsfactor;
-
-    // Resample to 16bit?
-    if (::sfxBits == 16 && smp.bytesPer == 1)
+    if (conv.resample)
     {
-        smp.bytesPer = 2;
-        smp.size     *= 2;
+        if (rate < conv.rate)
+        {
+            smp.rate       = conv.rate;
+            smp.numSamples = resampledSampleCount(numSamples, rate, conv.rate);
+        }
+        // Resample to 16bit?
+        smp.bytesPer = de::max(bytesPer, conv.bytesPer);
     }
-#endif
+
+    smp.size = smp.numSamples * smp.bytesPer;
 }
 
 SfxSampleCache::CacheItem::CacheItem()
@@ -287,7 +229,7 @@ SfxSampleCache::CacheItem::CacheItem()
 SfxSampleCache::CacheItem::~CacheItem()
 {
     // We have ownership of the sample data.
-    M_Free(sample.data);
+    sampleBuffers().release(sample.data);
 }
 
 void SfxSampleCache::CacheItem::hit()
@@ -301,7 +243,7 @@ void SfxSampleCache::CacheItem::replaceSample(sfxsample_t &newSample)
     hits = 0;
 
     // Release the existing sample data if any.
-    M_Free(sample.data);
+    sampleBuffers().release(sample.data);
     // Replace the sample.
     std::memcpy(&sample, &newSample, sizeof(sample));
 }
@@ -400,32 +342,88 @@ DENG2_PIMPL(SfxSampleCache)
         delete &item;
     }
     /**
-     * Caches a copy of the given sample. If it's already in the cache and has the
-     * same format, nothing is done.
+     * Sample data loaded for caching.
+     */
+    struct LoadedSample
+    {
+        dint soundId    = 0;
+        dint group      = 0;  ///< Exclusion group (0, if none).
+        dint bytesPer   = 0;
+        dint rate       = 0;
+        dint numSamples = 0;
+        void *zoneData  = nullptr;  ///< Loaded from a WAV file (Z_Malloc()'d).
+        Block lumpData;             ///< Copied from a DOOM format sound lump.
+
+        sfxsample_t converted;      ///< In the playback format (owns the data).
+        bool wasConverted = false;
+        TimeDelta convertTime;
+
+        LoadedSample() { zap(converted); }
+        ~LoadedSample()
+        {
+            if (zoneData) Z_Free(zoneData);
+            sampleBuffers().release(converted.data);
+        }
+
+        void const *data() const
+        {
+            return zoneData? zoneData : lumpData.constData();
+        }
+    };
+
+    Statistics stats;
+
+    /**
+     * Converts the loaded sample data to the playback format. Does not access the
+     * cache, so this may be called in any thread.
+     */
+    static void convert(LoadedSample &loaded, SampleConversion const &conv)
+    {
+        Time const startedAt;
+
+        sfxsample_t &smp = loaded.converted;
+        configureSample(smp, loaded.numSamples, loaded.bytesPer, loaded.rate, conv);
+
+        // Attribute the sample with tracking identifiers.
+        smp.id    = loaded.soundId;
+        smp.group = loaded.group;
+
+        smp.data = sampleBuffers().alloc(smp.size);
+        if (smp.rate == loaded.rate && smp.bytesPer == loaded.bytesPer)
+        {
+            std::memcpy(smp.data, loaded.data(), smp.size);
+        }
+        else
+        {
+            // Perform resampling.
+            resampleSound(smp.data, smp.bytesPer, smp.rate, loaded.data(), loaded.bytesPer,
+                          loaded.rate, loaded.numSamples, conv.interpolation);
+            loaded.wasConverted = true;
+        }
+
+        loaded.convertTime = startedAt.since();
+    }
+
+    /**
+     * Caches the converted sample. If it's already in the cache and has the same
+     * format, nothing is done.
      *
-     * @param soundId       Id number of the sound sample.
-     * @param data          Actual sample data.
-     * @param size          Size in bytes.
-     * @param numSamples    Number of samples.
-     * @param bytesPer      Bytes per sample (1 or 2).
-     * @param rate          Samples per second.
-     * @param group         Exclusion group (0, if none).
+     * @param loaded  Loaded and converted sample. Ownership of the converted sample
+     *                data is given to the cache.
      *
-     * @returns             Ptr to the cached sample. Always valid.
+     * @returns The cached sample. Always valid.
      */
-    CacheItem &insert(dint soundId, void const *data, duint size, dint numSamples,
-        dint bytesPer, dint rate, dint group)
+    CacheItem &insert(LoadedSample &loaded)
     {
-        sfxsample_t cached;
-        configureSample(cached, data, size, numSamples, bytesPer, rate);
+        sfxsample_t &cached = loaded.converted;
 
         // Have we already cached a comparable sample?
-        CacheItem *item = tryFind(soundId);
+        CacheItem *item = tryFind(loaded.soundId);
         if (item)
         {
             // A sample is already in the cache.
             // If the existing sample is in the same format - use it.
-            if (cached.bytesPer * 8 == ::sfxBits && cached.rate == ::sfxRate)
+            if (item->sample.bytesPer == cached.bytesPer && item->sample.rate == cached.rate)
                 return *item;
 
             // Sample format differs - uncache it (we'll reuse this CacheItem).
@@ -434,27 +432,172 @@ DENG2_PIMPL(SfxSampleCache)
         else
         {
             // Add a new CacheItem for the sample.
-            item = &insertCacheItem(soundId);
+            item = &insertCacheItem(loaded.soundId);
         }
 
-        // Attribute the sample with tracking identifiers.
-        cached.id    = soundId;
-        cached.group = group;
-
-#if 0
-        // Perform resampling if necessary.
-        resample(cached.data = M_Malloc(cached.size), cached.bytesPer, cached.rate,
-                 data, bytesPer, rate, numSamples, size);
-#endif
-        cached.data = M_Malloc(cached.size);
-        std::memcpy(cached.data, data, size);
+        if (loaded.wasConverted)
+        {
+            stats.convertedCount += 1;
+            stats.convertSeconds += loaded.convertTime;
+        }
 
         // Replace the cached sample.
         item->replaceSample(cached);
+        cached.data = nullptr;
 
         return *item;
     }
 
+    /**
+     * Loads the sample data of a sound. Must be called in the main thread.
+     *
+     * @param soundId  Sound sample identifier.
+     *
+     * @return  Loaded sample (ownership given to the caller), or @c nullptr if the
+     * sound could not be loaded.
+     */
+    LoadedSample *load(dint soundId)
+    {
+        // Lookup info for this sound.
+        sfxinfo_t *info = Def_GetSoundInfo(soundId, 0, 0);
+        if (!info)
+        {
+            LOG_AUDIO_WARNING("Ignoring sound id:%i (missing sfxinfo_t)") << soundId;
+            return nullptr;
+        }
+
+        // Attempt to cache this now.
+        LOG_AUDIO_VERBOSE("Caching sample '%s' (id:%i)...") << info->id << soundId;
+
+        std::unique_ptr<LoadedSample> loaded(new LoadedSample);
+        loaded->soundId = soundId;
+        loaded->group   = info->group;
+
+        /**
+         * Figure out where to get the sample data for this sound. It might be from a
+         * data file such as a WAD or external sound resources. The definition and the
+         * configuration settings will help us in making the decision.
+         */
+        void *&data = loaded->zoneData;
+
+        /// Has an external sound file been defined?
+        /// @note Path is relative to the base path.
+        if (!Str_IsEmpty(&info->external))
+        {
+            String searchPath = App_BasePath() / String(Str_Text(&info->external));
+            // Try loading.
+            data = WAV_Load(searchPath.toUtf8().constData(), &loaded->bytesPer, &loaded->rate,
+                            &loaded->numSamples);
+            if (data)
+            {
+                loaded->bytesPer /= 8; // Was returned as bits.
+            }
+        }
+
+        // If external didn't succeed, let's try the default resource dir.
+        if (!data)
+        {
+            /**
+             * If the sound has an invalid lumpname, search external anyway. If the
+             * original sound is from a PWAD, we won't look for an external resource
+             * (probably a custom sound).
+             *
+             * @todo should be a cvar.
+             */
+            if (info->lumpNum < 0 || !App_FileSystem().lump(info->lumpNum).container().hasCustom())
+            {
+                try
+                {
+                    String foundPath = App_FileSystem().findPath(de::Uri(info->lumpName, RC_SOUND),
+                                                                 RLF_DEFAULT, App_ResourceClass(RC_SOUND));
+                    foundPath = App_BasePath() / foundPath;  // Ensure the path is absolute.
+
+                    data = WAV_Load(foundPath.toUtf8().constData(), &loaded->bytesPer,
+                                    &loaded->rate, &loaded->numSamples);
+                    if (data)
+                    {
+                        // Loading was successful.
+                        loaded->bytesPer /= 8;  // Was returned as bits.
+                    }
+                }
+                catch (FS1::NotFoundError const &)
+                {}  // Ignore this error.
+            }
+        }
+
+        // No sample loaded yet?
+        if (!data)
+        {
+            // Try loading from the lump.
+            if (info->lumpNum < 0)
+            {
+                LOG_AUDIO_WARNING("Failed to locate lump resource '%s' for sample '%s'")
+                    << info->lumpName << info->id;
+                return nullptr;
+            }
+
+            File1 &lump = App_FileSystem().lump(info->lumpNum);
+            if (lump.size() <= 8) return nullptr;
+
+            char hdr[12];
+            lump.read((duint8 *)hdr, 0, 12);
+
+            // Is this perhaps a WAV sound?
+            if (WAV_CheckFormat(hdr))
+            {
+                // Load as WAV, then.
+                duint8 const *sp = lump.cache();
+                data = WAV_MemoryLoad((byte const *) sp, lump.size(), &loaded->bytesPer,
+                                      &loaded->rate, &loaded->numSamples);
+                lump.unlock();
+
+                if (!data)
+                {
+                    // Abort...
+                    LOG_AUDIO_WARNING("Unknown WAV format in lump '%s'") << info->lumpName;
+                    return nullptr;
+                }
+
+                loaded->bytesPer /= 8;
+            }
+        }
+
+        if (data)  // Loaded!
+        {
+            return loaded.release();
+        }
+
+        // Probably an old-fashioned DOOM sample.
+        if (info->lumpNum >= 0)
+        {
+            File1 &lump = App_FileSystem().lump(info->lumpNum);
+
+            if (lump.size() > 8)
+            {
+                duint8 hdr[8];
+                lump.read(hdr, 0, 8);
+                dint head          = DD_SHORT(*(dshort const *) (hdr));
+                loaded->rate       = DD_SHORT(*(dshort const *) (hdr + 2));
+                loaded->numSamples = de::max(0, DD_LONG(*(dint const *) (hdr + 4)));
+                loaded->bytesPer   = 1; // 8-bit.
+
+                if (head == 3 && loaded->numSamples > 0 && loaded->rate > 0 &&
+                    dsize(loaded->numSamples) <= lump.size() - 8)
+                {
+                    // The sample data can be used as-is - copy directly from the lump cache.
+                    loaded->lumpData = Block(lump.cache() + 8,  // Skip the header.
+                                             dsize(loaded->numSamples));
+                    lump.unlock();
+
+                    return loaded.release();
+                }
+            }
+        }
+
+        LOG_AUDIO_WARNING("Unknown lump '%s' sound format") << info->lumpName;
+        return nullptr;
+    }
+
     /**
      * Remove @em all CacheItems and their sample data.
      */
@@ -567,7 +710,7 @@ void SfxSampleCache::maybeRunPurge()
     }
 }
 
-void SfxSampleCache::info(duint *cacheBytes, duint *sampleCount)
+void SfxSampleCache::info(duint *cacheBytes, duint *sampleCount, Statistics *stats)
 {
     duint size  = 0;
     duint count = 0;
@@ -580,6 +723,11 @@ void SfxSampleCache::info(duint *cacheBytes, duint *sampleCount)
 
     if (cacheBytes)  *cacheBytes  = size;
     if (sampleCount) *sampleCount = count;
+    if (stats)
+    {
+        *stats = d->stats;
+        stats->pooledBytes = duint(sampleBuffers().pooledSize());
+    }
 }
 
 void SfxSampleCache::hit(dint soundId)
@@ -608,149 +756,53 @@ sfxsample_t *SfxSampleCache::cache(dint soundId)
     if (CacheItem *existing = d->tryFind(soundId))
         return &existing->sample;
 
-    // Lookup info for this sound.
-    sfxinfo_t *info = Def_GetSoundInfo(soundId, 0, 0);
-    if (!info)
-    {
-        LOG_AUDIO_WARNING("Ignoring sound id:%i (missing sfxinfo_t)") << soundId;
-        return nullptr;
-    }
-
-    // Attempt to cache this now.
-    LOG_AUDIO_VERBOSE("Caching sample '%s' (id:%i)...") << info->id << soundId;
-
-    dint bytesPer = 0;
-    dint rate = 0;
-    dint numSamples = 0;
+    std::unique_ptr<Impl::LoadedSample> loaded(d->load(soundId));
+    if (!loaded) return nullptr;
 
-    /**
-     * Figure out where to get the sample data for this sound. It might be from a
-     * data file such as a WAD or external sound resources. The definition and the
-     * configuration settings will help us in making the decision.
-     */
-    void *data = nullptr;
+    d->convert(*loaded, SampleConversion::current());
+    return &d->insert(*loaded).sample;
+}
 
-    /// Has an external sound file been defined?
-    /// @note Path is relative to the base path.
-    if (!Str_IsEmpty(&info->external))
-    {
-        String searchPath = App_BasePath() / String(Str_Text(&info->external));
-        // Try loading.
-        data = WAV_Load(searchPath.toUtf8().constData(), &bytesPer, &rate, &numSamples);
-        if (data)
-        {
-            bytesPer /= 8; // Was returned as bits.
-        }
-    }
+void SfxSampleCache::precache(QSet<dint> const &soundIds)
+{
+    LOG_AS("SfxSampleCache");
 
-    // If external didn't succeed, let's try the default resource dir.
-    if (!data)
-    {
-        /**
-         * If the sound has an invalid lumpname, search external anyway. If the
-         * original sound is from a PWAD, we won't look for an external resource
-         * (probably a custom sound).
-         *
-         * @todo should be a cvar.
-         */
-        if (info->lumpNum < 0 || !App_FileSystem().lump(info->lumpNum).container().hasCustom())
-        {
-            try
-            {
-                String foundPath = App_FileSystem().findPath(de::Uri(info->lumpName, RC_SOUND),
-                                                             RLF_DEFAULT, App_ResourceClass(RC_SOUND));
-                foundPath = App_BasePath() / foundPath;  // Ensure the path is absolute.
+#ifdef __CLIENT__
+    if (!App_AudioSystem().sfxIsAvailable()) return;
+#endif
 
-                data = WAV_Load(foundPath.toUtf8().constData(), &bytesPer, &rate, &numSamples);
-                if (data)
-                {
-                    // Loading was successful.
-                    bytesPer /= 8;  // Was returned as bits.
-                }
-            }
-            catch (FS1::NotFoundError const &)
-            {}  // Ignore this error.
-        }
-    }
+    Time const startedAt;
 
-    // No sample loaded yet?
-    if (!data)
+    // The data files are read in this thread.
+    QList<Impl::LoadedSample *> loaded;
+    for (dint soundId : soundIds)
     {
-        // Try loading from the lump.
-        if (info->lumpNum < 0)
-        {
-            LOG_AUDIO_WARNING("Failed to locate lump resource '%s' for sample '%s'")
-                << info->lumpName << info->id;
-            return nullptr;
-        }
+        if (soundId <= 0 || d->tryFind(soundId)) continue;
 
-        File1 &lump = App_FileSystem().lump(info->lumpNum);
-        if (lump.size() <= 8) return nullptr;
-
-        char hdr[12];
-        lump.read((duint8 *)hdr, 0, 12);
-
-        // Is this perhaps a WAV sound?
-        if (WAV_CheckFormat(hdr))
+        if (Impl::LoadedSample *sample = d->load(soundId))
         {
-            // Load as WAV, then.
-            duint8 const *sp = lump.cache();
-            data = WAV_MemoryLoad((byte const *) sp, lump.size(), &bytesPer, &rate, &numSamples);
-            lump.unlock();
-
-            if (!data)
-            {
-                // Abort...
-                LOG_AUDIO_WARNING("Unknown WAV format in lump '%s'") << info->lumpName;
-                return nullptr;
-            }
-
-            bytesPer /= 8;
+            loaded << sample;
         }
     }
 
-    if (data)  // Loaded!
+    // Convert all the samples in parallel.
+    SampleConversion const conv = SampleConversion::current();
+    TaskPool::parallelFor(Rangei(0, loaded.size()), [&loaded, &conv] (dint i)
     {
-        // Insert a copy of this into the cache.
-        CacheItem &item = d->insert(soundId, data, bytesPer * numSamples, numSamples,
-                                    bytesPer, rate, info->group);
-        Z_Free(data);
-        return &item.sample;
-    }
+        Impl::convert(*loaded.at(i), conv);
+    }, 1);
 
-    // Probably an old-fashioned DOOM sample.
-    dsize lumpLength = 0;
-    if (info->lumpNum >= 0)
+    for (Impl::LoadedSample *sample : loaded)
     {
-        File1 &lump = App_FileSystem().lump(info->lumpNum);
-
-        if (lump.size() > 8)
-        {
-            duint8 hdr[8];
-            lump.read(hdr, 0, 8);
-            dint head  = DD_SHORT(*(dshort const *) (hdr));
-            rate       = DD_SHORT(*(dshort const *) (hdr + 2));
-            numSamples = de::max(0, DD_LONG(*(dint const *) (hdr + 4)));
-            bytesPer   = 1; // 8-bit.
-
-            if (head == 3 && numSamples > 0 && (unsigned) numSamples <= lumpLength - 8)
-            {
-                // The sample data can be used as-is - load directly from the lump cache.
-                duint8 const *data = lump.cache() + 8;  // Skip the header.
-
-                // Insert a copy of this into the cache.
-                CacheItem &item = d->insert(soundId, data, bytesPer * numSamples, numSamples,
-                                            bytesPer, rate, info->group);
-
-                lump.unlock();
-
-                return &item.sample;
-            }
-        }
+        d->insert(*sample);
     }
+    qDeleteAll(loaded);
+
+    d->stats.lastPrecacheCount   = duint(loaded.size());
+    d->stats.lastPrecacheSeconds = startedAt.since();
 
-    LOG_AUDIO_WARNING("Unknown lump '%s' sound format") << info->lumpName;
-    return nullptr;
+    LOG_AUDIO_VERBOSE("Precached %i samples in %.2f seconds")
+        << loaded.size() << d->stats.lastPrecacheSeconds;
 }
 
 }  // namespace audio
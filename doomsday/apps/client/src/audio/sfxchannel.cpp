@@ -474,8 +474,12 @@ void Sfx_ChannelDrawer()
 
     // Sample cache information.
     duint cachesize, ccnt;
-    App_AudioSystem().sfxSampleCache().info(&cachesize, &ccnt);
-    char buf[200]; sprintf(buf, "Cached:%i (%i)", cachesize, ccnt);
+    audio::SfxSampleCache::Statistics stats;
+    App_AudioSystem().sfxSampleCache().info(&cachesize, &ccnt, &stats);
+    char buf[200]; sprintf(buf, "Cached:%i (%i) Converted:%i (%.1f ms) Precached:%i (%.1f ms) Pooled:%i",
+                           cachesize, ccnt, stats.convertedCount, stats.convertSeconds * 1000,
+                           stats.lastPrecacheCount, stats.lastPrecacheSeconds * 1000,
+                           stats.pooledBytes);
 
     FR_SetColor(1, 1, 1);
     FR_DrawTextXY(buf, 10, 0);
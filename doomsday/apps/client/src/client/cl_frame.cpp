@@ -28,10 +28,7 @@
 #include "network/net_buf.h"
 #include "network/net_msg.h"
 
-#if 0
-#define SET_HISTORY_SIZE    50
 #define RESEND_HISTORY_SIZE 50
-#endif
 
 extern int gotFrame;
 
@@ -45,28 +42,28 @@ dd_bool gotFirstFrame;
 // gameTime of the current frame.
 static float frameGameTime = 0;
 
-#if 0
-// Ordinal of the latest set received by the client. Used for detecting deltas
-// that arrive out of order. The ordinal is the logical equivalent of the set
-// identifier (which is 0...255).
-static uint     latestSetOrdinal;
-static byte     latestSet;
+// Counts the first frames received; datagram frames of an earlier map are
+// recognized by a different epoch. Set by the server's datagram offer.
+static byte     frameEpoch;
 
-// The ordinal base is added to the set number to convert it from a set
-// identifier to an ordinal. Every time the set numbers wrap around from 255
-// to zero, the ordinal is incremented by 256.
-static uint     setOrdinalBase;
+// The latest set received as a datagram. Frames that arrive after a later set
+// are discarded.
+static byte     latestSet;
+static dd_bool  gotLatestSet;
 
 // The set history keeps track of received sets and is used to detect
-// duplicate frames.
-static short    setHistory[SET_HISTORY_SIZE];
-static int      historyIdx;
+// duplicate resent deltas. Sets older than the latest by more than half
+// of the range are considered not received.
+static dd_bool  setHistory[256];
 
 // The resend ID history keeps track of received resend deltas. Used
 // to detect duplicate resends.
 static byte     resendHistory[RESEND_HISTORY_SIZE];
 static int      resendHistoryIdx;
-#endif
+
+// Resend IDs of the deltas in the frame being read (acked with the set).
+static byte     frameResends[255];
+static int      frameResendCount;
 
 /**
  * Clear the history of received set numbers.
@@ -74,21 +71,56 @@ static int      resendHistoryIdx;
 void Cl_InitFrame(void)
 {
     Cl_ResetFrame();
+}
 
-#if 0
-    // -1 denotes an invalid entry.
-    memset(setHistory, -1, sizeof(setHistory));
-    historyIdx = 0;
+/**
+ * Forgets the received sets and resent deltas.
+ */
+static void Cl_ClearFrameHistory()
+{
+    gotLatestSet = false;
+    de::zap(setHistory);
 
     // Clear the resend ID history.
-    memset(resendHistory, 0, sizeof(resendHistory));
+    de::zap(resendHistory);
     resendHistoryIdx = 0;
+}
+
+/**
+ * Records the set of a frame received as a datagram.
+ */
+static void Cl_AddToSetHistory(byte set)
+{
+    if (gotLatestSet)
+    {
+        // The skipped sets were not received (or are too old to matter).
+        for (byte s = byte(latestSet + 1); s != set; ++s)
+        {
+            setHistory[s] = false;
+        }
+    }
+    setHistory[set] = true;
+    latestSet = set;
+    gotLatestSet = true;
+}
 
-    // Reset ordinal counters.
-    latestSet = 0;
-    latestSetOrdinal = 0;
-    setOrdinalBase = 256;
-#endif
+/**
+ * Determines whether a resent delta has already been received, either in its
+ * original set or in an earlier resend.
+ */
+static bool Cl_IsDuplicateResend(byte set, byte resend)
+{
+    if (gotLatestSet && setHistory[set] && de::dint8(latestSet - set) >= 0)
+    {
+        return true;
+    }
+    for (int i = 0; i < RESEND_HISTORY_SIZE; ++i)
+    {
+        if (resend && resendHistory[i] == resend) return true;
+    }
+    resendHistory[resendHistoryIdx] = resend;
+    resendHistoryIdx = (resendHistoryIdx + 1) % RESEND_HISTORY_SIZE;
+    return false;
 }
 
 /**
@@ -103,6 +135,51 @@ void Cl_ResetFrame()
     gotFirstFrame = false;
 }
 
+void Cl_SetFrameEpoch(byte epoch)
+{
+    frameEpoch = epoch;
+}
+
+void Cl_FirstFrameArrived()
+{
+    // Datagram frames of the previous map may still arrive.
+    frameEpoch++;
+    Cl_ClearFrameHistory();
+}
+
+void Cl_DatagramFrameReceived()
+{
+    byte const epoch = Reader_ReadByte(msgReader);
+    byte const set   = Reader_ReadByte(msgReader);
+
+    // A frame that is not acked will be resent by the server.
+    if (epoch != frameEpoch || !gotFirstFrame)
+    {
+        return;
+    }
+    if (gotLatestSet && de::dint8(set - latestSet) <= 0)
+    {
+        // Arrived too late; a later frame may have already changed the same
+        // things. The deltas will be resent (without the obsolete parts).
+        return;
+    }
+
+    Cl_Frame2Received(PSV_FRAME2);
+    Cl_AddToSetHistory(set);
+
+    // Let the server know the set arrived.
+    Msg_Begin(PCL_ACK_SETS);
+    Writer_WriteByte(msgWriter, epoch);
+    Writer_WriteByte(msgWriter, set);
+    Writer_WriteByte(msgWriter, frameResendCount);
+    for (int i = 0; i < frameResendCount; ++i)
+    {
+        Writer_WriteByte(msgWriter, frameResends[i]);
+    }
+    Msg_End();
+    Net_SendBuffer(0, 0);
+}
+
 float Cl_FrameGameTime()
 {
     return frameGameTime;
@@ -112,6 +189,7 @@ void Cl_Frame2Received(int packetType)
 {
     // The first thing in the frame is the gameTime.
     frameGameTime = Reader_ReadFloat(msgReader);
+    frameResendCount = 0;
 
     // All frames that arrive before the first frame are ignored.
     // They are most likely from the wrong map.
@@ -129,7 +207,26 @@ void Cl_Frame2Received(int packetType)
     // Read and process the message.
     while (!Reader_AtEnd(msgReader))
     {
-        byte const deltaType = Reader_ReadByte(msgReader);
+        byte deltaType = Reader_ReadByte(msgReader);
+        bool duplicate = false;
+
+        if (deltaType & DT_RESENT)
+        {
+            // A resent delta is followed by its original set and resend ID.
+            deltaType &= ~DT_RESENT;
+            byte const set    = Reader_ReadByte(msgReader);
+            byte const resend = Reader_ReadByte(msgReader);
+
+            // The server waits for these to be acked along with the frame.
+            if (frameResendCount < int(sizeof(frameResends)))
+            {
+                frameResends[frameResendCount++] = resend;
+            }
+
+            // Applying the other deltas again does no harm (they have the same
+            // values as before), but sounds would be heard twice.
+            duplicate = Cl_IsDuplicateResend(set, resend);
+        }
 
         switch (deltaType)
         {
@@ -170,7 +267,7 @@ void Cl_Frame2Received(int packetType)
         case DT_SECTOR_SOUND:
         case DT_SIDE_SOUND:
         case DT_POLY_SOUND:
-            Cl_ReadSoundDelta((deltatype_t) deltaType);
+            Cl_ReadSoundDelta((deltatype_t) deltaType, duplicate);
             break;
 
         default:
@@ -30,6 +30,8 @@
 #include "network/net_main.h"
 #include "network/net_buf.h"
 #include "network/net_demo.h"
+#include "network/serverlink.h"
+#include "network/sys_network.h"
 
 #include "world/map.h"
 #include "world/p_players.h"
@@ -217,6 +219,35 @@ void Cl_AnswerHandshake()
     DD_ResetTimer();
 
     Con_Executef(CMDS_DDAY, true, "setcon %i", consolePlayer);
+
+    if (netDatagrams)
+    {
+        // Frames and coordinates get through faster as datagrams, if the server
+        // supports them. Older servers ignore the request.
+        Msg_Begin(PCL_DATAGRAM_REQUEST);
+        Msg_End();
+        Net_SendBuffer(0, 0);
+    }
+}
+
+/**
+ * The server tells where to send datagrams (PSV_DATAGRAM_OFFER). A zero token
+ * means that only TCP is to be used.
+ */
+static void Cl_HandleDatagramOffer()
+{
+    duint16 const port  = Reader_ReadUInt16(msgReader);
+    duint32 const token = Reader_ReadUInt32(msgReader);
+    Cl_SetFrameEpoch(Reader_ReadByte(msgReader));
+
+    if (token && port && netDatagrams)
+    {
+        Net_ServerLink().openDatagramChannel(port, token);
+    }
+    else
+    {
+        Net_ServerLink().closeDatagramChannel();
+    }
 }
 
 void Cl_HandlePlayerInfo()
@@ -264,6 +295,12 @@ void Cl_GetPackets()
     {
         Msg_BeginRead();
 
+        if (netBuffer.msg.type == PSV_FIRST_FRAME2)
+        {
+            // Datagram frames sent before this one are now obsolete.
+            Cl_FirstFrameArrived();
+        }
+
         // First check for packets that are only valid when
         // a game is in progress.
         if (Cl_GameReady())
@@ -276,6 +313,11 @@ void Cl_GetPackets()
                 Msg_EndRead();
                 continue; // Get the next packet.
 
+            case PSV_DATAGRAM_FRAME2:
+                Cl_DatagramFrameReceived();
+                Msg_EndRead();
+                continue; // Get the next packet.
+
             case PSV_SOUND:
                 Cl_Sound();
                 Msg_EndRead();
@@ -313,6 +355,10 @@ void Cl_GetPackets()
             Cl_AnswerHandshake();
             break;
 
+        case PSV_DATAGRAM_OFFER:
+            Cl_HandleDatagramOffer();
+            break;
+
         case PSV_MATERIAL_ARCHIVE:
             Cl_ReadServerMaterials();
             break;
@@ -377,6 +423,10 @@ void Cl_GetPackets()
             LOGDEV_NET_WARNING("Packet type %i was discarded (client not ready)") << netBuffer.msg.type;
             break;
 
+        case PSV_DATAGRAM_FRAME2:
+            // Not acknowledged, so the server will send the deltas again.
+            break;
+
         default:
             if (netBuffer.msg.type >= PKT_GAME_MARKER)
             {
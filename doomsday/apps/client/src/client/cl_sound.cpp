@@ -35,7 +35,7 @@
 
 using namespace de;
 
-void Cl_ReadSoundDelta(deltatype_t type)
+void Cl_ReadSoundDelta(deltatype_t type, bool duplicate)
 {
     LOG_AS("Cl_ReadSoundDelta");
 
@@ -53,7 +53,7 @@ void Cl_ReadSoundDelta(deltatype_t type)
     duint16 const deltaId = Reader_ReadUInt16(::msgReader);
     byte const flags      = Reader_ReadByte(::msgReader);
 
-    bool skip = false;
+    bool skip = duplicate;
     if (type == DT_SOUND)
     {
         // Delta ID is the sound ID.
@@ -98,6 +98,18 @@ void RuntimeDefs::clear()
     states.clear();
     texts.clear();
     stateInfo.clear();
+    strings.clear();
+}
+
+int RuntimeDefs::addString(String const &text)
+{
+    if (text.isEmpty()) return 0;
+
+    if (strings.isEmpty()) strings.append('\0');
+    int const offset = strings.size();
+    strings.append(text.toUtf8());
+    strings.append('\0');
+    return offset;
 }
 
 void Def_Init()
@@ -142,7 +154,7 @@ void Def_Destroy()
 
 state_t *Def_GetState(dint num)
 {
-    if (num >= 0 && num < DED_Definitions()->states.size())
+    if (num >= 0 && num < ::runtimeDefs.states.size())
     {
         return &::runtimeDefs.states[num];
     }
@@ -1260,6 +1272,15 @@ void Def_Read()
 
     ::runtimeDefs.stateInfo.append(defs.states.size());
 
+    // The state texts are needed whenever a mobj changes state.
+    for (dint i = 0; i < ::runtimeDefs.stateInfo.size(); ++i)
+    {
+        Record const &def = defs.states[i];
+        stateinfo_t &info = ::runtimeDefs.stateInfo[i];
+        info.name    = ::runtimeDefs.addString(def.gets("id"));
+        info.execute = ::runtimeDefs.addString(def.gets("execute"));
+    }
+
     // Mobj info.
     ::runtimeDefs.mobjInfo.append(defs.things.size());
     for (dint i = 0; i < runtimeDefs.mobjInfo.size(); ++i)
@@ -1699,7 +1720,7 @@ String Def_GetStateName(state_t const *state)
     if (!state) return "(nullptr)";
     dint const idx = ::runtimeDefs.states.indexOf(state);
     DENG2_ASSERT(idx >= 0);
-    return DED_Definitions()->states[idx].gets("id");
+    return String::fromUtf8(::runtimeDefs.string(::runtimeDefs.stateInfo[idx].name));
 }
 
 static inline dint Friendly(dint num)
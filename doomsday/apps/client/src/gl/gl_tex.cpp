@@ -19,6 +19,7 @@
 
 #include "de_platform.h"
 #include "gl/gl_tex.h"
+#include "gl/gl_texkernels.h"
 #include "dd_main.h"
 
 #include "misc/color.h"
@@ -28,29 +29,30 @@
 
 #include <doomsday/resource/colorpalette.h>
 #include <de/memory.h>
-#include <de/memoryzone.h>
 #include <de/vector1.h>
 #include <de/texgamma.h>
 #include <cstdlib>
+#include <QThreadStorage>
 #include <cmath>
 #include <cctype>
 
-static uint8_t *scratchBuffer;
-static size_t scratchBufferSize;
+static QThreadStorage<QByteArray> scratchBuffers;
 
 /**
  * Provides a persistent scratch buffer for use by texture manipulation
- * routines e.g. scaleLine().
+ * routines e.g. scaleLine(). Each thread has its own buffer, as texture
+ * content is finalized in background threads.
  */
 static uint8_t *GetScratchBuffer(size_t size)
 {
+    QByteArray &scratchBuffer = scratchBuffers.localData();
+
     // Need to enlarge?
-    if(size > scratchBufferSize)
+    if(size > size_t(scratchBuffer.size()))
     {
-        scratchBuffer = (uint8_t *) Z_Realloc(scratchBuffer, size, PU_APPSTATIC);
-        scratchBufferSize = size;
+        scratchBuffer.resize(int(size));
     }
-    return scratchBuffer;
+    return reinterpret_cast<uint8_t *>(scratchBuffer.data());
 }
 
 /**
@@ -70,25 +72,15 @@ static void scaleLine(const uint8_t* in, int inStride, uint8_t* out, int outStri
     {
         // Magnification is done using linear interpolation.
         fixed_t inPosDelta = (FRACUNIT * (inLen - 1)) / (outLen - 1);
-        fixed_t inPos = inPosDelta;
-        const uint8_t* col1, *col2;
-        int weight, invWeight;
 
         // The first pixel.
         memcpy(out, in, comps);
         out += outStride;
 
         // Step at each out pixel between the first and last ones.
-        for(i = 1; i < outLen - 1; ++i, out += outStride, inPos += inPosDelta)
-        {
-            col1 = in + (inPos >> FRACBITS) * inStride;
-            col2 = col1 + inStride;
-            weight = inPos & 0xffff;
-            invWeight = 0x10000 - weight;
-
-            for(c = 0; c < comps; ++c)
-                out[c] = (uint8_t)((col1[c] * invWeight + col2[c] * weight) >> 16);
-        }
+        TexKernels::get().lerpLine(out, outStride, in, inStride, outLen - 2, inPosDelta,
+                                   inPosDelta, comps);
+        out += (outLen - 2) * outStride;
 
         // The last pixel.
         memcpy(out, in + (inLen - 1) * inStride, comps);
@@ -210,16 +202,13 @@ static void* packImage(int components, const float* tempOut, GLint typeOut,
     switch(typeOut)
     {
     case GL_UNSIGNED_BYTE: {
-        int i, j, k = 0;
-        for(i = 0; i < heightOut; ++i)
+        int i, k = 0;
+        for(i = 0; i < heightOut; ++i, k += widthOut * components)
         {
             GLubyte* ubptr = (GLubyte*) dataOut
                 + i * rowStride
                 + packSkipRows * rowStride + packSkipPixels * components;
-            for(j = 0; j < widthOut * components; ++j)
-            {
-                *ubptr++ = (GLubyte) tempOut[k++];
-            }
+            TexKernels::get().floatsToBytes(ubptr, tempOut + k, widthOut * components);
         }
         break;
       }
@@ -419,15 +408,12 @@ void* GL_ScaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
     {
     case GL_UNSIGNED_BYTE:
         k = 0;
-        for(i = 0; i < heightIn; ++i)
+        for(i = 0; i < heightIn; ++i, k += widthIn * bpp)
         {
             GLubyte* ubptr = (GLubyte*) dataIn
                 + i * rowStride
                 + unpackSkipRows * rowStride + unpackSkipPixels * bpp;
-            for(j = 0; j < widthIn * bpp; ++j)
-            {
-                tempIn[k++] = (float) *ubptr++;
-            }
+            TexKernels::get().bytesToFloats(tempIn + k, ubptr, widthIn * bpp);
         }
         break;
     case GL_BYTE:
@@ -528,11 +514,8 @@ void* GL_ScaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
     if(sx < 1.0 && sy < 1.0)
     {
         // Magnify both width and height: use weighted sample of 4 pixels.
-        int i0, i1, j0, j1;
-        float alpha, beta;
-        float* src00, *src01, *src10, *src11;
-        float s1, s2;
-        float* dst;
+        int i0, i1;
+        float alpha;
 
         for(i = 0; i < heightOut; ++i)
         {
@@ -541,38 +524,17 @@ void* GL_ScaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
             if(i1 >= heightIn)
                 i1 = heightIn - 1;
             alpha = i * sy - i0;
-            for(j = 0; j < widthOut; ++j)
-            {
-                j0 = j * sx;
-                j1 = j0 + 1;
-                if(j1 >= widthIn)
-                    j1 = widthIn - 1;
-                beta = j * sx - j0;
-
-                // Compute weighted average of pixels in rect (i0,j0)-(i1,j1)
-                src00 = tempIn + (i0 * widthIn + j0) * bpp;
-                src01 = tempIn + (i0 * widthIn + j1) * bpp;
-                src10 = tempIn + (i1 * widthIn + j0) * bpp;
-                src11 = tempIn + (i1 * widthIn + j1) * bpp;
-
-                dst = tempOut + (i * widthOut + j) * bpp;
 
-                for (k = 0; k < bpp; ++k)
-                {
-                    s1 = *src00++ * (1.0 - beta) + *src01++ * beta;
-                    s2 = *src10++ * (1.0 - beta) + *src11++ * beta;
-                    *dst++ = s1 * (1.0 - alpha) + s2 * alpha;
-                }
-            }
+            TexKernels::get().magnifyRow(tempOut + i * widthOut * bpp,
+                                         tempIn + i0 * widthIn * bpp,
+                                         tempIn + i1 * widthIn * bpp,
+                                         widthIn, widthOut, sx, alpha, bpp);
         }
     }
     else
     {
         // Shrink width and/or height:  use an unweighted box filter.
         int i0, i1;
-        int j0, j1;
-        int ii, jj;
-        float sum, *dst;
 
         for(i = 0; i < heightOut; ++i)
         {
@@ -581,30 +543,10 @@ void* GL_ScaleBufferEx(const void* dataIn, int widthIn, int heightIn, int bpp,
             if(i1 >= heightIn)
                 i1 = heightIn - 1;
 
-            for(j = 0; j < widthOut; ++j)
-            {
-                j0 = j * sx;
-                j1 = j0 + 1;
-                if(j1 >= widthIn)
-                    j1 = widthIn - 1;
-
-                dst = tempOut + (i * widthOut + j) * bpp;
-
-                // Compute average of pixels in the rectangle (i0,j0)-(i1,j1)
-                for(k = 0; k < bpp; ++k)
-                {
-                    sum = 0.0;
-                    for(ii = i0; ii <= i1; ++ii)
-                    {
-                        for(jj = j0; jj <= j1; ++jj)
-                        {
-                            sum += *(tempIn + (ii * widthIn + jj) * bpp + k);
-                        }
-                    }
-                    sum /= (j1 - j0 + 1) * (i1 - i0 + 1);
-                    *dst++ = sum;
-                }
-            }
+            TexKernels::get().shrinkRow(tempOut + i * widthOut * bpp,
+                                        tempIn + i0 * widthIn * bpp,
+                                        tempIn + i1 * widthIn * bpp,
+                                        widthIn, widthOut, sx, i1 - i0 + 1, bpp);
         }
     }
 
@@ -662,7 +604,7 @@ void GL_DownMipmap32(uint8_t* in, int width, int height, int comps)
 {
     assert(in);
     {
-    int x, y, c, outW = width >> 1, outH = height >> 1;
+    int x, c, outW = width >> 1, outH = height >> 1;
     uint8_t* out;
 
     if(width <= 0 || height <= 0 || comps <= 0)
@@ -687,12 +629,7 @@ void GL_DownMipmap32(uint8_t* in, int width, int height, int comps)
     }
 
     // Unconstrained, 2x2 -> 1x1 reduction?
-    out = in;
-    for(y = 0; y < outH; ++y, in += width * comps)
-        for(x = 0; x < outW; ++x, in += comps * 2)
-            for(c = 0; c < comps; ++c, out++)
-                *out = (uint8_t)((in[c] + in[comps + c] + in[comps * width + c] +
-                              in[comps * (width + 1) + c]) >> 2);
+    TexKernels::get().downMipmap(in, in, width, outW, outH, comps);
     }
 }
 
@@ -938,8 +875,7 @@ void FindAverageLineColor(const uint8_t* pixels, int width, int height,
 void FindAverageColor(const uint8_t* pixels, int width, int height,
     int pixelSize, ColorRawf* color)
 {
-    long i, numpels, avg[3] = { 0, 0, 0 };
-    const uint8_t* src;
+    long numpels, avg[3];
     assert(pixels && color);
 
     if(width <= 0 || height <= 0)
@@ -958,13 +894,7 @@ void FindAverageColor(const uint8_t* pixels, int width, int height,
     }
 
     numpels = width * height;
-    src = pixels;
-    for(i = 0; i < numpels; ++i, src += pixelSize)
-    {
-        avg[0] += src[0];
-        avg[1] += src[1];
-        avg[2] += src[2];
-    }
+    TexKernels::get().sumRgb(pixels, numpels, pixelSize, avg);
 
     V3f_Set(color->rgb, avg[0] / numpels * reciprocal255,
                         avg[1] / numpels * reciprocal255,
@@ -1269,23 +1199,12 @@ void EqualizeLuma(uint8_t* pixels, int width, int height, float* rBaMul,
     float hiMul, loMul, baMul;
     long wideAvg, numpels;
     uint8_t min, max, avg;
-    uint8_t* pix;
 
     if(width <= 0 || height <= 0)
         return;
 
     numpels = width * height;
-    min = 255;
-    max = 0;
-    wideAvg = 0;
-
-    { long i;
-    for(i = 0, pix = pixels; i < numpels; ++i, pix += 1)
-    {
-        if(*pix < min) min = *pix;
-        if(*pix > max) max = *pix;
-        wideAvg += *pix;
-    }}
+    TexKernels::get().lumaRange(pixels, numpels, &min, &max, &wideAvg);
 
     if(max <= min || max == 0 || min == 255)
     {
@@ -1312,17 +1231,7 @@ void EqualizeLuma(uint8_t* pixels, int width, int height, float* rBaMul,
 
     if(!(baMul == 1 && hiMul == 1 && loMul == 1))
     {
-        long i;
-        for(i = 0, pix = pixels; i < numpels; ++i, pix += 1)
-        {
-            // First balance.
-            float val = baMul * (*pix);
-            // Now amplify.
-            if(val > 127) val *= hiMul;
-            else          val *= loMul;
-
-            *pix = (uint8_t) MINMAX_OF(0, val, 255);
-        }
+        TexKernels::get().equalizeLuma(pixels, numpels, baMul, hiMul, loMul);
     }
 
     if(rBaMul) *rBaMul = baMul;
@@ -1445,7 +1354,7 @@ void SharpenPixels(uint8_t* pixels, int width, int height, int comps)
     const float strength = .05f;
     uint8_t* result;
     float A, B, C;
-    int x, y;
+    int y;
 
     if(width <= 0 || height <= 0)
         return;
@@ -1464,22 +1373,10 @@ void SharpenPixels(uint8_t* pixels, int width, int height, int comps)
     C = 1 + 4*A + 4*B;
 
     for(y = 1; y < height - 1; ++y)
-        for(x = 1; x < width -1; ++x)
-        {
-            const uint8_t* pix = pixels + (x + y*width) * comps;
-            uint8_t* out = result + (x + y*width) * comps;
-            int c;
-            for(c = 0; c < 3; ++c)
-            {
-                int r = (C*pix[c] - A*pix[c - width] - A*pix[c + comps] - A*pix[c - comps] -
-                         A*pix[c + width] - B*pix[c + comps - width] - B*pix[c + comps + width] -
-                         B*pix[c - comps - width] - B*pix[c - comps + width]);
-                out[c] = MINMAX_OF(0, r, 255);
-            }
-
-            if(comps == 4)
-                out[3] = pix[3];
-        }
+    {
+        TexKernels::get().sharpenRow(result + y*width * comps, pixels + y*width * comps,
+                                     width, comps, A, B, C);
+    }
 
     memcpy(pixels, result, comps * width * height);
     free(result);
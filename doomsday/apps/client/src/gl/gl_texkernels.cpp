@@ -0,0 +1,805 @@
+/** @file gl_texkernels.cpp  Vectorized inner loops of the image manipulation algorithms.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "gl/gl_texkernels.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG_TEXKERNELS_SSE2
+#  include <emmintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    define DENG_TEXKERNELS_AVX2
+#    define DENG_TARGET_AVX2
+#    include <immintrin.h>
+#    include <intrin.h>
+#  elif defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#    define DENG_TEXKERNELS_AVX2
+#    define DENG_TARGET_AVX2 __attribute__((target("avx2")))
+#    include <immintrin.h>
+#  endif
+#endif
+
+/*
+ * Scalar kernels. These are the reference implementations; the vectorized
+ * kernels below must produce the same results.
+ */
+
+static void downMipmapScalar(uint8_t *out, uint8_t const *in, int width, int outW, int outH,
+                             int comps)
+{
+    for(int y = 0; y < outH; ++y, in += width * comps)
+        for(int x = 0; x < outW; ++x, in += comps * 2)
+            for(int c = 0; c < comps; ++c, out++)
+                *out = (uint8_t)((in[c] + in[comps + c] + in[comps * width + c] +
+                                  in[comps * (width + 1) + c]) >> 2);
+}
+
+static void sumRgbScalar(uint8_t const *pixels, long count, int pixelSize, long sums[3])
+{
+    sums[0] = sums[1] = sums[2] = 0;
+    for(long i = 0; i < count; ++i, pixels += pixelSize)
+    {
+        sums[0] += pixels[0];
+        sums[1] += pixels[1];
+        sums[2] += pixels[2];
+    }
+}
+
+static void lumaRangeScalar(uint8_t const *values, long count, uint8_t *min, uint8_t *max,
+                            long *sum)
+{
+    *min = 255;
+    *max = 0;
+    *sum = 0;
+    for(long i = 0; i < count; ++i)
+    {
+        if(values[i] < *min) *min = values[i];
+        if(values[i] > *max) *max = values[i];
+        *sum += values[i];
+    }
+}
+
+static void equalizeLumaScalar(uint8_t *values, long count, float baMul, float hiMul,
+                               float loMul)
+{
+    for(long i = 0; i < count; ++i)
+    {
+        // First balance.
+        float val = baMul * values[i];
+        // Now amplify.
+        if(val > 127) val *= hiMul;
+        else          val *= loMul;
+
+        values[i] = (uint8_t) (val < 0? 0 : val > 255? 255 : val);
+    }
+}
+
+static void sharpenRowScalar(uint8_t *out, uint8_t const *in, int width, int comps,
+                             float A, float B, float C)
+{
+    uint8_t const *pix = in + comps;
+    out += comps;
+    for(int x = 1; x < width - 1; ++x, pix += comps, out += comps)
+    {
+        for(int c = 0; c < 3; ++c)
+        {
+            int r = (C*pix[c] - A*pix[c - width] - A*pix[c + comps] - A*pix[c - comps] -
+                     A*pix[c + width] - B*pix[c + comps - width] - B*pix[c + comps + width] -
+                     B*pix[c - comps - width] - B*pix[c - comps + width]);
+            out[c] = (r < 0? 0 : r > 255? 255 : r);
+        }
+
+        if(comps == 4)
+            out[3] = pix[3];
+    }
+}
+
+static void bytesToFloatsScalar(float *out, uint8_t const *in, long count)
+{
+    for(long i = 0; i < count; ++i)
+        out[i] = (float) in[i];
+}
+
+static void floatsToBytesScalar(uint8_t *out, float const *in, long count)
+{
+    for(long i = 0; i < count; ++i)
+        out[i] = (uint8_t) in[i];
+}
+
+static void magnifyRowScalar(float *out, float const *row0, float const *row1, int widthIn,
+                             int widthOut, float sx, float alpha, int bpp)
+{
+    for(int j = 0; j < widthOut; ++j)
+    {
+        int j0 = j * sx;
+        int j1 = j0 + 1;
+        if(j1 >= widthIn)
+            j1 = widthIn - 1;
+        float beta = j * sx - j0;
+
+        // Compute weighted average of pixels in rect (i0,j0)-(i1,j1)
+        float const *src00 = row0 + j0 * bpp;
+        float const *src01 = row0 + j1 * bpp;
+        float const *src10 = row1 + j0 * bpp;
+        float const *src11 = row1 + j1 * bpp;
+
+        float *dst = out + j * bpp;
+
+        for(int k = 0; k < bpp; ++k)
+        {
+            float s1 = *src00++ * (1.0 - beta) + *src01++ * beta;
+            float s2 = *src10++ * (1.0 - beta) + *src11++ * beta;
+            *dst++ = s1 * (1.0 - alpha) + s2 * alpha;
+        }
+    }
+}
+
+static void shrinkRowScalar(float *out, float const *row0, float const *row1, int widthIn,
+                            int widthOut, float sx, int rows, int bpp)
+{
+    for(int j = 0; j < widthOut; ++j)
+    {
+        int j0 = j * sx;
+        int j1 = j0 + 1;
+        if(j1 >= widthIn)
+            j1 = widthIn - 1;
+
+        float *dst = out + j * bpp;
+
+        // Compute average of pixels in the rectangle (i0,j0)-(i1,j1)
+        for(int k = 0; k < bpp; ++k)
+        {
+            float sum = 0.0;
+            for(int ii = 0; ii < rows; ++ii)
+            {
+                float const *row = (ii? row1 : row0);
+                for(int jj = j0; jj <= j1; ++jj)
+                {
+                    sum += row[jj * bpp + k];
+                }
+            }
+            sum /= (j1 - j0 + 1) * rows;
+            *dst++ = sum;
+        }
+    }
+}
+
+static int32_t lerpLineScalar(uint8_t *out, int outStride, uint8_t const *in, int inStride,
+                              int count, int32_t inPos, int32_t inPosDelta, int comps)
+{
+    for(int i = 0; i < count; ++i, out += outStride, inPos += inPosDelta)
+    {
+        uint8_t const *col1 = in + (inPos >> 16) * inStride;
+        uint8_t const *col2 = col1 + inStride;
+        int weight = inPos & 0xffff;
+        int invWeight = 0x10000 - weight;
+
+        for(int c = 0; c < comps; ++c)
+            out[c] = (uint8_t)((col1[c] * invWeight + col2[c] * weight) >> 16);
+    }
+    return inPos;
+}
+
+#ifdef DENG_TEXKERNELS_SSE2
+
+/*
+ * SSE2 kernels.
+ */
+
+static inline __m128i loadPixelSSE2(uint8_t const *pix)
+{
+    int32_t value;
+    std::memcpy(&value, pix, 4);
+    __m128i const zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+}
+
+static inline void storePixelSSE2(uint8_t *pix, __m128i comps)
+{
+    comps = _mm_packs_epi32(comps, comps);
+    int32_t const value = _mm_cvtsi128_si32(_mm_packus_epi16(comps, comps));
+    std::memcpy(pix, &value, 4);
+}
+
+static inline long sumLanesSSE2(__m128i v)
+{
+    int64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, v);
+    return long(lanes[0] + lanes[1]);
+}
+
+static void downMipmapSSE2(uint8_t *out, uint8_t const *in, int width, int outW, int outH,
+                           int comps)
+{
+    if(comps != 4)
+    {
+        downMipmapScalar(out, in, width, outW, outH, comps);
+        return;
+    }
+
+    __m128i const zero = _mm_setzero_si128();
+    for(int y = 0; y < outH; ++y, in += width * 4)
+    {
+        int x = 0;
+        for(; x + 2 <= outW; x += 2, in += 16, out += 8)
+        {
+            __m128i const row0 = _mm_loadu_si128((__m128i const *) in);
+            __m128i const row1 = _mm_loadu_si128((__m128i const *) (in + width * 4));
+
+            // Columns 0 and 1, and columns 2 and 3, as 16-bit values.
+            __m128i const left  = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero),
+                                                _mm_unpacklo_epi8(row1, zero));
+            __m128i const right = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero),
+                                                _mm_unpackhi_epi8(row1, zero));
+
+            __m128i sum = _mm_unpacklo_epi64(_mm_add_epi16(left,  _mm_srli_si128(left,  8)),
+                                             _mm_add_epi16(right, _mm_srli_si128(right, 8)));
+            sum = _mm_srli_epi16(sum, 2);
+            _mm_storel_epi64((__m128i *) out, _mm_packus_epi16(sum, sum));
+        }
+        // The odd pixel at the end.
+        downMipmapScalar(out, in, width, outW - x, 1, 4);
+        in  += (outW - x) * 8;
+        out += (outW - x) * 4;
+    }
+}
+
+static void sumRgbSSE2(uint8_t const *pixels, long count, int pixelSize, long sums[3])
+{
+    if(pixelSize != 4)
+    {
+        sumRgbScalar(pixels, count, pixelSize, sums);
+        return;
+    }
+
+    __m128i const zero = _mm_setzero_si128();
+    __m128i const mask = _mm_set1_epi32(0xff);
+    __m128i r = zero, g = zero, b = zero;
+    long i = 0;
+    for(; i + 4 <= count; i += 4, pixels += 16)
+    {
+        __m128i const v = _mm_loadu_si128((__m128i const *) pixels);
+        r = _mm_add_epi64(r, _mm_sad_epu8(_mm_and_si128(v, mask), zero));
+        g = _mm_add_epi64(g, _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(v,  8), mask), zero));
+        b = _mm_add_epi64(b, _mm_sad_epu8(_mm_and_si128(_mm_srli_epi32(v, 16), mask), zero));
+    }
+    sumRgbScalar(pixels, count - i, 4, sums);
+    sums[0] += sumLanesSSE2(r);
+    sums[1] += sumLanesSSE2(g);
+    sums[2] += sumLanesSSE2(b);
+}
+
+static void lumaRangeSSE2(uint8_t const *values, long count, uint8_t *min, uint8_t *max,
+                          long *sum)
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128i vmin = _mm_set1_epi8(char(0xff)), vmax = zero, vsum = zero;
+    long i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i const v = _mm_loadu_si128((__m128i const *) (values + i));
+        vmin = _mm_min_epu8(vmin, v);
+        vmax = _mm_max_epu8(vmax, v);
+        vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+    }
+
+    uint8_t mins[16], maxs[16];
+    _mm_storeu_si128((__m128i *) mins, vmin);
+    _mm_storeu_si128((__m128i *) maxs, vmax);
+
+    lumaRangeScalar(values + i, count - i, min, max, sum);
+    for(int k = 0; k < 16; ++k)
+    {
+        if(mins[k] < *min) *min = mins[k];
+        if(maxs[k] > *max) *max = maxs[k];
+    }
+    *sum += sumLanesSSE2(vsum);
+}
+
+static inline __m128i equalizeSSE2(__m128i v, __m128 baMul, __m128 hiMul, __m128 loMul)
+{
+    __m128 const limit = _mm_set1_ps(127);
+    __m128 const top   = _mm_set1_ps(255);
+
+    __m128 val = _mm_mul_ps(baMul, _mm_cvtepi32_ps(v));
+    __m128 const isHigh = _mm_cmpgt_ps(val, limit);
+    val = _mm_mul_ps(val, _mm_or_ps(_mm_and_ps(isHigh, hiMul), _mm_andnot_ps(isHigh, loMul)));
+    return _mm_cvttps_epi32(_mm_min_ps(val, top));
+}
+
+static void equalizeLumaSSE2(uint8_t *values, long count, float baMul, float hiMul,
+                             float loMul)
+{
+    __m128i const zero = _mm_setzero_si128();
+    __m128 const ba = _mm_set1_ps(baMul);
+    __m128 const hi = _mm_set1_ps(hiMul);
+    __m128 const lo = _mm_set1_ps(loMul);
+    long i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i const v = _mm_loadu_si128((__m128i const *) (values + i));
+        __m128i const v0 = _mm_unpacklo_epi8(v, zero);
+        __m128i const v1 = _mm_unpackhi_epi8(v, zero);
+
+        __m128i const r0 = _mm_packs_epi32(equalizeSSE2(_mm_unpacklo_epi16(v0, zero), ba, hi, lo),
+                                           equalizeSSE2(_mm_unpackhi_epi16(v0, zero), ba, hi, lo));
+        __m128i const r1 = _mm_packs_epi32(equalizeSSE2(_mm_unpacklo_epi16(v1, zero), ba, hi, lo),
+                                           equalizeSSE2(_mm_unpackhi_epi16(v1, zero), ba, hi, lo));
+        _mm_storeu_si128((__m128i *) (values + i), _mm_packus_epi16(r0, r1));
+    }
+    equalizeLumaScalar(values + i, count - i, baMul, hiMul, loMul);
+}
+
+static void sharpenRowSSE2(uint8_t *out, uint8_t const *in, int width, int comps,
+                           float A, float B, float C)
+{
+    if(comps != 4)
+    {
+        sharpenRowScalar(out, in, width, comps, A, B, C);
+        return;
+    }
+
+    __m128 const a = _mm_set1_ps(A);
+    __m128 const b = _mm_set1_ps(B);
+    __m128 const c = _mm_set1_ps(C);
+
+#define DENG_PIXEL(offset) _mm_cvtepi32_ps(loadPixelSSE2(pix + (offset)))
+    uint8_t const *pix = in + 4;
+    out += 4;
+    for(int x = 1; x < width - 1; ++x, pix += 4, out += 4)
+    {
+        __m128 r = _mm_mul_ps(c, DENG_PIXEL(0));
+        r = _mm_sub_ps(r, _mm_mul_ps(a, DENG_PIXEL(-width)));
+        r = _mm_sub_ps(r, _mm_mul_ps(a, DENG_PIXEL(4)));
+        r = _mm_sub_ps(r, _mm_mul_ps(a, DENG_PIXEL(-4)));
+        r = _mm_sub_ps(r, _mm_mul_ps(a, DENG_PIXEL(width)));
+        r = _mm_sub_ps(r, _mm_mul_ps(b, DENG_PIXEL(4 - width)));
+        r = _mm_sub_ps(r, _mm_mul_ps(b, DENG_PIXEL(4 + width)));
+        r = _mm_sub_ps(r, _mm_mul_ps(b, DENG_PIXEL(-4 - width)));
+        r = _mm_sub_ps(r, _mm_mul_ps(b, DENG_PIXEL(-4 + width)));
+        storePixelSSE2(out, _mm_cvttps_epi32(r));
+        out[3] = pix[3];
+    }
+#undef DENG_PIXEL
+}
+
+static void bytesToFloatsSSE2(float *out, uint8_t const *in, long count)
+{
+    __m128i const zero = _mm_setzero_si128();
+    long i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i const v  = _mm_loadu_si128((__m128i const *) (in + i));
+        __m128i const v0 = _mm_unpacklo_epi8(v, zero);
+        __m128i const v1 = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(out + i,      _mm_cvtepi32_ps(_mm_unpacklo_epi16(v0, zero)));
+        _mm_storeu_ps(out + i + 4,  _mm_cvtepi32_ps(_mm_unpackhi_epi16(v0, zero)));
+        _mm_storeu_ps(out + i + 8,  _mm_cvtepi32_ps(_mm_unpacklo_epi16(v1, zero)));
+        _mm_storeu_ps(out + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v1, zero)));
+    }
+    bytesToFloatsScalar(out + i, in + i, count - i);
+}
+
+static void floatsToBytesSSE2(uint8_t *out, float const *in, long count)
+{
+    long i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m128i const r0 = _mm_packs_epi32(_mm_cvttps_epi32(_mm_loadu_ps(in + i)),
+                                           _mm_cvttps_epi32(_mm_loadu_ps(in + i + 4)));
+        __m128i const r1 = _mm_packs_epi32(_mm_cvttps_epi32(_mm_loadu_ps(in + i + 8)),
+                                           _mm_cvttps_epi32(_mm_loadu_ps(in + i + 12)));
+        _mm_storeu_si128((__m128i *) (out + i), _mm_packus_epi16(r0, r1));
+    }
+    floatsToBytesScalar(out + i, in + i, count - i);
+}
+
+static void magnifyRowSSE2(float *out, float const *row0, float const *row1, int widthIn,
+                           int widthOut, float sx, float alpha, int bpp)
+{
+    if(bpp != 4)
+    {
+        magnifyRowScalar(out, row0, row1, widthIn, widthOut, sx, alpha, bpp);
+        return;
+    }
+
+    // Like in the scalar version, the first weight is applied at double precision
+    // and the second at single precision, and the sums are rounded to float.
+    __m128d const ia = _mm_set1_pd(1.0 - alpha);
+    __m128 const a   = _mm_set1_ps(alpha);
+    for(int j = 0; j < widthOut; ++j, out += 4)
+    {
+        int j0 = j * sx;
+        int j1 = j0 + 1;
+        if(j1 >= widthIn)
+            j1 = widthIn - 1;
+        float beta = j * sx - j0;
+
+        __m128d const ib = _mm_set1_pd(1.0 - beta);
+        __m128 const b   = _mm_set1_ps(beta);
+
+#define DENG_LERP(p, q, w, iw) \
+    _mm_movelh_ps(_mm_cvtpd_ps(_mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(p), iw), _mm_cvtps_pd(_mm_mul_ps(q, w)))), \
+                  _mm_cvtpd_ps(_mm_add_pd(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(p, p)), iw), \
+                                          _mm_cvtps_pd(_mm_movehl_ps(_mm_mul_ps(q, w), _mm_mul_ps(q, w))))))
+        __m128 const s1 = DENG_LERP(_mm_loadu_ps(row0 + j0 * 4), _mm_loadu_ps(row0 + j1 * 4), b, ib);
+        __m128 const s2 = DENG_LERP(_mm_loadu_ps(row1 + j0 * 4), _mm_loadu_ps(row1 + j1 * 4), b, ib);
+        _mm_storeu_ps(out, DENG_LERP(s1, s2, a, ia));
+#undef DENG_LERP
+    }
+}
+
+static void shrinkRowSSE2(float *out, float const *row0, float const *row1, int widthIn,
+                          int widthOut, float sx, int rows, int bpp)
+{
+    if(bpp != 4)
+    {
+        shrinkRowScalar(out, row0, row1, widthIn, widthOut, sx, rows, bpp);
+        return;
+    }
+
+    for(int j = 0; j < widthOut; ++j, out += 4)
+    {
+        int j0 = j * sx;
+        int j1 = j0 + 1;
+        if(j1 >= widthIn)
+            j1 = widthIn - 1;
+
+        __m128 sum = _mm_setzero_ps();
+        for(int ii = 0; ii < rows; ++ii)
+        {
+            float const *row = (ii? row1 : row0);
+            for(int jj = j0; jj <= j1; ++jj)
+            {
+                sum = _mm_add_ps(sum, _mm_loadu_ps(row + jj * 4));
+            }
+        }
+        _mm_storeu_ps(out, _mm_div_ps(sum, _mm_set1_ps(float((j1 - j0 + 1) * rows))));
+    }
+}
+
+static int32_t lerpLineSSE2(uint8_t *out, int outStride, uint8_t const *in, int inStride,
+                            int count, int32_t inPos, int32_t inPosDelta, int comps)
+{
+    if(comps != 4)
+    {
+        return lerpLineScalar(out, outStride, in, inStride, count, inPos, inPosDelta, comps);
+    }
+
+    // Multiplies the 32-bit lanes of @a v with @a w (there is no 32-bit
+    // multiply in SSE2, so the even and odd lanes are done separately).
+    __m128i const lowHalves = _mm_set_epi32(0, -1, 0, -1);
+    auto mul = [&lowHalves] (__m128i v, __m128i w) {
+        __m128i const even = _mm_mul_epu32(v, w);
+        __m128i const odd  = _mm_mul_epu32(_mm_srli_epi64(v, 32), w);
+        return _mm_or_si128(_mm_and_si128(even, lowHalves), _mm_slli_epi64(odd, 32));
+    };
+
+    for(int i = 0; i < count; ++i, out += outStride, inPos += inPosDelta)
+    {
+        uint8_t const *col1 = in + (inPos >> 16) * inStride;
+        uint8_t const *col2 = col1 + inStride;
+        int const weight = inPos & 0xffff;
+
+        __m128i const sum = _mm_add_epi32(mul(loadPixelSSE2(col1), _mm_set1_epi32(0x10000 - weight)),
+                                          mul(loadPixelSSE2(col2), _mm_set1_epi32(weight)));
+        storePixelSSE2(out, _mm_srli_epi32(sum, 16));
+    }
+    return inPos;
+}
+
+#endif // DENG_TEXKERNELS_SSE2
+
+#ifdef DENG_TEXKERNELS_AVX2
+
+/*
+ * AVX2 kernels. Kernels that work one pixel at a time gain nothing from the
+ * wider registers, so the SSE2 versions of those are used instead.
+ */
+
+DENG_TARGET_AVX2
+static inline long sumLanesAVX2(__m256i v)
+{
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, v);
+    return long(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+DENG_TARGET_AVX2
+static void downMipmapAVX2(uint8_t *out, uint8_t const *in, int width, int outW, int outH,
+                           int comps)
+{
+    if(comps != 4)
+    {
+        downMipmapScalar(out, in, width, outW, outH, comps);
+        return;
+    }
+
+    __m256i const zero = _mm256_setzero_si256();
+    for(int y = 0; y < outH; ++y, in += width * 4)
+    {
+        int x = 0;
+        for(; x + 4 <= outW; x += 4, in += 32, out += 16)
+        {
+            __m256i const row0 = _mm256_loadu_si256((__m256i const *) in);
+            __m256i const row1 = _mm256_loadu_si256((__m256i const *) (in + width * 4));
+
+            // Within each 128-bit lane, the unpacking works like in the SSE2 version.
+            __m256i const left  = _mm256_add_epi16(_mm256_unpacklo_epi8(row0, zero),
+                                                   _mm256_unpacklo_epi8(row1, zero));
+            __m256i const right = _mm256_add_epi16(_mm256_unpackhi_epi8(row0, zero),
+                                                   _mm256_unpackhi_epi8(row1, zero));
+
+            __m256i sum = _mm256_unpacklo_epi64(_mm256_add_epi16(left,  _mm256_srli_si256(left,  8)),
+                                                _mm256_add_epi16(right, _mm256_srli_si256(right, 8)));
+            sum = _mm256_srli_epi16(sum, 2);
+
+            // Gather the low halves of the lanes.
+            __m256i const packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum),
+                                                            _MM_SHUFFLE(3, 1, 2, 0));
+            _mm_storeu_si128((__m128i *) out, _mm256_castsi256_si128(packed));
+        }
+        // The remaining pixels at the end.
+        downMipmapScalar(out, in, width, outW - x, 1, 4);
+        in  += (outW - x) * 8;
+        out += (outW - x) * 4;
+    }
+}
+
+DENG_TARGET_AVX2
+static void sumRgbAVX2(uint8_t const *pixels, long count, int pixelSize, long sums[3])
+{
+    if(pixelSize != 4)
+    {
+        sumRgbScalar(pixels, count, pixelSize, sums);
+        return;
+    }
+
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i const mask = _mm256_set1_epi32(0xff);
+    __m256i r = zero, g = zero, b = zero;
+    long i = 0;
+    for(; i + 8 <= count; i += 8, pixels += 32)
+    {
+        __m256i const v = _mm256_loadu_si256((__m256i const *) pixels);
+        r = _mm256_add_epi64(r, _mm256_sad_epu8(_mm256_and_si256(v, mask), zero));
+        g = _mm256_add_epi64(g, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(v,  8), mask), zero));
+        b = _mm256_add_epi64(b, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(v, 16), mask), zero));
+    }
+    sumRgbScalar(pixels, count - i, 4, sums);
+    sums[0] += sumLanesAVX2(r);
+    sums[1] += sumLanesAVX2(g);
+    sums[2] += sumLanesAVX2(b);
+}
+
+DENG_TARGET_AVX2
+static void lumaRangeAVX2(uint8_t const *values, long count, uint8_t *min, uint8_t *max,
+                          long *sum)
+{
+    __m256i const zero = _mm256_setzero_si256();
+    __m256i vmin = _mm256_set1_epi8(char(0xff)), vmax = zero, vsum = zero;
+    long i = 0;
+    for(; i + 32 <= count; i += 32)
+    {
+        __m256i const v = _mm256_loadu_si256((__m256i const *) (values + i));
+        vmin = _mm256_min_epu8(vmin, v);
+        vmax = _mm256_max_epu8(vmax, v);
+        vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(v, zero));
+    }
+
+    uint8_t mins[32], maxs[32];
+    _mm256_storeu_si256((__m256i *) mins, vmin);
+    _mm256_storeu_si256((__m256i *) maxs, vmax);
+
+    lumaRangeScalar(values + i, count - i, min, max, sum);
+    for(int k = 0; k < 32; ++k)
+    {
+        if(mins[k] < *min) *min = mins[k];
+        if(maxs[k] > *max) *max = maxs[k];
+    }
+    *sum += sumLanesAVX2(vsum);
+}
+
+DENG_TARGET_AVX2
+static void equalizeLumaAVX2(uint8_t *values, long count, float baMul, float hiMul,
+                             float loMul)
+{
+    __m256 const ba    = _mm256_set1_ps(baMul);
+    __m256 const hi    = _mm256_set1_ps(hiMul);
+    __m256 const lo    = _mm256_set1_ps(loMul);
+    __m256 const limit = _mm256_set1_ps(127);
+    __m256 const top   = _mm256_set1_ps(255);
+    long i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i const v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i const *) (values + i)));
+
+        __m256 val = _mm256_mul_ps(ba, _mm256_cvtepi32_ps(v));
+        val = _mm256_mul_ps(val, _mm256_blendv_ps(lo, hi, _mm256_cmp_ps(val, limit, _CMP_GT_OQ)));
+        __m256i const r = _mm256_cvttps_epi32(_mm256_min_ps(val, top));
+
+        __m128i const r16 = _mm_packs_epi32(_mm256_castsi256_si128(r),
+                                            _mm256_extracti128_si256(r, 1));
+        _mm_storel_epi64((__m128i *) (values + i), _mm_packus_epi16(r16, r16));
+    }
+    equalizeLumaScalar(values + i, count - i, baMul, hiMul, loMul);
+}
+
+DENG_TARGET_AVX2
+static void bytesToFloatsAVX2(float *out, uint8_t const *in, long count)
+{
+    long i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        __m256i const v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i const *) (in + i)));
+        _mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(v));
+    }
+    bytesToFloatsScalar(out + i, in + i, count - i);
+}
+
+DENG_TARGET_AVX2
+static void floatsToBytesAVX2(uint8_t *out, float const *in, long count)
+{
+    long i = 0;
+    for(; i + 16 <= count; i += 16)
+    {
+        __m256i const r0 = _mm256_cvttps_epi32(_mm256_loadu_ps(in + i));
+        __m256i const r1 = _mm256_cvttps_epi32(_mm256_loadu_ps(in + i + 8));
+        __m128i const s0 = _mm_packs_epi32(_mm256_castsi256_si128(r0), _mm256_extracti128_si256(r0, 1));
+        __m128i const s1 = _mm_packs_epi32(_mm256_castsi256_si128(r1), _mm256_extracti128_si256(r1, 1));
+        _mm_storeu_si128((__m128i *) (out + i), _mm_packus_epi16(s0, s1));
+    }
+    floatsToBytesScalar(out + i, in + i, count - i);
+}
+
+DENG_TARGET_AVX2
+static void magnifyRowAVX2(float *out, float const *row0, float const *row1, int widthIn,
+                           int widthOut, float sx, float alpha, int bpp)
+{
+    if(bpp != 4)
+    {
+        magnifyRowScalar(out, row0, row1, widthIn, widthOut, sx, alpha, bpp);
+        return;
+    }
+
+    __m256d const ia = _mm256_set1_pd(1.0 - alpha);
+    __m128 const a   = _mm_set1_ps(alpha);
+    for(int j = 0; j < widthOut; ++j, out += 4)
+    {
+        int j0 = j * sx;
+        int j1 = j0 + 1;
+        if(j1 >= widthIn)
+            j1 = widthIn - 1;
+        float beta = j * sx - j0;
+
+        __m256d const ib = _mm256_set1_pd(1.0 - beta);
+        __m128 const b   = _mm_set1_ps(beta);
+
+#define DENG_LERP(p, q, w, iw) \
+    _mm256_cvtpd_ps(_mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(p), iw), _mm256_cvtps_pd(_mm_mul_ps(q, w))))
+        __m128 const s1 = DENG_LERP(_mm_loadu_ps(row0 + j0 * 4), _mm_loadu_ps(row0 + j1 * 4), b, ib);
+        __m128 const s2 = DENG_LERP(_mm_loadu_ps(row1 + j0 * 4), _mm_loadu_ps(row1 + j1 * 4), b, ib);
+        _mm_storeu_ps(out, DENG_LERP(s1, s2, a, ia));
+#undef DENG_LERP
+    }
+}
+
+#endif // DENG_TEXKERNELS_AVX2
+
+static TexKernels::Level supportedLevel()
+{
+#ifdef DENG_TEXKERNELS_AVX2
+#  if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] >= 7)
+    {
+        __cpuid(info, 1);
+        bool const osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                                (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        if(osSavesYmm && (info[1] & (1 << 5)))
+        {
+            return TexKernels::AVX2;
+        }
+    }
+#  else
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return TexKernels::AVX2;
+    }
+#  endif
+#endif
+#ifdef DENG_TEXKERNELS_SSE2
+    return TexKernels::SSE2;
+#else
+    return TexKernels::Scalar;
+#endif
+}
+
+TexKernels const &TexKernels::get()
+{
+    static TexKernels const &kernels = forLevel(supportedLevel());
+    return kernels;
+}
+
+TexKernels const &TexKernels::forLevel(Level level)
+{
+    static TexKernels const scalar {
+        Scalar,
+        downMipmapScalar,
+        sumRgbScalar,
+        lumaRangeScalar,
+        equalizeLumaScalar,
+        sharpenRowScalar,
+        bytesToFloatsScalar,
+        floatsToBytesScalar,
+        magnifyRowScalar,
+        shrinkRowScalar,
+        lerpLineScalar
+    };
+#ifdef DENG_TEXKERNELS_SSE2
+    static TexKernels const sse2 {
+        SSE2,
+        downMipmapSSE2,
+        sumRgbSSE2,
+        lumaRangeSSE2,
+        equalizeLumaSSE2,
+        sharpenRowSSE2,
+        bytesToFloatsSSE2,
+        floatsToBytesSSE2,
+        magnifyRowSSE2,
+        shrinkRowSSE2,
+        lerpLineSSE2
+    };
+#endif
+#ifdef DENG_TEXKERNELS_AVX2
+    static TexKernels const avx2 {
+        AVX2,
+        downMipmapAVX2,
+        sumRgbAVX2,
+        lumaRangeAVX2,
+        equalizeLumaAVX2,
+        sharpenRowSSE2,
+        bytesToFloatsAVX2,
+        floatsToBytesAVX2,
+        magnifyRowAVX2,
+        shrinkRowSSE2,
+        lerpLineSSE2
+    };
+#endif
+
+    if(level > supportedLevel())
+    {
+        level = supportedLevel();
+    }
+    switch(level)
+    {
+#ifdef DENG_TEXKERNELS_AVX2
+    case AVX2: return avx2;
+#endif
+#ifdef DENG_TEXKERNELS_SSE2
+    case SSE2: return sse2;
+#endif
+    default:   return scalar;
+    }
+}
@@ -108,6 +108,29 @@ void GL_InitTextureContent(texturecontent_t *content)
     content->wrap[1] = GL_CLAMP_TO_EDGE;
     content->grayMipmap = 0;
     content->flags = 0;
+    content->uploadWidth = 0;
+    content->uploadHeight = 0;
+}
+
+/**
+ * Returns the size of the pixel buffer of @a content in bytes, including the
+ * mipmap levels that follow the pixels.
+ */
+static size_t contentBufferSize(texturecontent_t const &content)
+{
+    size_t const bytesPerPixel = BytesPerPixelFmt(content.format);
+    size_t size = bytesPerPixel * content.width * content.height;
+    if (content.flags & TXCF_MIPMAP_LEVELS)
+    {
+        int w = content.width, h = content.height;
+        while (w > 1 || h > 1)
+        {
+            w = de::max(1, w / 2);
+            h = de::max(1, h / 2);
+            size += bytesPerPixel * w * h;
+        }
+    }
+    return size;
 }
 
 texturecontent_t *GL_ConstructTextureContentCopy(texturecontent_t const *other)
@@ -119,8 +142,7 @@ texturecontent_t *GL_ConstructTextureContentCopy(texturecontent_t const *other)
     std::memcpy(c, other, sizeof(*c));
 
     // Duplicate the image buffer.
-    int bytesPerPixel = BytesPerPixelFmt(other->format);
-    size_t bufferSize = bytesPerPixel * other->width * other->height;
+    size_t bufferSize = contentBufferSize(*other);
     uint8_t *pixels = (uint8_t*) M_Malloc(bufferSize);
     std::memcpy(pixels, other->pixels, bufferSize);
     c->pixels = pixels;
@@ -725,120 +747,127 @@ static dd_bool uploadTextureGrayMipmap(int glFormat, int loadFormat, const uint8
     return true;
 }
 
-/// @note Texture parameters will NOT be set here!
-void GL_UploadTextureContent(texturecontent_t const &content, gl::UploadMethod method)
+/**
+ * Replaces the pixels of @a c with @a newPixels. The previous pixel buffer is
+ * freed unless it is @a original, which belongs to the caller.
+ */
+static void replacePixels(texturecontent_t &c, uint8_t const *original, uint8_t *newPixels)
 {
-    if (method == gl::Deferred)
+    if (newPixels == c.pixels) return;
+
+    if (c.pixels != original)
     {
-        GL_DeferTextureUpload(&content);
-        return;
+        M_Free(const_cast<uint8_t *>(c.pixels));
     }
+    c.pixels = newPixels;
+}
 
-    if (novideo) return;
+/**
+ * Translates paletted pixels to truecolor, applies gamma correction and chooses
+ * the final dimensions of the texture.
+ *
+ * @param c         Texture content being processed.
+ * @param original  Pixels that belong to the caller and must not be freed.
+ */
+static void translatePixels(texturecontent_t &c, uint8_t const *original)
+{
+    bool const generateMipmaps = (c.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
+    bool const applyTexGamma   = (c.flags & TXCF_APPLY_GAMMACORRECTION)     != 0;
 
-    // Do this right away. No need to take a copy.
-    bool generateMipmaps = (content.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
-    bool applyTexGamma   = (content.flags & TXCF_APPLY_GAMMACORRECTION)     != 0;
-    bool noCompression   = (content.flags & TXCF_NO_COMPRESSION)            != 0;
-    bool noSmartFilter   = (content.flags & TXCF_UPLOAD_ARG_NOSMARTFILTER)  != 0;
-    bool noStretch       = (content.flags & TXCF_UPLOAD_ARG_NOSTRETCH)      != 0;
+    // Convert a paletted source image to truecolor.
+    if (c.format == DGL_COLOR_INDEX_8 || c.format == DGL_COLOR_INDEX_8_PLUS_A8)
+    {
+        bool const hasAlpha = (c.format == DGL_COLOR_INDEX_8_PLUS_A8);
+        replacePixels(c, original, GL_ConvertBuffer(c.pixels, c.width, c.height,
+                                                    hasAlpha ? 2 : 1, c.paletteId,
+                                                    hasAlpha ? 4 : 3));
+        c.format = (hasAlpha ? DGL_RGBA : DGL_RGB);
+    }
+    c.paletteId = 0;
 
-    int loadWidth             = content.width;
-    int loadHeight            = content.height;
-    uint8_t const *loadPixels = content.pixels;
-    dgltexformat_t dglFormat  = content.format;
+    bool const isTrueColor = (c.format == DGL_RGBA || c.format == DGL_RGB);
 
-    // Convert a paletted source image to truecolor.
-    if (dglFormat == DGL_COLOR_INDEX_8 || dglFormat == DGL_COLOR_INDEX_8_PLUS_A8)
+    // Gamma adjustment.
+    if (isTrueColor && applyTexGamma && texGamma > .0001f)
     {
-        uint8_t *newPixels = GL_ConvertBuffer(loadPixels, loadWidth, loadHeight,
-                                              dglFormat == DGL_COLOR_INDEX_8_PLUS_A8 ? 2 : 1,
-                                              content.paletteId,
-                                              dglFormat == DGL_COLOR_INDEX_8_PLUS_A8 ? 4 : 3);
-        if (loadPixels != content.pixels)
+        int const comps = (c.format == DGL_RGBA ? 4 : 3);
+        long const numPels = c.width * c.height;
+
+        uint8_t const *src = c.pixels;
+        uint8_t *adjusted = (c.pixels == original ? (uint8_t *) M_Malloc(comps * numPels)
+                                                  : const_cast<uint8_t *>(c.pixels));
+        uint8_t *dst = adjusted;
+        for (long i = 0; i < numPels; ++i)
         {
-            M_Free(const_cast<uint8_t *>(loadPixels));
+            dst[CR] = R_TexGammaLut(src[CR]);
+            dst[CG] = R_TexGammaLut(src[CG]);
+            dst[CB] = R_TexGammaLut(src[CB]);
+            if (comps == 4)
+                dst[CA] = src[CA];
+
+            dst += comps;
+            src += comps;
         }
-        loadPixels = newPixels;
-        dglFormat = (dglFormat == DGL_COLOR_INDEX_8_PLUS_A8 ? DGL_RGBA : DGL_RGB);
+        replacePixels(c, original, adjusted);
     }
+    c.flags &= ~TXCF_APPLY_GAMMACORRECTION;
 
-    // Gamma adjustment and smart filtering.
-    if (dglFormat == DGL_RGBA || dglFormat == DGL_RGB)
+    // Smart filtering doubles the dimensions.
+    if (!isTrueColor || !useSmartFilter)
     {
-        int comps = (dglFormat == DGL_RGBA ? 4 : 3);
-
-        if (applyTexGamma && texGamma > .0001f)
-        {
-            uint8_t* dst, *localBuffer = 0;
-            long const numPels = loadWidth * loadHeight;
+        c.flags |= TXCF_UPLOAD_ARG_NOSMARTFILTER;
+    }
+    int const filterScale = (c.flags & TXCF_UPLOAD_ARG_NOSMARTFILTER ? 1 : 2);
 
-            uint8_t const *src = loadPixels;
-            if (loadPixels == content.pixels)
-            {
-                localBuffer = (uint8_t *) M_Malloc(comps * numPels);
-                dst = localBuffer;
-            }
-            else
-            {
-                dst = const_cast<uint8_t *>(loadPixels);
-            }
+    // Calculate the final dimensions for the texture, as required by
+    // the graphics hardware and/or engine configuration.
+    bool const noStretch = GL_OptimalTextureSize(c.width * filterScale, c.height * filterScale,
+                                                 (c.flags & TXCF_UPLOAD_ARG_NOSTRETCH) != 0,
+                                                 generateMipmaps,
+                                                 &c.uploadWidth, &c.uploadHeight);
+    if (noStretch) c.flags |= TXCF_UPLOAD_ARG_NOSTRETCH;
+    else           c.flags &= ~TXCF_UPLOAD_ARG_NOSTRETCH;
+}
 
-            for (long i = 0; i < numPels; ++i)
-            {
-                dst[CR] = R_TexGammaLut(src[CR]);
-                dst[CG] = R_TexGammaLut(src[CG]);
-                dst[CB] = R_TexGammaLut(src[CB]);
-                if (comps == 4)
-                    dst[CA] = src[CA];
-
-                dst += comps;
-                src += comps;
-            }
+/**
+ * Converts translated pixels to RGB(A) with smart filtering as needed, and
+ * resizes them to the final dimensions. Only the pixels are used.
+ *
+ * @param c             Texture content being processed.
+ * @param original      Pixels that belong to the caller and must not be freed.
+ * @param buildMipmaps  Generate the mipmap levels of a mipmapped texture, and
+ *                      store them after the pixels (TXCF_MIPMAP_LEVELS).
+ */
+static void processPixels(texturecontent_t &c, uint8_t const *original, bool buildMipmaps)
+{
+    DENG2_ASSERT(!c.paletteId);
 
-            if (localBuffer)
-            {
-                if (loadPixels != content.pixels)
-                {
-                    M_Free(const_cast<uint8_t *>(loadPixels));
-                }
-                loadPixels = localBuffer;
-            }
-        }
+    // Smart filtering.
+    if (!(c.flags & TXCF_UPLOAD_ARG_NOSMARTFILTER))
+    {
+        DENG2_ASSERT(c.format == DGL_RGBA || c.format == DGL_RGB);
 
-        if (useSmartFilter && !noSmartFilter)
+        if (c.format == DGL_RGB)
         {
-            if (comps == 3)
-            {
-                // Need to add an alpha channel.
-                uint8_t *newPixels = GL_ConvertBuffer(loadPixels, loadWidth, loadHeight, 3, 0, 4);
-                if (loadPixels != content.pixels)
-                {
-                    M_Free(const_cast<uint8_t *>(loadPixels));
-                }
-                loadPixels = newPixels;
-                dglFormat = DGL_RGBA;
-            }
-
-            uint8_t *filtered = GL_SmartFilter(GL_ChooseSmartFilter(loadWidth, loadHeight, 0),
-                                               loadPixels, loadWidth, loadHeight,
-                                               ICF_UPSCALE_SAMPLE_WRAP,
-                                               &loadWidth, &loadHeight);
-            if (filtered != loadPixels)
-            {
-                if (loadPixels != content.pixels)
-                {
-                    M_Free(const_cast<uint8_t *>(loadPixels));
-                }
-                loadPixels = filtered;
-            }
+            // Need to add an alpha channel.
+            replacePixels(c, original, GL_ConvertBuffer(c.pixels, c.width, c.height, 3, 0, 4));
+            c.format = DGL_RGBA;
         }
+
+        int filteredWidth, filteredHeight;
+        uint8_t *filtered = GL_SmartFilter(GL_ChooseSmartFilter(c.width, c.height, 0),
+                                           c.pixels, c.width, c.height,
+                                           ICF_UPSCALE_SAMPLE_WRAP,
+                                           &filteredWidth, &filteredHeight);
+        replacePixels(c, original, filtered);
+        c.width  = filteredWidth;
+        c.height = filteredHeight;
     }
 
-    if (dglFormat == DGL_LUMINANCE && (content.flags & TXCF_CONVERT_8BIT_TO_ALPHA))
+    if (c.format == DGL_LUMINANCE && (c.flags & TXCF_CONVERT_8BIT_TO_ALPHA))
     {
         // Needs converting. This adds some overhead.
-        long const numPixels = content.width * content.height;
+        long const numPixels = c.width * c.height;
         uint8_t *localBuffer = (uint8_t *) M_Malloc(4 * numPixels);
 
         // Move the average color to the alpha channel, make the actual color white.
@@ -848,119 +877,164 @@ void GL_UploadTextureContent(texturecontent_t const &content, gl::UploadMethod m
             *pixel++ = 255;
             *pixel++ = 255;
             *pixel++ = 255;
-            *pixel++ = loadPixels[i];
+            *pixel++ = c.pixels[i];
         }
 
-        if (loadPixels != content.pixels)
-        {
-            M_Free(const_cast<uint8_t *>(loadPixels));
-        }
-        loadPixels = localBuffer;
-        dglFormat = DGL_RGBA;
+        replacePixels(c, original, localBuffer);
+        c.format = DGL_RGBA;
     }
-    else if (dglFormat == DGL_LUMINANCE)
+    else if (c.format == DGL_LUMINANCE)
     {
         // Needs converting. This adds some overhead.
-        long const numPixels = content.width * content.height;
+        long const numPixels = c.width * c.height;
         uint8_t *localBuffer = (uint8_t *) M_Malloc(3 * numPixels);
 
         // Move the average color to the alpha channel, make the actual color white.
         uint8_t *pixel = localBuffer;
         for (long i = 0; i < numPixels; ++i)
         {
-            *pixel++ = loadPixels[i];
-            *pixel++ = loadPixels[i];
-            *pixel++ = loadPixels[i];
+            *pixel++ = c.pixels[i];
+            *pixel++ = c.pixels[i];
+            *pixel++ = c.pixels[i];
         }
 
-        if (loadPixels != content.pixels)
-        {
-            M_Free(const_cast<uint8_t *>(loadPixels));
-        }
-        loadPixels = localBuffer;
-        dglFormat = DGL_RGB;
+        replacePixels(c, original, localBuffer);
+        c.format = DGL_RGB;
     }
 
-    if (dglFormat == DGL_LUMINANCE_PLUS_A8)
+    if (c.format == DGL_LUMINANCE_PLUS_A8)
     {
         // Needs converting. This adds some overhead.
-        long const numPixels = content.width * content.height;
+        long const numPixels = c.width * c.height;
         uint8_t *localBuffer = (uint8_t *) M_Malloc(4 * numPixels);
 
         uint8_t *pixel = localBuffer;
         for (long i = 0; i < numPixels; ++i)
         {
-            *pixel++ = loadPixels[i];
-            *pixel++ = loadPixels[i];
-            *pixel++ = loadPixels[i];
-            *pixel++ = loadPixels[numPixels + i];
+            *pixel++ = c.pixels[i];
+            *pixel++ = c.pixels[i];
+            *pixel++ = c.pixels[i];
+            *pixel++ = c.pixels[numPixels + i];
         }
 
-        if (loadPixels != content.pixels)
-        {
-            M_Free(const_cast<uint8_t *>(loadPixels));
-        }
-        loadPixels = localBuffer;
-        dglFormat = DGL_RGBA;
+        replacePixels(c, original, localBuffer);
+        c.format = DGL_RGBA;
     }
 
-    // Calculate the final dimensions for the texture, as required by
-    // the graphics hardware and/or engine configuration.
-    int width = loadWidth, height = loadHeight;
-
-    noStretch = GL_OptimalTextureSize(width, height, noStretch, generateMipmaps,
-                                      &loadWidth, &loadHeight);
+    int const comps = BytesPerPixelFmt(c.format);
 
     // Do we need to resize?
-    if (width != loadWidth || height != loadHeight)
+    if (c.width != c.uploadWidth || c.height != c.uploadHeight)
     {
-        int comps = BytesPerPixelFmt(dglFormat);
-
-        if (noStretch)
+        if (c.flags & TXCF_UPLOAD_ARG_NOSTRETCH)
         {
             // Copy the texture into a power-of-two canvas.
-            uint8_t *localBuffer = (uint8_t *) M_Calloc(comps * loadWidth * loadHeight);
+            uint8_t *localBuffer = (uint8_t *) M_Calloc(comps * c.uploadWidth * c.uploadHeight);
 
             // Copy line by line.
-            for (int i = 0; i < height; ++i)
+            for (int i = 0; i < c.height; ++i)
             {
-                std::memcpy(localBuffer + loadWidth * comps * i,
-                            loadPixels  + width     * comps * i, comps * width);
+                std::memcpy(localBuffer + c.uploadWidth * comps * i,
+                            c.pixels    + c.width       * comps * i, comps * c.width);
             }
 
-            if (loadPixels != content.pixels)
-            {
-                M_Free(const_cast<uint8_t *>(loadPixels));
-            }
-            loadPixels = localBuffer;
+            replacePixels(c, original, localBuffer);
         }
         else
         {
             // Stretch into a new power-of-two texture.
-            uint8_t *newPixels = GL_ScaleBuffer(loadPixels, width, height, comps,
-                                                loadWidth, loadHeight);
-            if (loadPixels != content.pixels)
-            {
-                M_Free(const_cast<uint8_t *>(loadPixels));
-            }
-            loadPixels = newPixels;
+            replacePixels(c, original, GL_ScaleBuffer(c.pixels, c.width, c.height, comps,
+                                                      c.uploadWidth, c.uploadHeight));
+        }
+        c.width  = c.uploadWidth;
+        c.height = c.uploadHeight;
+    }
+
+    if (buildMipmaps && (c.flags & TXCF_MIPMAP) && !(c.flags & TXCF_GRAY_MIPMAP))
+    {
+        size_t const levelSize = comps * c.width * c.height;
+        c.flags |= TXCF_MIPMAP_LEVELS;
+
+        uint8_t *levels = (uint8_t *) M_Malloc(contentBufferSize(c));
+        std::memcpy(levels, c.pixels, levelSize);
+
+        // Each level is reduced from the previous one, in place.
+        uint8_t *reduced = (uint8_t *) M_Malloc(levelSize);
+        std::memcpy(reduced, c.pixels, levelSize);
+        uint8_t *out = levels + levelSize;
+        int w = c.width, h = c.height;
+        while (w > 1 || h > 1)
+        {
+            GL_DownMipmap32(reduced, w, h, comps);
+            w = de::max(1, w / 2);
+            h = de::max(1, h / 2);
+            std::memcpy(out, reduced, comps * w * h);
+            out += comps * w * h;
         }
+        M_Free(reduced);
+
+        replacePixels(c, original, levels);
     }
+}
+
+void GL_TranslateTextureContent(texturecontent_t &content)
+{
+    DENG2_ASSERT(!(content.flags & TXCF_TRANSLATED));
+
+    translatePixels(content, nullptr);
+    content.flags |= TXCF_TRANSLATED;
+}
+
+void GL_FinalizeTextureContent(texturecontent_t &content)
+{
+    DENG2_ASSERT(content.flags & TXCF_TRANSLATED);
+    DENG2_ASSERT(!(content.flags & TXCF_FINALIZED));
+
+    processPixels(content, nullptr, true /*build mipmaps*/);
+    content.flags |= TXCF_FINALIZED;
+}
+
+/// @note Texture parameters will NOT be set here!
+void GL_UploadTextureContent(texturecontent_t const &content, gl::UploadMethod method)
+{
+    if (method == gl::Deferred)
+    {
+        GL_DeferTextureUpload(&content);
+        return;
+    }
+
+    if (novideo) return;
+
+    // Do this right away. No need to take a copy of the pixels.
+    texturecontent_t c = content;
+    if (!(c.flags & TXCF_TRANSLATED))
+    {
+        translatePixels(c, content.pixels);
+    }
+    if (!(c.flags & TXCF_FINALIZED))
+    {
+        // GL generates the mipmaps.
+        processPixels(c, content.pixels, false);
+    }
+
+    bool const generateMipmaps = (c.flags & (TXCF_MIPMAP|TXCF_GRAY_MIPMAP)) != 0;
+    bool const noCompression   = (c.flags & TXCF_NO_COMPRESSION)            != 0;
+    dgltexformat_t const dglFormat = c.format;
 
     //DENG_ASSERT_IN_MAIN_THREAD();
     DENG_ASSERT_GL_CONTEXT_ACTIVE();
 
-    LIBGUI_GL.glBindTexture(GL_TEXTURE_2D, content.name);
-    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, content.minFilter);
-    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, content.magFilter);
-    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     content.wrap[0]);
-    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     content.wrap[1]);
+    LIBGUI_GL.glBindTexture(GL_TEXTURE_2D, c.name);
+    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, c.minFilter);
+    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, c.magFilter);
+    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     c.wrap[0]);
+    LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     c.wrap[1]);
     if (GL_state.features.texFilterAniso)
-        LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, GL_GetTexAnisoMul(content.anisoFilter));
+        LIBGUI_GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, GL_GetTexAnisoMul(c.anisoFilter));
 
     DENG2_ASSERT(dglFormat == DGL_RGB || dglFormat == DGL_RGBA);
 
-    if (!(content.flags & TXCF_GRAY_MIPMAP))
+    if (!(c.flags & TXCF_GRAY_MIPMAP))
     {
         GLint loadFormat;
         switch (dglFormat)
@@ -975,12 +1049,34 @@ void GL_UploadTextureContent(texturecontent_t const &content, gl::UploadMethod m
 
         GLint glFormat = ChooseTextureFormat(dglFormat, !noCompression);
 
-        if (!uploadTexture(glFormat, loadFormat, loadPixels, loadWidth, loadHeight,
-                          generateMipmaps ? true : false))
+        bool uploaded;
+        if (c.flags & TXCF_MIPMAP_LEVELS)
+        {
+            // Upload each of the levels generated by GL_FinalizeTextureContent().
+            int const comps = BytesPerPixelFmt(dglFormat);
+            uint8_t const *levelPixels = c.pixels;
+            int w = c.width, h = c.height, level = 0;
+            for (;;)
+            {
+                uploaded = uploadTexture(glFormat, loadFormat, levelPixels, w, h, -level);
+                if (!uploaded || (w == 1 && h == 1)) break;
+
+                levelPixels += comps * w * h;
+                w = de::max(1, w / 2);
+                h = de::max(1, h / 2);
+                level++;
+            }
+        }
+        else
+        {
+            uploaded = uploadTexture(glFormat, loadFormat, c.pixels, c.width, c.height,
+                                     generateMipmaps ? true : false);
+        }
+        if (!uploaded)
         {
             throw Error("GL_UploadTextureContent", QString("TexImage failed (%1:%2 fmt%3)")
-                                                       .arg(content.name)
-                                                       .arg(Vector2i(loadWidth, loadHeight).asText())
+                                                       .arg(c.name)
+                                                       .arg(Vector2i(c.width, c.height).asText())
                                                        .arg(int(dglFormat)));
         }
     }
@@ -999,18 +1095,18 @@ void GL_UploadTextureContent(texturecontent_t const &content, gl::UploadMethod m
 
         glFormat = ChooseTextureFormat(dglFormat, !noCompression);
 
-        if (!uploadTextureGrayMipmap(glFormat, loadFormat, loadPixels, loadWidth, loadHeight,
-                                     content.grayMipmap * reciprocal255))
+        if (!uploadTextureGrayMipmap(glFormat, loadFormat, c.pixels, c.width, c.height,
+                                     c.grayMipmap * reciprocal255))
         {
             throw Error("GL_UploadTextureContent", QString("TexImageGrayMipmap failed (%1:%2 fmt%3)")
-                                                       .arg(content.name)
-                                                       .arg(Vector2i(loadWidth, loadHeight).asText())
+                                                       .arg(c.name)
+                                                       .arg(Vector2i(c.width, c.height).asText())
                                                        .arg(int(dglFormat)));
         }
     }
 
-    if (loadPixels != content.pixels)
+    if (c.pixels != content.pixels)
     {
-        M_Free(const_cast<uint8_t *>(loadPixels));
+        M_Free(const_cast<uint8_t *>(c.pixels));
     }
 }
@@ -0,0 +1,164 @@
+/** @file datagramchannel.cpp  Unreliable channel for sending game messages.
+ *
+ * @authors Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "network/datagramchannel.h"
+
+#include <de/ByteSubArray>
+#include <de/Log>
+#include <de/Reader>
+#include <de/Writer>
+#include <de/data/huffman.h>
+#include <QUdpSocket>
+
+using namespace de;
+
+/// Token and flags.
+static dsize const DATAGRAM_HEADER_SIZE = 5;
+
+/// The message has been Huffman coded.
+static dbyte const DATAGRAM_HUFFMAN = 0x1;
+
+int netSimulatedDatagramLoss;
+
+DENG2_PIMPL_NOREF(DatagramChannel)
+{
+    std::unique_ptr<QUdpSocket> socket;
+};
+
+DatagramChannel::DatagramChannel() : d(new Impl)
+{}
+
+void DatagramChannel::open(duint16 port)
+{
+    close();
+
+    d->socket.reset(new QUdpSocket);
+    connect(d->socket.get(), SIGNAL(readyRead()), this, SLOT(readIncoming()));
+
+    if (!d->socket->bind(port, QUdpSocket::DontShareAddress))
+    {
+        d->socket.reset();
+
+        /// @throws PortError Could not open the UDP port.
+        throw PortError("DatagramChannel::open", "Could not bind to UDP port " + String::number(port));
+    }
+
+    LOG_NET_VERBOSE("Datagram channel open at UDP port %i") << d->socket->localPort();
+}
+
+void DatagramChannel::close()
+{
+    if (d->socket)
+    {
+        // May be called while the socket is signaling.
+        d->socket->disconnect(this);
+        d->socket.release()->deleteLater();
+    }
+}
+
+bool DatagramChannel::isOpen() const
+{
+    return bool(d->socket);
+}
+
+duint16 DatagramChannel::port() const
+{
+    return d->socket? d->socket->localPort() : 0;
+}
+
+bool DatagramChannel::send(Address const &to, duint32 token, IByteArray const &message)
+{
+    if (!d->socket) return false;
+
+    Block payload(message);
+    dbyte flags = 0;
+    if (payload.size() > DatagramChannel::MAX_MESSAGE_SIZE / 2)
+    {
+        Block const coded = codec::huffmanEncode(payload);
+        if (coded.size() < payload.size())
+        {
+            payload = coded;
+            flags |= DATAGRAM_HUFFMAN;
+        }
+    }
+    if (payload.size() > DatagramChannel::MAX_MESSAGE_SIZE)
+    {
+        return false;
+    }
+
+    if (netSimulatedDatagramLoss > 0 && qrand() % 100 < netSimulatedDatagramLoss)
+    {
+        // Pretend this was sent.
+        return true;
+    }
+
+    Block datagram;
+    Writer(datagram) << token << flags;
+    datagram += payload;
+    d->socket->writeDatagram(datagram, to.host(), to.port());
+    return true;
+}
+
+bool DatagramChannel::isSameHost(Address const &a, Address const &b) // static
+{
+    // Compare IPv4 addresses as such, also when one of them is IPv4-mapped IPv6.
+    bool isV4A = false, isV4B = false;
+    quint32 const v4A = a.host().toIPv4Address(&isV4A);
+    quint32 const v4B = b.host().toIPv4Address(&isV4B);
+    if (isV4A || isV4B)
+    {
+        return isV4A && isV4B && v4A == v4B;
+    }
+    return !a.host().isNull() && a.host() == b.host();
+}
+
+void DatagramChannel::readIncoming()
+{
+    LOG_AS("DatagramChannel");
+
+    while (d->socket && d->socket->hasPendingDatagrams())
+    {
+        QHostAddress from;
+        quint16 port = 0;
+        Block datagram(d->socket->pendingDatagramSize());
+        d->socket->readDatagram(reinterpret_cast<char *>(datagram.data()),
+                                datagram.size(), &from, &port);
+
+        if (datagram.size() <= DATAGRAM_HEADER_SIZE) continue; // Not for us.
+
+        try
+        {
+            duint32 token;
+            dbyte flags;
+            Reader(datagram) >> token >> flags;
+
+            Block message = ByteSubArray(datagram, DATAGRAM_HEADER_SIZE);
+            if (flags & DATAGRAM_HUFFMAN)
+            {
+                message = codec::huffmanDecode(message);
+            }
+
+            emit messageReceived(Address(from, port), token, message);
+        }
+        catch (Error const &er)
+        {
+            LOGDEV_NET_WARNING("Invalid datagram from %s port %i: %s")
+                    << from.toString() << port << er.asText();
+        }
+    }
+}
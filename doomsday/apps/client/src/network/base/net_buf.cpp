@@ -20,6 +20,7 @@
 
 #include "de_base.h"
 #include "network/net_buf.h"
+#include "network/net_msg.h"
 
 #include <de/c_wrapper.h>
 #include <de/concurrency.h>
@@ -96,6 +97,8 @@ void N_Shutdown()
 
     ::allowSending = false;
 
+    Msg_ReleaseWriters();
+
     // Close the handle of the message queue mutex.
     Sys_DestroyMutex(msgMutex);
     msgMutex = 0;
@@ -255,8 +258,6 @@ void N_SendPacket(dint flags)
 {
 #ifdef __SERVER__
     duint dest = 0;
-#else
-    DENG2_UNUSED(flags);
 #endif
 
     // Is the network available?
@@ -278,13 +279,22 @@ void N_SendPacket(dint flags)
         }
         else
         {
-            // Broadcast to all non-local players, using recursive calls.
+            // Broadcast to all non-local players. The message is compressed only
+            // once for all of them.
+            QList<de::Id> recipients;
             for(dint i = 0; i < DDMAXPLAYERS; ++i)
             {
-                ::netBuffer.player = i;
-                N_SendPacket(flags);
+                if(DD_Player(i)->isConnected())
+                {
+                    recipients << DD_Player(i)->remoteUserId;
+                    ::numOutBytes += ::netBuffer.headerLength + ::netBuffer.length;
+                }
             }
 
+            App_ServerSystem().broadcast(de::ByteRefArray(&::netBuffer.msg,
+                                                          ::netBuffer.headerLength + ::netBuffer.length),
+                                         recipients);
+
             // Reset back to -1 to notify of the broadcast.
             ::netBuffer.player = NSP_BROADCAST;
             return;
@@ -295,6 +305,18 @@ void N_SendPacket(dint flags)
     // This is what will be sent.
     ::numOutBytes += ::netBuffer.headerLength + ::netBuffer.length;
 
+    de::ByteRefArray const message(&::netBuffer.msg, ::netBuffer.headerLength + ::netBuffer.length);
+
+    if(flags & SPF_DATAGRAM)
+    {
+        // If the datagram can't be sent, TCP will do.
+#ifdef __CLIENT__
+        if(Net_ServerLink().sendDatagram(message)) return;
+#else
+        if(App_ServerSystem().sendDatagram(dest, message)) return;
+#endif
+    }
+
     try
     {
 #ifdef __CLIENT__
@@ -303,7 +325,7 @@ void N_SendPacket(dint flags)
         de::Transmitter &out = App_ServerSystem().user(dest);
 #endif
 
-        out << de::ByteRefArray(&::netBuffer.msg, ::netBuffer.headerLength + ::netBuffer.length);
+        out << message;
     }
     catch(Error const &er)
     {
@@ -426,4 +448,9 @@ void N_PrintTransmissionStats()
             << ::numOutBytes
             << ::numSentBytes;
     }
+
+    size_t messages, allocations, bufferBytes;
+    Msg_WriterStats(&messages, &allocations, &bufferBytes);
+    LOG_NET_MSG("Message writers: %i messages written, %i writers allocated (%i bytes of buffers)")
+        << messages << allocations << bufferBytes;
 }
@@ -47,6 +47,7 @@
 #  include "server/sv_pool.h"
 #endif
 
+#include "network/datagramchannel.h"
 #include "network/masterserver.h"
 #include "network/net_buf.h"
 #include "network/net_event.h"
@@ -104,6 +105,7 @@ static byte netAllowJoin = true;
 //static dfloat netConnectTime;
 //dint netCoordTime = 17;
 dfloat netSimulatedLatencySeconds;
+byte netDatagrams = true;  ///< Use datagram channels when both ends support them.
 
 // Local packets are stored into this buffer.
 static dd_bool reboundPacket;
@@ -113,6 +115,18 @@ static netbuffer_t reboundStore;
 static dint coordTimer;
 #endif
 
+/**
+ * Copies the used part of a network buffer. The data buffer is large, so copying
+ * the whole struct would be wasteful for the usual short messages.
+ */
+static void copyNetBuffer(netbuffer_t &dest, netbuffer_t const &src)
+{
+    dest.player       = src.player;
+    dest.length       = src.length;
+    dest.headerLength = src.headerLength;
+    std::memcpy(&dest.msg, &src.msg, de::min(sizeof(src.msg), src.headerLength + src.length));
+}
+
 void Net_Init()
 {
     for(dint i = 0; i < DDMAXPLAYERS; ++i)
@@ -166,7 +180,7 @@ void Net_SendBuffer(dint toPlayer, dint spFlags)
     // A rebound packet?
     if(spFlags & SPF_REBOUND)
     {
-        ::reboundStore  = ::netBuffer;
+        copyNetBuffer(::reboundStore, ::netBuffer);
         ::reboundPacket = true;
         return;
     }
@@ -190,7 +204,7 @@ dd_bool Net_GetPacket()
 {
     if(reboundPacket)  // Local packets rebound.
     {
-        ::netBuffer = ::reboundStore;
+        copyNetBuffer(::netBuffer, ::reboundStore);
         ::netBuffer.player = ::consolePlayer;
         //::netBuffer.cursor = ::netBuffer.msg.data;
         ::reboundPacket = false;
@@ -385,7 +399,8 @@ static void Net_DoUpdate()
         Writer_WriteChar(::msgWriter, FLT2FIX(DD_Player(::consolePlayer)->publicData().sideMove) >> 13);
         Msg_End();
 
-        Net_SendBuffer(0, 0);
+        // Coordinates are sent every tic, so a lost one doesn't matter.
+        Net_SendBuffer(0, SPF_DATAGRAM);
     }
 #endif // __CLIENT__
 }
@@ -1309,6 +1324,8 @@ void Net_Register()
 #ifdef DENG2_DEBUG
     C_VAR_FLOAT     ("net-dev-latency",         &::netSimulatedLatencySeconds, CVF_NO_MAX, 0, 0);
 #endif
+    C_VAR_INT       ("net-dev-datagram-loss",   &::netSimulatedDatagramLoss, 0, 0, 100);
+    C_VAR_BYTE      ("net-datagrams",           &::netDatagrams, 0, 0, 1);
     //C_VAR_BYTE      ("net-nosleep",             &::netDontSleep, 0, 0, 1);
     //C_VAR_CHARPTR   ("net-master-address",      &::masterAddress, 0, 0, 0);
     //C_VAR_INT       ("net-master-port",         &::masterPort, 0, 0, 65535);
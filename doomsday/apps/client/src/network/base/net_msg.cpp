@@ -38,6 +38,13 @@ reader_s *msgReader;
 /// earlier one is finished.
 static QList<writer_s *> pendingWriters;
 
+/// Finished writers are kept for reuse. Their buffers have already grown to fit
+/// the messages written so far, so a new message normally needs no allocations.
+static QList<writer_s *> freeWriters;
+
+static dsize numWrittenMessages;
+static dsize numWriterAllocs;
+
 void Msg_Begin(dint type)
 {
     if(::msgReader)
@@ -53,8 +60,16 @@ void Msg_Begin(dint type)
         ::msgWriter = nullptr;
     }
 
-    // Allocate a new writer.
-    ::msgWriter = Writer_NewWithDynamicBuffer(1 /*type*/ + NETBUFFER_MAXSIZE);
+    if(!::freeWriters.isEmpty())
+    {
+        ::msgWriter = ::freeWriters.takeLast();
+        Writer_SetPos(::msgWriter, 0);
+    }
+    else
+    {
+        ::msgWriter = Writer_NewWithDynamicBuffer(1 /*type*/ + NETBUFFER_MAXSIZE);
+        ::numWriterAllocs++;
+    }
     Writer_WriteByte(::msgWriter, type);
 }
 
@@ -71,7 +86,8 @@ void Msg_End()
     // Message type is included as the first byte.
     ::netBuffer.length = Writer_Size(::msgWriter) - 1 /*type*/;
     std::memcpy(&::netBuffer.msg, Writer_Data(::msgWriter), Writer_Size(::msgWriter));
-    Writer_Delete(::msgWriter);
+    ::numWrittenMessages++;
+    ::freeWriters.append(::msgWriter);
     ::msgWriter = 0;
 
     // Pop a pending writer off the stack.
@@ -81,6 +97,31 @@ void Msg_End()
     }
 }
 
+void Msg_WriterStats(size_t *messages, size_t *allocations, size_t *bufferBytes)
+{
+    if(messages)    *messages    = ::numWrittenMessages;
+    if(allocations) *allocations = ::numWriterAllocs;
+    if(bufferBytes)
+    {
+        *bufferBytes = 0;
+        for(writer_s const *writer : ::freeWriters)
+        {
+            *bufferBytes += Writer_TotalBufferSize(writer);
+        }
+    }
+}
+
+void Msg_ReleaseWriters()
+{
+    DENG2_ASSERT(!::msgWriter && ::pendingWriters.isEmpty());
+
+    for(writer_s *writer : ::freeWriters)
+    {
+        Writer_Delete(writer);
+    }
+    ::freeWriters.clear();
+}
+
 void Msg_BeginRead()
 {
     if(::msgWriter)
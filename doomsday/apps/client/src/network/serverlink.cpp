@@ -18,6 +18,7 @@
 
 #include "de_platform.h"
 #include "network/serverlink.h"
+#include "network/datagramchannel.h"
 #include "network/masterserver.h"
 #include "network/net_main.h"
 #include "network/net_buf.h"
@@ -66,6 +67,10 @@ enum LinkState
 
 static int const NUM_PINGS = 5;
 
+/// Datagram hellos are sent at this interval (milliseconds) until one is answered.
+static int const DATAGRAM_HELLO_INTERVAL = 250;
+static int const DATAGRAM_HELLO_COUNT = 8;
+
 DENG2_PIMPL(ServerLink)
 {
     std::unique_ptr<shell::ServerFinder> finder; ///< Finding local servers.
@@ -81,11 +86,20 @@ DENG2_PIMPL(ServerLink)
     std::function<void (GameProfile const *)> profileResultCallback;
     std::function<void (Address, GameProfile const *)> profileResultCallbackWithAddress;
     LoopCallback mainCall;
+    DatagramChannel datagrams;  ///< Frames and coordinates, if the server agrees.
+    duint32 datagramToken;
+    Address datagramAddress;
+    bool datagramsAnswered;     ///< Server has received our datagrams.
+    QTimer datagramHelloTimer;
+    int datagramHellosLeft;
 
     Impl(Public *i, Flags flags)
         : Base(i)
         , state(None)
         , fetching(false)
+        , datagramToken(0)
+        , datagramsAnswered(false)
+        , datagramHellosLeft(0)
     {
         if (flags & DiscoverLocalServers)
         {
@@ -322,6 +336,23 @@ DENG2_PIMPL(ServerLink)
         return all;
     }
 
+    /**
+     * Posts a message from the server into the incoming message queue.
+     */
+    void postMessage(Block const &packetData)
+    {
+        netmessage_t *msg = reinterpret_cast<netmessage_t *>(M_Calloc(sizeof(netmessage_t)));
+
+        msg->sender = 0; // the server
+        msg->data = new byte[packetData.size()];
+        memcpy(msg->data, packetData.data(), packetData.size());
+        msg->size = packetData.size();
+        msg->handle = msg->data; // needs delete[]
+
+        // The message queue will handle the message from now on.
+        N_PostMessage(msg);
+    }
+
     void reportError(String const &msg)
     {
         // Show the error message in a dialog box.
@@ -355,6 +386,11 @@ ServerLink::ServerLink(Flags flags) : d(new Impl(this, flags))
     }
     connect(this, SIGNAL(packetsReady()), this, SLOT(handleIncomingPackets()));
     connect(this, SIGNAL(disconnected()), this, SLOT(linkDisconnected()));
+    connect(&d->datagrams, SIGNAL(messageReceived(de::Address, de::duint32, de::Block)),
+            this, SLOT(datagramReceived(de::Address, de::duint32, de::Block)));
+
+    d->datagramHelloTimer.setInterval(DATAGRAM_HELLO_INTERVAL);
+    connect(&d->datagramHelloTimer, SIGNAL(timeout()), this, SLOT(sendDatagramHello()));
 }
 
 void ServerLink::clear()
@@ -529,6 +565,7 @@ void ServerLink::disconnect()
 
         LOG_NET_NOTE("Link to server %s disconnected") << address();
 
+        closeDatagramChannel();
         AbstractLink::disconnect();
 
         Net_StopGame();
@@ -723,21 +760,12 @@ void ServerLink::handleIncomingPackets()
             }
             break;
 
-        case InGame: {
+        case InGame:
             /// @todo The incoming packets should be handled immediately.
 
             // Post the data into the queue.
-            netmessage_t *msg = reinterpret_cast<netmessage_t *>(M_Calloc(sizeof(netmessage_t)));
-
-            msg->sender = 0; // the server
-            msg->data = new byte[packetData.size()];
-            memcpy(msg->data, packetData.data(), packetData.size());
-            msg->size = packetData.size();
-            msg->handle = msg->data; // needs delete[]
-
-            // The message queue will handle the message from now on.
-            N_PostMessage(msg);
-            break; }
+            d->postMessage(packetData);
+            break;
 
         default:
             // Ignore any packets left.
@@ -746,6 +774,86 @@ void ServerLink::handleIncomingPackets()
     }
 }
 
+void ServerLink::openDatagramChannel(duint16 port, duint32 token)
+{
+    LOG_AS("ServerLink");
+
+    closeDatagramChannel();
+    try
+    {
+        d->datagrams.open();
+    }
+    catch (Error const &er)
+    {
+        LOG_NET_WARNING("Datagrams are not available: %s") << er.asText();
+        return;
+    }
+
+    d->datagramToken      = token;
+    d->datagramAddress    = Address(address().host(), port);
+    d->datagramHellosLeft = DATAGRAM_HELLO_COUNT;
+
+    sendDatagramHello();
+    d->datagramHelloTimer.start();
+}
+
+void ServerLink::closeDatagramChannel()
+{
+    d->datagramHelloTimer.stop();
+    d->datagrams.close();
+    d->datagramToken     = 0;
+    d->datagramsAnswered = false;
+}
+
+bool ServerLink::sendDatagram(IByteArray const &message)
+{
+    if (!d->datagramsAnswered) return false;
+
+    return d->datagrams.send(d->datagramAddress, d->datagramToken, message);
+}
+
+void ServerLink::sendDatagramHello()
+{
+    LOG_AS("ServerLink");
+
+    if (d->datagramsAnswered) return;
+
+    if (d->datagramHellosLeft-- <= 0)
+    {
+        LOG_NET_MSG("Server is not answering datagrams; using only TCP");
+        closeDatagramChannel();
+        return;
+    }
+
+    // The server echoes this back.
+    dbyte const hello = PKT_DATAGRAM_HELLO;
+    d->datagrams.send(d->datagramAddress, d->datagramToken, ByteRefArray(&hello, 1));
+}
+
+void ServerLink::datagramReceived(Address from, duint32 token, Block message)
+{
+    LOG_AS("ServerLink");
+
+    if (!d->datagramToken || token != d->datagramToken || message.isEmpty()) return;
+
+    // The sender's address may be represented differently than the server's
+    // TCP address (e.g., IPv4-mapped IPv6).
+    if (!DatagramChannel::isSameHost(from, d->datagramAddress)) return;
+
+    if (!d->datagramsAnswered)
+    {
+        LOG_NET_MSG("Using datagrams for frames and coordinates (server UDP port %i)")
+                << from.port();
+        d->datagramsAnswered = true;
+        d->datagramHelloTimer.stop();
+    }
+
+    if (d->state == InGame && dbyte(message.at(0)) == PSV_DATAGRAM_FRAME2)
+    {
+        d->postMessage(message);
+    }
+}
+
 ServerLink &ServerLink::get() // static
 {
     return ClientApp::serverLink();
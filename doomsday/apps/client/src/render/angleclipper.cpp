@@ -19,6 +19,8 @@
  */
 
 #include "render/angleclipper.h"
+#include "render/clipranges.h"
+#include "render/elementpool.h"
 
 #include <QVector>
 #include <de/Error>
@@ -40,124 +42,14 @@ namespace internal
         // Shift for more accuracy;
         return bamsAtan2(dint(point.y * 100), dint(point.x * 100));
     }
-
-    /**
-     * Simple data structure for pooling POD elements. Note that unlike a traditional
-     * ObjectPool (pattern), the pooled elements are @em not owned by the pool!
-     */
-    class ElementPool
-    {
-    public:
-        /**
-         * Base for POD elements.
-         */
-        struct Element
-        {
-        private:
-            Element *_prev, *_next;
-
-            friend class ElementPool;
-        };
-
-        /**
-         * Begin reusing elements in the pool.
-         */
-        void rewind() {
-            _rover = _first;
-        }
-
-        /**
-         * Add a new @em unused object to the pool.
-         *
-         * @param elem  Element to be linked in the pool. Ownership is unaffected.
-         */
-        void add(Element *elem)
-        {
-            // Link it to the start of the rover's list.
-            if(!_last) _last = elem;
-            if(_first) _first->_prev = elem;
-
-            elem->_next = _first;
-            elem->_prev = nullptr;
-
-            _first = elem;
-        }
-
-        /**
-         * Returns a pointer to the next unused element in the pool; otherwise @c nullptr.
-         */
-        void *get() {
-            if(!_rover) return nullptr;
-
-            // We'll use this.
-            Element *next = _rover;
-            _rover = _rover->_next;
-            return next;
-        }
-
-        /**
-         * Release the element @a elem (@important which is assumed to have been added
-         * previously!), moving it to the list of used elements, for later reuse.
-         */
-        void release(Element *elem)
-        {
-            DENG2_ASSERT(_last);
-
-            if(elem == _last)
-            {
-                DENG2_ASSERT(!_rover);
-
-                // We can only remove the last if all elements are already in use.
-                _rover = elem;
-                return;
-            }
-
-            DENG2_ASSERT(elem->_next);
-
-            // Unlink from the list entirely.
-            elem->_next->_prev = elem->_prev;
-            if(elem->_prev)
-            {
-                elem->_prev->_next = elem->_next;
-            }
-            else
-            {
-                _first = _first->_next;
-                _first->_prev = nullptr;
-            }
-
-            // Put it back to the end of the list.
-            _last->_next = elem;
-            elem->_prev = _last;
-            elem->_next = nullptr;
-            _last = elem;
-
-            // If all were in use, set the rover here. Otherwise the rover can stay
-            // where it is.
-            if(!_rover)
-            {
-                _rover = _last;
-            }
-        }
-
-    private:
-        Element *_first = nullptr;
-        Element *_last  = nullptr;
-        Element *_rover = nullptr;
-    };
 }  // namespace internal
 using namespace ::internal;
 
 DENG2_PIMPL_NOREF(AngleClipper)
 {
-    /// Specialized AngleRange for half-space clipping.
-    struct Clipper : public ElementPool::Element, AngleRange
-    {
-        Clipper *prev;
-        Clipper *next;
-    };
-    ElementPool clipNodes;         ///< The list of clipnodes.
-    Clipper *clipHead = nullptr;   ///< Head of the clipped-range list.
+    ClipRangeList clipList;
+    ClipRangeBitmap clipBitmap;
+    ClipRanges *clipRanges = &clipList;  ///< Backend chosen in clearRanges().
 
     /// Specialized AngleRange for half-space occlusion.
     struct Occluder : public ElementPool::Element, AngleRange
@@ -175,7 +67,6 @@ DENG2_PIMPL_NOREF(AngleClipper)
 
     ~Impl()
     {
-        clearRangeList(&clipHead);
         clearRangeList(&occHead);
     }
 
@@ -191,65 +82,12 @@ DENG2_PIMPL_NOREF(AngleClipper)
         }
     }
 
-    /**
-     * The specified range must be safe!
-     */
-    dint isRangeVisible(binangle_t from, binangle_t to) const
-    {
-        for(Clipper *i = clipHead; i; i = i->next)
-        {
-            if(from >= i->from && to <= i->to)
-                return false;
-        }
-        // No clip-node fully contained the specified range.
-        return true;
-    }
-
     /**
      * @return  Non-zero iff the range is not entirely clipped; otherwise @c 0.
      */
     dint safeCheckRange(binangle_t from, binangle_t to) const
     {
-        if(from > to)
-        {
-            // The range wraps around.
-            return (isRangeVisible(from, BANG_MAX) || isRangeVisible(0, to));
-        }
-        return isRangeVisible(from, to);
-    }
-
-    void removeRange(Clipper *crange)
-    {
-        // If this is the head, move it.
-        if(clipHead == crange)
-            clipHead = crange->next;
-
-        if(crange->prev)
-            crange->prev->next = crange->next;
-        if(crange->next)
-            crange->next->prev = crange->prev;
-
-        // We're done with this range - mark it as free for reuse.
-        clipNodes.release(crange);
-    }
-
-    Clipper *newClipNode(binangle_t from, binangle_t to)
-    {
-        // Perhaps a previously-used clip-node can be reused?
-        auto *crange = reinterpret_cast<Clipper *>(clipNodes.get());
-        if(!crange)
-        {
-            // No, allocate another.
-            clipNodes.add(crange = new Clipper);
-        }
-
-        // (Re)Configure.
-        crange->from = from;
-        crange->to   = to;
-        crange->prev = nullptr;
-        crange->next = nullptr;
-
-        return crange;
+        return clipRanges->safeCheckRange(from, to);
     }
 
     void addRange(binangle_t from, binangle_t to)
@@ -258,187 +96,7 @@ DENG2_PIMPL_NOREF(AngleClipper)
         // corresponding occlusion range.
         cutOcclusionRange(from, to);
 
-        // If there is no head, this will be the first range.
-        if(!clipHead)
-        {
-            clipHead = newClipNode(from, to);
-
-            /*
-            LOG_AS("AngleClipper::addRange");
-            LOG_DEBUG(String("New head added: %1 => %2")
-                        .arg(clipHead->from, 0, 16)
-                        .arg(clipHead->to,   0, 16));
-            */
-            return;
-        }
-
-        // There are previous ranges. Check that the new range isn't contained
-        // by any of them.
-        for(Clipper *i = clipHead; i; i = i->next)
-        {
-            /*
-            LOG_AS("AngleClipper::addRange");
-            LOG_DEBUG(String("0x%1: %2 => %3")
-                        .arg((quintptr)i, QT_POINTER_SIZE * 2, 16, QChar('0'))
-                        .arg(i->from, 0, 16)
-                        .arg(i->to,   0, 16));
-            */
-
-            if(from >= i->from && to <= i->to)
-            {
-                /*
-                LOG_AS("AngleClipper::addRange");
-                LOG_DEBUG("Range already exists");
-                */
-                return;  // The new range already exists.
-            }
-
-#ifdef DENG2_DEBUG
-            if(i == i->next)
-                throw Error("AngleClipper::addRange", String("loop1 0x%1 linked to itself: %2 => %3")
-                                                        .arg((quintptr)i, QT_POINTER_SIZE * 2, 16, QChar('0'))
-                                                        .arg(i->from, 0, 16)
-                                                        .arg(i->to,   0, 16));
-#endif
-        }
-
-        // Now check if any of the old ranges are contained by the new one.
-        for(Clipper *i = clipHead; i;)
-        {
-            if(i->from >= from && i->to <= to)
-            {
-                Clipper *contained = i;
-
-                /*
-                LOG_AS("AngleClipper::addRange");
-                LOG_DEBUG(String("Removing contained range %1 => %2")
-                            .arg(contained->from, 0, 16)
-                            .arg(contained->to,   0, 16));
-                */
-
-                i = i->next;
-                removeRange(contained);
-                continue;
-            }
-
-            i = i->next;
-        }
-
-        // Now it is possible that the new range overlaps one or two old ranges.
-        // If two are overlapped, they are consecutive. First we'll try to find
-        // a range that overlaps the beginning.
-        Clipper *crange = nullptr;
-        for(Clipper *i = clipHead; i; i = i->next)
-        {
-            // In preparation for the next stage, find a good spot for the range.
-            if(i->from < to)
-            {
-                // After this one.
-                crange = i;
-            }
-
-            if(i->from >= from && i->from <= to)
-            {
-                // New range's end and i's beginning overlap. i's end is outside.
-                // Otherwise it would have been already removed.
-                // It suffices to adjust i.
-
-                /*
-                LOG_AS("AngleClipper::addRange");
-                LOG_DEBUG(String("Overlapping start: %1 => %2 - adjusting to %3 => %4")
-                            .arg(i->from, 0, 16)
-                            .arg(i->to,   0, 16)
-                            .arg(from,    0, 16)
-                            .arg(i->to,   0, 16));
-                */
-
-                i->from = from;
-                return;
-            }
-
-            // Check an overlapping end.
-            if(i->to >= from && i->to <= to)
-            {
-                // Now it's possible that the i->next's beginning overlaps the
-                // new range's end. In that case there will be a merger.
-
-                /*
-                LOG_AS("AngleClipper::addRange");
-                LOG_DEBUG(String("Overlapping end: %1 => %2")
-                            .arg(i->from, 0, 16)
-                            .arg(i->to,   0, 16));
-                */
-
-                crange = i->next;
-                if(!crange)
-                {
-                    i->to = to;
-
-                    /*
-                    LOG_AS("AngleClipper::addRange");
-                    LOG_DEBUG(String("No next, adjusting end (now %1 => %2)")
-                                .arg(i->from, 0, 16)
-                                .arg(i->to,   0, 16));
-                    */
-                }
-                else
-                {
-                    if(crange->from <= to)
-                    {
-                        // A fusion will commence. Ci will eat the new range
-                        // *and* crange.
-                        i->to = crange->to;
-
-                        /*
-                        LOG_AS("AngleClipper::addRange");
-                        LOG_DEBUG(String("merging with the next (%1 => %2)")
-                                    .arg(crange->from, 0, 16)
-                                    .arg(crange->to,   0, 16));
-                        */
-
-                        removeRange(crange);
-                    }
-                    else
-                    {
-                        // Not overlapping.
-                        i->to = to;
-
-                        /*
-                        LOG_AS("AngleClipper::addRange");
-                        LOG_DEBUG(String("Not merger w/next (now %1 => %2)")
-                                    .arg(i->from, 0, 16)
-                                    .arg(i->to,   0, 16));
-                        */
-                    }
-                }
-
-                return;
-            }
-        }
-
-        // Still here? Now we know for sure that the range is disconnected from
-        // the others. We still need to find a good place for it. Crange will
-        // mark the spot.
-
-        if(!crange)
-        {
-            // We have a new head.
-            crange = clipHead;
-            clipHead = newClipNode(from, to);
-            clipHead->next = crange;
-            if(crange)
-                crange->prev = clipHead;
-        }
-        else
-        {
-            // Add the new range after crange.
-            Clipper *added = newClipNode(from, to);
-            added->next = crange->next;
-            if(added->next)
-                added->next->prev = added;
-            added->prev = crange;
-            crange->next = added;
-        }
+        clipRanges->addRange(from, to);
     }
 
     void removeOcclusionRange(Occluder *orange)
@@ -773,20 +431,14 @@ dint AngleClipper::isFull() const
 {
     if(::devNoCulling) return false;
 
-    return d->clipHead && d->clipHead->from == 0 && d->clipHead->to == BANG_MAX;
+    return d->clipRanges->isFull();
 }
 
 dint AngleClipper::isAngleVisible(binangle_t bang) const
 {
     if(::devNoCulling) return true;
 
-    for(Impl::Clipper const *crange = d->clipHead; crange; crange = crange->next)
-    {
-        if(bang > crange->from && bang < crange->to)
-            return false;
-    }
-
-    return true;  // Not occluded.
+    return d->clipRanges->isAngleVisible(bang);
 }
 
 dint AngleClipper::isPointVisible(Vector3d const &point) const
@@ -868,8 +520,9 @@ dint AngleClipper::isPolyVisible(Face const &poly) const
 
 void AngleClipper::clearRanges()
 {
-    d->clipHead = nullptr;
-    d->clipNodes.rewind();  // Start reusing ranges.
+    // The backend can only be changed while there are no ranges.
+    d->clipRanges = (::angleClipBitmap? static_cast<ClipRanges *>(&d->clipBitmap) : &d->clipList);
+    d->clipRanges->clear();
 
     d->occHead = nullptr;
     d->occNodes.rewind();   // Start reusing ranges.
@@ -945,30 +598,6 @@ dint AngleClipper::checkRangeFromViewRelPoints(Vector2d const &from, Vector2d co
 #ifdef DENG2_DEBUG
 void AngleClipper::validate()
 {
-    for(Impl::Clipper *i = d->clipHead; i; i = i->next)
-    {
-        if(i == d->clipHead)
-        {
-            if(i->prev)
-                throw Error("AngleClipper::validate", "Cliphead->prev != NULL");
-        }
-
-        // Confirm that the links to prev and next are OK.
-        if(i->prev)
-        {
-            if(i->prev->next != i)
-                throw Error("AngleClipper::validate", "Prev->next != this");
-        }
-        else if(i != d->clipHead)
-        {
-            throw Error("AngleClipper::validate", "prev == NULL, this isn't clipHead");
-        }
-
-        if(i->next)
-        {
-            if(i->next->prev != i)
-                throw Error("AngleClipper::validate", "Next->prev != this");
-        }
-    }
+    d->clipList.validate();
 }
 #endif
@@ -0,0 +1,540 @@
+/** @file clipranges.cpp  Clipped angle ranges of the Angle Clipper.
+ *
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2006-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "render/clipranges.h"
+#include "render/elementpool.h"
+
+#include <de/Error>
+#include <de/String>
+#include <cstring>
+
+using namespace de;
+using namespace ::internal;
+
+void ClipRanges::safeAddRange(binangle_t from, binangle_t to)
+{
+    // The range may wrap around.
+    if(from > to)
+    {
+        // The range has to added in two parts.
+        addRange(from, BANG_MAX);
+        addRange(0, to);
+    }
+    else
+    {
+        // Add the range as usual.
+        addRange(from, to);
+    }
+}
+
+bool ClipRanges::safeCheckRange(binangle_t from, binangle_t to) const
+{
+    if(from > to)
+    {
+        // The range wraps around.
+        return (isRangeVisible(from, BANG_MAX) || isRangeVisible(0, to));
+    }
+    return isRangeVisible(from, to);
+}
+
+//---------------------------------------------------------------------------------------
+
+DENG2_PIMPL_NOREF(ClipRangeList)
+{
+    /// Specialized AngleRange for half-space clipping.
+    struct Clipper : public ElementPool::Element
+    {
+        binangle_t from;
+        binangle_t to;
+        Clipper *prev;
+        Clipper *next;
+    };
+    ElementPool clipNodes;         ///< The list of clipnodes.
+    Clipper *clipHead = nullptr;   ///< Head of the clipped-range list.
+
+    ~Impl()
+    {
+        while(clipHead)
+        {
+            auto *next = clipHead->next;
+            delete clipHead;
+            clipHead = next;
+        }
+    }
+
+    void removeRange(Clipper *crange)
+    {
+        // If this is the head, move it.
+        if(clipHead == crange)
+            clipHead = crange->next;
+
+        if(crange->prev)
+            crange->prev->next = crange->next;
+        if(crange->next)
+            crange->next->prev = crange->prev;
+
+        // We're done with this range - mark it as free for reuse.
+        clipNodes.release(crange);
+    }
+
+    Clipper *newClipNode(binangle_t from, binangle_t to)
+    {
+        // Perhaps a previously-used clip-node can be reused?
+        auto *crange = reinterpret_cast<Clipper *>(clipNodes.get());
+        if(!crange)
+        {
+            // No, allocate another.
+            clipNodes.add(crange = new Clipper);
+        }
+
+        // (Re)Configure.
+        crange->from = from;
+        crange->to   = to;
+        crange->prev = nullptr;
+        crange->next = nullptr;
+
+        return crange;
+    }
+
+    void addRange(binangle_t from, binangle_t to)
+    {
+        // If there is no head, this will be the first range.
+        if(!clipHead)
+        {
+            clipHead = newClipNode(from, to);
+
+            /*
+            LOG_AS("ClipRangeList::addRange");
+            LOG_DEBUG(String("New head added: %1 => %2")
+                        .arg(clipHead->from, 0, 16)
+                        .arg(clipHead->to,   0, 16));
+            */
+            return;
+        }
+
+        // There are previous ranges. Check that the new range isn't contained
+        // by any of them.
+        for(Clipper *i = clipHead; i; i = i->next)
+        {
+            /*
+            LOG_AS("ClipRangeList::addRange");
+            LOG_DEBUG(String("0x%1: %2 => %3")
+                        .arg((quintptr)i, QT_POINTER_SIZE * 2, 16, QChar('0'))
+                        .arg(i->from, 0, 16)
+                        .arg(i->to,   0, 16));
+            */
+
+            if(from >= i->from && to <= i->to)
+            {
+                /*
+                LOG_AS("ClipRangeList::addRange");
+                LOG_DEBUG("Range already exists");
+                */
+                return;  // The new range already exists.
+            }
+
+#ifdef DENG2_DEBUG
+            if(i == i->next)
+                throw Error("ClipRangeList::addRange", String("loop1 0x%1 linked to itself: %2 => %3")
+                                                        .arg((quintptr)i, QT_POINTER_SIZE * 2, 16, QChar('0'))
+                                                        .arg(i->from, 0, 16)
+                                                        .arg(i->to,   0, 16));
+#endif
+        }
+
+        // Now check if any of the old ranges are contained by the new one.
+        for(Clipper *i = clipHead; i;)
+        {
+            if(i->from >= from && i->to <= to)
+            {
+                Clipper *contained = i;
+
+                /*
+                LOG_AS("ClipRangeList::addRange");
+                LOG_DEBUG(String("Removing contained range %1 => %2")
+                            .arg(contained->from, 0, 16)
+                            .arg(contained->to,   0, 16));
+                */
+
+                i = i->next;
+                removeRange(contained);
+                continue;
+            }
+
+            i = i->next;
+        }
+
+        // Now it is possible that the new range overlaps one or two old ranges.
+        // If two are overlapped, they are consecutive. First we'll try to find
+        // a range that overlaps the beginning.
+        Clipper *crange = nullptr;
+        for(Clipper *i = clipHead; i; i = i->next)
+        {
+            // In preparation for the next stage, find a good spot for the range.
+            if(i->from < to)
+            {
+                // After this one.
+                crange = i;
+            }
+
+            if(i->from >= from && i->from <= to)
+            {
+                // New range's end and i's beginning overlap. i's end is outside.
+                // Otherwise it would have been already removed.
+                // It suffices to adjust i.
+
+                /*
+                LOG_AS("ClipRangeList::addRange");
+                LOG_DEBUG(String("Overlapping start: %1 => %2 - adjusting to %3 => %4")
+                            .arg(i->from, 0, 16)
+                            .arg(i->to,   0, 16)
+                            .arg(from,    0, 16)
+                            .arg(i->to,   0, 16));
+                */
+
+                i->from = from;
+                return;
+            }
+
+            // Check an overlapping end.
+            if(i->to >= from && i->to <= to)
+            {
+                // Now it's possible that the i->next's beginning overlaps the
+                // new range's end. In that case there will be a merger.
+
+                /*
+                LOG_AS("ClipRangeList::addRange");
+                LOG_DEBUG(String("Overlapping end: %1 => %2")
+                            .arg(i->from, 0, 16)
+                            .arg(i->to,   0, 16));
+                */
+
+                crange = i->next;
+                if(!crange)
+                {
+                    i->to = to;
+
+                    /*
+                    LOG_AS("ClipRangeList::addRange");
+                    LOG_DEBUG(String("No next, adjusting end (now %1 => %2)")
+                                .arg(i->from, 0, 16)
+                                .arg(i->to,   0, 16));
+                    */
+                }
+                else
+                {
+                    if(crange->from <= to)
+                    {
+                        // A fusion will commence. Ci will eat the new range
+                        // *and* crange.
+                        i->to = crange->to;
+
+                        /*
+                        LOG_AS("ClipRangeList::addRange");
+                        LOG_DEBUG(String("merging with the next (%1 => %2)")
+                                    .arg(crange->from, 0, 16)
+                                    .arg(crange->to,   0, 16));
+                        */
+
+                        removeRange(crange);
+                    }
+                    else
+                    {
+                        // Not overlapping.
+                        i->to = to;
+
+                        /*
+                        LOG_AS("ClipRangeList::addRange");
+                        LOG_DEBUG(String("Not merger w/next (now %1 => %2)")
+                                    .arg(i->from, 0, 16)
+                                    .arg(i->to,   0, 16));
+                        */
+                    }
+                }
+
+                return;
+            }
+        }
+
+        // Still here? Now we know for sure that the range is disconnected from
+        // the others. We still need to find a good place for it. Crange will
+        // mark the spot.
+
+        if(!crange)
+        {
+            // We have a new head.
+            crange = clipHead;
+            clipHead = newClipNode(from, to);
+            clipHead->next = crange;
+            if(crange)
+                crange->prev = clipHead;
+        }
+        else
+        {
+            // Add the new range after crange.
+            Clipper *added = newClipNode(from, to);
+            added->next = crange->next;
+            if(added->next)
+                added->next->prev = added;
+            added->prev = crange;
+            crange->next = added;
+        }
+    }
+};
+
+ClipRangeList::ClipRangeList() : d(new Impl)
+{}
+
+void ClipRangeList::clear()
+{
+    d->clipHead = nullptr;
+    d->clipNodes.rewind();  // Start reusing ranges.
+}
+
+void ClipRangeList::addRange(binangle_t from, binangle_t to)
+{
+    d->addRange(from, to);
+}
+
+bool ClipRangeList::isRangeVisible(binangle_t from, binangle_t to) const
+{
+    for(Impl::Clipper const *i = d->clipHead; i; i = i->next)
+    {
+        if(from >= i->from && to <= i->to)
+            return false;
+    }
+    // No clip-node fully contained the specified range.
+    return true;
+}
+
+bool ClipRangeList::isAngleVisible(binangle_t angle) const
+{
+    for(Impl::Clipper const *crange = d->clipHead; crange; crange = crange->next)
+    {
+        if(angle > crange->from && angle < crange->to)
+            return false;
+    }
+    return true;  // Not occluded.
+}
+
+bool ClipRangeList::isFull() const
+{
+    return d->clipHead && d->clipHead->from == 0 && d->clipHead->to == BANG_MAX;
+}
+
+#ifdef DENG2_DEBUG
+void ClipRangeList::validate() const
+{
+    for(Impl::Clipper const *i = d->clipHead; i; i = i->next)
+    {
+        if(i == d->clipHead)
+        {
+            if(i->prev)
+                throw Error("ClipRangeList::validate", "Cliphead->prev != NULL");
+        }
+
+        // Confirm that the links to prev and next are OK.
+        if(i->prev)
+        {
+            if(i->prev->next != i)
+                throw Error("ClipRangeList::validate", "Prev->next != this");
+        }
+        else if(i != d->clipHead)
+        {
+            throw Error("ClipRangeList::validate", "prev == NULL, this isn't clipHead");
+        }
+
+        if(i->next)
+        {
+            if(i->next->prev != i)
+                throw Error("ClipRangeList::validate", "Next->prev != this");
+        }
+    }
+}
+#endif
+
+//---------------------------------------------------------------------------------------
+
+/*
+ * Bit k of the lower level covers the gap between angles k and k + 1. A range
+ * [from, to] covers the gaps from...to-1, so ranges that touch (or overlap) end up
+ * as one continuous run of bits, as they are merged into one node in the list. A
+ * range is contained by a clipped range if all of its gaps are covered.
+ *
+ * Zero-length ranges do not cover any gaps, so they are marked separately.
+ */
+DENG2_PIMPL_NOREF(ClipRangeBitmap)
+{
+    static dint const GAP_WORDS  = (BANG_MAX + 1) / 64;
+    static dint const FULL_WORDS = GAP_WORDS / 64;
+
+    duint64 gaps[GAP_WORDS];      ///< Lower level: covered gaps between angles.
+    duint64 fullGaps[FULL_WORDS]; ///< Upper level: gap words that are full.
+    duint64 points[GAP_WORDS];    ///< Angles of zero-length ranges.
+    bool hasPoints = false;
+
+    Impl()
+    {
+        std::memset(points, 0, sizeof(points));
+        clear();
+    }
+
+    void clear()
+    {
+        std::memset(gaps, 0, sizeof(gaps));
+        std::memset(fullGaps, 0, sizeof(fullGaps));
+        if(hasPoints)
+        {
+            std::memset(points, 0, sizeof(points));
+            hasPoints = false;
+        }
+
+        // The gap between BANG_MAX and 0 is never part of a range (ranges don't wrap
+        // around). Marking it covered means that the circle is full when all the
+        // words are.
+        setGaps(GAP_WORDS - 1, duint64(1) << 63);
+    }
+
+    static inline duint64 maskFrom(dint bit) { return ~duint64(0) << (bit & 63); }
+    static inline duint64 maskTo  (dint bit) { return ~duint64(0) >> (63 - (bit & 63)); }
+
+    inline void setGaps(dint word, duint64 mask)
+    {
+        if((gaps[word] |= mask) == ~duint64(0))
+        {
+            fullGaps[word >> 6] |= duint64(1) << (word & 63);
+        }
+    }
+
+    inline bool isGap(dint gap) const
+    {
+        return (gaps[gap >> 6] >> (gap & 63)) & 1;
+    }
+
+    /**
+     * Determines if all the bits first...last (inclusive) are set.
+     */
+    static bool allSet(duint64 const *words, dint first, dint last)
+    {
+        dint const w0 = first >> 6;
+        dint const w1 = last  >> 6;
+        if(w0 == w1)
+        {
+            duint64 const mask = maskFrom(first) & maskTo(last);
+            return (words[w0] & mask) == mask;
+        }
+        if((words[w0] & maskFrom(first)) != maskFrom(first)) return false;
+        if((words[w1] & maskTo(last))    != maskTo(last))    return false;
+        for(dint w = w0 + 1; w < w1; ++w)
+        {
+            if(words[w] != ~duint64(0)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Determines if the gaps first...last (inclusive) are all covered.
+     */
+    bool areGapsCovered(dint first, dint last) const
+    {
+        dint const w0 = first >> 6;
+        dint const w1 = last  >> 6;
+        if(w0 == w1)
+        {
+            duint64 const mask = maskFrom(first) & maskTo(last);
+            return (gaps[w0] & mask) == mask;
+        }
+        if((gaps[w0] & maskFrom(first)) != maskFrom(first)) return false;
+        if((gaps[w1] & maskTo(last))    != maskTo(last))    return false;
+        // The words in between must be full.
+        return w0 + 1 == w1 || allSet(fullGaps, w0 + 1, w1 - 1);
+    }
+
+    void coverGaps(dint first, dint last)
+    {
+        dint const w0 = first >> 6;
+        dint const w1 = last  >> 6;
+        if(w0 == w1)
+        {
+            setGaps(w0, maskFrom(first) & maskTo(last));
+            return;
+        }
+        setGaps(w0, maskFrom(first));
+        for(dint w = w0 + 1; w < w1; ++w)
+        {
+            setGaps(w, ~duint64(0));
+        }
+        setGaps(w1, maskTo(last));
+    }
+};
+
+ClipRangeBitmap::ClipRangeBitmap() : d(new Impl)
+{}
+
+void ClipRangeBitmap::clear()
+{
+    d->clear();
+}
+
+void ClipRangeBitmap::addRange(binangle_t from, binangle_t to)
+{
+    DENG2_ASSERT(from <= to);
+
+    if(from < to)
+    {
+        d->coverGaps(from, to - 1);
+    }
+    else
+    {
+        d->points[from >> 6] |= duint64(1) << (from & 63);
+        d->hasPoints = true;
+    }
+}
+
+bool ClipRangeBitmap::isRangeVisible(binangle_t from, binangle_t to) const
+{
+    DENG2_ASSERT(from <= to);
+
+    if(from < to)
+    {
+        return !d->areGapsCovered(from, to - 1);
+    }
+
+    // A single angle is contained by the ranges on either side of it.
+    if(from > 0        && d->isGap(from - 1)) return false;
+    if(from < BANG_MAX && d->isGap(from))     return false;
+    return !d->hasPoints || !((d->points[from >> 6] >> (from & 63)) & 1);
+}
+
+bool ClipRangeBitmap::isAngleVisible(binangle_t angle) const
+{
+    // The angle must be inside a range, not at either end of it.
+    if(angle == 0 || angle == BANG_MAX) return true;
+    return !(d->isGap(angle - 1) && d->isGap(angle));
+}
+
+bool ClipRangeBitmap::isFull() const
+{
+    for(duint64 word : d->fullGaps)
+    {
+        if(word != ~duint64(0)) return false;
+    }
+    return true;
+}
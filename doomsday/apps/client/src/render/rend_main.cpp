@@ -242,6 +242,7 @@ static std::unique_ptr<FixedView> fixedView;
 
 dbyte freezeRLs;
 dint devNoCulling;  ///< @c 1= disabled (cvar).
+dbyte angleClipBitmap = true;  ///< @c 1= clipped angles kept in a bitmap (cvar).
 dint devRendSkyMode;
 dbyte devRendSkyAlways;
 
@@ -6476,6 +6477,7 @@ void Rend_Register()
     C_VAR_BYTE("rend-dev-blockmap-debug", &bmapShowDebug, CVF_NO_ARCHIVE, 0, 4);
     C_VAR_FLOAT("rend-dev-blockmap-debug-size", &bmapDebugSize, CVF_NO_ARCHIVE, .1f, 100);
     C_VAR_INT("rend-dev-cull-leafs", &devNoCulling, CVF_NO_ARCHIVE, 0, 1);
+    C_VAR_BYTE("rend-dev-cull-bitmap", &angleClipBitmap, CVF_NO_ARCHIVE, 0, 1);
     C_VAR_BYTE("rend-dev-freeze", &freezeRLs, CVF_NO_ARCHIVE, 0, 1);
     C_VAR_BYTE("rend-dev-generator-show-indices", &devDrawGenerators, CVF_NO_ARCHIVE, 0, 1);
     C_VAR_BYTE("rend-dev-light-mod", &devLightModRange, CVF_NO_ARCHIVE, 0, 1);
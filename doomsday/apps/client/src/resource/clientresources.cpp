@@ -69,6 +69,8 @@
 #include "dd_def.h"
 
 #include "clientapp.h"
+#include "audio/audiosystem.h"
+#include "audio/s_cache.h"
 #include "ui/progress.h"
 #include "ui/clientwindowsystem.h"
 #include "sys_system.h"  // novideo
@@ -2037,6 +2039,27 @@ void ClientResources::cacheForCurrentMap()
             return LoopContinue;
         });
     }
+
+    // Precache the sounds of the map objects. The samples are converted to the
+    // playback format in parallel.
+    {
+        QSet<dint> soundIds;
+        map.thinkers().forAll(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
+                              0x1/*public*/, [&soundIds] (thinker_t *th)
+        {
+            auto const &mob = *reinterpret_cast<mobj_t *>(th);
+            if (mob.type >= 0 && mob.type < runtimeDefs.mobjInfo.size())
+            {
+                mobjinfo_t const &info = runtimeDefs.mobjInfo[mob.type];
+                soundIds << info.seeSound << info.attackSound << info.painSound
+                         << info.deathSound << info.activeSound;
+            }
+            return LoopContinue;
+        });
+        soundIds.remove(0);
+
+        App_AudioSystem().sfxSampleCache().precache(soundIds);
+    }
 }
 
 /**
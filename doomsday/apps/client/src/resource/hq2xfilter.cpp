@@ -0,0 +1,2043 @@
+/** @file hq2xfilter.cpp  The hq2x filter algorithm.
+ *
+ * @authors Copyright © 2003 Maxim Stepin <maxst@hiend3d.com>
+ * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ * @authors Copyright © 2009-2015 Daniel Swanson <danij@dengine.net>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "resource/hq2xfilter.h"
+
+#include <cstdlib>
+#include <de/TaskPool>
+#include <de/math.h>
+
+/*
+ * RGB color space.
+ */
+#define BGR888_PACK(b, g, r) ( ((uint32_t)(b) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(r) )
+#define BGR888_COMP(n, c)   ( ((c) >> ((n) << 3)) & 0xFF )
+#define BGR888_Bmask        ((int)0xFF0000)
+#define BGR888_Gmask        ((int)0x00FF00)
+#define BGR888_Rmask        ((int)0x0000FF)
+
+#define BGR888toBGR565(c)   (((c & 0xF8) >> 3) | ((c & 0xFC00) >> 5) | ((c & 0xF80000) >> 8))
+
+#define ABGR8888_PACK(a, b, g, r) ( ((uint32_t)(a) << 24) | BGR888_PACK((b), (g), (r)) )
+#define ABGR8888_COMP       BGR888_COMP
+#define ABGR8888_Amask      ((int)0xFF000000)
+#define ABGR8888_Bmask      BGR888_Bmask
+#define ABGR8888_Gmask      BGR888_Gmask
+#define ABGR8888_Rmask      BGR888_Rmask
+#define ABGR8888_RGBmask    ((int)0x00FFFFFF)
+
+// YUV conversion.
+#define BGR888toYUV888(v)   (lutBGR888toYUV888[BGR888toBGR565(v)])
+#define ABGR8888toYUV888(v) (BGR888toYUV888(v & ABGR8888_RGBmask))
+#define ABGR8888toAYUV8888(v) (ABGR8888toYUV888(v) | (((v) & ABGR8888_Amask) << 24))
+
+#define RGB888_PACK(r, g, b) ( ((uint32_t)(r) << 16) | ((uint32_t)(g) << 8) | (uint32_t)(b) )
+#define RGB888_COMP(n, c)   ( ((c) >> ((n) << 3)) & 0xFF )
+#define RGB888_Rmask        ((int)0xFF0000)
+#define RGB888_Gmask        ((int)0x00FF00)
+#define RGB888_Bmask        ((int)0x0000FF)
+
+#define RGB888toRGB565(c)   (((c & 0xF80000) >> 8) | ((c & 0xFC00) >> 5) | ((c & 0xF8) >> 3))
+
+#define ARGB8888_PACK(a, r, g, b) ( ((uint32_t)(a) << 24) | RGB888_PACK((r), (g), (b)) )
+#define ARGB8888_COMP       RGB888_COMP
+#define ARGB8888_Amask      ((int)0xFF000000)
+#define ARGB8888_Rmask      RGB888_Rmask
+#define ARGB8888_Gmask      RGB888_Gmask
+#define ARGB8888_Bmask      RGB888_Bmask
+#define ARGB8888_RGBmask    ((int)0x00FFFFFF)
+
+/*
+// YUV conversion.
+#define RGB888toYUV888(v)   (BGR888toYUV888(RGB888toBGR888(v)))
+#define ARGB8888toYUV888(v) (RGB888toYUV888((v) & ARGB8888_RGBmask])
+#define ARGB8888toAYUV8888(v) (ARGB8888toYUV888(v) | (((v) & ARGB8888_Amask) << 24))
+*/
+
+#define BGR565_PACK(b, g, r) ( ((uint16_t)(b) << 11) | ((uint16_t)(g) << 5) | (uint16_t)(r) )
+#define BGR565_Bmask        ((int)0xF800)
+#define BGR565_Gmask        ((int)0x7E0)
+#define BGR565_Rmask        ((int)0x1F)
+
+/*
+ * YUV color space.
+ */
+#define YUV888_PACK(y, u, v) ( ((uint32_t)(y) << 16) | ((uint32_t)(u) << 8) | (uint32_t)(v) )
+#define YUV888_COMP(n, c)   ( ((c) >> ((n) << 3)) & 0xFF )
+#define YUV888_Ymask        ((int)0xFF0000)
+#define YUV888_Umask        ((int)0x00FF00)
+#define YUV888_Vmask        ((int)0x0000FF)
+
+#define AYUV8888_PACK(y, u, v, a) ( ((uint32_t)(a) << 24) | YUV888_PACK((y), (u), (v)) )
+#define AYUV8888_COMP       YUV888_COMP
+#define AYUV8888_Amask      ((int)0xFF000000)
+#define AYUV8888_Ymask      YUV888_Ymask
+#define AYUV8888_Umask      YUV888_Umask
+#define AYUV8888_Vmask      YUV888_Vmask
+#define AYUV8888_YUVmask    ((int)0x00FFFFFF)
+
+#define trY                 (48)
+#define trU                 (7)
+#define trV                 (6)
+
+#define PIXEL00_0         Transl(pOut,       w[5]);
+#define PIXEL00_10       Interp1(pOut,       w[5], w[1]);
+#define PIXEL00_11       Interp1(pOut,       w[5], w[4]);
+#define PIXEL00_12       Interp1(pOut,       w[5], w[2]);
+#define PIXEL00_20       Interp2(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_21       Interp2(pOut,       w[5], w[1], w[2]);
+#define PIXEL00_22       Interp2(pOut,       w[5], w[1], w[4]);
+#define PIXEL00_60       Interp6(pOut,       w[5], w[2], w[4]);
+#define PIXEL00_61       Interp6(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_70       Interp7(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_90       Interp9(pOut,       w[5], w[4], w[2]);
+#define PIXEL00_100     Interp10(pOut,       w[5], w[4], w[2]);
+#define PIXEL01_0         Transl(pOut+4,     w[5]);
+#define PIXEL01_10       Interp1(pOut+4,     w[5], w[3]);
+#define PIXEL01_11       Interp1(pOut+4,     w[5], w[2]);
+#define PIXEL01_12       Interp1(pOut+4,     w[5], w[6]);
+#define PIXEL01_20       Interp2(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_21       Interp2(pOut+4,     w[5], w[3], w[6]);
+#define PIXEL01_22       Interp2(pOut+4,     w[5], w[3], w[2]);
+#define PIXEL01_60       Interp6(pOut+4,     w[5], w[6], w[2]);
+#define PIXEL01_61       Interp6(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_70       Interp7(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_90       Interp9(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL01_100     Interp10(pOut+4,     w[5], w[2], w[6]);
+#define PIXEL10_0         Transl(pOut+BpL,   w[5]);
+#define PIXEL10_10       Interp1(pOut+BpL,   w[5], w[7]);
+#define PIXEL10_11       Interp1(pOut+BpL,   w[5], w[8]);
+#define PIXEL10_12       Interp1(pOut+BpL,   w[5], w[4]);
+#define PIXEL10_20       Interp2(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_21       Interp2(pOut+BpL,   w[5], w[7], w[4]);
+#define PIXEL10_22       Interp2(pOut+BpL,   w[5], w[7], w[8]);
+#define PIXEL10_60       Interp6(pOut+BpL,   w[5], w[4], w[8]);
+#define PIXEL10_61       Interp6(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_70       Interp7(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_90       Interp9(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL10_100     Interp10(pOut+BpL,   w[5], w[8], w[4]);
+#define PIXEL11_0         Transl(pOut+BpL+4, w[5]);
+#define PIXEL11_10       Interp1(pOut+BpL+4, w[5], w[9]);
+#define PIXEL11_11       Interp1(pOut+BpL+4, w[5], w[6]);
+#define PIXEL11_12       Interp1(pOut+BpL+4, w[5], w[8]);
+#define PIXEL11_20       Interp2(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_21       Interp2(pOut+BpL+4, w[5], w[9], w[8]);
+#define PIXEL11_22       Interp2(pOut+BpL+4, w[5], w[9], w[6]);
+#define PIXEL11_60       Interp6(pOut+BpL+4, w[5], w[8], w[6]);
+#define PIXEL11_61       Interp6(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_70       Interp7(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_90       Interp9(pOut+BpL+4, w[5], w[6], w[8]);
+#define PIXEL11_100     Interp10(pOut+BpL+4, w[5], w[6], w[8]);
+
+#define YUV888_Opaque       ((int)0x1000000)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define DENG_HQ2X_SSE2
+#  include <emmintrin.h>
+#endif
+
+/// Number of source rows filtered in one task.
+#define BAND_HEIGHT         16
+
+/// Smaller images are filtered on the calling thread.
+#define MIN_PARALLEL_PIXELS (64 * 64)
+
+static uint32_t lutBGR888toYUV888[32*64*32];
+
+/**
+ * Reads an R8G8B8A8 pixel as an ABGR8888 color, regardless of the byte order.
+ */
+static __inline uint32_t LoadPixel(uint8_t const* pix)
+{
+    return (uint32_t)pix[0] | ((uint32_t)pix[1] << 8) | ((uint32_t)pix[2] << 16) |
+           ((uint32_t)pix[3] << 24);
+}
+
+/**
+ * Converts an ABGR8888 color to the YUV888 form used in comparisons. Whether
+ * the color is transparent is marked with YUV888_Opaque.
+ */
+static __inline uint32_t ToComparable(uint32_t c)
+{
+    return ABGR8888toYUV888(c) | (ABGR8888_COMP(3, c) != 0? YUV888_Opaque : 0);
+}
+
+/**
+ * Spreads the components of an ABGR8888 color into the 16-bit lanes of a
+ * 64-bit integer, so that they can be interpolated all at once.
+ */
+static __inline uint64_t Spread(uint32_t c)
+{
+    uint64_t v = c;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v <<  8)) & 0x00FF00FF00FF00FFull;
+    return v;
+}
+
+static __inline uint32_t Gather(uint64_t v)
+{
+    v &= 0x00FF00FF00FF00FFull;
+    v = (v | (v >>  8)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v >> 16)) & 0x00000000FFFFFFFFull;
+    return (uint32_t) v;
+}
+
+/**
+ * Weighted average of three colors. The weights must add up to a power of
+ * two, whose base-2 logarithm is @a shift.
+ */
+static __inline void LerpColor(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t f1,
+    uint32_t f2, uint32_t f3, int shift)
+{
+    // Each lane holds at most 16 * 255, so the lanes don't overflow.
+    uint64_t const sum = f1 * Spread(c1) + f2 * Spread(c2) + f3 * Spread(c3);
+    uint32_t const c = Gather(sum >> shift);
+    pc[0] = ABGR8888_COMP(0, c);
+    pc[1] = ABGR8888_COMP(1, c);
+    pc[2] = ABGR8888_COMP(2, c);
+    pc[3] = ABGR8888_COMP(3, c);
+}
+
+/**
+ * Compares two colors converted with ToComparable().
+ */
+static __inline int Diff(uint32_t yuv1, uint32_t yuv2)
+{
+    return ( ((yuv1 ^ yuv2) & YUV888_Opaque) ||
+             (abs(int(yuv1 & YUV888_Ymask) - int(yuv2 & YUV888_Ymask)) > ((trY & (int)0xFF) << 16)) ||
+             (abs(int(yuv1 & YUV888_Umask) - int(yuv2 & YUV888_Umask)) > ((trU & (int)0xFF) << 8)) ||
+             (abs(int(yuv1 & YUV888_Vmask) - int(yuv2 & YUV888_Vmask)) > ((trV & (int)0xFF)) ));
+}
+
+#ifdef DENG_HQ2X_SSE2
+/**
+ * Returns a 4-bit mask of the neighbors in @a yuv that differ from @a center
+ * (cf. Diff()).
+ */
+static __inline int DiffMask(__m128i center, __m128i yuv)
+{
+    // The components are compared bytewise; the opaque flag has no tolerance.
+    __m128i const limits = _mm_set1_epi32((trY << 16) | (trU << 8) | trV);
+    __m128i const dist   = _mm_or_si128(_mm_subs_epu8(yuv, center), _mm_subs_epu8(center, yuv));
+    __m128i const same   = _mm_cmpeq_epi32(_mm_subs_epu8(dist, limits), _mm_setzero_si128());
+    return ~_mm_movemask_ps(_mm_castsi128_ps(same)) & 0xf;
+}
+#endif
+
+/**
+ * Determines which of the neighbors of the center pixel (5) differ from it.
+ * The bits of the pattern are the neighbors 1-4 and 6-9, in order.
+ */
+static __inline int Pattern(uint32_t const* yuv)
+{
+#ifdef DENG_HQ2X_SSE2
+    __m128i const center = _mm_set1_epi32(int(yuv[5]));
+    return DiffMask(center, _mm_loadu_si128((__m128i const*) &yuv[1])) |
+          (DiffMask(center, _mm_loadu_si128((__m128i const*) &yuv[6])) << 4);
+#else
+    int pattern = 0, flag = 1;
+    for(int k = 1; k <= 9; ++k)
+    {
+        if(k == 5)
+            continue;
+
+        if(yuv[k] != yuv[5] && Diff(yuv[5], yuv[k]))
+            pattern |= flag;
+        flag <<= 1;
+    }
+    return pattern;
+#endif
+}
+
+static __inline void Transl(uint8_t* pc, uint32_t c)
+{
+    pc[0] = ABGR8888_COMP(0, c);
+    pc[1] = ABGR8888_COMP(1, c);
+    pc[2] = ABGR8888_COMP(2, c);
+    pc[3] = ABGR8888_COMP(3, c);
+}
+
+static __inline void Interp1(uint8_t* pc, uint32_t c1, uint32_t c2)
+{
+    if(c1 == c2)
+    {
+        Transl(pc, c1);
+        return;
+    }
+    LerpColor(pc, c1, c2, 0, 3, 1, 0, 2);
+}
+
+static __inline void Interp2(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
+{
+    LerpColor(pc, c1, c2, c3, 2, 1, 1, 2);
+}
+
+static __inline void Interp6(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
+{
+    LerpColor(pc, c1, c2, c3, 5, 2, 1, 3);
+}
+
+static __inline void Interp7(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
+{
+    LerpColor(pc, c1, c2, c3, 6, 1, 1, 3);
+}
+
+static __inline void Interp9(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
+{
+    LerpColor(pc, c1, c2, c3, 2, 3, 3, 3);
+}
+
+static __inline void Interp10(uint8_t* pc, uint32_t c1, uint32_t c2, uint32_t c3)
+{
+    LerpColor(pc, c1, c2, c3, 14, 1, 1, 4);
+}
+
+void HQ2x_InitLookupTable(void)
+{
+    // Initalize RGB to YUV lookup table.
+    uint32_t r, g, b, y, u, v;
+    int i, j, k;
+    for(i = 0; i < 32; ++i)
+        for(j = 0; j < 64; ++j)
+            for(k = 0; k < 32; ++k)
+            {
+                r = i << 3;
+                g = j << 2;
+                b = k << 3;
+                y = (uint32_t)( 0.299*r + 0.587*g + 0.114*b);
+                u = (uint32_t)(-0.169*r - 0.331*g + 0.5  *b) + 128;
+                v = (uint32_t)( 0.5  *r - 0.419*g - 0.081*b) + 128;
+                lutBGR888toYUV888[BGR565_PACK(k, j, i)] = YUV888_PACK(y, u, v);
+            }
+}
+
+#define BPP             (4) // Bytes Per Pixel.
+
+/**
+ * Converts rows @a yBegin...@a yEnd-1 of the source image with ToComparable().
+ */
+static void PrepareRows(uint32_t* yuv, const uint8_t* src, int width, int yBegin, int yEnd)
+{
+    int i;
+    for(i = yBegin * width; i < yEnd * width; ++i)
+    {
+        yuv[i] = ToComparable(LoadPixel(src + BPP*i));
+    }
+}
+
+/**
+ * Filters rows @a yBegin...@a yEnd-1 of the source image into the corresponding
+ * rows of @a dst. @a yuvSrc has the comparable colors of the entire source image.
+ */
+static void FilterRows(uint8_t* dst, const uint8_t* src, const uint32_t* yuvSrc, int width,
+    int height, int yBegin, int yEnd, bool wrapH, bool wrapV)
+{
+    int pattern, BpL, xA, xB, yA, yB;
+    uint8_t* pOut;
+    uint32_t w[10], yuv[10];
+
+    // +----+----+----+
+    // | w1 | w2 | w3 |
+    // +----+----+----+
+    // | w4 | w5 | w6 |
+    // +----+----+----+
+    // | w7 | w8 | w9 |
+    // +----+----+----+
+
+    BpL = BPP * 2 * width; // (Out) Bytes per Line.
+    pOut = dst + yBegin * 2 * BpL;
+    { int y;
+    for(y = yBegin; y < yEnd; ++y)
+    {
+        yA =        y == 0? ( wrapV? height-1 : 0) : y-1;
+        yB = y == height-1? (!wrapV? height-1 : 0) : y+1;
+
+        { int x;
+        for(x = 0; x < width; ++x)
+        {
+            // At the edges, the neighbors either wrap around or are clamped.
+            xA =        x == 0? ( wrapH?  width-1 : 0) : x-1;
+            xB =  x == width-1? (!wrapH?  width-1 : 0) : x+1;
+
+            { int const neighbors[10] = { 0,
+                yA * width + xA, yA * width + x, yA * width + xB,
+                y  * width + xA, y  * width + x, y  * width + xB,
+                yB * width + xA, yB * width + x, yB * width + xB };
+            int k;
+            for(k = 1; k <= 9; ++k)
+            {
+                w[k]   = LoadPixel(src + BPP * neighbors[k]);
+                yuv[k] = yuvSrc[neighbors[k]];
+            }}
+
+            pattern = Pattern(yuv);
+
+            switch(pattern)
+            {
+            case 0:
+            case 1:
+            case 4:
+            case 32:
+            case 128:
+            case 5:
+            case 132:
+            case 160:
+            case 33:
+            case 129:
+            case 36:
+            case 133:
+            case 164:
+            case 161:
+            case 37:
+            case 165: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 2:
+            case 34:
+            case 130:
+            case 162: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 16:
+            case 17:
+            case 48:
+            case 49: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_20 PIXEL11_21 break;
+              }
+            case 64:
+            case 65:
+            case 68:
+            case 69: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 8:
+            case 12:
+            case 136:
+            case 140: {
+                    PIXEL00_21 PIXEL01_20 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 3:
+            case 35:
+            case 131:
+            case 163: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 6:
+            case 38:
+            case 134:
+            case 166: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 20:
+            case 21:
+            case 52:
+            case 53: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_21 break;
+              }
+            case 144:
+            case 145:
+            case 176:
+            case 177: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_20 PIXEL11_12 break;
+              }
+            case 192:
+            case 193:
+            case 196:
+            case 197: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 96:
+            case 97:
+            case 100:
+            case 101: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 40:
+            case 44:
+            case 168:
+            case 172: {
+                    PIXEL00_21 PIXEL01_20 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 9:
+            case 13:
+            case 137:
+            case 141: {
+                    PIXEL00_12 PIXEL01_20 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 18:
+            case 50: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 80:
+            case 81: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 72:
+            case 76: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 10:
+            case 138: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 66: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 24: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 7:
+            case 39:
+            case 135: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 148:
+            case 149:
+            case 180: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_12 break;
+              }
+            case 224:
+            case 228:
+            case 225: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 41:
+            case 169:
+            case 45: {
+                    PIXEL00_12 PIXEL01_20 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 22:
+            case 54: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 208:
+            case 209: {
+                    PIXEL00_20 PIXEL01_22 PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 104:
+            case 108: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 11:
+            case 139: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_22 PIXEL11_20 break;
+              }
+            case 19:
+            case 51: {
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL00_11 PIXEL01_10}
+                    else {
+                    PIXEL00_60 PIXEL01_90}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 146:
+            case 178: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10 PIXEL11_12}
+                    else {
+                    PIXEL01_90 PIXEL11_61}
+                    PIXEL10_20 break;
+              }
+            case 84:
+            case 85: {
+                    PIXEL00_20 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL01_11 PIXEL11_10}
+                    else {
+                    PIXEL01_60 PIXEL11_90}
+                    PIXEL10_21 break;
+              }
+            case 112:
+            case 113: {
+                    PIXEL00_20 PIXEL01_22 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL10_12 PIXEL11_10}
+                    else {
+                    PIXEL10_61 PIXEL11_90}
+                    break;
+              }
+            case 200:
+            case 204: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10 PIXEL11_11}
+                    else {
+                    PIXEL10_90 PIXEL11_60}
+                    break;
+              }
+            case 73:
+            case 77: {
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL00_12 PIXEL10_10}
+                    else {
+                    PIXEL00_61 PIXEL10_90}
+                    PIXEL01_20 PIXEL11_22 break;
+              }
+            case 42:
+            case 170: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10 PIXEL10_11}
+                    else {
+                    PIXEL00_90 PIXEL10_60}
+                    PIXEL01_21 PIXEL11_20 break;
+              }
+            case 14:
+            case 142: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10 PIXEL01_12}
+                    else {
+                    PIXEL00_90 PIXEL01_61}
+                    PIXEL10_22 PIXEL11_20 break;
+              }
+            case 67: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 70: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 28: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 152: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 194: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 98: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 56: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 25: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 26:
+            case 31: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_22 PIXEL11_21 break;
+              }
+            case 82:
+            case 214: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 88:
+            case 248: {
+                    PIXEL00_21 PIXEL01_22 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 74:
+            case 107: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 27: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 86: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_21 PIXEL11_10 break;
+              }
+            case 216: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_10 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 106: {
+                    PIXEL00_10 PIXEL01_21 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 30: {
+                    PIXEL00_10 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_22 PIXEL11_21 break;
+              }
+            case 210: {
+                    PIXEL00_22 PIXEL01_10 PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 120: {
+                    PIXEL00_21 PIXEL01_22 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 75: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_10 PIXEL11_22 break;
+              }
+            case 29: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_22 PIXEL11_21 break;
+              }
+            case 198: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 184: {
+                    PIXEL00_21 PIXEL01_22 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 99: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 57: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 71: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_21 PIXEL11_22 break;
+              }
+            case 156: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 226: {
+                    PIXEL00_22 PIXEL01_21 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 60: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 195: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 102: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 153: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 58: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 83: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 92: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 202: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_21 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_11 break;
+              }
+            case 78: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_22 break;
+              }
+            case 154: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_22 PIXEL11_12 break;
+              }
+            case 114: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 89: {
+                    PIXEL00_12 PIXEL01_22 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 90: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 55:
+            case 23: {
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL00_11 PIXEL01_0}
+                    else {
+                    PIXEL00_60 PIXEL01_90}
+                    PIXEL10_20 PIXEL11_21 break;
+              }
+            case 182:
+            case 150: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0 PIXEL11_12}
+                    else {
+                    PIXEL01_90 PIXEL11_61}
+                    PIXEL10_20 break;
+              }
+            case 213:
+            case 212: {
+                    PIXEL00_20 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL01_11 PIXEL11_0}
+                    else {
+                    PIXEL01_60 PIXEL11_90}
+                    PIXEL10_21 break;
+              }
+            case 241:
+            case 240: {
+                    PIXEL00_20 PIXEL01_22 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL10_12 PIXEL11_0}
+                    else {
+                    PIXEL10_61 PIXEL11_90}
+                    break;
+              }
+            case 236:
+            case 232: {
+                    PIXEL00_21 PIXEL01_20 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0 PIXEL11_11}
+                    else {
+                    PIXEL10_90 PIXEL11_60}
+                    break;
+              }
+            case 109:
+            case 105: {
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL00_12 PIXEL10_0}
+                    else {
+                    PIXEL00_61 PIXEL10_90}
+                    PIXEL01_20 PIXEL11_22 break;
+              }
+            case 171:
+            case 43: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0 PIXEL10_11}
+                    else {
+                    PIXEL00_90 PIXEL10_60}
+                    PIXEL01_21 PIXEL11_20 break;
+              }
+            case 143:
+            case 15: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0 PIXEL01_12}
+                    else {
+                    PIXEL00_90 PIXEL01_61}
+                    PIXEL10_22 PIXEL11_20 break;
+              }
+            case 124: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 203: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 PIXEL10_10 PIXEL11_11 break;
+              }
+            case 62: {
+                    PIXEL00_10 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 211: {
+                    PIXEL00_11 PIXEL01_10 PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 118: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_12 PIXEL11_10 break;
+              }
+            case 217: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_10 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 110: {
+                    PIXEL00_10 PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 155: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 188: {
+                    PIXEL00_21 PIXEL01_11 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 185: {
+                    PIXEL00_12 PIXEL01_22 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 61: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_11 PIXEL11_21 break;
+              }
+            case 157: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_22 PIXEL11_12 break;
+              }
+            case 103: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_12 PIXEL11_22 break;
+              }
+            case 227: {
+                    PIXEL00_11 PIXEL01_21 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 230: {
+                    PIXEL00_22 PIXEL01_12 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 199: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_21 PIXEL11_11 break;
+              }
+            case 220: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 158: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_22 PIXEL11_12 break;
+              }
+            case 234: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_21 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_11 break;
+              }
+            case 242: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 59: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 121: {
+                    PIXEL00_12 PIXEL01_22 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 87: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 79: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_22 break;
+              }
+            case 122: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 94: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 218: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 91: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 229: {
+                    PIXEL00_20 PIXEL01_20 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 167: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_20 PIXEL11_20 break;
+              }
+            case 173: {
+                    PIXEL00_12 PIXEL01_20 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 181: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_20 PIXEL11_12 break;
+              }
+            case 186: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_11 PIXEL11_12 break;
+              }
+            case 115: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 93: {
+                    PIXEL00_12 PIXEL01_11 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 206: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_11 break;
+              }
+            case 205:
+            case 201: {
+                    PIXEL00_12 PIXEL01_20 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_10}
+                    else
+                    {
+                    PIXEL10_70}
+                    PIXEL11_11 break;
+              }
+            case 174:
+            case 46: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_10}
+                    else
+                    {
+                    PIXEL00_70}
+                    PIXEL01_12 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 179:
+            case 147: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_10}
+                    else
+                    {
+                    PIXEL01_70}
+                    PIXEL10_20 PIXEL11_12 break;
+              }
+            case 117:
+            case 116: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_10}
+                    else
+                    {
+                    PIXEL11_70}
+                    break;
+              }
+            case 189: {
+                    PIXEL00_12 PIXEL01_11 PIXEL10_11 PIXEL11_12 break;
+              }
+            case 231: {
+                    PIXEL00_11 PIXEL01_12 PIXEL10_12 PIXEL11_11 break;
+              }
+            case 126: {
+                    PIXEL00_10 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 219: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 PIXEL10_10 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 125: {
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL00_12 PIXEL10_0}
+                    else {
+                    PIXEL00_61 PIXEL10_90}
+                    PIXEL01_11 PIXEL11_10 break;
+              }
+            case 221: {
+                    PIXEL00_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL01_11 PIXEL11_0}
+                    else {
+                    PIXEL01_60 PIXEL11_90}
+                    PIXEL10_10 break;
+              }
+            case 207: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0 PIXEL01_12}
+                    else {
+                    PIXEL00_90 PIXEL01_61}
+                    PIXEL10_10 PIXEL11_11 break;
+              }
+            case 238: {
+                    PIXEL00_10 PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0 PIXEL11_11}
+                    else {
+                    PIXEL10_90 PIXEL11_60}
+                    break;
+              }
+            case 190: {
+                    PIXEL00_10 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0 PIXEL11_12}
+                    else {
+                    PIXEL01_90 PIXEL11_61}
+                    PIXEL10_11 break;
+              }
+            case 187: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0 PIXEL10_11}
+                    else {
+                    PIXEL00_90 PIXEL10_60}
+                    PIXEL01_10 PIXEL11_12 break;
+              }
+            case 243: {
+                    PIXEL00_11 PIXEL01_10 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL10_12 PIXEL11_0}
+                    else {
+                    PIXEL10_61 PIXEL11_90}
+                    break;
+              }
+            case 119: {
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL00_11 PIXEL01_0}
+                    else {
+                    PIXEL00_60 PIXEL01_90}
+                    PIXEL10_12 PIXEL11_10 break;
+              }
+            case 237:
+            case 233: {
+                    PIXEL00_12 PIXEL01_20 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    PIXEL11_11 break;
+              }
+            case 175:
+            case 47: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    PIXEL01_12 PIXEL10_11 PIXEL11_20 break;
+              }
+            case 183:
+            case 151: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_20 PIXEL11_12 break;
+              }
+            case 245:
+            case 244: {
+                    PIXEL00_20 PIXEL01_11 PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 250: {
+                    PIXEL00_10 PIXEL01_10 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 123: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 95: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_10 PIXEL11_10 break;
+              }
+            case 222: {
+                    PIXEL00_10 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_10 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 252: {
+                    PIXEL00_21 PIXEL01_11 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 249: {
+                    PIXEL00_12 PIXEL01_22 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 235: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_21 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    PIXEL11_11 break;
+              }
+            case 111: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_22 break;
+              }
+            case 63: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_11 PIXEL11_21 break;
+              }
+            case 159: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_22 PIXEL11_12 break;
+              }
+            case 215: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_21 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 246: {
+                    PIXEL00_22 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 254: {
+                    PIXEL00_10 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 253: {
+                    PIXEL00_12 PIXEL01_11 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 251: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    PIXEL01_10 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 239: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    PIXEL01_12 if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    PIXEL11_11 break;
+              }
+            case 127: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_20}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_20}
+                    PIXEL11_10 break;
+              }
+            case 191: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_11 PIXEL11_12 break;
+              }
+            case 223: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_20}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_10 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_20}
+                    break;
+              }
+            case 247: {
+                    PIXEL00_11 if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    PIXEL10_12 if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            case 255: {
+                    if(Diff(yuv[4], yuv[2]))
+                    {
+                    PIXEL00_0}
+                    else
+                    {
+                    PIXEL00_100}
+                    if(Diff(yuv[2], yuv[6]))
+                    {
+                    PIXEL01_0}
+                    else
+                    {
+                    PIXEL01_100}
+                    if(Diff(yuv[8], yuv[4]))
+                    {
+                    PIXEL10_0}
+                    else
+                    {
+                    PIXEL10_100}
+                    if(Diff(yuv[6], yuv[8]))
+                    {
+                    PIXEL11_0}
+                    else
+                    {
+                    PIXEL11_100}
+                    break;
+              }
+            default:
+                // All the 256 patterns are handled above.
+                DENG2_ASSERT(!"HQ2x_Filter: Invalid pattern");
+                break;
+            }
+            pOut += 2 * BPP;
+        }}
+        pOut += BpL;
+    }}
+}
+
+void HQ2x_Filter(uint8_t* dst, const uint8_t* src, uint32_t* yuv, int width, int height,
+    bool wrapH, bool wrapV)
+{
+    if(width * height < MIN_PARALLEL_PIXELS)
+    {
+        PrepareRows(yuv, src, width, 0, height);
+        FilterRows(dst, src, yuv, width, height, 0, height, wrapH, wrapV);
+        return;
+    }
+
+    // The image is processed in bands of rows in parallel. The comparable
+    // colors are needed for the rows around each band, so they are all
+    // prepared first.
+    int const bandCount = (height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+
+    de::TaskPool::parallelFor(de::Rangei(0, bandCount), [&] (int band)
+    {
+        PrepareRows(yuv, src, width, band * BAND_HEIGHT,
+                    de::min(height, (band + 1) * BAND_HEIGHT));
+    }, 1);
+
+    de::TaskPool::parallelFor(de::Rangei(0, bandCount), [&] (int band)
+    {
+        FilterRows(dst, src, yuv, width, height, band * BAND_HEIGHT,
+                   de::min(height, (band + 1) * BAND_HEIGHT), wrapH, wrapV);
+    }, 1);
+}
+
+#undef BPP
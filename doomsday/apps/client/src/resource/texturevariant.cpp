@@ -21,6 +21,7 @@
 #include "de_base.h"
 
 #include "misc/r_util.h"
+#include "sys_system.h" // novideo
 
 #include "gl/gl_defer.h"
 #include "gl/gl_main.h"
@@ -33,8 +34,13 @@
 
 #include <doomsday/resource/colorpalettes.h>
 #include <doomsday/res/Texture>
+#include <doomsday/busymode.h>
+#include <de/App>
 #include <de/LogBuffer>
+#include <de/TaskPool>
 #include <de/mathutil.h> // M_CeilPow
+#include <atomic>
+#include <memory>
 
 using namespace de;
 
@@ -263,6 +269,32 @@ String TextureVariantSpec::asText() const
     return text;
 }
 
+/**
+ * Translated texture content that is being finalized in a background thread. The
+ * worker only uses the content, which stays alive until both the worker and the
+ * variant are done with it.
+ */
+struct BackgroundContent
+{
+    texturecontent_t *content;
+    std::atomic_bool finished;
+
+    BackgroundContent(texturecontent_t *content) : content(content), finished(false) {}
+    ~BackgroundContent() { GL_DestroyTextureContent(content); }
+};
+
+typedef std::shared_ptr<BackgroundContent> BackgroundContentRef;
+
+static TaskPool &backgroundTasks()
+{
+    static TaskPool tasks;
+    return tasks;
+}
+
+/// Variants whose content is being finalized in the background, in submission order.
+/// Only accessed in the main thread.
+static QList<ClientTexture::Variant *> backgroundVariants;
+
 DENG2_PIMPL(ClientTexture::Variant)
 {
     ClientTexture &texture; /// The base for which "this" is a context derivative.
@@ -278,6 +310,10 @@ DENG2_PIMPL(ClientTexture::Variant)
     /// Prepared coordinates for the bottom right of the texture minus border.
     float s, t;
 
+    /// Content being finalized in the background (if any). The variant is not
+    /// prepared until the content has been uploaded.
+    BackgroundContentRef background;
+
     Impl(Public *i, ClientTexture &generalCase, TextureVariantSpec const &spec)
         : Base(i)
         , texture(generalCase)
@@ -294,6 +330,84 @@ DENG2_PIMPL(ClientTexture::Variant)
         // Release any GL texture we may have prepared.
         self().release();
     }
+
+    /**
+     * Determines whether the content @a c can be finalized in a background thread.
+     * Only map surfaces and models are prepared this way, because until the
+     * content is uploaded, they are drawn without the texture.
+     */
+    bool canFinalizeInBackground(texturecontent_t const &c) const
+    {
+        if (novideo || (c.flags & TXCF_NEVER_DEFER)) return false;
+        if (spec.type != TST_GENERAL) return false;
+        if (BusyMode_Active() || !App::inMainThread()) return false;
+
+        switch (spec.variant.context)
+        {
+        case TC_MAPSURFACE_DIFFUSE:
+        case TC_MAPSURFACE_REFLECTION:
+        case TC_MAPSURFACE_REFLECTIONMASK:
+        case TC_MAPSURFACE_LIGHTMAP:
+        case TC_MODELSKIN_DIFFUSE:
+        case TC_MODELSKIN_REFLECTION:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Translates the content @a c in the main thread and has a background thread
+     * finalize it for uploading. The content takes ownership of the pixels.
+     */
+    void beginBackgroundFinalize(texturecontent_t const &c)
+    {
+        DENG2_ASSERT(!background);
+
+        auto *content = (texturecontent_t *) M_Malloc(sizeof(*content));
+        *content = c;
+        GL_TranslateTextureContent(*content);
+
+        background.reset(new BackgroundContent(content));
+        backgroundVariants.append(thisPublic);
+
+        BackgroundContentRef ref = background;
+        backgroundTasks().start([ref] ()
+        {
+            GL_FinalizeTextureContent(*ref->content);
+            ref->finished = true;
+        });
+    }
+
+    /**
+     * Abandons the content being finalized in the background. The worker may still
+     * be processing it; the content is destroyed when it is done.
+     */
+    void cancelBackgroundFinalize()
+    {
+        if (!background) return;
+
+        backgroundVariants.removeOne(thisPublic);
+        Deferred_glDeleteTextures(1, &background->content->name);
+        background.reset();
+    }
+
+    /**
+     * Uploads the content finalized in the background. Called in the main thread.
+     */
+    void uploadFinalizedContent()
+    {
+        DENG2_ASSERT(background && background->finished);
+
+        glTexName = background->content->name;
+        GL_UploadTextureContent(*background->content, gl::Immediate);
+
+        LOGDEV_RES_XVERBOSE("Prepared \"%s\" variant (glName:%u) in the background",
+                            texture.manifest().composeUri() << uint(glTexName));
+
+        background.reset();
+    }
 };
 
 ClientTexture::Variant::Variant(ClientTexture &generalCase, TextureVariantSpec const &spec)
@@ -512,6 +626,16 @@ uint ClientTexture::Variant::prepare()
 
     LOG_AS("TextureVariant::prepare");
 
+    if(d->background)
+    {
+        // Still being finalized in the background?
+        if(!BusyMode_Active() && App::inMainThread())
+            return 0;
+
+        // Can't wait for it any more; do it now.
+        d->cancelBackgroundFinalize();
+    }
+
     // Load the source image data.
     image_t image;
     res::Source source = GL_LoadSourceImage(image, d->texture, d->spec);
@@ -564,13 +688,26 @@ uint ClientTexture::Variant::prepare()
         d->flags |= TextureVariant::Masked;
     }
 
-    // Submit the content for uploading (possibly deferred).
-    gl::UploadMethod uploadMethod = GL_ChooseUploadMethod(&c);
-    GL_UploadTextureContent(c, uploadMethod);
+    if(d->canFinalizeInBackground(c))
+    {
+        // The variant remains unprepared until the content is uploaded.
+        d->beginBackgroundFinalize(c);
+        image.pixels = nullptr; // Owned by the content.
+        d->glTexName = 0;
+
+        LOGDEV_RES_XVERBOSE("Finalizing \"%s\" variant (glName:%u) in the background",
+                            d->texture.manifest().composeUri() << uint(c.name));
+    }
+    else
+    {
+        // Submit the content for uploading (possibly deferred).
+        gl::UploadMethod uploadMethod = GL_ChooseUploadMethod(&c);
+        GL_UploadTextureContent(c, uploadMethod);
 
-    LOGDEV_RES_XVERBOSE("Prepared \"%s\" variant (glName:%u)%s",
-                        d->texture.manifest().composeUri() << uint(d->glTexName) <<
-                        (uploadMethod == gl::Immediate? " while not busy!" : ""));
+        LOGDEV_RES_XVERBOSE("Prepared \"%s\" variant (glName:%u)%s",
+                            d->texture.manifest().composeUri() << uint(d->glTexName) <<
+                            (uploadMethod == gl::Immediate? " while not busy!" : ""));
+    }
     LOGDEV_RES_XVERBOSE("  Content: %s", Image_Description(image));
     LOGDEV_RES_XVERBOSE("  Specification %p: %s", &d->spec << d->spec.asText());
 
@@ -592,6 +729,8 @@ uint ClientTexture::Variant::prepare()
 
 void ClientTexture::Variant::release()
 {
+    d->cancelBackgroundFinalize();
+
     if (isPrepared())
     {
         Deferred_glDeleteTextures(1, (GLuint const *) &d->glTexName);
@@ -599,6 +738,26 @@ void ClientTexture::Variant::release()
     }
 }
 
+int ClientTexture::Variant::uploadFinalizedContent(int maxCount) // static
+{
+    DENG2_ASSERT_IN_MAIN_THREAD();
+
+    int count = 0;
+    for(auto i = backgroundVariants.begin(); i != backgroundVariants.end() && count < maxCount; )
+    {
+        Variant *variant = *i;
+        if(!variant->d->background->finished)
+        {
+            ++i;
+            continue;
+        }
+        i = backgroundVariants.erase(i);
+        variant->d->uploadFinalizedContent();
+        count++;
+    }
+    return count;
+}
+
 ClientTexture &ClientTexture::Variant::base() const
 {
     return d->texture;
@@ -46,6 +46,7 @@
 #include "gl/gl_main.h"
 #include "gl/sys_opengl.h"
 #include "gl/gl_defer.h"
+#include "resource/clienttexture.h"
 
 #include <doomsday/console/exec.h>
 #include <de/FileSystem>
@@ -65,6 +66,12 @@
  */
 #define FRAME_DEFERRED_UPLOAD_TIMEOUT 20
 
+/**
+ * Maximum number of texture variants finalized in background threads that are
+ * uploaded per frame. The rest are left for the following frames.
+ */
+#define FRAME_FINALIZED_TEXTURE_UPLOADS 4
+
 using namespace de;
 
 DENG2_PIMPL(GameWidget)
@@ -297,6 +304,7 @@ void GameWidget::update()
     if (Sys_IsShuttingDown()) return;
 
     GL_ProcessDeferredTasks(FRAME_DEFERRED_UPLOAD_TIMEOUT);
+    ClientTexture::Variant::uploadFinalizedContent(FRAME_FINALIZED_TEXTURE_UPLOADS);
 
     // Release the busy transition frame now when we can be sure that busy mode
     // is over / didn't start at all.
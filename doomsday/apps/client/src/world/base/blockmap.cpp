@@ -30,183 +30,55 @@
 #include <de/Vector>
 #include <de/memoryzone.h>
 #include <de/vector1.h>
+#include <QVector>
 #include <cmath>
 
 using namespace de;
 
 namespace world {
 
-struct RingNode
+/**
+ * Link of an element in a cell.
+ */
+struct CellElem
 {
     void *elem;
-    RingNode *prev;
-    RingNode *next;
+    dint *slot;    ///< Where the element's position in the cell is kept up to date (optional).
 };
 
+/**
+ * Elements linked in a cell are kept in a compact array. When an element is
+ * unlinked, the last element of the array is moved into its place. While the
+ * blockmap is being iterated, unlinked slots are only cleared and the array is
+ * compacted when the iteration has ended.
+ */
 struct CellData
 {
-    RingNode *ringNodes;
-    dint elemCount; ///< Total number of linked elements.
-
-    bool unlink(void *elem)
-    {
-        if(RingNode *node = findNode(elem))
-        {
-            clearElement(*node);
-            return true;
-        }
-        return false;
-    }
-
-    void unlinkAll()
-    {
-        for(RingNode *node = ringNodes; node; node = node->next)
-        {
-            clearElement(*node);
-        }
-    }
-
-    bool link(void *elem)
-    {
-        addElement(newNode(), elem);
-        return true;
-    }
-
-private:
-    RingNode &newNode()
-    {
-        RingNode *node = nullptr;
-
-        if(!ringNodes)
-        {
-            // Create a new root node.
-            node = (RingNode *) Z_Malloc(sizeof(*node), PU_MAP, nullptr);
-            node->next = nullptr;
-            node->prev = nullptr;
-            node->elem = nullptr;
-
-            ringNodes = node;
-
-            return *node;
-        }
-
-        // Is there an available node in the ring we can reuse?
-        for(node = ringNodes; node->next && node->elem; node = node->next)
-        {}
-
-        if(!node->elem)
-        {
-            // This will do nicely.
-            return *node;
-        }
-
-        // Add a new node to the ring.
-        node->next = (RingNode *) Z_Malloc(sizeof(*node), PU_MAP, nullptr);
-        node->next->next = nullptr;
-        node->next->prev = node;
-        node->next->elem = nullptr;
-
-        return *node->next;
-    }
-
-    RingNode *findNode(void *elem)
-    {
-        if(elem)
-        {
-            for(RingNode *found = ringNodes; found; found = found->next)
-            {
-                if(found->elem == elem) return found;
-            }
-        }
-        return nullptr;
-    }
-
-    void clearElement(RingNode &node)
-    {
-        if(!node.elem) return;
-
-        node.elem = nullptr;
-        elemCount--;
-    }
-
-    void addElement(RingNode &node, void *elem)
-    {
-        DENG2_ASSERT(node.elem == nullptr);
-        node.elem = elem;
-        elemCount++;
-    }
+    QVector<CellElem> elems;
+    dint elemCount = 0;              ///< Total number of linked elements.
+    bool needsCompaction = false;    ///< Some of the slots are vacant.
 };
 
 DENG2_PIMPL(Blockmap)
 {
-    /**
-     * Quadtree node.
-     */
-    struct Node
-    {
-        /// Logical child quadrant identifiers.
-        enum Quadrant
-        {
-            TopLeft,
-            TopRight,
-            BottomLeft,
-            BottomRight
-        };
-
-        Cell cell;   ///< Cell coordinates for this node.
-        duint size;  ///< Size of the cell at this node (width=height).
-        union {
-            Node *children[4];   ///< One per quadrant (if any, not owned).
-            CellData *leafData;  ///< Data associated with the leaf cell.
-        };
-
-        /**
-         * Construct a new node.
-         *
-         * @param cell  Cell coordinates for the node.
-         * @param size  Size of the cell.
-         */
-        Node(Cell const &cell, duint size)
-            : cell(cell)
-            , size(size)
-        {
-            zap(children);
-        }
-
-        ~Node()
-        {
-            if(isLeaf()) Z_Free(leafData);
-        }
-
-        /**
-         * Returns @c true iff the cell is a leaf (i.e., equal to a unit in the
-         * gridmap coordinate space).
-         */
-        inline bool isLeaf() const { return size == 1; }
-
-        /**
-         * In which child quadrant is the given @a point?
-         */
-        Quadrant quadrant(Cell const &point) const
-        {
-            duint const subSize = size >> 1;
-            if(point.x < cell.x + subSize)
-            {
-                return (point.y < cell.y + subSize)? TopLeft  : BottomLeft;
-            }
-            else
-            {
-                return (point.y < cell.y + subSize)? TopRight : BottomRight;
-            }
-        }
-    };
-    typedef QList<Node> Nodes;
-
     AABoxd bounds;    ///< Map space units.
     duint cellSize;   ///< Map space units.
     Cell dimensions;  ///< Dimensions of the indexed space, in cells.
 
-    Nodes nodes;      ///< Quadtree nodes. The first being the root.
+    QVector<CellData> cells;          ///< All cells of the blockmap, row by row.
+
+    dint iterating = 0;               ///< Depth of ongoing iterations.
+    QVector<dint> cellsToCompact;
+
+    /**
+     * Holds off compaction of the cell arrays while elements are being iterated.
+     */
+    struct IterationGuard
+    {
+        Impl &d;
+        IterationGuard(Impl &d) : d(d) { d.iterating++; }
+        ~IterationGuard() { d.endIteration(); }
+    };
 
     Impl(Public *i, AABoxd const &bounds, duint cellSize)
         : Base(i)
@@ -215,8 +87,7 @@ DENG2_PIMPL(Blockmap)
         , dimensions(Vector2ui(de::ceil((bounds.maxX - bounds.minX) / cellSize),
                                de::ceil((bounds.maxY - bounds.minY) / cellSize)))
     {
-        // Quadtree must subdivide the space equally into 1x1 unit cells.
-        newNode(Cell(0, 0), ceilPow2(de::max(dimensions.x, dimensions.y)));
+        cells.resize(dint(dimensions.x * dimensions.y));
     }
 
     inline dint toCellIndex(duint cellX, duint cellY)
@@ -308,88 +179,139 @@ DENG2_PIMPL(Blockmap)
         return didClipMin | didClipMax;
     }
 
-    Node *newNode(Cell const &at, duint size)
+    /**
+     * Returns the linear index of the identified cell, or @c -1 if the cell is
+     * outside the blockmap.
+     */
+    dint cellIndex(Cell const &cell)
     {
-        nodes.append(Node(at, size));
-        return &nodes.last();
+        if(cell.x >= dimensions.x || cell.y >= dimensions.y)
+        {
+            return -1;
+        }
+        return toCellIndex(cell.x, cell.y);
     }
 
-    Node *findLeaf(Node *node, Cell const &at, bool canSubdivide)
+    /**
+     * Retrieve the data of the identified cell.
+     *
+     * @return  Cell data, or @c nullptr if the cell is outside the blockmap.
+     */
+    CellData *cellData(Cell const &cell)
     {
-        if(node->isLeaf()) return node;
+        dint const index = cellIndex(cell);
+        return (index >= 0? &cells[index] : nullptr);
+    }
 
-        // Into which quadrant do we need to descend?
-        Node::Quadrant q = node->quadrant(at);
+    void link(dint index, void *elem, dint *slot)
+    {
+        CellData &cell = cells[index];
+        if(slot) *slot = cell.elems.size();
+        cell.elems.append(CellElem{ elem, slot });
+        cell.elemCount++;
+    }
 
-        // Has this quadrant been initialized yet?
-        Node **childAdr = &node->children[q];
-        if(!*childAdr)
+    /**
+     * Returns the position of @a elem in the cell's array, or @c -1 if it isn't
+     * linked in the cell. The element's own record of its position is checked
+     * first; if it has none, the cell is searched.
+     */
+    dint findSlot(CellData const &cell, void *elem, dint const *slot) const
+    {
+        if(slot && *slot >= 0 && *slot < cell.elems.size() &&
+           cell.elems.at(*slot).elem == elem)
         {
-            if(!canSubdivide) return nullptr;
-
-            // Subdivide the space.
-            duint const subSize = node->size >> 1;
-            switch(q)
-            {
-            case Node::TopLeft:
-                *childAdr = newNode(node->cell, subSize);
-                break;
-
-            case Node::TopRight:
-                *childAdr = newNode(Cell(node->cell.x + subSize, node->cell.y), subSize);
-                break;
-
-            case Node::BottomLeft:
-                *childAdr = newNode(Cell(node->cell.x, node->cell.y + subSize), subSize);
-                break;
-            case Node::BottomRight:
-                *childAdr = newNode(Cell(node->cell.x + subSize, node->cell.y + subSize), subSize);
-                break;
-            }
+            return *slot;
+        }
+        for(dint i = 0; i < cell.elems.size(); ++i)
+        {
+            if(cell.elems.at(i).elem == elem) return i;
         }
+        return -1;
+    }
+
+    bool unlink(dint index, void *elem, dint *slot)
+    {
+        CellData &cell = cells[index];
+        dint const pos = findSlot(cell, elem, slot);
+        if(pos < 0) return false;
 
-        return findLeaf(*childAdr, at, canSubdivide);
+        cell.elemCount--;
+        if(iterating)
+        {
+            // Someone may be looking at the array; compact it later.
+            cell.elems[pos] = CellElem{ nullptr, nullptr };
+            markForCompaction(index);
+        }
+        else
+        {
+            removeSlot(index, pos);
+        }
+        return true;
     }
 
-    inline Node *findLeaf(Cell const &at, bool canCreate = false)
+    void unlinkAll()
     {
-        return findLeaf(&nodes.first(), at, canCreate);
+        for(dint i = 0; i < cells.size(); ++i)
+        {
+            CellData &cell = cells[i];
+            if(cell.elems.isEmpty()) continue;
+
+            cell.elemCount = 0;
+            if(iterating)
+            {
+                cell.elems.fill(CellElem{ nullptr, nullptr });
+                markForCompaction(i);
+            }
+            else
+            {
+                cell.elems.clear();
+            }
+        }
     }
 
     /**
-     * Retrieve the user data associated with the identified cell.
-     *
-     * @param cell       Cell coordinates to retrieve user data for.
-     * @param canCreate  @c true= allocate new data if not already present
-     *                   for the referenced cell.
-     *
-     * @return  User data for the identified cell else @c 0if an invalid
-     *          reference or no there is no data present (and not allocating).
+     * Moves the last element of the cell's array into @a pos.
      */
-    CellData *cellData(Cell const &cell, bool canCreate = false)
+    void removeSlot(dint index, dint pos)
     {
-        // Outside our boundary?
-        if(cell.x >= dimensions.x || cell.y >= dimensions.y)
+        CellData &cell = cells[index];
+        dint const last = cell.elems.size() - 1;
+        if(pos != last)
+        {
+            CellElem const moved = cell.elems.at(last);
+            cell.elems[pos] = moved;
+            if(moved.slot) *moved.slot = pos;
+        }
+        cell.elems.removeLast();
+    }
+
+    void markForCompaction(dint index)
+    {
+        CellData &cell = cells[index];
+        if(!cell.needsCompaction)
         {
-            return nullptr;
+            cell.needsCompaction = true;
+            cellsToCompact.append(index);
         }
+    }
+
+    void endIteration()
+    {
+        DENG2_ASSERT(iterating > 0);
+        if(--iterating) return;
 
-        // Try to locate this leaf (may fail if not present and we are
-        // not allocating user data (there will be no corresponding cell)).
-        if(Node *node = findLeaf(cell, canCreate))
+        for(dint index : cellsToCompact)
         {
-            // Exisiting user data for this cell?
-            if(!node->leafData)
+            CellData &cell = cells[index];
+            // Going backwards, the moved elements are always ones already checked.
+            for(dint i = cell.elems.size() - 1; i >= 0; --i)
             {
-                // Can we allocate new user data?
-                if(canCreate)
-                {
-                    node->leafData = (CellData *)Z_Calloc(sizeof(CellData), PU_MAPSTATIC, nullptr);
-                }
+                if(!cell.elems.at(i).elem) removeSlot(index, i);
             }
-            return node->leafData;
+            cell.needsCompaction = false;
         }
-        return nullptr;
+        cellsToCompact.clear();
     }
 };
 
@@ -442,13 +364,15 @@ BlockmapCellBlock Blockmap::toCellBlock(AABoxd const &box, bool *retDidClip) con
     return block;
 }
 
-bool Blockmap::link(Cell const &cell, void *elem)
+bool Blockmap::link(Cell const &cell, void *elem, dint *slot)
 {
     if(!elem) return false; // Huh?
 
-    if(auto *cellData = d->cellData(cell, true /*can create*/))
+    dint const index = d->cellIndex(cell);
+    if(index >= 0)
     {
-        return cellData->link(elem);
+        d->link(index, elem, slot);
+        return true;
     }
     return false; // Outside the blockmap?
 }
@@ -466,25 +390,25 @@ bool Blockmap::link(AABoxd const &region, void *elem)
     for(cell.y = cellBlock.min.y; cell.y < cellBlock.max.y; ++cell.y)
     for(cell.x = cellBlock.min.x; cell.x < cellBlock.max.x; ++cell.x)
     {
-        if(auto *cellData = d->cellData(cell, true))
+        dint const index = d->cellIndex(cell);
+        if(index >= 0)
         {
-            if(cellData->link(elem))
-            {
-                didLink = true;
-            }
+            d->link(index, elem, nullptr);
+            didLink = true;
         }
     }
 
     return didLink;
 }
 
-bool Blockmap::unlink(Cell const &cell, void *elem)
+bool Blockmap::unlink(Cell const &cell, void *elem, dint *slot)
 {
     if(!elem) return false; // Huh?
 
-    if(auto *cellData = d->cellData(cell))
+    dint const index = d->cellIndex(cell);
+    if(index >= 0)
     {
-        return cellData->unlink(elem);
+        return d->unlink(index, elem, slot);
     }
     return false;
 }
@@ -502,12 +426,10 @@ bool Blockmap::unlink(AABoxd const &region, void *elem)
     for(cell.y = cellBlock.min.y; cell.y < cellBlock.max.y; ++cell.y)
     for(cell.x = cellBlock.min.x; cell.x < cellBlock.max.x; ++cell.x)
     {
-        if(auto *cellData = d->cellData(cell))
+        dint const index = d->cellIndex(cell);
+        if(index >= 0 && d->unlink(index, elem, nullptr))
         {
-            if(cellData->unlink(elem))
-            {
-                didUnlink = true;
-            }
+            didUnlink = true;
         }
     }
 
@@ -516,16 +438,7 @@ bool Blockmap::unlink(AABoxd const &region, void *elem)
 
 void Blockmap::unlinkAll()
 {
-    for(Impl::Node const &node : d->nodes)
-    {
-        // Only leafs with user data.
-        if(!node.isLeaf()) continue;
-
-        if(auto *cellData = node.leafData)
-        {
-            cellData->unlinkAll();
-        }
-    }
+    d->unlinkAll();
 }
 
 dint Blockmap::cellElementCount(Cell const &cell) const
@@ -541,15 +454,14 @@ LoopResult Blockmap::forAllInCell(Cell const &cell, std::function<LoopResult (vo
 {
     if(auto *cellData = d->cellData(cell))
     {
-        RingNode *node = cellData->ringNodes;
-        while(node)
+        // Elements may be linked and unlinked during the iteration.
+        Impl::IterationGuard const guard(*d);
+        for(dint i = 0; i < cellData->elems.size(); ++i)
         {
-            RingNode *next = node->next;
-            if(node->elem)
+            if(void *elem = cellData->elems.at(i).elem)
             {
-                if(auto result = func(node->elem)) return result;
+                if(auto result = func(elem)) return result;
             }
-            node = next;
         }
     }
     return LoopContinue;
@@ -733,16 +645,15 @@ void Blockmap::drawDebugVisual() const
     DGL_CurrentColor(oldColor);
 
     /*
-     * Draw the Quadtree.
+     * Draw the cells with linked elements.
      */
-    DGL_Color4f(1.f, 1.f, 1.f, 1.f / d->nodes.first().size);
-    foreach(Impl::Node const &node, d->nodes)
+    DGL_Color4f(1.f, 1.f, 1.f, 1.f / ceilPow2(de::max(d->dimensions.x, d->dimensions.y)));
+    for(duint y = 0; y < d->dimensions.y; ++y)
+    for(duint x = 0; x < d->dimensions.x; ++x)
     {
-        // Only leafs with user data.
-        if(!node.isLeaf()) continue;
-        if(!node.leafData) continue;
+        if(!d->cells.at(d->toCellIndex(x, y)).elemCount) continue;
 
-        Vector2f const topLeft     = node.cell * UNIT_SIZE;
+        Vector2f const topLeft     = Vector2f(x, y) * UNIT_SIZE;
         Vector2f const bottomRight = topLeft + Vector2f(UNIT_SIZE, UNIT_SIZE);
 
         DGL_Begin(DGL_LINE_STRIP);
@@ -24,6 +24,7 @@
 #include <utility>
 #include <QMap>
 #include <QtAlgorithms>
+#include <de/c_wrapper.h>
 #include <de/memoryzone.h>
 #include <de/timer.h>
 #include <de/Binder>
@@ -31,6 +32,7 @@
 #include <de/Log>
 #include <de/Scheduler>
 #include <de/ScriptSystem>
+#include <de/TaskPool>
 #include <de/Time>
 #include <doomsday/doomsdayapp.h>
 #include <doomsday/console/cmd.h>
@@ -94,6 +96,8 @@ using namespace world;
 
 dint validCount = 1;  // Increment every time a check is made.
 
+static dbyte mapPrefetch = 1;  // cvar
+
 #ifdef __CLIENT__
 //static dfloat handDistance = 300;  //cvar
 static inline RenderSystem &rendSys()
@@ -304,6 +308,7 @@ DENG2_PIMPL(ClientServerWorld)
 
     timespan_t time = 0;         ///< World-wide time.
     Scheduler scheduler;
+    TaskPool prefetchTasks;      ///< Reading the data lumps of the next map.
 #if 0
 #ifdef __CLIENT__
     std::unique_ptr<Hand> hand;  ///< For map editing/manipulation.
@@ -456,12 +461,20 @@ DENG2_PIMPL(ClientServerWorld)
         }*/
 
         // Try a JIT conversion with the help of a plugin.
+        Time begunAt;
         Map *map = convertMap(mapManifest, reporter);
         if (!map)
         {
             LOG_WARNING("Failed conversion of \"%s\".") << mapManifest.composeUri().path();
             //mapManifest.lastLoadAttemptFailed = true;
         }
+        else
+        {
+            // Lumps are read from memory-mapped files unless -nommap is used.
+            LOG_MAP_VERBOSE("\"%s\" converted in %.2f seconds (%s lumps)")
+                    << mapManifest.composeUri().path() << begunAt.since()
+                    << (CommandLine_Exists("-nommap")? "read" : "mapped");
+        }
         return map;
     }
 
@@ -730,6 +743,11 @@ DENG2_PIMPL(ClientServerWorld)
 
         Z_FreeTags(PU_MAP, PU_PURGELEVEL - 1);
 
+        // The data lumps may have been prefetched while the old map was unloaded.
+        // The prefetch must not outlive the map change, as the files may be
+        // unloaded afterwards.
+        prefetchTasks.waitForDone();
+
         // Are we just unloading the current map?
         if (!mapManifest) return true;
 
@@ -813,6 +831,12 @@ bool ClientServerWorld::changeMap(de::Uri const &mapUri)
         mapDef = App_Resources().mapManifests().tryFindMapManifest(mapUri);
     }
 
+    if (mapDef && mapPrefetch)
+    {
+        // Start reading the map data in the background.
+        mapDef->recognizer().prefetch(d->prefetchTasks);
+    }
+
     // Switch to busy mode (if we haven't already) except when simply unloading.
     if (!mapUri.path().isEmpty() && !DoomsdayApp::app().busyMode().isActive())
     {
@@ -832,6 +856,9 @@ bool ClientServerWorld::changeMap(de::Uri const &mapUri)
 
 void ClientServerWorld::reset()
 {
+    // Files are unloaded after a reset, so the prefetch must be finished.
+    d->prefetchTasks.waitForDone();
+
     World::reset();
 
 #ifdef __CLIENT__
@@ -976,6 +1003,7 @@ void ClientServerWorld::endFrame()
 void ClientServerWorld::consoleRegister()  // static
 {
     //C_VAR_BYTE ("map-cache", &mapCache, 0, 0, 1);
+    C_VAR_BYTE ("map-prefetch", &mapPrefetch, 0, 0, 1);
 #ifdef __CLIENT__
     //C_VAR_FLOAT("edit-bias-grab-distance", &handDistance, 0, 10, 1000);
 #endif
@@ -2537,7 +2537,7 @@ dint Map::unlink(mobj_t &mob)
         links |= MLF_SECTOR;
 
     BlockmapCell cell = d->mobjBlockmap->toCell(Mobj_Origin(mob));
-    if (d->mobjBlockmap->unlink(cell, &mob))
+    if (d->mobjBlockmap->unlink(cell, &mob, &mob.blockmapSlot))
         links |= MLF_BLOCKMAP;
 
     if (!d->unlinkMobjFromLines(mob))
@@ -2562,7 +2562,7 @@ void Map::link(mobj_t &mob, dint flags)
     if (flags & MLF_BLOCKMAP)
     {
         BlockmapCell cell = d->mobjBlockmap->toCell(Mobj_Origin(mob));
-        d->mobjBlockmap->link(cell, &mob);
+        d->mobjBlockmap->link(cell, &mob, &mob.blockmapSlot);
     }
 
     // Link into lines?
@@ -186,7 +186,7 @@ DENG_EXTERN_C void Mobj_SetState(mobj_t *mob, int statenum)
 
     state_t const *oldState = mob->state;
 
-    DENG2_ASSERT(statenum >= 0 && statenum < DED_Definitions()->states.size());
+    DENG2_ASSERT(statenum >= 0 && statenum < runtimeDefs.states.size());
 
     mob->state  = &runtimeDefs.states[statenum];
     mob->tics   = mob->state->tics;
@@ -195,10 +195,9 @@ DENG_EXTERN_C void Mobj_SetState(mobj_t *mob, int statenum)
 
     if (!(mob->ddFlags & DDMF_REMOTE))
     {
-        String const exec = DED_Definitions()->states[statenum].gets("execute");
-        if (!exec.isEmpty())
+        if (dint const exec = runtimeDefs.stateInfo[statenum].execute)
         {
-            Con_Execute(CMDS_SCRIPT, exec.toUtf8(), true, false);
+            Con_Execute(CMDS_SCRIPT, runtimeDefs.string(exec), true, false);
         }
     }
 
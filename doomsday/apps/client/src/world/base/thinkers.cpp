@@ -37,8 +37,12 @@
 #include "world/p_object.h"
 
 #include <de/memoryzone.h>
+#include <QHash>
 #include <QList>
+#include <QVector>
 #include <QtAlgorithms>
+#include <algorithm>
+#include <memory>
 
 using namespace de;
 
@@ -60,80 +64,99 @@ world::Map &Thinker_Map(thinker_t const & /*th*/)
 
 namespace world {
 
+/**
+ * Thinkers with the same think function are stored in an array, in the order they
+ * were added. The thinkers themselves are owned by their creators (usually allocated
+ * from the memory zone), so only pointers are stored.
+ */
 struct ThinkerList
 {
-    bool isPublic; ///< All thinkers in this list are visible publically.
-
-    Thinker sentinel;
+    thinkfunc_t function;
+    bool isPublic;                   ///< All thinkers in this list are visible publically.
+    QVector<thinker_t *> thinkers;   ///< Removed thinkers are @c nullptr until compacted.
+    bool needsCompaction = false;
 
-    ThinkerList(thinkfunc_t func, bool isPublic) : isPublic(isPublic)
-    {
-        sentinel.function = func;
-        sentinel.disable(); // Safety measure.
-
-        sentinel.prev = sentinel.next = sentinel;
-    }
+    ThinkerList(thinkfunc_t func, bool isPublic) : function(func), isPublic(isPublic)
+    {}
 
     void reinit()
     {
-        sentinel.prev = sentinel.next = sentinel;
+        thinkers.clear();
+        needsCompaction = false;
     }
 
-    thinkfunc_t function() const
-    {
-        return sentinel.function;
-    }
-
-    // Link the thinker to the list.
     void link(thinker_t &th)
     {
-        sentinel.prev->next = &th;
-        th.next = sentinel;
-        th.prev = sentinel.prev;
-        sentinel.prev = &th;
+        thinkers.append(&th);
     }
 
     dint count(dint *numInStasis) const
     {
         dint num = 0;
-        thinker_t *th = sentinel.next;
-        while (th != &sentinel.base() && th)
+        for (thinker_t const *th : thinkers)
         {
-#ifdef LIBDENG_FAKE_MEMORY_ZONE
-            DENG2_ASSERT(th->next);
-            DENG2_ASSERT(th->prev);
-#endif
+            if (!th) continue;
             num += 1;
             if (numInStasis && Thinker_InStasis(th))
             {
                 (*numInStasis) += 1;
             }
-            th = th->next;
         }
         return num;
     }
 
+    LoopResult forAll(std::function<LoopResult (thinker_t *)> const &func) const
+    {
+        // Thinkers may be added to the list during the iteration.
+        for (dint i = 0; i < thinkers.size(); ++i)
+        {
+            if (thinker_t *th = thinkers.at(i))
+            {
+                if (auto result = func(th)) return result;
+            }
+        }
+        return LoopContinue;
+    }
+
+    /**
+     * Removes the slots of unlinked thinkers, preserving the order of the rest.
+     */
+    void compact()
+    {
+        if (!needsCompaction) return;
+        thinkers.erase(std::remove(thinkers.begin(), thinkers.end(), nullptr), thinkers.end());
+        needsCompaction = false;
+    }
+
     void releaseAll()
     {
-        for (thinker_t *th = sentinel.next; th != &sentinel.base() && th; th = th->next)
+        for (thinker_t *th : thinkers)
         {
-            Thinker::release(*th);
+            if (th) Thinker::release(*th);
         }
     }
 };
 
 DENG2_PIMPL(Thinkers)
 {
-    dint idtable[2048];     ///< 65536 bits telling which IDs are in use.
+    static dint const MAX_IDS = 0x10000;
+
+    dint idtable[MAX_IDS / 32];  ///< 65536 bits telling which IDs are in use.
     dushort iddealer = 0;
 
-    QList<ThinkerList *> lists;
-    QHash<thid_t, mobj_t *> mobjIdLookup;  ///< public only
-    QHash<thid_t, thinker_t *> thinkerIdLookup; ///< all thinkers with ID
+    QList<ThinkerList *> lists;                        ///< In order of creation.
+    QHash<quintptr, ThinkerList *> listsByFunc[2];     ///< Private and public lists.
+
+    // Direct lookup tables indexed by ID.
+    std::unique_ptr<mobj_t *[]> mobjIdLookup;          ///< public only
+    std::unique_ptr<thinker_t *[]> thinkerIdLookup;    ///< all thinkers with ID
 
     bool inited = false;
 
-    Impl(Public *i) : Base(i)
+    Impl(Public *i)
+        : Base(i)
+        , mobjIdLookup   (new mobj_t *[MAX_IDS])
+        , thinkerIdLookup(new thinker_t *[MAX_IDS])
     {
         clearMobjIds();
     }
@@ -151,7 +174,7 @@ DENG2_PIMPL(Thinkers)
 
     void releaseAllThinkers()
     {
-        thinkerIdLookup.clear();
+        std::fill(thinkerIdLookup.get(), thinkerIdLookup.get() + MAX_IDS, nullptr);
         for (ThinkerList *list : lists)
         {
             list->releaseAll();
@@ -163,8 +186,8 @@ DENG2_PIMPL(Thinkers)
         de::zap(idtable);
         idtable[0] |= 1;  // ID zero is always "used" (it's not a valid ID).
 
-        mobjIdLookup.clear();
-        thinkerIdLookup.clear();
+        std::fill(mobjIdLookup.get(),    mobjIdLookup.get()    + MAX_IDS, nullptr);
+        std::fill(thinkerIdLookup.get(), thinkerIdLookup.get() + MAX_IDS, nullptr);
     }
 
     thid_t newMobjId()
@@ -182,18 +205,60 @@ DENG2_PIMPL(Thinkers)
     ThinkerList *listForThinkFunc(thinkfunc_t func, bool makePublic = true,
                                   bool canCreate = false)
     {
-        for (dint i = 0; i < lists.count(); ++i)
-        {
-            ThinkerList *list = lists[i];
-            if (list->function() == func && list->isPublic == makePublic)
-                return list;
-        }
+        auto &lut = listsByFunc[makePublic? 1 : 0];
+        auto found = lut.constFind(quintptr(func));
+        if (found != lut.constEnd()) return found.value();
 
         if (!canCreate) return nullptr;
 
         // A new thinker type.
-        lists.append(new ThinkerList(func, makePublic));
-        return lists.last();
+        auto *list = new ThinkerList(func, makePublic);
+        lists.append(list);
+        lut.insert(quintptr(func), list);
+        return list;
+    }
+
+    void runList(ThinkerList &list)
+    {
+        // Thinkers may be added to the list while it is being run.
+        for (dint i = 0; i < list.thinkers.size(); ++i)
+        {
+            thinker_t *th = list.thinkers.at(i);
+            if (!th) continue;
+            if (Thinker_InStasis(th)) continue; // Skip.
+
+            // Time to remove it?
+            if (th->function == (thinkfunc_t) -1)
+            {
+                // The slot is removed after the whole list has been run, so that
+                // other thinkers can iterate the list meanwhile.
+                list.thinkers[i] = nullptr;
+                list.needsCompaction = true;
+
+                if (th->id)
+                {
+                    // Recycle for reduced allocation overhead.
+                    P_MobjRecycle((mobj_t *) th);
+                }
+                else
+                {
+                    // Non-mobjs are just deleted right away.
+                    Thinker::destroy(th);
+                }
+            }
+            else if (th->function)
+            {
+                // Create a private data instance of appropriate type.
+                if (!th->d) Thinker_InitPrivateData(th);
+
+                // Public thinker callback.
+                th->function(th);
+
+                // Private thinking.
+                if (th->d) THINKER_DATA(*th, Thinker::IData).think();
+            }
+        }
+        list.compact();
     }
 };
 
@@ -215,22 +280,13 @@ void Thinkers::setMobjId(thid_t id, bool inUse)
 
 struct mobj_s *Thinkers::mobjById(dint id)
 {
-    auto found = d->mobjIdLookup.constFind(id);
-    if (found != d->mobjIdLookup.constEnd())
-    {
-        return found.value();
-    }
-    return nullptr;
+    if (id < 0 || id >= Impl::MAX_IDS) return nullptr;
+    return d->mobjIdLookup[id];
 }
 
 thinker_t *Thinkers::find(thid_t id)
 {
-    auto found = d->thinkerIdLookup.constFind(id);
-    if (found != d->thinkerIdLookup.constEnd())
-    {
-        return found.value();
-    }
-    return nullptr;
+    return d->thinkerIdLookup[id];
 }
 
 void Thinkers::add(thinker_t &th, bool makePublic)
@@ -252,7 +308,7 @@ void Thinkers::add(thinker_t &th, bool makePublic)
 
         if (makePublic && th.id)
         {
-            d->mobjIdLookup.insert(th.id, reinterpret_cast<mobj_t *>(&th));
+            d->mobjIdLookup[th.id] = reinterpret_cast<mobj_t *>(&th);
         }
     }
     else
@@ -262,7 +318,7 @@ void Thinkers::add(thinker_t &th, bool makePublic)
 
     if (th.id)
     {
-        d->thinkerIdLookup.insert(th.id, &th);
+        d->thinkerIdLookup[th.id] = &th;
     }
 
     // Link the thinker to the thinker list.
@@ -278,8 +334,8 @@ void Thinkers::remove(thinker_t &th)
         // Flag the identifier as free.
         setMobjId(th.id, false);
 
-        d->mobjIdLookup.remove(th.id);
-        d->thinkerIdLookup.remove(th.id);
+        d->mobjIdLookup[th.id]    = nullptr;
+        d->thinkerIdLookup[th.id] = nullptr;
 
 #ifdef __SERVER__
         // Then it must be a mobj.
@@ -305,6 +361,8 @@ void Thinkers::initLists(dbyte flags)
     if (!d->inited)
     {
         d->lists.clear();
+        d->listsByFunc[0].clear();
+        d->listsByFunc[1].clear();
     }
     else
     {
@@ -339,20 +397,8 @@ LoopResult Thinkers::forAll(dbyte flags, std::function<LoopResult (thinker_t *)>
         if ( list->isPublic && !(flags & 0x1)) continue;
         if (!list->isPublic && !(flags & 0x2)) continue;
 
-        thinker_t *th = list->sentinel.next;
-        while (th != &list->sentinel.base() && th)
-        {
-#ifdef LIBDENG_FAKE_MEMORY_ZONE
-            DENG2_ASSERT(th->next);
-            DENG2_ASSERT(th->prev);
-#endif
-            thinker_t *next = th->next;
-
-            if (auto result = func(th))
-                return result;
-
-            th = next;
-        }
+        if (auto result = list->forAll(func))
+            return result;
     }
 
     return LoopContinue;
@@ -371,46 +417,33 @@ LoopResult Thinkers::forAll(thinkfunc_t thinkFunc, dbyte flags, std::function<Lo
     {
         if (ThinkerList *list = d->listForThinkFunc(thinkFunc))
         {
-            thinker_t *th = list->sentinel.next;
-            while (th != &list->sentinel.base() && th)
-            {
-#ifdef LIBDENG_FAKE_MEMORY_ZONE
-                DENG2_ASSERT(th->next);
-                DENG2_ASSERT(th->prev);
-#endif
-                thinker_t *next = th->next;
-
-                if (auto result = func(th))
-                    return result;
-
-                th = next;
-            }
+            if (auto result = list->forAll(func))
+                return result;
         }
     }
     if (flags & 0x2 /*private*/)
     {
         if (ThinkerList *list = d->listForThinkFunc(thinkFunc, false /*private*/))
         {
-            thinker_t *th = list->sentinel.next;
-            while (th != &list->sentinel.base() && th)
-            {
-#ifdef LIBDENG_FAKE_MEMORY_ZONE
-                DENG2_ASSERT(th->next);
-                DENG2_ASSERT(th->prev);
-#endif
-                thinker_t *next = th->next;
-
-                if (auto result = func(th))
-                    return result;
-
-                th = next;
-            }
+            if (auto result = list->forAll(func))
+                return result;
         }
     }
 
     return LoopContinue;
 }
 
+void Thinkers::runAll()
+{
+    if (!d->inited) return;
+
+    // New lists may be created while running the thinkers.
+    for (dint i = 0; i < d->lists.count(); ++i)
+    {
+        d->runList(*d->lists[i]);
+    }
+}
+
 dint Thinkers::count(dint *numInStasis) const
 {
     dint total = 0;
@@ -425,12 +458,6 @@ dint Thinkers::count(dint *numInStasis) const
     return total;
 }
 
-static void unlinkThinkerFromList(thinker_t *th)
-{
-    th->next->prev = th->prev;
-    th->prev->next = th->next;
-}
-
 }  // namespace world
 using namespace world;
 
@@ -496,39 +523,7 @@ void Thinker_Run()
     /// @todo fixme: Do not assume the current map.
     if (!App_World().hasMap()) return;
 
-    App_World().map().thinkers().forAll(0x1 | 0x2, [] (thinker_t *th)
-    {
-        if (Thinker_InStasis(th)) return LoopContinue; // Skip.
-
-        // Time to remove it?
-        if (th->function == (thinkfunc_t) -1)
-        {
-            unlinkThinkerFromList(th);
-
-            if (th->id)
-            {
-                // Recycle for reduced allocation overhead.
-                P_MobjRecycle((mobj_t *) th);
-            }
-            else
-            {
-                // Non-mobjs are just deleted right away.
-                Thinker::destroy(th);
-            }
-        }
-        else if (th->function)
-        {
-            // Create a private data instance of appropriate type.
-            if (!th->d) Thinker_InitPrivateData(th);
-
-            // Public thinker callback.
-            th->function(th);
-
-            // Private thinking.
-            if (th->d) THINKER_DATA(*th, Thinker::IData).think();
-        }
-        return LoopContinue;
-    });
+    App_World().map().thinkers().runAll();
 }
 
 #undef Thinker_Add
@@ -27,9 +27,13 @@
 #include <algorithm>
 #include <QHash>
 #include <QList>
+#include <QVector>
 #include <QtAlgorithms>
 #include <de/vector1.h>
 #include <de/LogBuffer>
+#include <de/MetadataBank>
+#include <de/Reader>
+#include <de/Writer>
 #include <doomsday/BspNode>
 
 #include "BspLeaf"
@@ -56,6 +60,11 @@ typedef QList<LineSegmentSide *>   LineSegmentSides;
 typedef QList<ConvexSubspaceProxy> SubspaceProxys;
 typedef QHash<Vertex *, EdgeTips>  EdgeTipSetMap;
 
+static String const CACHE_CATEGORY = "BspPartitions";
+
+/// Version of the cached partition choices (and the geometry they apply to).
+static dint32 const CACHE_VERSION = 1;
+
 DENG2_PIMPL(Partitioner)
 {
     int splitCostFactor = 7;     ///< Cost of splitting a line segment.
@@ -73,6 +82,21 @@ DENG2_PIMPL(Partitioner)
     BspTree *bspRoot = nullptr;  ///< The BSP tree under construction.
     HPlane hplane;               ///< Current space half-plane (partitioner state).
 
+    /**
+     * Partition chosen for a node of the tree. The partitioning is deterministic,
+     * so the choices made in an earlier build of the same geometry can be repeated
+     * without evaluating the candidates again.
+     */
+    struct PartitionChoice
+    {
+        dint32 ordinal;    ///< Ordinal of the chosen candidate (-1 if none).
+        dint32 lineIndex;  ///< Index of the partition's map line (for validation).
+    };
+    QVector<PartitionChoice> choices; ///< In pre-order.
+    int nextChoice = 0;
+    bool repeatingChoices = false;    ///< Choices were read from the cache.
+    bool choicesChanged   = false;
+
     struct LineSegmentBlockTree
     {
         LineSegmentBlockTreeNode *rootNode;
@@ -131,6 +155,69 @@ DENG2_PIMPL(Partitioner)
         hplane.clearIntercepts();
 
         segmentCount = vertexCount = 0;
+
+        choices.clear();
+        nextChoice = 0;
+        repeatingChoices = choicesChanged = false;
+    }
+
+    /**
+     * Composes an identifier for the geometry being partitioned. Everything the
+     * choice of partitions depends on is included.
+     */
+    Block geometryId() const
+    {
+        Block geometry;
+        Writer writer(geometry);
+        writer << CACHE_VERSION << dint32(splitCostFactor) << dint32(lines.count());
+        for(Line const *line : lines)
+        {
+            Sector const *backSec = line->back().sectorPtr();
+            if(!backSec) backSec = line->_bspWindowSector;
+
+            writer << dint32(line->indexInMap())
+                   << line->from().origin().x << line->from().origin().y
+                   << line->to().origin().x   << line->to().origin().y
+                   << dint32(line->front().hasSector()? line->front().sector().indexInMap() : -1)
+                   << dint32(backSec? backSec->indexInMap() : -1);
+        }
+        return geometry.md5Hash();
+    }
+
+    void readChoicesFromCache(Block const &id)
+    {
+        try
+        {
+            if(Block const data = MetadataBank::get().check(CACHE_CATEGORY, id))
+            {
+                Reader reader(data);
+                dint32 count;
+                reader.withHeader() >> count;
+                choices.resize(count);
+                for(PartitionChoice &choice : choices)
+                {
+                    reader >> choice.ordinal >> choice.lineIndex;
+                }
+                repeatingChoices = true;
+            }
+        }
+        catch(Error const &er)
+        {
+            LOGDEV_MAP_WARNING("Corrupt cached BSP partitions: %s") << er.asText();
+            choices.clear();
+        }
+    }
+
+    void updateCache(Block const &id)
+    {
+        Block data;
+        Writer writer(data);
+        writer.withHeader() << dint32(choices.size());
+        for(PartitionChoice const &choice : choices)
+        {
+            writer << choice.ordinal << choice.lineIndex;
+        }
+        MetadataBank::get().setMetadata(CACHE_CATEGORY, id, data);
     }
 
     /**
@@ -841,7 +928,41 @@ DENG2_PIMPL(Partitioner)
 
     LineSegmentSide *choosePartition(LineSegmentBlockTreeNode &candidateSet)
     {
-        return PartitionEvaluator(splitCostFactor).choose(candidateSet);
+        PartitionEvaluator evaluator(splitCostFactor);
+
+        if(repeatingChoices)
+        {
+            if(nextChoice < choices.size())
+            {
+                PartitionChoice const &choice = choices.at(nextChoice);
+                if(choice.ordinal < 0)
+                {
+                    nextChoice++;
+                    return nullptr;
+                }
+                LineSegmentSide *partSeg = evaluator.candidate(candidateSet, choice.ordinal);
+                if(partSeg && partSeg->mapLine().indexInMap() == choice.lineIndex)
+                {
+                    nextChoice++;
+                    return partSeg;
+                }
+            }
+
+            // Evaluate the rest of the choices normally.
+            LOGDEV_MAP_WARNING("Cached BSP partitions do not match the map geometry");
+            repeatingChoices = false;
+        }
+
+        int ordinal;
+        LineSegmentSide *partSeg = evaluator.choose(candidateSet, &ordinal);
+
+        PartitionChoice const choice{ ordinal, partSeg? partSeg->mapLine().indexInMap() : -1 };
+        choices.resize(nextChoice);
+        choices.append(choice);
+        nextChoice++;
+        choicesChanged = true;
+
+        return partSeg;
     }
 
     /**
@@ -1140,6 +1261,10 @@ BspTree *Partitioner::makeBspTree(QSet<Line *> const &lines, Mesh &mesh)
 
     d->mesh = &mesh;
 
+    // Partitions chosen in an earlier build of the same geometry are reused.
+    Block const geometryId = d->geometryId();
+    d->readChoicesFromCache(geometryId);
+
     // Initialize vertex info for the initial set of vertexes.
     d->edgeTipSets.reserve(d->lines.count() * 2);
 
@@ -1167,6 +1292,16 @@ BspTree *Partitioner::makeBspTree(QSet<Line *> const &lines, Mesh &mesh)
 
     d->bspRoot = d->partitionSpace(blockTree);
 
+    if(d->choicesChanged || d->nextChoice != d->choices.size())
+    {
+        d->choices.resize(d->nextChoice);
+        d->updateCache(geometryId);
+    }
+    else
+    {
+        LOGDEV_MAP_VERBOSE("Used %i cached BSP partitions") << d->choices.size();
+    }
+
     // At this point we know that *something* useful was built.
     d->splitOverlappingSegments();
     d->buildSubspaceGeometries();
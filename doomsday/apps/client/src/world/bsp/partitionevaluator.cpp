@@ -23,10 +23,9 @@
 
 #include "world/bsp/partitionevaluator.h"
 
-#include <QList>
+#include <QVector>
 #include <de/Log>
 #include <de/String>
-#include <de/Task>
 #include <de/TaskPool>
 #include "world/bsp/partitioner.h"
 #include "world/clientserverworld.h" // validCount
@@ -184,212 +183,256 @@ DENG2_PIMPL_NOREF(PartitionEvaluator)
         LineSegmentSide *line;  ///< Candidate partition line.
         PartitionCost cost;     ///< Running cost metric total.
 
-        PartitionCandidate(LineSegmentSide &partition) : line(&partition)
+        PartitionCandidate(LineSegmentSide *partition = nullptr) : line(partition)
         {}
     };
-    typedef QList<PartitionCandidate *> Candidates;
+    typedef QVector<PartitionCandidate> Candidates;
     Candidates candidates;
 
-    PartitionCandidate *nextCandidate()
-    {
-        DENG2_ASSERT(costTaskPool.isDone());
-        if(candidates.isEmpty()) return nullptr;
-        return candidates.takeFirst();
-    }
-
-    class CostTask : public Task
+    /**
+     * Collects the partition candidates of the block tree, in the order they are
+     * evaluated.
+     */
+    void collectCandidates(LineSegmentBlockTreeNode &node)
     {
-    public:
-        Impl &evaluator;
-        PartitionCandidate &candidate;
+        rootNode = &node;
+        candidates.clear();
 
-        CostTask(Impl &evaluator, PartitionCandidate &candidate)
-            : evaluator(evaluator), candidate(candidate)
-        {}
+        // Increment valid count so we can avoid testing the line segments
+        // produced from a single line more than once per round of partition
+        // selection.
+        validCount++;
 
-        /**
-         * Evaluate the cost of the partition candidate.
-         *
-         * If the candidate is not suitable (or a better choice has already been
-         * determined) then @var partition is zeroed. Otherwise the candidate is
-         * suitable and @var cost contains valid costing metrics.
-         */
-        void runTask()
+        // Iterative pre-order traversal.
+        LineSegmentBlockTreeNode const *cur  = rootNode;
+        LineSegmentBlockTreeNode const *prev = nullptr;
+        while(cur)
         {
-            LineSegmentSide **partition = &candidate.line;
-            PartitionCost &cost         = candidate.cost;
-
-            costForBlock(*evaluator.rootNode);
-
-            // Make sure there is at least one map line segment on each side.
-            if(!cost.mapLeft || !cost.mapRight)
+            while(cur)
             {
-                //LOG_DEBUG("evaluate: No map line segments on %s%sside")
-                //        << (cost.mapLeft ? "" : "left ")
-                //        << (cost.mapRight? "" : "right ");
-                *partition = nullptr;
-                return;
-            }
-
-            // This is suitable for use as a partition.
+                LineSegmentBlock const &segs = *cur->userData();
 
-            // Increase cost by the difference between left and right.
-            cost.total += 100 * de::abs(cost.mapLeft - cost.mapRight);
+                // Test each line segment as a potential partition candidate.
+                for(LineSegmentSide *candidate : segs.all())
+                {
+                    //LOG_DEBUG("%sline segment %p sector:%d %s -> %s")
+                    //        << (candidate->hasMapLineSide()? "" : "mini-") << candidate
+                    //        << (candidate->sector? candidate->sector->indexInMap() : -1)
+                    //        << candidate->fromOrigin().asText()
+                    //        << candidate->toOrigin().asText();
+
+                    // Only map line segments are suitable candidates.
+                    if(!candidate->hasMapSide())
+                        continue;
+
+                    // Optimization: Only the first line segment produced from a
+                    // given line is tested per round of partition costing because
+                    // they are all collinear.
+                    if(candidate->mapLine().validCount() == validCount)
+                        continue; // Skip this.
+
+                    // Don't consider further segments of the candidate.
+                    candidate->mapLine().setValidCount(validCount);
+
+                    candidates << PartitionCandidate(candidate);
+                }
 
-            // Allow partition segment counts to affect the outcome.
-            cost.total += 50 * de::abs(cost.partLeft - cost.partRight);
+                if(prev == cur->parentPtr())
+                {
+                    // Descending - right first, then left.
+                    prev = cur;
+                    if(cur->hasRight()) cur = cur->rightPtr();
+                    else                cur = cur->leftPtr();
+                }
+                else if(prev == cur->rightPtr())
+                {
+                    // Last moved up the right branch - descend the left.
+                    prev = cur;
+                    cur = cur->leftPtr();
+                }
+                else if(prev == cur->leftPtr())
+                {
+                    // Last moved up the left branch - continue upward.
+                    prev = cur;
+                    cur = cur->parentPtr();
+                }
+            }
 
-            // Another little twist, here we show a slight preference for partition
-            // lines that lie either purely horizontally or purely vertically.
-            if((*partition)->slopeType() != ST_HORIZONTAL &&
-               (*partition)->slopeType() != ST_VERTICAL)
+            if(prev)
             {
-                cost.total += 25;
+                // No left child - back up.
+                cur = prev->parentPtr();
             }
         }
+    }
 
-    private:
-        void costForSegment(LineSegmentSide const &seg)
+    /**
+     * Evaluate the cost of the partition candidate.
+     *
+     * If the candidate is not suitable (or a better choice has already been
+     * determined) then @var partition is zeroed. Otherwise the candidate is
+     * suitable and @var cost contains valid costing metrics.
+     */
+    void evaluate(PartitionCandidate &candidate) const
+    {
+        LineSegmentSide **partition = &candidate.line;
+        PartitionCost &cost         = candidate.cost;
+
+        costForBlock(candidate, *rootNode);
+
+        // Make sure there is at least one map line segment on each side.
+        if(!cost.mapLeft || !cost.mapRight)
         {
-            LineSegmentSide **partition = &candidate.line;
-            PartitionCost &cost         = candidate.cost;
-            int const splitCostFactor   = evaluator.splitCostFactor;
-
-            /// Determine the relationship between @a seg and the partition plane.
-            coord_t fromDist, toDist;
-            LineRelationship rel = seg.relationship(**partition, &fromDist, &toDist);
-            switch(rel)
-            {
-            case Collinear: {
-                // This line segment runs along the same line as the partition.
-                // Check whether it goes in the same direction or the opposite.
-                if(seg.direction().dot((*partition)->direction()) < 0)
-                {
-                    cost.addSegmentLeft(seg);
-                }
-                else
-                {
-                    cost.addSegmentRight(seg);
-                }
-                break; }
+            //LOG_DEBUG("evaluate: No map line segments on %s%sside")
+            //        << (cost.mapLeft ? "" : "left ")
+            //        << (cost.mapRight? "" : "right ");
+            *partition = nullptr;
+            return;
+        }
 
-            case Right:
-            case RightIntercept: {
-                cost.addSegmentRight(seg);
+        // This is suitable for use as a partition.
 
-                /*
-                 * Near misses are bad, as they have the potential to result in
-                 * really short line segments being produced later on.
-                 *
-                 * The closer the near miss, the higher the cost.
-                 */
-                coord_t nearDist;
-                if(nearMiss(rel, fromDist, toDist, &nearDist))
-                {
-                    cost.nearMiss += 1;
-                    cost.total += int( 100 * splitCostFactor * (nearDist * nearDist - 1.0) );
-                }
-                break; }
+        // Increase cost by the difference between left and right.
+        cost.total += 100 * de::abs(cost.mapLeft - cost.mapRight);
 
-            case Left:
-            case LeftIntercept: {
-                cost.addSegmentLeft(seg);
+        // Allow partition segment counts to affect the outcome.
+        cost.total += 50 * de::abs(cost.partLeft - cost.partRight);
 
-                // Near miss?
-                coord_t nearDist;
-                if(nearMiss(rel, fromDist, toDist, &nearDist))
-                {
-                    /// @todo Why the cost multiplier imbalance between the left
-                    /// and right edge near misses?
-                    cost.nearMiss += 1;
-                    cost.total += int( 70 * splitCostFactor * (nearDist * nearDist - 1.0) );
-                }
-                break; }
-
-            case Intersects: {
-                cost.splits += 1;
-                cost.total  += 100 * splitCostFactor;
-
-                /*
-                 * If the split point is very close to one end, which is quite an
-                 * undesirable situation (producing really short edges), thus a
-                 * rather hefty surcharge.
-                 *
-                 * The closer to the edge, the higher the cost.
-                 */
-                coord_t nearDist;
-                if(nearEdge(fromDist, toDist, &nearDist))
-                {
-                    cost.iffy += 1;
-                    cost.total += int( 140 * splitCostFactor * (nearDist * nearDist - 1.0) );
-                }
-                break; }
-            }
+        // Another little twist, here we show a slight preference for partition
+        // lines that lie either purely horizontally or purely vertically.
+        if((*partition)->slopeType() != ST_HORIZONTAL &&
+           (*partition)->slopeType() != ST_VERTICAL)
+        {
+            cost.total += 25;
         }
+    }
+
+    void costForSegment(PartitionCandidate &candidate, LineSegmentSide const &seg) const
+    {
+        LineSegmentSide **partition = &candidate.line;
+        PartitionCost &cost         = candidate.cost;
 
-        /**
-         * Test the whole block against the partition line to quickly handle all the
-         * line segments within it at once. Only when the partition line intercepts
-         * the block do we need to go deeper into it.
-         */
-        void costForBlock(LineSegmentBlockTreeNode const &node)
+        /// Determine the relationship between @a seg and the partition plane.
+        coord_t fromDist, toDist;
+        LineRelationship rel = seg.relationship(**partition, &fromDist, &toDist);
+        switch(rel)
         {
-            LineSegmentBlock const &block    = *node.userData();
-            LineSegmentSide const *partition = candidate.line;
-            PartitionCost &cost              = candidate.cost;
-
-            /// @todo Why are we extending the bounding box for this test? Also,
-            /// there is no need to convert from integer to floating-point each
-            /// time this is tested. (If we intend to do this with floating-point
-            /// then we should return that representation in SuperBlock::bounds() ).
-            AABoxd bounds(coord_t( block.bounds().minX ) - SHORT_HEDGE_EPSILON * 1.5,
-                          coord_t( block.bounds().minY ) - SHORT_HEDGE_EPSILON * 1.5,
-                          coord_t( block.bounds().maxX ) + SHORT_HEDGE_EPSILON * 1.5,
-                          coord_t( block.bounds().maxY ) + SHORT_HEDGE_EPSILON * 1.5);
-
-            int side = partition->boxOnSide(bounds);
-            if(side > 0)
+        case Collinear: {
+            // This line segment runs along the same line as the partition.
+            // Check whether it goes in the same direction or the opposite.
+            if(seg.direction().dot((*partition)->direction()) < 0)
             {
-                // Right.
-                cost.mapRight  += block.mapCount();
-                cost.partRight += block.partCount();
-                return;
+                cost.addSegmentLeft(seg);
             }
-            if(side < 0)
+            else
             {
-                // Left.
-                cost.mapLeft  += block.mapCount();
-                cost.partLeft += block.partCount();
-                return;
+                cost.addSegmentRight(seg);
             }
-
-            for(LineSegmentSide *otherSeg : block.all())
+            break; }
+
+        case Right:
+        case RightIntercept: {
+            cost.addSegmentRight(seg);
+
+            /*
+             * Near misses are bad, as they have the potential to result in
+             * really short line segments being produced later on.
+             *
+             * The closer the near miss, the higher the cost.
+             */
+            coord_t nearDist;
+            if(nearMiss(rel, fromDist, toDist, &nearDist))
             {
-                costForSegment(*otherSeg);
+                cost.nearMiss += 1;
+                cost.total += int( 100 * splitCostFactor * (nearDist * nearDist - 1.0) );
             }
+            break; }
+
+        case Left:
+        case LeftIntercept: {
+            cost.addSegmentLeft(seg);
 
-            if(node.hasRight())
+            // Near miss?
+            coord_t nearDist;
+            if(nearMiss(rel, fromDist, toDist, &nearDist))
             {
-                costForBlock(*node.rightPtr());
+                /// @todo Why the cost multiplier imbalance between the left
+                /// and right edge near misses?
+                cost.nearMiss += 1;
+                cost.total += int( 70 * splitCostFactor * (nearDist * nearDist - 1.0) );
             }
-            if(node.hasLeft())
+            break; }
+
+        case Intersects: {
+            cost.splits += 1;
+            cost.total  += 100 * splitCostFactor;
+
+            /*
+             * If the split point is very close to one end, which is quite an
+             * undesirable situation (producing really short edges), thus a
+             * rather hefty surcharge.
+             *
+             * The closer to the edge, the higher the cost.
+             */
+            coord_t nearDist;
+            if(nearEdge(fromDist, toDist, &nearDist))
             {
-                costForBlock(*node.leftPtr());
+                cost.iffy += 1;
+                cost.total += int( 140 * splitCostFactor * (nearDist * nearDist - 1.0) );
             }
+            break; }
         }
-    };
-    TaskPool costTaskPool;
+    }
 
     /**
-     * @param line  Partition line to evaluate.
+     * Test the whole block against the partition line to quickly handle all the
+     * line segments within it at once. Only when the partition line intercepts
+     * the block do we need to go deeper into it.
      */
-    void beginPartitionCosting(LineSegmentSide *line)
+    void costForBlock(PartitionCandidate &candidate, LineSegmentBlockTreeNode const &node) const
     {
-        DENG2_ASSERT(line && line->hasMapSide());
-        // Run a new partition cost task.
-        PartitionCandidate *newCandidate = new PartitionCandidate(*line);
-        candidates << newCandidate;
-        costTaskPool.start(new CostTask(*this, *newCandidate));
+        LineSegmentBlock const &block    = *node.userData();
+        LineSegmentSide const *partition = candidate.line;
+        PartitionCost &cost              = candidate.cost;
+
+        /// @todo Why are we extending the bounding box for this test? Also,
+        /// there is no need to convert from integer to floating-point each
+        /// time this is tested. (If we intend to do this with floating-point
+        /// then we should return that representation in SuperBlock::bounds() ).
+        AABoxd bounds(coord_t( block.bounds().minX ) - SHORT_HEDGE_EPSILON * 1.5,
+                      coord_t( block.bounds().minY ) - SHORT_HEDGE_EPSILON * 1.5,
+                      coord_t( block.bounds().maxX ) + SHORT_HEDGE_EPSILON * 1.5,
+                      coord_t( block.bounds().maxY ) + SHORT_HEDGE_EPSILON * 1.5);
+
+        int side = partition->boxOnSide(bounds);
+        if(side > 0)
+        {
+            // Right.
+            cost.mapRight  += block.mapCount();
+            cost.partRight += block.partCount();
+            return;
+        }
+        if(side < 0)
+        {
+            // Left.
+            cost.mapLeft  += block.mapCount();
+            cost.partLeft += block.partCount();
+            return;
+        }
+
+        for(LineSegmentSide *otherSeg : block.all())
+        {
+            costForSegment(candidate, *otherSeg);
+        }
+
+        if(node.hasRight())
+        {
+            costForBlock(candidate, *node.rightPtr());
+        }
+        if(node.hasLeft())
+        {
+            costForBlock(candidate, *node.leftPtr());
+        }
     }
 };
 
@@ -398,104 +441,57 @@ PartitionEvaluator::PartitionEvaluator(int splitCostFactor) : d(new Impl)
     d->splitCostFactor = splitCostFactor;
 }
 
-LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node)
+LineSegmentSide *PartitionEvaluator::choose(LineSegmentBlockTreeNode &node, int *ordinal)
 {
     LOG_AS("PartitionEvaluator");
 
-    d->rootNode = &node;
-
-    // Increment valid count so we can avoid testing the line segments
-    // produced from a single line more than once per round of partition
-    // selection.
-    validCount++;
+    d->collectCandidates(node);
 
-    // Iterative pre-order traversal.
-    LineSegmentBlockTreeNode const *cur  = d->rootNode;
-    LineSegmentBlockTreeNode const *prev = nullptr;
-    while(cur)
+    // The candidates are evaluated concurrently, a few per task to keep the
+    // scheduling overhead low.
+    int const GRAIN_SIZE = 8;
+    TaskPool::parallelFor(Rangei(0, d->candidates.size()), [this] (int i)
     {
-        while(cur)
-        {
-            LineSegmentBlock const &segs = *cur->userData();
+        d->evaluate(d->candidates[i]);
+    }, GRAIN_SIZE);
 
-            // Test each line segment as a potential partition candidate.
-            for(LineSegmentSide *candidate : segs.all())
-            {
-                //LOG_DEBUG("%sline segment %p sector:%d %s -> %s")
-                //        << (candidate->hasMapLineSide()? "" : "mini-") << candidate
-                //        << (candidate->sector? candidate->sector->indexInMap() : -1)
-                //        << candidate->fromOrigin().asText()
-                //        << candidate->toOrigin().asText();
-
-                // Only map line segments are suitable candidates.
-                if(!candidate->hasMapSide())
-                    continue;
-
-                // Optimization: Only the first line segment produced from a
-                // given line is tested per round of partition costing because
-                // they are all collinear.
-                if(candidate->mapLine().validCount() == validCount)
-                    continue; // Skip this.
-
-                // Don't consider further segments of the candidate.
-                candidate->mapLine().setValidCount(validCount);
-
-                // Determine candidate suitability and cost.
-                d->beginPartitionCosting(candidate);
-            }
+    LineSegmentSide *best = nullptr;
+    PartitionCost bestCost;
+    int bestOrdinal = -1;
+    for(int i = 0; i < d->candidates.size(); ++i)
+    {
+        Impl::PartitionCandidate const &candidate = d->candidates.at(i);
 
-            if(prev == cur->parentPtr())
-            {
-                // Descending - right first, then left.
-                prev = cur;
-                if(cur->hasRight()) cur = cur->rightPtr();
-                else                cur = cur->leftPtr();
-            }
-            else if(prev == cur->rightPtr())
-            {
-                // Last moved up the right branch - descend the left.
-                prev = cur;
-                cur = cur->leftPtr();
-            }
-            else if(prev == cur->leftPtr())
-            {
-                // Last moved up the left branch - continue upward.
-                prev = cur;
-                cur = cur->parentPtr();
-            }
-        }
+        //LOG_DEBUG("%p: %s") << candidate.line << candidate.cost.asText();
 
-        if(prev)
+        if(candidate.line && (!best || candidate.cost < bestCost))
         {
-            // No left child - back up.
-            cur = prev->parentPtr();
+            // We have a new better choice.
+            best        = candidate.line;
+            bestCost    = candidate.cost;
+            bestOrdinal = i;
         }
     }
 
-    LineSegmentSide *best = nullptr;
-    if(!d->candidates.isEmpty())
-    {
-        d->costTaskPool.waitForDone();
-        PartitionCost bestCost;
-        while(Impl::PartitionCandidate *candidate = d->nextCandidate())
-        {
-            //LOG_DEBUG("%p: %s") << candidate->line << candidate->cost.asText();
+    //LOG_DEBUG("best %p score: %d.%02d")
+    //        << best << bestCost.total / 100 << bestCost.total % 100;
 
-            if(candidate->line && (!best || candidate->cost < bestCost))
-            {
-                // We have a new better choice.
-                best     = candidate->line;
-                bestCost = candidate->cost;
-            }
+    d->candidates.clear();
+    if(ordinal) *ordinal = bestOrdinal;
+    return best;
+}
 
-            delete candidate;
-        }
+LineSegmentSide *PartitionEvaluator::candidate(LineSegmentBlockTreeNode &node, int ordinal)
+{
+    d->collectCandidates(node);
 
-        //LOG_DEBUG("best %p score: %d.%02d")
-        //        << best << bestCost.total / 100 << bestCost.total % 100;
+    LineSegmentSide *found = nullptr;
+    if(ordinal >= 0 && ordinal < d->candidates.size())
+    {
+        found = d->candidates.at(ordinal).line;
     }
-
-    return best;
+    d->candidates.clear();
+    return found;
 }
 
 }  // namespace bsp
@@ -82,6 +82,18 @@ public:
      */
     size_t read(uint8_t *buffer, size_t count);
 
+    /**
+     * Provides direct read-only access to the contents of the file, without copying.
+     * Native files are memory-mapped when first accessed; the mapping remains valid
+     * until the handle is closed. Buffered lumps return the buffered data.
+     *
+     * @param length  If not @c nullptr, the number of accessible bytes is written here.
+     *
+     * @return  Contents of the file starting from baseOffset(); otherwise @c nullptr
+     * if the file cannot be accessed directly.
+     */
+    uint8_t const *mappedData(size_t *length = nullptr);
+
     /**
      * Read a character from the stream, advancing the read position in the process.
      */
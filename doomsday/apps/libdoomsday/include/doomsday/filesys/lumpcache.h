@@ -24,11 +24,33 @@
 #include "dd_types.h"
 #include <vector>
 
+struct LumpCacheState;
+
 /**
+ * Cache for lump data. All the caches share a common memory budget: when the
+ * total size of the cached data exceeds the budget, the least recently used
+ * unlocked lumps are released. A lump is locked when it is inserted or retrieved
+ * with data(), and it remains locked until unlock() has been called once for each
+ * of these.
+ *
+ * The caches are thread-safe.
+ *
  * @ingroup fs
  */
 class LIBDOOMSDAY_PUBLIC LumpCache
 {
+public:
+    /// Cache usage statistics (for all caches).
+    struct Stats
+    {
+        size_t budget;         ///< Maximum number of bytes for unlocked data.
+        size_t bytes;          ///< Total number of bytes cached.
+        size_t lockedBytes;    ///< Number of bytes in locked lumps.
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+    };
+
 private:
     /**
      * Data item. Represents a lump of data in the cache.
@@ -36,13 +58,18 @@ private:
     class Data
     {
     public:
-        explicit Data(uint8_t *data = 0);
+        Data();
+        Data(Data const &) = delete;
 
         ~Data();
 
         uint8_t *data() const;
 
-        uint8_t const *replaceData(uint8_t *newData);
+        size_t size() const;
+
+        bool isLocked() const;
+
+        void replaceData(uint8_t *newData, size_t size);
 
         Data &clearData(bool *retCleared = 0);
 
@@ -51,7 +78,13 @@ private:
         Data &unlock();
 
     private:
+        friend struct ::LumpCacheState;
+
         uint8_t *data_;
+        size_t size_;
+        uint locks_;  ///< Number of holders; the data is not released while nonzero.
+        Data *prev_;  ///< Previous unlocked item (less recently used).
+        Data *next_;  ///< Next unlocked item (more recently used).
     };
     typedef std::vector<Data> DataCache;
 
@@ -63,11 +96,29 @@ public:
 
     bool isValidIndex(uint idx) const;
 
-    uint8_t const *data(uint lumpIdx) const;
+    /**
+     * Returns the cached data of a lump, locking it. Counted as a cache hit or
+     * a miss.
+     */
+    uint8_t const *data(uint lumpIdx);
 
-    LumpCache &insert(uint lumpIdx, uint8_t *data);
+    /**
+     * Copies a section of a cached lump to @a buffer.
+     *
+     * @return  Number of bytes copied. Zero if the lump is not cached.
+     */
+    size_t read(uint lumpIdx, uint8_t *buffer, size_t startOffset, size_t length);
+
+    /**
+     * Inserts the data of a lump into the cache. The lump is locked.
+     *
+     * @param lumpIdx  Lump index.
+     * @param data     Data allocated from the memory zone. Ownership given.
+     * @param size     Size of the data in bytes.
+     */
+    LumpCache &insert(uint lumpIdx, uint8_t *data, size_t size);
 
-    LumpCache &insertAndLock(uint lumpIdx, uint8_t *data);
+    LumpCache &insertAndLock(uint lumpIdx, uint8_t *data, size_t size);
 
     LumpCache &lock(uint lumpIdx);
 
@@ -77,6 +128,17 @@ public:
 
     LumpCache &clear();
 
+public:
+    /**
+     * Sets the maximum number of bytes all the caches may use for unlocked lumps.
+     * Unlocked lumps are released immediately if needed.
+     */
+    static void setBudget(size_t bytes);
+
+    static size_t budget();
+
+    static Stats stats();
+
 protected:
     Data *cacheRecord(uint lumpIdx);
 
@@ -31,6 +31,7 @@
 
 #include <QList>
 #include <de/Error>
+#include <de/TaskPool>
 
 namespace de {
 
@@ -126,6 +127,15 @@ public:
          */
         lumpnum_t lastLump() const;
 
+        /**
+         * Starts reading the recognized map data lumps into memory in the background
+         * so that they are readily available when the map is loaded.
+         *
+         * @param tasks  Pool for the background task. The caller must wait for the
+         *               pool to finish before the lumps are unloaded.
+         */
+        void prefetch(TaskPool &tasks) const;
+
     public:
         /**
          * Returns the textual name for the identified map format @a id.
@@ -238,7 +238,7 @@ public:
      *
      * @return  @c true if successful.
      */
-    static bool uncompressRaw(uint8_t *in, size_t inSize, uint8_t *out, size_t outSize);
+    static bool uncompressRaw(uint8_t const *in, size_t inSize, uint8_t *out, size_t outSize);
 
     /**
      * Compresses a block of data using zlib with the default/balanced compression level.
@@ -42,6 +42,11 @@ public:
 
     void clear();
 
+    /**
+     * Adds a new set of sprite frames. The frames are looked up from a compiled,
+     * index-addressed table that is rebuilt after sets have been added, so the
+     * returned set should not be modified afterwards.
+     */
     SpriteSet &addSpriteSet(spritenum_t id, SpriteSet const &frames);
 
     /**
@@ -51,11 +56,12 @@ public:
     bool hasSprite(spritenum_t id, de::dint frame) const;
 
     /**
-     * Lookup a Sprite by it's unique @a id and @a frame number.
+     * Lookup a Sprite by it's unique @a id and @a frame number. The sprite is
+     * read-only; sprite sets are changed with addSpriteSet().
      *
      * @see hasSprite(), spritePtr()
      */
-    defn::CompiledSpriteRecord &sprite(spritenum_t id, de::dint frame);
+    defn::CompiledSpriteRecord const &sprite(spritenum_t id, de::dint frame) const;
         
     /**
      * Returns a pointer to the identified Sprite, or @c nullptr.
@@ -28,10 +28,13 @@
 #include <ctime>
 #include <sys/stat.h>
 
+#include <de/c_wrapper.h>
 #include <de/memory.h>
 #include <de/memoryblockset.h>
 #include <de/LogBuffer>
 #include <de/NativePath>
+#include <QFile>
+#include <QScopedPointer>
 
 namespace de {
 
@@ -58,12 +61,52 @@ DENG2_PIMPL_NOREF(FileHandle)
     uint8_t *data;
     uint8_t *pos;
 
+    /// Memory mapping of a native file (starting at baseOffset).
+    QScopedPointer<QFile> mappedFile;
+    uchar *mapped;
+    size_t mappedSize;
+    bool mapAttempted;
+
     Impl() : file(0), list(0), baseOffset(0), hndl(0), size(0), data(0), pos(0)
+           , mapped(0), mappedSize(0), mapAttempted(false)
     {
         flags.eof  = false;
         flags.open = false;
         flags.reference = false;
     }
+
+    void map()
+    {
+        mapAttempted = true;
+
+        // Mapping can be disabled for comparing load times.
+        if (CommandLine_Exists("-nommap")) return;
+
+        QScopedPointer<QFile> nativeFile(new QFile);
+        if (!nativeFile->open(hndl, QIODevice::ReadOnly, QFile::DontCloseHandle)) return;
+
+        qint64 const fileSize = nativeFile->size();
+        if (fileSize <= qint64(baseOffset)) return;
+
+        mapped = nativeFile->map(qint64(baseOffset), fileSize - qint64(baseOffset));
+        if (mapped)
+        {
+            mappedSize = size_t(fileSize) - baseOffset;
+            mappedFile.reset(nativeFile.take());
+        }
+    }
+
+    void unmap()
+    {
+        if (mappedFile)
+        {
+            mappedFile->unmap(mapped);
+            mappedFile.reset();
+        }
+        mapped       = 0;
+        mappedSize   = 0;
+        mapAttempted = false;
+    }
 };
 
 static void errorIfNotValid(FileHandle const &file, char const * /*callerName*/)
@@ -90,6 +133,7 @@ FileHandle::~FileHandle()
 FileHandle &FileHandle::close()
 {
     if (!d->flags.open) return *this;
+    d->unmap();
     if (d->hndl)
     {
         fclose(d->hndl); d->hndl = 0;
@@ -200,6 +244,23 @@ size_t FileHandle::read(uint8_t *buffer, size_t count)
     }
 }
 
+uint8_t const *FileHandle::mappedData(size_t *length)
+{
+    errorIfNotValid(*this, "FileHandle::mappedData");
+    if (d->flags.reference)
+    {
+        return d->file->handle().mappedData(length);
+    }
+    if (d->hndl)
+    {
+        if (!d->mapAttempted) d->map();
+        if (length) *length = d->mappedSize;
+        return d->mapped;
+    }
+    if (length) *length = (d->data? d->size : 0);
+    return d->data;
+}
+
 bool FileHandle::atEnd()
 {
     errorIfNotValid(*this, "FileHandle::atEnd");
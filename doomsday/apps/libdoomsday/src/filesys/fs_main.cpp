@@ -25,9 +25,11 @@
 #include "doomsday/filesys/fs_util.h"
 #include "doomsday/console/exec.h"
 #include "doomsday/console/cmd.h"
+#include "doomsday/console/var.h"
 #include "doomsday/filesys/file.h"
 #include "doomsday/filesys/fileid.h"
 #include "doomsday/filesys/fileinfo.h"
+#include "doomsday/filesys/lumpcache.h"
 #include "doomsday/filesys/lumpindex.h"
 #include "doomsday/filesys/wad.h"
 #include "doomsday/filesys/zip.h"
@@ -49,6 +51,8 @@ extern uint F_GetLastModified(char const *path);
 
 static FS1 *fileSystem;
 
+static int lumpCacheBudget = 128; ///< Megabytes (cvar).
+
 typedef QList<FileId> FileIds;
 
 /**
@@ -1241,8 +1245,33 @@ D_CMD(ListFiles)
     return true;
 }
 
+/// Print statistics about the lump caches.
+D_CMD(LumpCacheStats)
+{
+    DENG2_UNUSED3(src, argc, argv);
+
+    LumpCache::Stats const st = LumpCache::stats();
+    uint64_t const lookups = st.hits + st.misses;
+
+    LOG_RES_MSG(_E(b) "Lump cache:");
+    LOG_RES_MSG("  Cached: " _E(>) "%.1f MB (%.1f MB locked)")
+            << st.bytes / 1048576.0 << st.lockedBytes / 1048576.0;
+    LOG_RES_MSG("  Budget: " _E(>) "%.1f MB") << st.budget / 1048576.0;
+    LOG_RES_MSG("  Hits: " _E(>) "%i of %i lookups (%.1f%%)")
+            << st.hits << lookups << (lookups? 100.0 * st.hits / lookups : 0.0);
+    LOG_RES_MSG("  Evictions: " _E(>) "%i") << st.evictions;
+    return true;
+}
+
+static void lumpCacheBudgetChanged()
+{
+    LumpCache::setBudget(size_t(de::max(0, lumpCacheBudget)) * 1024 * 1024);
+}
+
 void FS1::consoleRegister()
 {
+    C_VAR_INT2("fs-cache-size", &lumpCacheBudget, 0, 0, 4096, lumpCacheBudgetChanged);
+
     C_CMD("dir", "",   Dir);
     C_CMD("ls",  "",   Dir); // Alias
     C_CMD("dir", "s*", Dir);
@@ -1251,6 +1280,7 @@ void FS1::consoleRegister()
     C_CMD("dump",      "s", DumpLump);
     C_CMD("listfiles", "",  ListFiles);
     C_CMD("listlumps", "",  ListLumps);
+    C_CMD("lumpcache", "",  LumpCacheStats);
 }
 
 FS1 &App_FileSystem()
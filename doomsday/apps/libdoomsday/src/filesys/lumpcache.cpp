@@ -21,12 +21,81 @@
 #include <de/memory.h>
 #include <de/memoryzone.h>
 #include <de/Error>
+#include <de/Guard>
+#include <de/Lockable>
 #include <de/Log>
+#include <cstring>
 
 using namespace de;
 
-LumpCache::Data::Data(uint8_t *data)
-    : data_(data)
+/**
+ * State shared by all the lump caches.
+ */
+struct LumpCacheState : public Lockable
+{
+    typedef LumpCache::Data Data;
+
+    size_t budget      = 128 * 1024 * 1024;
+    size_t bytes       = 0;
+    size_t lockedBytes = 0;
+    uint64_t hits      = 0;
+    uint64_t misses    = 0;
+    uint64_t evictions = 0;
+
+    Data *leastRecent = nullptr;  ///< First unlocked item.
+    Data *mostRecent  = nullptr;  ///< Last unlocked item.
+
+    static LumpCacheState &get()
+    {
+        static LumpCacheState state;
+        return state;
+    }
+
+    void append(Data &item)
+    {
+        DENG2_ASSERT(!item.prev_ && !item.next_);
+        item.prev_ = mostRecent;
+        if (mostRecent) mostRecent->next_ = &item;
+        else            leastRecent = &item;
+        mostRecent = &item;
+    }
+
+    void remove(Data &item)
+    {
+        if (item.prev_) item.prev_->next_ = item.next_;
+        else if (leastRecent == &item) leastRecent = item.next_;
+        if (item.next_) item.next_->prev_ = item.prev_;
+        else if (mostRecent == &item) mostRecent = item.prev_;
+        item.prev_ = item.next_ = nullptr;
+    }
+
+    /**
+     * Releases the least recently used unlocked items until the unlocked data
+     * fits in the budget.
+     */
+    void evict()
+    {
+        while (leastRecent && bytes - lockedBytes > budget)
+        {
+            Data &item = *leastRecent;
+            remove(item);
+
+            bytes -= item.size_;
+            if (item.data_) Z_Free(item.data_);
+            item.data_ = nullptr;
+            item.size_ = 0;
+
+            evictions++;
+        }
+    }
+};
+
+LumpCache::Data::Data()
+    : data_(0)
+    , size_(0)
+    , locks_(0)
+    , prev_(0)
+    , next_(0)
 {}
 
 LumpCache::Data::~Data()
@@ -36,24 +105,33 @@ LumpCache::Data::~Data()
 
 uint8_t *LumpCache::Data::data() const
 {
-    if (data_ && Z_GetTag(data_) == PU_PURGELEVEL)
-    {
-        // Reaquire the data.
-        Z_ChangeTag2(data_, PU_APPSTATIC);
-        Z_ChangeUser(data_, (void*)&data_);
-    }
     return data_;
 }
 
-uint8_t const *LumpCache::Data::replaceData(uint8_t *newData)
+size_t LumpCache::Data::size() const
+{
+    return size_;
+}
+
+bool LumpCache::Data::isLocked() const
+{
+    return locks_ > 0;
+}
+
+void LumpCache::Data::replaceData(uint8_t *newData, size_t size)
 {
     clearData();
-    data_ = newData;
-    if (data_)
+    if (newData)
     {
+        data_   = newData;
+        size_   = size;
+        locks_  = 1;
         Z_ChangeUser(data_, &data_);
+
+        auto &state = LumpCacheState::get();
+        state.bytes       += size_;
+        state.lockedBytes += size_;
     }
-    return newData;
 }
 
 LumpCache::Data &LumpCache::Data::clearData(bool *retCleared)
@@ -61,16 +139,30 @@ LumpCache::Data &LumpCache::Data::clearData(bool *retCleared)
     bool hasData = !!data_;
     if (hasData)
     {
-        /// @todo Implement a proper thread-safe locking mechanism.
+        auto &state = LumpCacheState::get();
+        state.bytes -= size_;
+        if (locks_)
+        {
+            state.lockedBytes -= size_;
 
-        // Elevate the cached data to purge level so it will be explicitly
-        // free'd by the Zone the next time the rover passes it.
-        if (Z_GetTag(data_) != PU_PURGELEVEL)
+            // Someone may still be using the data. Elevate the data to purge
+            // level so it will be explicitly free'd by the Zone the next time
+            // the rover passes it.
+            if (Z_GetTag(data_) != PU_PURGELEVEL)
+            {
+                Z_ChangeTag2(data_, PU_PURGELEVEL);
+            }
+            // Mark the data as unowned.
+            Z_ChangeUser(data_, (void *) 0x2);
+        }
+        else
         {
-            Z_ChangeTag2(data_, PU_PURGELEVEL);
+            state.remove(*this);
+            Z_Free(data_);
         }
-        // Mark the data as unowned.
-        Z_ChangeUser(data_, (void *) 0x2);
+        data_   = 0;
+        size_   = 0;
+        locks_  = 0;
     }
     if (retCleared) *retCleared = hasData;
     return *this;
@@ -78,16 +170,26 @@ LumpCache::Data &LumpCache::Data::clearData(bool *retCleared)
 
 LumpCache::Data &LumpCache::Data::lock()
 {
-    /// @todo Implement a proper thread-safe locking mechanism.
+    if (!data_) return *this;
+    if (!locks_++)
+    {
+        auto &state = LumpCacheState::get();
+        state.remove(*this);
+        state.lockedBytes += size_;
+    }
     return *this;
 }
 
 LumpCache::Data &LumpCache::Data::unlock()
 {
-    /// @todo Implement a proper thread-safe locking mechanism.
-    if (data_)
+    if (!data_ || !locks_) return *this;
+    if (!--locks_)
     {
-        Z_ChangeTag2(data_, PU_PURGELEVEL);
+        // Released by the last holder; can now be evicted.
+        auto &state = LumpCacheState::get();
+        state.lockedBytes -= size_;
+        state.append(*this);
+        state.evict();
     }
     return *this;
 }
@@ -97,6 +199,7 @@ LumpCache::LumpCache(uint size) : _size(size), _dataCache(0)
 
 LumpCache::~LumpCache()
 {
+    DENG2_GUARD_FOR(LumpCacheState::get(), G);
     if (_dataCache) delete _dataCache;
 }
 
@@ -110,18 +213,54 @@ bool LumpCache::isValidIndex(uint idx) const
     return idx < _size;
 }
 
-uint8_t const *LumpCache::data(uint lumpIdx) const
+uint8_t const *LumpCache::data(uint lumpIdx)
 {
     LOG_AS("LumpCache::data");
-    Data const* record = cacheRecord(lumpIdx);
-    return record? record->data() : 0;
+    auto &state = LumpCacheState::get();
+    DENG2_GUARD(state);
+
+    Data *record = cacheRecord(lumpIdx);
+    if (record && record->data())
+    {
+        state.hits++;
+        return record->lock().data();
+    }
+    state.misses++;
+    return 0;
 }
 
-LumpCache &LumpCache::insert(uint lumpIdx, uint8_t *data)
+size_t LumpCache::read(uint lumpIdx, uint8_t *buffer, size_t startOffset, size_t length)
+{
+    auto &state = LumpCacheState::get();
+    DENG2_GUARD(state);
+
+    Data *record = cacheRecord(lumpIdx);
+    if (!record || !record->data() || startOffset >= record->size())
+    {
+        state.misses++;
+        return 0;
+    }
+    state.hits++;
+
+    if (!record->isLocked())
+    {
+        // Now the most recently used.
+        state.remove(*record);
+        state.append(*record);
+    }
+
+    size_t const readBytes = de::min(record->size() - startOffset, length);
+    std::memcpy(buffer, record->data() + startOffset, readBytes);
+    return readBytes;
+}
+
+LumpCache &LumpCache::insert(uint lumpIdx, uint8_t *data, size_t size)
 {
     LOG_AS("LumpCache::insert");
     if (!isValidIndex(lumpIdx)) throw Error("LumpCache::insert", QString("Invalid index %1").arg(lumpIdx));
 
+    DENG2_GUARD_FOR(LumpCacheState::get(), G);
+
     // Time to allocate the data cache?
     if (!_dataCache)
     {
@@ -129,21 +268,24 @@ LumpCache &LumpCache::insert(uint lumpIdx, uint8_t *data)
     }
 
     Data *record = cacheRecord(lumpIdx);
-    record->replaceData(data);
+    record->replaceData(data, size);
     return *this;
 }
 
-LumpCache &LumpCache::insertAndLock(uint lumpIdx, uint8_t *data)
+LumpCache &LumpCache::insertAndLock(uint lumpIdx, uint8_t *data, size_t size)
 {
-    return insert(lumpIdx, data).lock(lumpIdx);
+    return insert(lumpIdx, data, size).lock(lumpIdx);
 }
 
 LumpCache &LumpCache::lock(uint lumpIdx)
 {
     LOG_AS("LumpCache::lock");
     if (!isValidIndex(lumpIdx)) throw Error("LumpCache::lock", QString("Invalid index %1").arg(lumpIdx));
-    Data* record = cacheRecord(lumpIdx);
-    record->lock();
+    DENG2_GUARD_FOR(LumpCacheState::get(), G);
+    if (Data *record = cacheRecord(lumpIdx))
+    {
+        record->lock();
+    }
     return *this;
 }
 
@@ -151,13 +293,17 @@ LumpCache &LumpCache::unlock(uint lumpIdx)
 {
     LOG_AS("LumpCache::unlock");
     if (!isValidIndex(lumpIdx)) throw Error("LumpCache::unlock", QString("Invalid index %1").arg(lumpIdx));
-    Data* record = cacheRecord(lumpIdx);
-    record->unlock();
+    DENG2_GUARD_FOR(LumpCacheState::get(), G);
+    if (Data *record = cacheRecord(lumpIdx))
+    {
+        record->unlock();
+    }
     return *this;
 }
 
 LumpCache &LumpCache::remove(uint lumpIdx, bool *retRemoved)
 {
+    DENG2_GUARD_FOR(LumpCacheState::get(), G);
     Data *record = cacheRecord(lumpIdx);
     if (record)
     {
@@ -172,6 +318,7 @@ LumpCache &LumpCache::remove(uint lumpIdx, bool *retRemoved)
 
 LumpCache &LumpCache::clear()
 {
+    DENG2_GUARD_FOR(LumpCacheState::get(), G);
     if (_dataCache)
     {
         DENG2_FOR_EACH(DataCache, i, *_dataCache)
@@ -182,6 +329,35 @@ LumpCache &LumpCache::clear()
     return *this;
 }
 
+void LumpCache::setBudget(size_t bytes) // static
+{
+    auto &state = LumpCacheState::get();
+    DENG2_GUARD(state);
+    state.budget = bytes;
+    state.evict();
+}
+
+size_t LumpCache::budget() // static
+{
+    auto &state = LumpCacheState::get();
+    DENG2_GUARD(state);
+    return state.budget;
+}
+
+LumpCache::Stats LumpCache::stats() // static
+{
+    auto &state = LumpCacheState::get();
+    DENG2_GUARD(state);
+    Stats st;
+    st.budget      = state.budget;
+    st.bytes       = state.bytes;
+    st.lockedBytes = state.lockedBytes;
+    st.hits        = state.hits;
+    st.misses      = state.misses;
+    st.evictions   = state.evictions;
+    return st;
+}
+
 LumpCache::Data *LumpCache::cacheRecord(uint lumpIdx)
 {
     if (!isValidIndex(lumpIdx)) return 0;
@@ -224,6 +224,34 @@ lumpnum_t LumpIndex::Id1MapRecognizer::lastLump() const
     return d->lastLump;
 }
 
+void LumpIndex::Id1MapRecognizer::prefetch(TaskPool &tasks) const
+{
+    if (d->lumps.isEmpty()) return;
+
+    QList<File1 *> const files = d->lumps.values();
+    tasks.start([files] ()
+    {
+        for (File1 *file : files)
+        {
+            // Compressed lumps are decompressed into the lump cache; otherwise
+            // the data is read from the (memory-mapped) container.
+            uint8_t const *data = file->cache();
+            size_t const size   = file->size();
+
+            // Touch each page so that it will be resident.
+            volatile uint8_t sum = 0;
+            for (size_t pos = 0; pos < size; pos += 4096)
+            {
+                sum += data[pos];
+            }
+            DENG2_UNUSED(sum);
+
+            // Only releases the lock taken above; other holders keep theirs.
+            file->unlock();
+        }
+    }, TaskPool::MediumPriority);
+}
+
 String const &LumpIndex::Id1MapRecognizer::formatName(Format id) // static
 {
     static String const names[1 + KnownFormatCount] = {
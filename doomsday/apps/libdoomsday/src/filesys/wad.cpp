@@ -25,6 +25,7 @@
 #include "doomsday/DoomsdayApp"
 #include "doomsday/filesys/lumpcache.h"
 #include <de/ByteOrder>
+#include <de/Guard>
 #include <de/NativePath>
 #include <de/LogBuffer>
 #include <de/memoryzone.h>
@@ -173,12 +174,24 @@ Wad &Wad::LumpFile::wad() const
     return container().as<Wad>();
 }
 
-DENG2_PIMPL_NOREF(Wad)
+DENG2_PIMPL_NOREF(Wad), public Lockable
 {
     LumpTree entries;                     ///< Directory structure and entry records for all lumps.
     QScopedPointer<LumpCache> dataCache;  ///< Data payload cache.
 
     Impl() : entries(PathTree::MultiLeaf) {}
+
+    /**
+     * Returns the data of a lump in the memory-mapped WAD file, or @c nullptr if
+     * the file is not mapped or the lump is truncated.
+     */
+    uint8_t const *mappedLump(FileHandle &handle, FileInfo const &info)
+    {
+        size_t mappedSize;
+        uint8_t const *mapped = handle.mappedData(&mappedSize);
+        if (!mapped || info.baseOffset + info.size > mappedSize) return nullptr;
+        return mapped + info.baseOffset;
+    }
 };
 
 Wad::Wad(FileHandle &hndl, String path, FileInfo const &info, File1 *container)
@@ -229,6 +242,7 @@ Wad::~Wad()
 void Wad::clearCachedLump(int lumpIndex, bool *retCleared)
 {
     LOG_AS("Wad::clearCachedLump");
+    DENG2_GUARD(d);
 
     if (retCleared) *retCleared = false;
 
@@ -248,6 +262,7 @@ void Wad::clearCachedLump(int lumpIndex, bool *retCleared)
 void Wad::clearLumpCache()
 {
     LOG_AS("Wad::clearLumpCache");
+    DENG2_GUARD(d);
     if (!d->dataCache.isNull())
     {
         d->dataCache->clear();
@@ -257,6 +272,7 @@ void Wad::clearLumpCache()
 uint8_t const *Wad::cacheLump(int lumpIndex)
 {
     LOG_AS("Wad::cacheLump");
+    DENG2_GUARD(d);
 
     LumpFile const &lumpFile = static_cast<LumpFile &>(lump(lumpIndex));
     LOGDEV_RES_XVERBOSE("\"%s:%s\" (%u bytes%s)",
@@ -265,6 +281,12 @@ uint8_t const *Wad::cacheLump(int lumpIndex)
             << (unsigned long) lumpFile.info().size
             << (lumpFile.info().isCompressed()? ", compressed" : ""));
 
+    // WAD lumps are never compressed so they can be accessed in the mapped file.
+    if (uint8_t const *mapped = d->mappedLump(*handle_, lumpFile.info()))
+    {
+        return mapped;
+    }
+
     // Time to create the cache?
     if (d->dataCache.isNull())
     {
@@ -278,7 +300,7 @@ uint8_t const *Wad::cacheLump(int lumpIndex)
     if (!region) throw Error("Wad::cacheLump", QString("Failed on allocation of %1 bytes for cache copy of lump #%2").arg(lumpFile.info().size).arg(lumpIndex));
 
     readLump(lumpIndex, region, false);
-    d->dataCache->insert(lumpIndex, region);
+    d->dataCache->insert(lumpIndex, region, lumpFile.info().size);
 
     return region;
 }
@@ -286,6 +308,7 @@ uint8_t const *Wad::cacheLump(int lumpIndex)
 void Wad::unlockLump(int lumpIndex)
 {
     LOG_AS("Wad::unlockLump");
+    DENG2_GUARD(d);
     LOGDEV_RES_XVERBOSE("\"%s:%s\"",
                         NativePath(composePath()).pretty() <<
                         NativePath(lump(lumpIndex).composePath()).pretty());
@@ -313,6 +336,7 @@ size_t Wad::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     size_t length, bool tryCache)
 {
     LOG_AS("Wad::readLump");
+    DENG2_GUARD(d);
 
     LumpFile const &lumpFile = static_cast<LumpFile &>(lump(lumpIndex));
     LOGDEV_RES_XVERBOSE("\"%s:%s\" (%u bytes%s) [%u +%u]",
@@ -326,13 +350,17 @@ size_t Wad::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     // Try to avoid a file system read by checking for a cached copy.
     if (tryCache)
     {
-        uint8_t const *data = (!d->dataCache.isNull() ? d->dataCache->data(lumpIndex) : 0);
-        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (data? "hit" : "miss") << lumpIndex);
-        if (data)
+        size_t const readBytes = (!d->dataCache.isNull()? d->dataCache->read(lumpIndex, buffer, startOffset, length) : 0);
+        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (readBytes? "hit" : "miss") << lumpIndex);
+        if (readBytes) return readBytes;
+    }
+
+    if (uint8_t const *mapped = d->mappedLump(*handle_, lumpFile.info()))
+    {
+        if (startOffset + length <= lumpFile.info().size)
         {
-            size_t readBytes = de::min(size_t(lumpFile.size()), length);
-            std::memcpy(buffer, data + startOffset, readBytes);
-            return readBytes;
+            std::memcpy(buffer, mapped + startOffset, length);
+            return length;
         }
     }
 
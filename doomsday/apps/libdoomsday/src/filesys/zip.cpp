@@ -30,6 +30,7 @@
 
 #include <de/App>
 #include <de/ByteOrder>
+#include <de/Guard>
 #include <de/NativePath>
 #include <de/LogBuffer>
 #include <de/memory.h>
@@ -316,7 +317,7 @@ Zip &Zip::LumpFile::zip() const
     return container().as<Zip>();
 }
 
-DENG2_PIMPL(Zip)
+DENG2_PIMPL(Zip), public Lockable
 {
     LumpTree entries;                     ///< Directory structure and entry records for all lumps.
     QScopedPointer<LumpCache> dataCache;  ///< Data payload cache.
@@ -324,6 +325,19 @@ DENG2_PIMPL(Zip)
     Impl(Public *i) : Base(i)
     {}
 
+    /**
+     * Returns the (possibly compressed) data of a lump in the memory-mapped ZIP
+     * file, or @c nullptr if the file is not mapped or the lump is truncated.
+     */
+    uint8_t const *mappedLump(FileInfo const &info)
+    {
+        size_t const storedSize = (info.isCompressed()? info.compressedSize : info.size);
+        size_t mappedSize;
+        uint8_t const *mapped = self().handle_->mappedData(&mappedSize);
+        if (!mapped || info.baseOffset + storedSize > mappedSize) return nullptr;
+        return mapped + info.baseOffset;
+    }
+
     /**
      * @param lump      Lump/file to be buffered.
      * @param buffer    Must be large enough to hold the entire uncompressed data lump.
@@ -334,6 +348,22 @@ DENG2_PIMPL(Zip)
         LOG_AS("Zip");
 
         FileInfo const &lumpInfo = lump.info();
+
+        if (uint8_t const *mapped = mappedLump(lumpInfo))
+        {
+            if (lumpInfo.isCompressed())
+            {
+                // Uncompress straight from the mapped file.
+                if (!uncompressRaw(mapped, lumpInfo.compressedSize, buffer, lumpInfo.size))
+                    return 0; // Inflate failed.
+            }
+            else
+            {
+                std::memcpy(buffer, mapped, lumpInfo.size);
+            }
+            return lumpInfo.size;
+        }
+
         self().handle_->seek(lumpInfo.baseOffset, SeekSet);
 
         if (lumpInfo.isCompressed())
@@ -532,6 +562,7 @@ Zip::~Zip()
 void Zip::clearCachedLump(int lumpIndex, bool *retCleared)
 {
     LOG_AS("Zip::clearCachedLump");
+    DENG2_GUARD(d);
 
     if (retCleared) *retCleared = false;
 
@@ -551,6 +582,7 @@ void Zip::clearCachedLump(int lumpIndex, bool *retCleared)
 void Zip::clearLumpCache()
 {
     LOG_AS("Zip::clearLumpCache");
+    DENG2_GUARD(d);
     if (!d->dataCache.isNull())
     {
         d->dataCache->clear();
@@ -560,6 +592,7 @@ void Zip::clearLumpCache()
 uint8_t const *Zip::cacheLump(int lumpIndex)
 {
     LOG_AS("Zip::cacheLump");
+    DENG2_GUARD(d);
 
     LumpFile &lumpFile = static_cast<LumpFile &>(lump(lumpIndex));
     LOGDEV_RES_XVERBOSE("\"%s:%s\" (%u bytes%s)",
@@ -568,6 +601,16 @@ uint8_t const *Zip::cacheLump(int lumpIndex)
                         << (unsigned long) lumpFile.info().size
                         << (lumpFile.info().isCompressed()? ", compressed" : ""));
 
+    // Stored lumps can be accessed in the mapped file; only the decompressed
+    // ones need to be cached.
+    if (!lumpFile.info().isCompressed())
+    {
+        if (uint8_t const *mapped = d->mappedLump(lumpFile.info()))
+        {
+            return mapped;
+        }
+    }
+
     // Time to create the cache?
     if (d->dataCache.isNull())
     {
@@ -581,7 +624,7 @@ uint8_t const *Zip::cacheLump(int lumpIndex)
     if (!region) throw Error("Zip::cacheLump", QString("Failed on allocation of %1 bytes for cache copy of lump #%2").arg(lumpFile.info().size).arg(lumpIndex));
 
     readLump(lumpIndex, region, false);
-    d->dataCache->insert(lumpIndex, region);
+    d->dataCache->insert(lumpIndex, region, lumpFile.info().size);
 
     return region;
 }
@@ -589,6 +632,7 @@ uint8_t const *Zip::cacheLump(int lumpIndex)
 void Zip::unlockLump(int lumpIndex)
 {
     LOG_AS("Zip::unlockLump");
+    DENG2_GUARD(d);
     LOGDEV_RES_XVERBOSE("\"%s:%s\"", NativePath(composePath()).pretty()
                         << NativePath(lump(lumpIndex).composePath()).pretty());
 
@@ -615,6 +659,7 @@ size_t Zip::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     size_t length, bool tryCache)
 {
     LOG_AS("Zip::readLump");
+    DENG2_GUARD(d);
 
     LumpFile const &lumpFile = static_cast<LumpFile &>(lump(lumpIndex));
     LOGDEV_RES_XVERBOSE("\"%s:%s\" (%u bytes%s) [%u +%u]",
@@ -628,13 +673,18 @@ size_t Zip::readLump(int lumpIndex, uint8_t *buffer, size_t startOffset,
     // Try to avoid a file system read by checking for a cached copy.
     if (tryCache)
     {
-        uint8_t const *data = (!d->dataCache.isNull() ? d->dataCache->data(lumpIndex) : 0);
-        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (data? "hit" : "miss") << lumpIndex);
-        if (data)
+        size_t const readBytes = (!d->dataCache.isNull()? d->dataCache->read(lumpIndex, buffer, startOffset, length) : 0);
+        LOGDEV_RES_XVERBOSE("Cache %s on #%i", (readBytes? "hit" : "miss") << lumpIndex);
+        if (readBytes) return readBytes;
+    }
+
+    if (!lumpFile.info().isCompressed())
+    {
+        uint8_t const *mapped = d->mappedLump(lumpFile.info());
+        if (mapped && startOffset + length <= lumpFile.size())
         {
-            size_t readBytes = de::min(size_t(lumpFile.size()), length);
-            std::memcpy(buffer, data + startOffset, readBytes);
-            return readBytes;
+            std::memcpy(buffer, mapped + startOffset, length);
+            return length;
         }
     }
 
@@ -817,14 +867,14 @@ uint8_t *Zip::uncompress(uint8_t *in, size_t inSize, size_t *outSize)
 #undef INF_CHUNK_SIZE
 }
 
-bool Zip::uncompressRaw(uint8_t *in, size_t inSize, uint8_t *out, size_t outSize)
+bool Zip::uncompressRaw(uint8_t const *in, size_t inSize, uint8_t *out, size_t outSize)
 {
     LOG_AS("Zip::uncompressRaw");
     z_stream stream;
     int result;
 
     std::memset(&stream, 0, sizeof(stream));
-    stream.next_in   = (Bytef *) in;
+    stream.next_in   = (Bytef *) const_cast<uint8_t *>(in);
     stream.avail_in  = (uInt) inSize;
     stream.zalloc    = Z_NULL;
     stream.zfree     = Z_NULL;
@@ -24,8 +24,10 @@
 #include "doomsday/defs/ded.h"
 #include "doomsday/defs/sprite.h"
 
+#include <de/math.h>
 #include <de/types.h>
 #include <QMap>
+#include <QVector>
 
 namespace res {
 
@@ -35,11 +37,69 @@ DENG2_PIMPL_NOREF(Sprites)
 {
     QHash<spritenum_t, SpriteSet> sprites;
 
+    /**
+     * Index-addressed table of all the sprite frames, compiled from the sprite sets
+     * when first needed after they have changed. The frames of sprite @em id are
+     * at frames[firstFrame[id]] ... frames[firstFrame[id + 1] - 1]; missing frames
+     * are @c nullptr.
+     */
+    struct FrameTable
+    {
+        QVector<dint> firstFrame;
+        QVector<defn::CompiledSpriteRecord const *> frames;
+        bool isValid = false;
+    };
+    FrameTable table;
+
     ~Impl()
     {
         sprites.clear();
     }
 
+    void compileFrameTable()
+    {
+        table.firstFrame.clear();
+        table.frames.clear();
+
+        spritenum_t maxId = -1;
+        for (auto it = sprites.constBegin(); it != sprites.constEnd(); ++it)
+        {
+            maxId = de::max(maxId, it.key());
+        }
+        table.firstFrame.reserve(maxId + 2);
+        for (spritenum_t id = 0; id <= maxId; ++id)
+        {
+            table.firstFrame.append(table.frames.size());
+            if (SpriteSet const *frames = tryFindSpriteSet(id))
+            {
+                dint frameCount = 0;
+                for (auto it = frames->constBegin(); it != frames->constEnd(); ++it)
+                {
+                    frameCount = de::max(frameCount, it.key() + 1);
+                }
+                dint const start = table.frames.size();
+                table.frames.resize(start + frameCount);
+                for (auto it = frames->constBegin(); it != frames->constEnd(); ++it)
+                {
+                    if (it.key() >= 0) table.frames[start + it.key()] = &it.value();
+                }
+            }
+        }
+        table.firstFrame.append(table.frames.size());
+        table.isValid = true;
+    }
+
+    /// Looks up a sprite frame in the compiled frame table.
+    defn::CompiledSpriteRecord const *tryFindFrame(spritenum_t id, dint frame)
+    {
+        if (!table.isValid) compileFrameTable();
+
+        if (id < 0 || id + 1 >= table.firstFrame.size() || frame < 0) return nullptr;
+        dint const pos = table.firstFrame[id] + frame;
+        if (pos >= table.firstFrame[id + 1]) return nullptr;
+        return table.frames[pos];
+    }
+
     inline bool hasSpriteSet(spritenum_t id) const
     {
         return sprites.contains(id);
@@ -62,6 +122,7 @@ DENG2_PIMPL_NOREF(Sprites)
     SpriteSet &addSpriteSet(spritenum_t id, SpriteSet const &frames)
     {
         DENG2_ASSERT(!tryFindSpriteSet(id));  // sanity check.
+        table.isValid = false;
         return sprites.insert(id, frames).value();
     }
 };
@@ -73,6 +134,7 @@ Sprites::Sprites()
 void Sprites::clear()
 {
     d->sprites.clear();
+    d->table = Impl::FrameTable();
 }
 
 Sprites::SpriteSet &Sprites::addSpriteSet(spritenum_t id, SpriteSet const &frames)
@@ -87,26 +149,24 @@ dint Sprites::spriteCount() const
 
 bool Sprites::hasSprite(spritenum_t id, dint frame) const
 {
-    if (SpriteSet const *frames = d.getConst()->tryFindSpriteSet(id))
-    {
-        return frames->contains(frame);
-    }
-    return false;
+    return d->tryFindFrame(id, frame) != nullptr;
 }
 
-defn::CompiledSpriteRecord &Sprites::sprite(spritenum_t id, dint frame)
+defn::CompiledSpriteRecord const &Sprites::sprite(spritenum_t id, dint frame) const
 {
-    return d->findSpriteSet(id).find(frame).value();
+    if (auto const *rec = d->tryFindFrame(id, frame))
+    {
+        return *rec;
+    }
+    /// @throw MissingResourceError An unknown/invalid id or frame was specified.
+    throw Resources::MissingResourceError("Sprites::sprite",
+                                          "Unknown sprite id " + String::number(id) +
+                                          " frame " + String::number(frame));
 }
 
 defn::CompiledSpriteRecord const *Sprites::spritePtr(spritenum_t id, de::dint frame) const
 {
-    if (Sprites::SpriteSet const *sprSet = tryFindSpriteSet(id))
-    {
-        auto found = sprSet->find(frame);
-        if (found != sprSet->end()) return &found.value();
-    }
-    return nullptr;
+    return d->tryFindFrame(id, frame);
 }
 
 Sprites::SpriteSet const *Sprites::tryFindSpriteSet(spritenum_t id) const
@@ -306,6 +366,8 @@ void Sprites::initSprites()
     // We're done with the definitions.
     spriteDefs.clear();
 
+    d->compileFrameTable();
+
     LOG_RES_VERBOSE("Sprites built in %.2f seconds") << begunAt.since();
 }
 
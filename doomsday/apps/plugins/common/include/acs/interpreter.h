@@ -60,7 +60,7 @@ struct Interpreter
         void drop();
     } locals;
     int args[ACS_INTERPRETER_MAX_SCRIPT_ARGS];
-    int const *pcodePtr;
+    int const *pcodePtr;  ///< Position in the decoded code (see Module::code()).
 
     System &scriptSys() const;
 
@@ -48,12 +48,27 @@ public:
     /// Required/referenced (script) entry point data is missing. @ingroup errors
     DENG2_ERROR(MissingEntryPointError);
 
+    /**
+     * Commands of the decoded code that do not exist in ACS bytecode. They are
+     * numbered after the last ACS bytecode command.
+     */
+    enum DecodedCommand
+    {
+        PcodeCommandCount = 102,
+
+        PushNumbers = PcodeCommandCount,  ///< Two PushNumbers: [number, number]
+        BinaryOpNumber,                   ///< PushNumber and an operator: [operator, number]
+        InvalidCommand,                   ///< Unknown bytecode command: [command]
+
+        DecodedCommandCount
+    };
+
     /**
      * Stores information about an ACS script entry point.
      */
     struct EntryPoint
     {
-        int const *pcodePtr       = nullptr;
+        int const *pcodePtr       = nullptr;  ///< Start of the script in the decoded code.
         bool startWhenMapBegins   = false;
         de::dint32 scriptNumber   = 0;
         de::dint32 scriptArgCount = 0;
@@ -107,6 +122,27 @@ public:
      */
     de::Block const &pcode() const;
 
+    /**
+     * Provides readonly access to the decoded code. The bytecode is decoded and
+     * validated when the module is loaded: operands are in native byte order,
+     * jump targets are positions in the decoded code, all commands are known
+     * (or InvalidCommand), and some common command sequences are fused.
+     */
+    int const *code() const;
+
+    /**
+     * Returns the position in the decoded code of the instruction that begins at
+     * @a pcodeOffset in the bytecode. If no instruction begins there, returns an
+     * instruction that terminates the script.
+     */
+    int const *codeAt(de::dint32 pcodeOffset) const;
+
+    /**
+     * Returns the bytecode offset of the instruction at @a codePtr in the decoded
+     * code. Used for serializing interpreter state.
+     */
+    de::dint32 pcodeOffset(int const *codePtr) const;
+
 private:
     Module();
 
@@ -74,13 +74,13 @@ namespace internal
 
     ACS_COMMAND(PushNumber)
     {
-        interp.locals.push(DD_LONG(*interp.pcodePtr++));
+        interp.locals.push(*interp.pcodePtr++);
         return Continue;
     }
 
     ACS_COMMAND(LSpec1)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
         specArgs[0] = interp.locals.pop();
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side, interp.activator);
 
@@ -89,7 +89,7 @@ namespace internal
 
     ACS_COMMAND(LSpec2)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
         specArgs[1] = interp.locals.pop();
         specArgs[0] = interp.locals.pop();
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side, interp.activator);
@@ -99,7 +99,7 @@ namespace internal
 
     ACS_COMMAND(LSpec3)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
         specArgs[2] = interp.locals.pop();
         specArgs[1] = interp.locals.pop();
         specArgs[0] = interp.locals.pop();
@@ -110,7 +110,7 @@ namespace internal
 
     ACS_COMMAND(LSpec4)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
         specArgs[3] = interp.locals.pop();
         specArgs[2] = interp.locals.pop();
         specArgs[1] = interp.locals.pop();
@@ -122,7 +122,7 @@ namespace internal
 
     ACS_COMMAND(LSpec5)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
         specArgs[4] = interp.locals.pop();
         specArgs[3] = interp.locals.pop();
         specArgs[2] = interp.locals.pop();
@@ -136,8 +136,8 @@ namespace internal
 
     ACS_COMMAND(LSpec1Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
+        specArgs[0] = *interp.pcodePtr++;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -146,9 +146,9 @@ namespace internal
 
     ACS_COMMAND(LSpec2Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
+        specArgs[0] = *interp.pcodePtr++;
+        specArgs[1] = *interp.pcodePtr++;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -157,10 +157,10 @@ namespace internal
 
     ACS_COMMAND(LSpec3Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
-        specArgs[2] = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
+        specArgs[0] = *interp.pcodePtr++;
+        specArgs[1] = *interp.pcodePtr++;
+        specArgs[2] = *interp.pcodePtr++;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -169,11 +169,11 @@ namespace internal
 
     ACS_COMMAND(LSpec4Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
-        specArgs[2] = DD_LONG(*interp.pcodePtr++);
-        specArgs[3] = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
+        specArgs[0] = *interp.pcodePtr++;
+        specArgs[1] = *interp.pcodePtr++;
+        specArgs[2] = *interp.pcodePtr++;
+        specArgs[3] = *interp.pcodePtr++;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
@@ -182,18 +182,74 @@ namespace internal
 
     ACS_COMMAND(LSpec5Direct)
     {
-        int special = DD_LONG(*interp.pcodePtr++);
-        specArgs[0] = DD_LONG(*interp.pcodePtr++);
-        specArgs[1] = DD_LONG(*interp.pcodePtr++);
-        specArgs[2] = DD_LONG(*interp.pcodePtr++);
-        specArgs[3] = DD_LONG(*interp.pcodePtr++);
-        specArgs[4] = DD_LONG(*interp.pcodePtr++);
+        int special = *interp.pcodePtr++;
+        specArgs[0] = *interp.pcodePtr++;
+        specArgs[1] = *interp.pcodePtr++;
+        specArgs[2] = *interp.pcodePtr++;
+        specArgs[3] = *interp.pcodePtr++;
+        specArgs[4] = *interp.pcodePtr++;
         P_ExecuteLineSpecial(special, specArgs, interp.line, interp.side,
                              interp.activator);
 
         return Continue;
     }
 
+    ACS_COMMAND(PushNumbers)
+    {
+        interp.locals.push(*interp.pcodePtr++);
+        interp.locals.push(*interp.pcodePtr++);
+        return Continue;
+    }
+
+    static int applyBinaryOperator(int command, int operand1, int operand2)
+    {
+        switch(command)
+        {
+        case 14: return operand1 + operand2;      // Add
+        case 15: return operand1 - operand2;      // Subtract
+        case 16: return operand1 * operand2;      // Multiply
+        case 17: return operand1 / operand2;      // Divide
+        case 18: return operand1 % operand2;      // Modulus
+        case 19: return operand1 == operand2;     // EQ
+        case 20: return operand1 != operand2;     // NE
+        case 21: return operand1 < operand2;      // LT
+        case 22: return operand1 > operand2;      // GT
+        case 23: return operand1 <= operand2;     // LE
+        case 24: return operand1 >= operand2;     // GE
+        case 72: return operand1 & operand2;      // AndBitwise
+        case 73: return operand1 | operand2;      // OrBitwise
+        case 74: return operand1 ^ operand2;      // EorBitwise
+        case 76: return operand1 << operand2;     // LShift
+        case 77: return operand1 >> operand2;     // RShift
+
+        default:
+            DENG2_ASSERT(false); // The decoder only fuses the above.
+            return 0;
+        }
+    }
+
+    static CommandFunc const &findCommand(int name);
+
+    ACS_COMMAND(BinaryOpNumber)
+    {
+        int const command  = *interp.pcodePtr++;
+        int const operand2 = *interp.pcodePtr++;
+        if(interp.locals.height >= ACS_INTERPRETER_SCRIPT_STACK_DEPTH)
+        {
+            // Let the separate commands deal with the overflow.
+            interp.locals.push(operand2);
+            return findCommand(command)(interp);
+        }
+        interp.locals.push(applyBinaryOperator(command, interp.locals.pop(), operand2));
+        return Continue;
+    }
+
+    ACS_COMMAND(InvalidCommand)
+    {
+        /// @throw Error  Invalid command name specified.
+        throw Error("acs::Interpreter::findCommand", "Unknown command #" + String::number(*interp.pcodePtr));
+    }
+
     ACS_COMMAND(Add)
     {
         interp.locals.push(interp.locals.pop() + interp.locals.pop());
@@ -269,169 +325,169 @@ namespace internal
 
     ACS_COMMAND(AssignScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] = interp.locals.pop();
+        interp.args[*interp.pcodePtr++] = interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AssignMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] = interp.locals.pop();
+        interp.scriptSys().mapVars[*interp.pcodePtr++] = interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AssignWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] = interp.locals.pop();
+        interp.scriptSys().worldVars[*interp.pcodePtr++] = interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(PushScriptVar)
     {
-        interp.locals.push(interp.args[DD_LONG(*interp.pcodePtr++)]);
+        interp.locals.push(interp.args[*interp.pcodePtr++]);
         return Continue;
     }
 
     ACS_COMMAND(PushMapVar)
     {
-        interp.locals.push(interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)]);
+        interp.locals.push(interp.scriptSys().mapVars[*interp.pcodePtr++]);
         return Continue;
     }
 
     ACS_COMMAND(PushWorldVar)
     {
-        interp.locals.push(interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)]);
+        interp.locals.push(interp.scriptSys().worldVars[*interp.pcodePtr++]);
         return Continue;
     }
 
     ACS_COMMAND(AddScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] += interp.locals.pop();
+        interp.args[*interp.pcodePtr++] += interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AddMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] += interp.locals.pop();
+        interp.scriptSys().mapVars[*interp.pcodePtr++] += interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(AddWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] += interp.locals.pop();
+        interp.scriptSys().worldVars[*interp.pcodePtr++] += interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(SubScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] -= interp.locals.pop();
+        interp.args[*interp.pcodePtr++] -= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(SubMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] -= interp.locals.pop();
+        interp.scriptSys().mapVars[*interp.pcodePtr++] -= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(SubWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] -= interp.locals.pop();
+        interp.scriptSys().worldVars[*interp.pcodePtr++] -= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(MulScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] *= interp.locals.pop();
+        interp.args[*interp.pcodePtr++] *= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(MulMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] *= interp.locals.pop();
+        interp.scriptSys().mapVars[*interp.pcodePtr++] *= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(MulWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] *= interp.locals.pop();
+        interp.scriptSys().worldVars[*interp.pcodePtr++] *= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(DivScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] /= interp.locals.pop();
+        interp.args[*interp.pcodePtr++] /= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(DivMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] /= interp.locals.pop();
+        interp.scriptSys().mapVars[*interp.pcodePtr++] /= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(DivWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] /= interp.locals.pop();
+        interp.scriptSys().worldVars[*interp.pcodePtr++] /= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(ModScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)] %= interp.locals.pop();
+        interp.args[*interp.pcodePtr++] %= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(ModMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)] %= interp.locals.pop();
+        interp.scriptSys().mapVars[*interp.pcodePtr++] %= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(ModWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)] %= interp.locals.pop();
+        interp.scriptSys().worldVars[*interp.pcodePtr++] %= interp.locals.pop();
         return Continue;
     }
 
     ACS_COMMAND(IncScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)]++;
+        interp.args[*interp.pcodePtr++]++;
         return Continue;
     }
 
     ACS_COMMAND(IncMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)]++;
+        interp.scriptSys().mapVars[*interp.pcodePtr++]++;
         return Continue;
     }
 
     ACS_COMMAND(IncWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)]++;
+        interp.scriptSys().worldVars[*interp.pcodePtr++]++;
         return Continue;
     }
 
     ACS_COMMAND(DecScriptVar)
     {
-        interp.args[DD_LONG(*interp.pcodePtr++)]--;
+        interp.args[*interp.pcodePtr++]--;
         return Continue;
     }
 
     ACS_COMMAND(DecMapVar)
     {
-        interp.scriptSys().mapVars[DD_LONG(*interp.pcodePtr++)]--;
+        interp.scriptSys().mapVars[*interp.pcodePtr++]--;
         return Continue;
     }
 
     ACS_COMMAND(DecWorldVar)
     {
-        interp.scriptSys().worldVars[DD_LONG(*interp.pcodePtr++)]--;
+        interp.scriptSys().worldVars[*interp.pcodePtr++]--;
         return Continue;
     }
 
     ACS_COMMAND(Goto)
     {
-        interp.pcodePtr = (int const *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+        interp.pcodePtr = interp.scriptSys().module().code() + *interp.pcodePtr;
         return Continue;
     }
 
@@ -439,7 +495,7 @@ namespace internal
     {
         if(interp.locals.pop())
         {
-            interp.pcodePtr = (int const *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+            interp.pcodePtr = interp.scriptSys().module().code() + *interp.pcodePtr;
         }
         else
         {
@@ -462,7 +518,7 @@ namespace internal
 
     ACS_COMMAND(DelayDirect)
     {
-        interp.delayCount = DD_LONG(*interp.pcodePtr++);
+        interp.delayCount = *interp.pcodePtr++;
         return Stop;
     }
 
@@ -476,8 +532,8 @@ namespace internal
 
     ACS_COMMAND(RandomDirect)
     {
-        int low  = DD_LONG(*interp.pcodePtr++);
-        int high = DD_LONG(*interp.pcodePtr++);
+        int low  = *interp.pcodePtr++;
+        int high = *interp.pcodePtr++;
         interp.locals.push(low + (P_Random() % (high - low + 1)));
         return Continue;
     }
@@ -496,8 +552,8 @@ namespace internal
 
     ACS_COMMAND(ThingCountDirect)
     {
-        int type = DD_LONG(*interp.pcodePtr++);
-        int tid  = DD_LONG(*interp.pcodePtr++);
+        int type = *interp.pcodePtr++;
+        int tid  = *interp.pcodePtr++;
         // Anything to count?
         if(type + tid)
         {
@@ -514,7 +570,7 @@ namespace internal
 
     ACS_COMMAND(TagWaitDirect)
     {
-        interp.script().waitForSector(DD_LONG(*interp.pcodePtr++));
+        interp.script().waitForSector(*interp.pcodePtr++);
         return Stop;
     }
 
@@ -526,7 +582,7 @@ namespace internal
 
     ACS_COMMAND(PolyWaitDirect)
     {
-        interp.script().waitForPolyobj(DD_LONG(*interp.pcodePtr++));
+        interp.script().waitForPolyobj(*interp.pcodePtr++);
         return Stop;
     }
 
@@ -557,9 +613,9 @@ namespace internal
 
     ACS_COMMAND(ChangeFloorDirect)
     {
-        int tag = DD_LONG(*interp.pcodePtr++);
+        int tag = *interp.pcodePtr++;
 
-        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(DD_LONG(*interp.pcodePtr++)).toUtf8().constData()));
+        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(*interp.pcodePtr++).toUtf8().constData()));
         uri_s *uri = Uri_NewWithPath3("Flats", Str_Text(path));
 
         world_Material *mat = (world_Material *) P_ToPtr(DMU_MATERIAL, Materials_ResolveUri(uri));
@@ -607,9 +663,9 @@ namespace internal
 
     ACS_COMMAND(ChangeCeilingDirect)
     {
-        int tag = DD_LONG(*interp.pcodePtr++);
+        int tag = *interp.pcodePtr++;
 
-        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(DD_LONG(*interp.pcodePtr++)).toUtf8().constData()));
+        AutoStr *path = Str_PercentEncode(AutoStr_FromTextStd(interp.scriptSys().module().constant(*interp.pcodePtr++).toUtf8().constData()));
         uri_s *uri = Uri_NewWithPath3("Flats", Str_Text(path));
 
         world_Material *mat = (world_Material *) P_ToPtr(DMU_MATERIAL, Materials_ResolveUri(uri));
@@ -700,7 +756,7 @@ namespace internal
         }
         else
         {
-            interp.pcodePtr = (int const *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+            interp.pcodePtr = interp.scriptSys().module().code() + *interp.pcodePtr;
         }
         return Continue;
     }
@@ -719,7 +775,7 @@ namespace internal
 
     ACS_COMMAND(ScriptWaitDirect)
     {
-        interp.script().waitForScript(DD_LONG(*interp.pcodePtr++));
+        interp.script().waitForScript(*interp.pcodePtr++);
         return Stop;
     }
 
@@ -734,9 +790,9 @@ namespace internal
 
     ACS_COMMAND(CaseGoto)
     {
-        if(interp.locals.top() == DD_LONG(*interp.pcodePtr++))
+        if(interp.locals.top() == *interp.pcodePtr++)
         {
-            interp.pcodePtr = (int const *) (interp.scriptSys().module().pcode().constData() + DD_LONG(*interp.pcodePtr));
+            interp.pcodePtr = interp.scriptSys().module().code() + *interp.pcodePtr;
             interp.locals.drop();
         }
         else
@@ -1052,12 +1108,17 @@ namespace internal
             cmdPrintCharacter, cmdPlayerCount, cmdGameType, cmdGameSkill,
             cmdTimer, cmdSectorSound, cmdAmbientSound, cmdSoundSequence,
             cmdSetLineTexture, cmdSetLineBlocking, cmdSetLineSpecial,
-            cmdThingSound, cmdEndPrintBold
+            cmdThingSound, cmdEndPrintBold,
+
+            // Commands of the decoded code:
+            cmdPushNumbers, cmdBinaryOpNumber, cmdInvalidCommand
         };
-        static int const numCmds = sizeof(cmds) / sizeof(cmds[0]);
-        if(name >= 0 && name < numCmds) return cmds[name];
-        /// @throw Error  Invalid command name specified.
-        throw Error("acs::Interpreter::findCommand", "Unknown command #" + String::number(name));
+        static_assert(sizeof(cmds) / sizeof(cmds[0]) == acs::Module::DecodedCommandCount,
+                      "Command table does not match the decoded commands");
+
+        // The decoder has made sure that only valid commands are present.
+        DENG2_ASSERT(name >= 0 && name < acs::Module::DecodedCommandCount);
+        return cmds[name];
     }
 
 #endif  // __JHEXEN__
@@ -1107,7 +1168,7 @@ void Interpreter::think()
             return;
         }
 
-        while((action = findCommand(DD_LONG(*pcodePtr++))(*this)) == Continue)
+        while((action = findCommand(*pcodePtr++)(*this)) == Continue)
         {}
     }
 
@@ -1197,7 +1258,8 @@ void Interpreter::write(MapStateWriter *msw) const
     {
         Writer_WriteInt32(writer, args[i]);
     }
-    Writer_WriteInt32(writer, ((dbyte const *)pcodePtr) - (dbyte const *)scriptSys().module().pcode().constData());
+    // The position is saved as a bytecode offset.
+    Writer_WriteInt32(writer, scriptSys().module().pcodeOffset(pcodePtr));
 }
 
 int Interpreter::read(MapStateReader *msr)
@@ -1252,7 +1314,7 @@ int Interpreter::read(MapStateReader *msr)
             args[i] = Reader_ReadInt32(reader);
         }
 
-        pcodePtr = (int const *) (scriptSys().module().pcode().constData() + Reader_ReadInt32(reader));
+        pcodePtr = scriptSys().module().codeAt(Reader_ReadInt32(reader));
     }
     else
     {
@@ -1292,7 +1354,7 @@ int Interpreter::read(MapStateReader *msr)
             args[i] = Reader_ReadInt32(reader);
         }
 
-        pcodePtr = (int const *) (scriptSys().module().pcode().constData() + Reader_ReadInt32(reader));
+        pcodePtr = scriptSys().module().codeAt(Reader_ReadInt32(reader));
     }
 
     thinker.function = (thinkfunc_t) acs_Interpreter_Think;
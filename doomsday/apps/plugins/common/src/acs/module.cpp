@@ -22,8 +22,10 @@
 #include "common.h"           // IS_CLIENT
 #include "acs/module.h"
 
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QSet>
 #include <QVector>
 #include <de/Log>
 #include "acs/interpreter.h"  // ACS_INTERPRETER_MAX_SCRIPT_ARGS
@@ -31,6 +33,85 @@
 
 using namespace de;
 
+namespace internal
+{
+    /// ACS bytecode commands that the decoder needs to know about.
+    enum PcodeCommand
+    {
+        PcodeTerminate        = 1,
+        PcodeSuspend          = 2,
+        PcodePushNumber       = 3,
+        PcodeAdd              = 14,
+        PcodeGE               = 24,
+        PcodeGoto             = 52,
+        PcodeIfGoto           = 53,
+        PcodeDelay            = 55,
+        PcodeDelayDirect      = 56,
+        PcodeTagWait          = 61,
+        PcodeTagWaitDirect    = 62,
+        PcodePolyWait         = 63,
+        PcodePolyWaitDirect   = 64,
+        PcodeRestart          = 69,
+        PcodeAndBitwise       = 72,
+        PcodeOrBitwise        = 73,
+        PcodeEorBitwise       = 74,
+        PcodeLShift           = 76,
+        PcodeRShift           = 77,
+        PcodeIfNotGoto        = 79,
+        PcodeScriptWait       = 81,
+        PcodeScriptWaitDirect = 82,
+        PcodeCaseGoto         = 84
+    };
+
+    /// Number of operands following each ACS bytecode command.
+    static int const pcodeOperandCounts[acs::Module::PcodeCommandCount] =
+    {
+        0, 0, 0, 1, 1, 1, 1, 1, 1, 2,   //   0: NOP .. LSpec1Direct
+        3, 4, 5, 6, 0, 0, 0, 0, 0, 0,   //  10: LSpec2Direct .. EQ
+        0, 0, 0, 0, 0, 1, 1, 1, 1, 1,   //  20: NE .. PushMapVar
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1,   //  30: PushWorldVar .. MulMapVar
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1,   //  40: MulWorldVar .. DecScriptVar
+        1, 1, 1, 1, 0, 0, 1, 0, 2, 0,   //  50: DecMapVar .. ThingCount
+        2, 0, 1, 0, 1, 0, 2, 0, 2, 0,   //  60: ThingCountDirect .. Restart
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 1,   //  70: AndLogical .. IfNotGoto
+        0, 0, 1, 0, 2, 0, 0, 0, 0, 0,   //  80: LineSide .. PrintCharacter
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   //  90: PlayerCount .. SetLineSpecial
+        0, 0                            // 100: ThingSound, EndPrintBold
+    };
+
+    /// Commands after which the interpreter stops until a later tic.
+    static bool pcodeCommandSuspends(dint32 command)
+    {
+        switch(command)
+        {
+        case PcodeSuspend:
+        case PcodeDelay:
+        case PcodeDelayDirect:
+        case PcodeTagWait:
+        case PcodeTagWaitDirect:
+        case PcodePolyWait:
+        case PcodePolyWaitDirect:
+        case PcodeScriptWait:
+        case PcodeScriptWaitDirect:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    /// Binary operators whose right operand can be fused with a preceding PushNumber.
+    /// (AndLogical and OrLogical are excluded as they may only pop one value.)
+    static bool pcodeCommandIsFusableOperator(dint32 command)
+    {
+        return (command >= PcodeAdd && command <= PcodeGE) ||
+               (command >= PcodeAndBitwise && command <= PcodeEorBitwise) ||
+               command == PcodeLShift || command == PcodeRShift;
+    }
+}
+
+using namespace internal;
+
 namespace acs {
 
 DENG2_PIMPL_NOREF(Module)
@@ -40,6 +121,18 @@ DENG2_PIMPL_NOREF(Module)
     QMap<int, EntryPoint *> epByScriptNumberLut;
     QList<String> constants;
 
+    QVector<int> code;                  ///< Decoded code.
+    QVector<dint32> codePcodeOffsets;   ///< Bytecode offset of each instruction (-1 for operands).
+    QHash<dint32, int> codeIndexByPcodeOffset;
+
+    struct PcodeInstruction
+    {
+        dint32 offset;
+        dint32 command;
+        int size;                       ///< In bytes, including operands.
+        bool isTarget;                  ///< Execution may begin here.
+    };
+
     void buildEntryPointLut()
     {
         epByScriptNumberLut.clear();
@@ -48,6 +141,199 @@ DENG2_PIMPL_NOREF(Module)
             epByScriptNumberLut.insert(ep.scriptNumber, &ep);
         }
     }
+
+    dint32 pcodeInt(dint32 offset) const
+    {
+        if(offset < 0 || offset + 4 > dint32(pcode.size()))
+        {
+            throw FormatError("acs::Module", "Bytecode ends unexpectedly at offset " + String::number(offset));
+        }
+        return DD_LONG(*(int const *)(pcode.constData() + offset));
+    }
+
+    /**
+     * Finds all instructions reachable from the entry points of the scripts.
+     *
+     * @param entryOffsets  Bytecode offsets of the script entry points.
+     *
+     * @return  Instructions in bytecode order.
+     */
+    QVector<PcodeInstruction> findInstructions(QVector<dint32> const &entryOffsets) const
+    {
+        QMap<dint32, PcodeInstruction> found;
+        QList<dint32> pending;
+
+        auto addTarget = [this, &pending] (dint32 offset)
+        {
+            if(offset < 0 || offset + 4 > dint32(pcode.size()))
+            {
+                throw FormatError("acs::Module", "Invalid jump target offset " + String::number(offset));
+            }
+            pending << offset;
+        };
+        for(dint32 offset : entryOffsets) addTarget(offset);
+
+        QSet<dint32> targets;
+        while(!pending.isEmpty())
+        {
+            dint32 offset = pending.takeLast();
+            targets.insert(offset);
+
+            // Follow the execution until it ends or reaches known instructions.
+            while(!found.contains(offset))
+            {
+                PcodeInstruction inst;
+                inst.offset   = offset;
+                inst.command  = pcodeInt(offset);
+                inst.isTarget = false;
+                if(inst.command < 0 || inst.command >= PcodeCommandCount)
+                {
+                    // The interpreter will complain if this is ever reached.
+                    inst.size = 4;
+                    found.insert(offset, inst);
+                    break;
+                }
+                inst.size = 4 * (1 + pcodeOperandCounts[inst.command]);
+                found.insert(offset, inst);
+
+                switch(inst.command)
+                {
+                case PcodeGoto:
+                case PcodeIfGoto:
+                case PcodeIfNotGoto:
+                    addTarget(pcodeInt(offset + 4));
+                    break;
+
+                case PcodeCaseGoto:
+                    addTarget(pcodeInt(offset + 8));
+                    break;
+
+                default:
+                    break;
+                }
+
+                offset += inst.size;
+                pcodeInt(offset - 4); // Operands must be inside the bytecode.
+
+                if(inst.command == PcodeTerminate || inst.command == PcodeGoto ||
+                   inst.command == PcodeRestart)
+                {
+                    break; // No fallthrough.
+                }
+                if(pcodeCommandSuspends(inst.command))
+                {
+                    // Interpretation resumes here later (possibly from a saved game).
+                    targets.insert(offset);
+                }
+            }
+        }
+
+        QVector<PcodeInstruction> insts;
+        insts.reserve(found.size());
+        for(PcodeInstruction inst : found)
+        {
+            if(!insts.isEmpty() && insts.last().offset + insts.last().size > inst.offset)
+            {
+                throw FormatError("acs::Module", "Overlapping instructions at offset " + String::number(inst.offset));
+            }
+            inst.isTarget = targets.contains(inst.offset);
+            insts << inst;
+        }
+        return insts;
+    }
+
+    /**
+     * Decodes the bytecode reachable from the script entry points into the
+     * form used by the interpreter.
+     *
+     * @param entryOffsets  Bytecode offsets of the script entry points.
+     */
+    void decode(QVector<dint32> const &entryOffsets)
+    {
+        QVector<PcodeInstruction> const insts = findInstructions(entryOffsets);
+
+        code.clear();
+        codePcodeOffsets.clear();
+        codeIndexByPcodeOffset.clear();
+
+        // Position zero is used for invalid code positions.
+        code << PcodeTerminate;
+        codePcodeOffsets << 0;
+
+        QList<QPair<int, dint32>> jumps; // code index, target offset
+        auto append = [this] (int value, dint32 pcodeOffset = -1)
+        {
+            code << value;
+            codePcodeOffsets << pcodeOffset;
+        };
+        auto isFollowedBy = [&insts] (int i, std::function<bool (dint32)> pred)
+        {
+            if(i + 1 >= insts.size()) return false;
+            PcodeInstruction const &next = insts.at(i + 1);
+            return next.offset == insts.at(i).offset + insts.at(i).size &&
+                   !next.isTarget && pred(next.command);
+        };
+        auto isPushNumber = [] (dint32 command) { return command == PcodePushNumber; };
+
+        for(int i = 0; i < insts.size(); ++i)
+        {
+            PcodeInstruction const &inst = insts.at(i);
+            codeIndexByPcodeOffset.insert(inst.offset, code.size());
+
+            if(inst.command < 0 || inst.command >= PcodeCommandCount)
+            {
+                append(InvalidCommand, inst.offset);
+                append(inst.command);
+                continue;
+            }
+
+            // Fuse common sequences.
+            if(inst.command == PcodePushNumber)
+            {
+                if(isFollowedBy(i, pcodeCommandIsFusableOperator))
+                {
+                    append(BinaryOpNumber, inst.offset);
+                    append(insts.at(i + 1).command);
+                    append(pcodeInt(inst.offset + 4));
+                    i += 1;
+                    continue;
+                }
+                if(isFollowedBy(i, isPushNumber) && !isFollowedBy(i + 1, pcodeCommandIsFusableOperator))
+                {
+                    append(PushNumbers, inst.offset);
+                    append(pcodeInt(inst.offset + 4));
+                    append(pcodeInt(insts.at(i + 1).offset + 4));
+                    i += 1;
+                    continue;
+                }
+            }
+
+            append(inst.command, inst.offset);
+            for(int k = 0; k < pcodeOperandCounts[inst.command]; ++k)
+            {
+                dint32 const operandOffset = inst.offset + 4 * (1 + k);
+                bool const isJumpTarget =
+                        ((inst.command == PcodeGoto || inst.command == PcodeIfGoto ||
+                          inst.command == PcodeIfNotGoto) && k == 0) ||
+                        (inst.command == PcodeCaseGoto && k == 1);
+                if(isJumpTarget)
+                {
+                    jumps << qMakePair(code.size(), pcodeInt(operandOffset));
+                }
+                append(pcodeInt(operandOffset));
+            }
+        }
+
+        // Resolve the jumps.
+        for(auto const &jump : jumps)
+        {
+            DENG2_ASSERT(codeIndexByPcodeOffset.contains(jump.second));
+            code[jump.first] = codeIndexByPcodeOffset[jump.second];
+        }
+
+        LOGDEV_SCR_VERBOSE("Decoded %i bytecode instructions into %i words")
+                << insts.size() << code.size();
+    }
 };
 
 Module::Module() : d(new Impl)
@@ -87,6 +373,8 @@ Module *Module::newFromBytecode(Block const &bytecode)  // static
     dint32 numEntryPoints;
     from >> numEntryPoints;
     module->d->entryPoints.reserve(numEntryPoints);
+    QVector<dint32> entryOffsets;
+    entryOffsets.reserve(numEntryPoints);
     for(dint32 i = 0; i < numEntryPoints; ++i)
     {
 #define OPEN_SCRIPTS_BASE 1000
@@ -106,7 +394,7 @@ Module *Module::newFromBytecode(Block const &bytecode)  // static
         {
             throw FormatError("acs::Module", "Invalid script entrypoint offset");
         }
-        ep.pcodePtr = (int const *)(module->d->pcode.constData() + offset);
+        entryOffsets << offset;
 
         from >> ep.scriptArgCount;
         if(ep.scriptArgCount > ACS_INTERPRETER_MAX_SCRIPT_ARGS)
@@ -118,6 +406,14 @@ Module *Module::newFromBytecode(Block const &bytecode)  // static
 
 #undef OPEN_SCRIPTS_BASE
     }
+
+    // Decode and validate the code of the scripts.
+    module->d->decode(entryOffsets);
+    for(int i = 0; i < module->d->entryPoints.size(); ++i)
+    {
+        module->d->entryPoints[i].pcodePtr = module->codeAt(entryOffsets.at(i));
+    }
+
     // Prepare a script-number => EntryPoint LUT.
     module->d->buildEntryPointLut();
 
@@ -199,4 +495,26 @@ Block const &Module::pcode() const
     return d->pcode;
 }
 
+int const *Module::code() const
+{
+    return d->code.constData();
+}
+
+int const *Module::codeAt(dint32 pcodeOffset) const
+{
+    return d->code.constData() + d->codeIndexByPcodeOffset.value(pcodeOffset, 0);
+}
+
+dint32 Module::pcodeOffset(int const *codePtr) const
+{
+    int const index = int(codePtr - d->code.constData());
+    if(index > 0 && index < d->codePcodeOffsets.size())
+    {
+        dint32 const offset = d->codePcodeOffsets.at(index);
+        DENG2_ASSERT(offset >= 0); // Must be the start of an instruction.
+        return de::max(offset, 0);
+    }
+    return 0;
+}
+
 } // namespace acs
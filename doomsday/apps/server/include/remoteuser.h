@@ -73,9 +73,35 @@ public:
      */
     de::Socket *takeSocket();
 
+    /**
+     * Token that the user includes in its datagrams (see DatagramChannel). Zero if
+     * a datagram channel has not been offered to the user.
+     */
+    de::duint32 datagramToken() const;
+
+    void setDatagramToken(de::duint32 token);
+
+    /**
+     * Address where the user's datagrams come from. This is null until the user
+     * has opened the datagram channel.
+     */
+    de::Address datagramAddress() const;
+
+    void setDatagramAddress(de::Address const &address);
+
+    /**
+     * Posts a message received from the user into the incoming message queue.
+     */
+    void postMessage(de::IByteArray const &message);
+
     // Implements Transmitter.
     void send(de::IByteArray const &data);
 
+    /**
+     * Sends a message that has already been encoded (see ServerSystem::broadcast()).
+     */
+    void send(de::Socket::EncodedMessage const &message);
+
 signals:
     void userDestroyed();
 
@@ -31,4 +31,20 @@
 void Sv_TransmitFrame();
 de::dsize Sv_GetMaxFrameSize(de::dint playerNumber);
 
+/**
+ * Returns the time (milliseconds) after which a player's unacked deltas are sent
+ * again. Zero, if the player receives frames over TCP.
+ */
+de::duint Sv_GetAckThreshold(de::dint playerNumber);
+
+/**
+ * Answers a player's request for a datagram channel (PCL_DATAGRAM_REQUEST).
+ */
+void Sv_OfferDatagramChannel(de::dint playerNumber);
+
+/**
+ * Handles a player's acknowledgement of a datagram frame (PCL_ACK_SETS).
+ */
+void Sv_FrameAcked(de::dint playerNumber);
+
 #endif  // SERVER_FRAME_H
@@ -32,9 +32,6 @@
 extern "C" {
 #endif
 
-// OR'd with the type number when resending Unacked deltas.
-#define DT_RESENT               0x80
-
 // Mobj Delta Control flags (not included directly in the frame).
 #define MDFC_NULL               0x010000 // The delta is not defined.
 #define MDFC_CREATE             0x020000 // Mobj didn't exist before.
@@ -92,6 +89,13 @@ typedef struct delta_s {
     uint            timeStamp;
 
     int             flags;
+
+    // Position of the delta in the pool's priority queue, plus one. Zero
+    // means the delta is not in the queue and needs to be rated.
+    int             queuePos;
+
+    // System time when the priority score was last calculated.
+    uint            ratedAt;
 } delta_t;
 
 typedef mobj_t  dt_mobj_t;
@@ -240,6 +244,24 @@ typedef struct pool_s {
     // for each resent delta. Zero is not used.
     byte            resendDealer;
 
+    // Incremented whenever a first frame is sent. Datagram frames and acks from
+    // an earlier epoch are ignored.
+    byte            frameEpoch;
+
+    // Times when the sets were sent as datagrams (Sv_GetTimeStamp()). Zero if the
+    // set was not sent as a datagram or has already been acked.
+    uint            setSentAt[256];
+
+    // Number of resent deltas included in each datagram set. An ack may not
+    // list more resend IDs than this.
+    byte            setResentCount[256];
+
+    // Average time for the client to ack a datagram frame, in milliseconds.
+    uint            ackTime;
+
+    // When the client last acked a datagram frame (or the first one was sent).
+    uint            lastAckAt;
+
     // The delta hash table holds all kinds of deltas.
     deltalink_t     hash[POOL_HASH_SIZE];
 
@@ -247,12 +269,16 @@ typedef struct pool_s {
     // not be sent.
     mislink_t       misHash[POOL_MISSILE_HASH_SIZE];
 
-    // The priority queue (a heap). Built when the pool contents are rated.
-    // Contains pointers to deltas in the hash. Becomes invalid when deltas
-    // are removed from the hash!
+    // The priority queue (an indexed heap). Contains pointers to the rated
+    // deltas in the hash. The queue is kept up to date as deltas are removed
+    // or modified, and only deltas whose scores have become outdated are
+    // re-rated when the pool is rated.
     int             queueSize;
     int             allocatedSize;
     delta_t**       queue;
+
+    // Origin of the owner when all the deltas of the pool were last rated.
+    coord_t         ratedOrigin[3];
 } pool_t;
 
 void            Sv_InitPools(void);
@@ -266,6 +292,7 @@ dd_bool         Sv_IsFrameTarget(uint clientNumber);
 uint            Sv_GetTimeStamp(void);
 pool_t*         Sv_GetPool(uint clientNumber);
 void            Sv_RatePool(pool_t* pool);
+void            Sv_RatePools(pool_t** pools);
 delta_t*        Sv_PoolQueueExtract(pool_t* pool);
 void            Sv_AckDeltaSet(uint clientNumber, int set, byte resent);
 uint            Sv_CountUnackedDeltas(uint clientNumber);
@@ -27,6 +27,7 @@
 #include "dd_types.h"
 
 #include <QObject>
+#include <QList>
 
 /**
  * Subsystem for tending to clients.
@@ -74,6 +75,48 @@ public:
 
     RemoteUser &user(de::Id const &id) const;
 
+    /**
+     * Sends the same message to several remote users. The message is compressed
+     * only once, no matter how many recipients there are.
+     *
+     * @param data        Message to send.
+     * @param recipients  Remote users. Unknown users are ignored.
+     */
+    void broadcast(de::IByteArray const &data, QList<de::Id> const &recipients);
+
+    /**
+     * Offers a datagram channel to a remote user (see DatagramChannel). The
+     * channel is open after the user has sent a datagram with the returned token.
+     *
+     * @param id  Remote user.
+     *
+     * @return Token for the user's datagrams, or zero if datagrams are not
+     * available.
+     */
+    de::duint32 offerDatagramChannel(de::Id const &id);
+
+    /**
+     * Returns the UDP port where datagrams are received, or zero if datagrams are
+     * not available.
+     */
+    de::duint16 datagramPort() const;
+
+    bool hasDatagramChannel(de::Id const &id) const;
+
+    /**
+     * Sends a message to a remote user as a datagram.
+     *
+     * @return @c true, if the message was sent. @c false if the user does not have
+     * an open datagram channel or the message is too large.
+     */
+    bool sendDatagram(de::Id const &id, de::IByteArray const &message);
+
+    /**
+     * Closes a remote user's datagram channel. Further messages to the user are
+     * sent over TCP.
+     */
+    void closeDatagramChannel(de::Id const &id);
+
     /**
      * A network node wishes to become a real client.
      * @return @c true if we allow this.
@@ -91,6 +134,7 @@ public:
 
 protected slots:
     void handleIncomingConnection();
+    void handleDatagram(de::Address from, de::duint32 token, de::Block message);
     void userDestroyed();
 
 private:
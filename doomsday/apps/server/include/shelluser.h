@@ -56,6 +56,15 @@ public:
     void sendMapOutline();
     void sendPlayerInfo();
 
+    /**
+     * Packets describing the state of the server. They are the same for all shell
+     * users, so ShellUsers can encode them once and broadcast them. Returns
+     * @c nullptr if there is nothing to send. Caller gets ownership.
+     */
+    static de::Packet *newGameStatePacket();
+    static de::Packet *newMapOutlinePacket();
+    static de::Packet *newPlayerInfoPacket();
+
 protected slots:
     void handleIncomingPackets();
 
@@ -50,11 +50,14 @@ DENG2_PIMPL(RemoteUser)
     bool isFromLocal;
     RemoteUserState state;
     String name;
+    duint32 datagramToken;
+    Address datagramAddress;
 
     Impl(Public *i, Socket *sock)
         : Base(i),
           socket(sock),
-          state(Unjoined)
+          state(Unjoined),
+          datagramToken(0)
     {
         DENG2_ASSERT(socket != 0);
 
@@ -251,6 +254,41 @@ Socket *RemoteUser::takeSocket()
     return sock;
 }
 
+duint32 RemoteUser::datagramToken() const
+{
+    return d->datagramToken;
+}
+
+void RemoteUser::setDatagramToken(duint32 token)
+{
+    d->datagramToken = token;
+}
+
+Address RemoteUser::datagramAddress() const
+{
+    return d->datagramAddress;
+}
+
+void RemoteUser::setDatagramAddress(Address const &address)
+{
+    d->datagramAddress = address;
+}
+
+void RemoteUser::postMessage(IByteArray const &message)
+{
+    // Post the data into the queue.
+    netmessage_t *msg = (netmessage_t *) M_Calloc(sizeof(netmessage_t));
+
+    msg->sender = d->id;
+    msg->data = new byte[message.size()];
+    message.get(0, msg->data, message.size());
+    msg->size = message.size();
+    msg->handle = msg->data; // needs delete[]
+
+    // The message queue will handle the message from now on.
+    N_PostMessage(msg);
+}
+
 void RemoteUser::send(IByteArray const &data)
 {
     if (d->state != Disconnected && d->socket->isOpen())
@@ -259,6 +297,14 @@ void RemoteUser::send(IByteArray const &data)
     }
 }
 
+void RemoteUser::send(Socket::EncodedMessage const &message)
+{
+    if (d->state != Disconnected && d->socket->isOpen())
+    {
+        d->socket->send(message);
+    }
+}
+
 void RemoteUser::handleIncomingPackets()
 {
     LOG_AS("RemoteUser");
@@ -274,22 +320,11 @@ void RemoteUser::handleIncomingPackets()
             if (!d->handleRequest(*packet)) return;
             break;
 
-        case Joined: {
+        case Joined:
             /// @todo The incoming packets should go through a de::Protocol and
             /// be handled immediately.
-
-            // Post the data into the queue.
-            netmessage_t *msg = (netmessage_t *) M_Calloc(sizeof(netmessage_t));
-
-            msg->sender = d->id;
-            msg->data = new byte[packet->size()];
-            memcpy(msg->data, packet->data(), packet->size());
-            msg->size = packet->size();
-            msg->handle = msg->data; // needs delete[]
-
-            // The message queue will handle the message from now on.
-            N_PostMessage(msg);
-            break; }
+            postMessage(*packet);
+            break;
 
         default:
             // Ignore the message.
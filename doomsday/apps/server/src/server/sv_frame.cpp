@@ -21,9 +21,12 @@
 #include "server/sv_frame.h"
 #include "def_main.h"
 #include "sys_system.h"
+#include "network/datagramchannel.h"
 #include "network/net_main.h"
+#include "network/net_buf.h"
 #include "server/sv_pool.h"
 #include "world/p_players.h"
+#include "serversystem.h"
 
 #include <de/LogBuffer>
 #include <cmath>
@@ -50,6 +53,15 @@ using namespace de;
 // If movement is faster than this, we'll adjust the place of the point.
 #define MOM_FAST_LIMIT      (127)
 
+// Limits for the time (milliseconds) after which unacked deltas are resent.
+#define MIN_ACK_THRESHOLD       50
+#define MAX_ACK_THRESHOLD       1000
+#define ACK_THRESHOLD_MARGIN    20
+
+// If datagram frames are not acked in this time (milliseconds), the client
+// will receive frames over TCP instead.
+#define DATAGRAM_ACK_TIMEOUT    3000
+
 void Sv_SendFrame(dint playerNumber);
 
 dint allowFrames;
@@ -100,6 +112,11 @@ void Sv_TransmitFrame()
     // How many players currently in the game?
     dint const numInGame = Sv_GetNumPlayers();
 
+    // Players who will be sent a frame during this tic.
+    dint framePlayers[DDMAXPLAYERS];
+    pool_t *framePools[DDMAXPLAYERS + 1];
+    dint numFrames = 0;
+
     dint pCount = 0;
     for (dint i = 0; i < DDMAXPLAYERS; ++i)
     {
@@ -128,12 +145,22 @@ void Sv_TransmitFrame()
 
         if (plr.ready)
         {
+            // Does the send queue allow us to send this packet?
+            // Bandwidth rating is updated during the check.
+            if (!Sv_CheckBandwidth(i))
+            {
+                // We cannot send anything at this time. This will only happen if
+                // the send queue has too many packets waiting to be sent.
+                continue;
+            }
+
             // A frame will be sent to this client. If the client
             // doesn't send ticcmds, the updatecount will eventually
             // decrease back to zero.
             //::clients[i].updateCount--;
 
-            Sv_SendFrame(i);
+            framePlayers[numFrames] = i;
+            framePools[numFrames++] = Sv_GetPool(i);
         }
         else
         {
@@ -141,6 +168,17 @@ void Sv_TransmitFrame()
                              ::lastTransmitTic << i << plr.ready);
         }
     }
+    framePools[numFrames] = nullptr;
+
+    // The priority queues of the clients need to be rebuilt before new
+    // frames can be sent. The pools are independent of each other, so they
+    // are all rated at once.
+    Sv_RatePools(framePools);
+
+    for (dint i = 0; i < numFrames; ++i)
+    {
+        Sv_SendFrame(framePlayers[i]);
+    }
 }
 
 /**
@@ -653,12 +691,10 @@ void Sv_WriteDeltaHeader(byte type, delta_t const *delta)
     }
 #endif
 
-    // Once sent, the deltas can be discarded and there is no need for resending.
-    DENG2_ASSERT(delta->state != DELTA_UNACKED);
-
+    // Deltas of frames sent over TCP are acked right away, so only deltas of
+    // lost (or late) datagram frames are resent.
     if (delta->state == DELTA_UNACKED)
     {
-        DENG2_ASSERT(!"Unacked");
         // Flag this as Resent.
         type |= DT_RESENT;
     }
@@ -775,41 +811,164 @@ byte Sv_GetNewResendID(pool_t *pool)
 }
 
 /**
- * Send a sv_frame packet to the specified player. The amount of data sent
- * depends on the player's bandwidth rating.
+ * Determines whether the player's frames are sent as datagrams. The first frame
+ * is always sent over TCP, because the client must not miss it.
  */
-void Sv_SendFrame(dint plrNum)
+static bool Sv_UsesDatagramFrames(dint plrNum)
 {
-    pool_t *pool = Sv_GetPool(plrNum);
+    return !Sv_GetPool(plrNum)->isFirst &&
+           App_ServerSystem().hasDatagramChannel(DD_Player(plrNum)->remoteUserId);
+}
+
+/**
+ * Tells the client where to send its datagrams. A zero token means that the client
+ * should close its datagram channel and use only TCP.
+ */
+static void Sv_SendDatagramOffer(dint plrNum, duint32 token)
+{
+    Msg_Begin(PSV_DATAGRAM_OFFER);
+    Writer_WriteUInt16(::msgWriter, token? App_ServerSystem().datagramPort() : 0);
+    Writer_WriteUInt32(::msgWriter, token);
+    Writer_WriteByte(::msgWriter, Sv_GetPool(plrNum)->frameEpoch);
+    Msg_End();
 
-    // Does the send queue allow us to send this packet?
-    // Bandwidth rating is updated during the check.
-    if (!Sv_CheckBandwidth(plrNum))
+    Net_SendBuffer(plrNum, 0);
+}
+
+duint Sv_GetAckThreshold(dint plrNum)
+{
+    if (!Sv_UsesDatagramFrames(plrNum)) return 0;
+
+    // Give the ack twice the average time to arrive before resending.
+    return de::clamp<duint>(MIN_ACK_THRESHOLD, 2 * Sv_GetPool(plrNum)->ackTime + ACK_THRESHOLD_MARGIN,
+                            MAX_ACK_THRESHOLD);
+}
+
+void Sv_OfferDatagramChannel(dint plrNum)
+{
+    LOG_AS("Sv_OfferDatagramChannel");
+
+    auto const &plr = *DD_Player(plrNum);
+    if (!plr.isConnected()) return;
+
+    duint32 const token = (::netDatagrams? App_ServerSystem().offerDatagramChannel(plr.remoteUserId) : 0);
+    if (token)
+    {
+        LOG_NET_VERBOSE("Offering a datagram channel to player %i") << plrNum;
+    }
+    Sv_SendDatagramOffer(plrNum, token);
+
+    // The ack time is measured anew for the channel.
+    Sv_GetPool(plrNum)->ackTime = 0;
+}
+
+void Sv_FrameAcked(dint plrNum)
+{
+    byte const epoch = Reader_ReadByte(::msgReader);
+    byte const set   = Reader_ReadByte(::msgReader);
+    byte const resentCount = Reader_ReadByte(::msgReader);
+
+    pool_t *pool = Sv_GetPool(plrNum);
+    if (epoch != pool->frameEpoch)
+    {
+        // This is about an earlier map; those deltas are already gone.
+        return;
+    }
+    if (!pool->setSentAt[set])
     {
-        // We cannot send anything at this time. This will only happen if
-        // the send queue has too many packets waiting to be sent.
+        // The set was not sent as a datagram, or it has already been acked.
+        LOGDEV_NET_VERBOSE("Player %i acked set %i that is not awaiting an ack")
+                << plrNum << set;
         return;
     }
 
-    // The priority queue of the client needs to be rebuilt before
-    // a new frame can be sent.
-    Sv_RatePool(pool);
+    Sv_AckDeltaSet(plrNum, set, 0);
+
+    // Deltas whose original set was lost were resent in this one. They are
+    // acked separately, since they still belong to their original sets. The
+    // client can't have received more of them than were sent in the set.
+    dint const count = de::min(resentCount, pool->setResentCount[set]);
+    for (dint i = 0; i < count && !Reader_AtEnd(::msgReader); ++i)
+    {
+        if (byte const resent = Reader_ReadByte(::msgReader))
+        {
+            Sv_AckDeltaSet(plrNum, 0, resent);
+        }
+    }
+
+    // Update the average ack time.
+    uint const now     = Sv_GetTimeStamp();
+    uint const ackTime = now - pool->setSentAt[set];
+    pool->ackTime   = (pool->ackTime? (3 * pool->ackTime + ackTime) / 4 : ackTime);
+    pool->lastAckAt = now;
+
+    // Further acks of this set are ignored.
+    pool->setSentAt[set] = 0;
+}
+
+/**
+ * Send a sv_frame packet to the specified player. The amount of data sent
+ * depends on the player's bandwidth rating. The player's pool must have been
+ * rated beforehand (Sv_RatePools()).
+ *
+ * Frames sent over TCP are acked right away. Datagram frames carry the epoch and
+ * set number, and their deltas remain unacked until the client acknowledges the
+ * set (Sv_FrameAcked()). Unacked deltas are resent after the ack threshold.
+ */
+void Sv_SendFrame(dint plrNum)
+{
+    LOG_AS("Sv_SendFrame");
+
+    pool_t *pool = Sv_GetPool(plrNum);
 
     // This will be a new set.
     DENG2_ASSERT(pool);
     pool->setDealer++;
 
+    bool const datagram = Sv_UsesDatagramFrames(plrNum);
+    if (datagram && Sv_GetTimeStamp() - pool->lastAckAt > DATAGRAM_ACK_TIMEOUT)
+    {
+        // The datagrams are not getting through (a firewall, perhaps).
+        LOG_NET_WARNING("Player %i is not acknowledging datagram frames; "
+                        "switching to TCP") << plrNum;
+        App_ServerSystem().closeDatagramChannel(DD_Player(plrNum)->remoteUserId);
+        Sv_SendDatagramOffer(plrNum, 0);
+
+        // The next frame will be sent over TCP.
+        return;
+    }
+
     // Determine the maximum size of the frame packet.
     dsize maxFrameSize = Sv_GetMaxFrameSize(plrNum);
     if (pool->isFirst)
     {
         // Allow more info for the first frame.
         maxFrameSize = MAX_FIRST_FRAME_SIZE;
+        pool->frameEpoch++;
+
+        // None of the sets of the earlier epoch can be acked any more.
+        de::zap(pool->setSentAt);
+    }
+    else if (datagram)
+    {
+        // The whole frame must fit in one datagram.
+        maxFrameSize = de::min(maxFrameSize, dsize(DatagramChannel::MAX_MESSAGE_SIZE));
     }
 
-    // If this is the first frame after a map change, use the special
-    // first frame packet type.
-    Msg_Begin(pool->isFirst ? PSV_FIRST_FRAME2 : PSV_FRAME2);
+    if (datagram)
+    {
+        // The client uses the set number to ack the frame and to discard
+        // frames that arrive late.
+        Msg_Begin(PSV_DATAGRAM_FRAME2);
+        Writer_WriteByte(::msgWriter, pool->frameEpoch);
+        Writer_WriteByte(::msgWriter, pool->setDealer);
+    }
+    else
+    {
+        // If this is the first frame after a map change, use the special
+        // first frame packet type.
+        Msg_Begin(pool->isFirst ? PSV_FIRST_FRAME2 : PSV_FRAME2);
+    }
 
     // First send the gameTime of this frame.
     Writer_WriteFloat(::msgWriter, ::gameTime);
@@ -817,11 +976,16 @@ void Sv_SendFrame(dint plrNum)
     // Keep writing until the maximum size is reached.
     delta_t *delta;
     size_t lastStart;
+    dint resentCount = 0;
     while ((delta = Sv_PoolQueueExtract(pool)) != nullptr &&
           (lastStart = Writer_Size(::msgWriter)) < maxFrameSize)
     {
         byte const oldResend = pool->resendDealer;
 
+        // Only deltas of datagram sets still waiting for an ack are resent.
+        // Deltas of sets sent over TCP were acked right after sending.
+        DENG2_ASSERT(delta->state != DELTA_UNACKED || pool->setSentAt[delta->set]);
+
         // Is this going to be a resent?
         if (delta->state == DELTA_UNACKED && !delta->resend)
         {
@@ -858,18 +1022,44 @@ void Sv_SendFrame(dint plrNum)
         {
             // New deltas are assigned to this set. Unacked deltas will
             // remain in the set they were initially sent in.
-            delta->set       = pool->setDealer;
-            delta->timeStamp = Sv_GetTimeStamp();
-            delta->state     = DELTA_UNACKED;
+            delta->set   = pool->setDealer;
+            delta->state = DELTA_UNACKED;
+        }
+        else if (datagram)
+        {
+            // The client lists the resend IDs of these in its ack.
+            resentCount++;
         }
+        else
+        {
+            // There will be no ack from the client, so the resent delta is
+            // acked along with this set.
+            delta->set = pool->setDealer;
+        }
+        delta->timeStamp = Sv_GetTimeStamp();
     }
 
     Msg_End();
 
-    Net_SendBuffer(plrNum, 0);
+    if (datagram)
+    {
+        // Zero would mean the set is not awaiting an ack.
+        pool->setSentAt[pool->setDealer]      = de::max(1u, Sv_GetTimeStamp());
+        pool->setResentCount[pool->setDealer] = byte(de::min(resentCount, 255));
+        Net_SendBuffer(plrNum, SPF_DATAGRAM);
+    }
+    else
+    {
+        pool->setSentAt[pool->setDealer] = 0;
+        Net_SendBuffer(plrNum, 0);
 
-    // Once sent, the delta set can be discarded.
-    Sv_AckDeltaSet(plrNum, pool->setDealer, 0);
+        // Once sent, the delta set can be discarded.
+        Sv_AckDeltaSet(plrNum, pool->setDealer, 0);
+
+        // Datagram frames may begin with the next frame, so acks are expected
+        // from this point on.
+        pool->lastAckAt = Sv_GetTimeStamp();
+    }
 
     // Now a frame has been sent.
     pool->isFirst = false;
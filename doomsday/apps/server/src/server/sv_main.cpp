@@ -47,6 +47,7 @@
 #include "serversystem.h"
 #include "server/sv_def.h"
 #include "server/sv_pool.h"
+#include "server/sv_frame.h"
 
 using namespace de;
 
@@ -69,6 +70,9 @@ dint svMaxPlayers = DDMAXPLAYERS;
 
 static world::MaterialArchive *materialDict;
 
+/// Game time of the latest coordinates received from each client.
+static dfloat lastCoordsTime[DDMAXPLAYERS];
+
 #if 0
 /**
  * @defgroup pathToStringFlags  Path To String Flags
@@ -546,6 +550,14 @@ void Sv_GetPackets(void)
             Sv_ClientCoords(netBuffer.player);
             break;
 
+        case PCL_DATAGRAM_REQUEST:
+            Sv_OfferDatagramChannel(netBuffer.player);
+            break;
+
+        case PCL_ACK_SETS:
+            Sv_FrameAcked(netBuffer.player);
+            break;
+
         case PCL_ACK_SHAKE:
             // The client has acknowledged our handshake.
             // Note the time (this isn't perfectly accurate, though).
@@ -630,6 +642,7 @@ dd_bool Sv_PlayerArrives(unsigned int nodeID, char const *name)
             // This'll do.
             plr->remoteUserId = nodeID;
             plr->lastTransmit = -1;
+            lastCoordsTime[i] = 0;
             plr->ready = false;
             plr->viewConsole = i;
             strncpy(plr->name, name, PLAYERNAMELEN);
@@ -1128,6 +1141,16 @@ void Sv_ClientCoords(int plrNum)
 
     clientGameTime = Reader_ReadFloat(msgReader);
 
+    // Coordinates sent as datagrams may arrive out of order. The late ones would
+    // be in the past for the smoother, so they are discarded. (A large step back
+    // in time means the game time has been reset.)
+    if (clientGameTime < lastCoordsTime[plrNum] &&
+        lastCoordsTime[plrNum] - clientGameTime < 1)
+    {
+        return;
+    }
+    lastCoordsTime[plrNum] = clientGameTime;
+
     clientPos[VX] = Reader_ReadFloat(msgReader);
     clientPos[VY] = Reader_ReadFloat(msgReader);
 
@@ -29,9 +29,12 @@
 #include <de/timer.h>
 #include <de/vector1.h>
 #include <de/LogBuffer>
+#include <de/TaskPool>
+#include <vector>
 #include "def_main.h"  // Def_SameStateSequence
 
 #include "network/net_main.h"
+#include "server/sv_frame.h"
 
 #include "world/p_object.h"
 #include "world/p_players.h"
@@ -42,22 +45,47 @@ using namespace de;
 
 #define DEFAULT_DELTA_BASE_SCORE    ( 10000 )
 
-#define REG_MOBJ_HASH_SIZE          ( 1024 )
-#define REG_MOBJ_HASH_FUNCTION_MASK ( 0x3ff )
+// Scores of queued deltas are recalculated after this many milliseconds.
+#define DELTA_RERATE_INTERVAL       ( 100 )
+
+// If the pool owner moves farther than this, all deltas of the pool are re-rated.
+#define POOL_RERATE_DISTANCE        ( 64 )
+
+// Initial number of slots in the register mobj index (must be a power of two).
+#define REG_MOBJ_MIN_SLOTS          ( 256 )
 
 // Maximum difference in plane height where the absolute height doesn't need to be sent.
 #define PLANE_SKIP_LIMIT            ( 40 )
 
 struct reg_mobj_t
 {
-    reg_mobj_t *next;  ///< In the register hash.
-    reg_mobj_t *prev;  ///< In the register hash.
     dt_mobj_t mo;      ///< The state of the mobj.
 };
 
-struct mobjhash_t
+/**
+ * Slot in the open-addressed mobj index of the register.
+ */
+struct reg_mobjslot_t
+{
+    thid_t id;
+    duint index;       ///< Index of the register-mobj plus one (zero= empty slot).
+};
+
+/**
+ * Registered mobjs are stored contiguously in an array. An open-addressed index
+ * (linear probing, ID is the key) is used for finding mobjs by ID. Removing a
+ * mobj moves the last mobj of the array into the vacated place and shifts the
+ * following index slots backward, so no tombstones are left behind.
+ */
+struct mobjregister_t
 {
-    reg_mobj_t *first, *last;
+    reg_mobj_t *mobjs;
+    dint count;
+    dint allocated;
+
+    reg_mobjslot_t *slots;
+    duint slotMask;    ///< Number of slots minus one.
+    dint slotShift;    ///< 32 minus the base-2 logarithm of the number of slots.
 };
 
 /**
@@ -68,8 +96,8 @@ struct cregister_t
     dint gametic;       ///< The time the register was last updated.
     dd_bool isInitial;  ///< @c true if *this* register contains a read-only copy of the initial state of the world.
 
-    // The mobjs are stored in a hash for efficiency (ID is the key).
-    mobjhash_t mobjs[REG_MOBJ_HASH_SIZE];
+    // The mobjs are stored in a flat table for efficiency (ID is the key).
+    mobjregister_t mobjs;
 
     dt_player_t ddPlayers[DDMAXPLAYERS];
     dt_sector_t *sectors;
@@ -81,6 +109,7 @@ void Sv_RegisterWorld(cregister_t *reg, dd_bool isInitial);
 void Sv_NewDelta(void *deltaPtr, deltatype_t type, duint id);
 dd_bool Sv_IsVoidDelta(void const *delta);
 void Sv_PoolQueueClear(pool_t *pool);
+void Sv_PoolQueueRemove(pool_t *pool, delta_t *delta);
 void Sv_GenerateNewDeltas(cregister_t *reg, dint clientNumber, dd_bool doUpdate);
 
 // The register contains the previous state of the world.
@@ -146,6 +175,7 @@ void Sv_InitPools()
         pool.queueSize     = 0;
         pool.allocatedSize = 0;
         pool.queue         = nullptr;
+        V3d_Set(pool.ratedOrigin, DDMAXFLOAT, DDMAXFLOAT, DDMAXFLOAT);
 
         pool.isFirst       = true;  // Set to @c false when a frame is sent.
     }
@@ -195,91 +225,150 @@ pool_t *Sv_GetPool(duint consoleNumber)
 }
 
 /**
- * The hash function for the register mobj hash.
+ * The hash function for the register mobj index. Returns the home slot of @a id
+ * in an index of 2^(32 - @a shift) slots.
+ */
+static duint Sv_RegisterHashFunction(thid_t id, dint shift)
+{
+    // Fibonacci hashing spreads consecutive IDs evenly over the slots. The top
+    // bits of the product are the best mixed ones.
+    return (duint(id) * 2654435769u) >> shift;
+}
+
+/**
+ * Returns the index slot of the register-mobj @a id, or the empty slot where it
+ * would be placed.
+ */
+static reg_mobjslot_t *Sv_RegisterMobjSlot(mobjregister_t const &reg, thid_t id)
+{
+    DENG2_ASSERT(reg.slots);
+    for (duint i = Sv_RegisterHashFunction(id, reg.slotShift); ; i = (i + 1) & reg.slotMask)
+    {
+        reg_mobjslot_t *slot = &reg.slots[i];
+        if (!slot->index || slot->id == id) return slot;
+    }
+}
+
+/**
+ * Rebuilds the mobj index with @a numSlots slots.
  */
-duint Sv_RegisterHashFunction(thid_t id)
+static void Sv_RegisterRehashMobjs(mobjregister_t &reg, duint numSlots)
 {
-    return (duint) id & REG_MOBJ_HASH_FUNCTION_MASK;
+    DENG2_ASSERT(numSlots && !(numSlots & (numSlots - 1)));
+
+    Z_Free(reg.slots);
+    reg.slots    = (reg_mobjslot_t *) Z_Calloc(sizeof(*reg.slots) * numSlots, PU_MAP, 0);
+    reg.slotMask = numSlots - 1;
+    reg.slotShift = 32;
+    for (duint n = numSlots; n > 1; n >>= 1) reg.slotShift--;
+
+    for (dint i = 0; i < reg.count; ++i)
+    {
+        reg_mobjslot_t *slot = Sv_RegisterMobjSlot(reg, reg.mobjs[i].mo.thinker.id);
+        slot->id    = reg.mobjs[i].mo.thinker.id;
+        slot->index = duint(i) + 1;
+    }
 }
 
 /**
  * Returns a pointer to the register map-object, if it already exists.
+ *
+ * @note The returned pointer remains valid only until a mobj is added to or
+ * removed from the register.
  */
 reg_mobj_t *Sv_RegisterFindMobj(cregister_t *reg, thid_t id)
 {
     DENG2_ASSERT(reg);
+    mobjregister_t const &mobjs = reg->mobjs;
+
+    if (!mobjs.count) return nullptr;
 
-    // See if there already is a register-mobj for this id.
-    mobjhash_t const &hash = reg->mobjs[Sv_RegisterHashFunction(id)];
-    for (reg_mobj_t *it = hash.first; it; it = it->next)
+    reg_mobjslot_t const *slot = Sv_RegisterMobjSlot(mobjs, id);
+    if (slot->index)
     {
-        if (it->mo.thinker.id == id) return it;
+        return &mobjs.mobjs[slot->index - 1];
     }
-
     return nullptr;  // Not found.
 }
 
 /**
- * Adds a new reg_mobj_t to the register's mobj hash.
+ * Adds a new reg_mobj_t to the register's mobj table.
  */
 reg_mobj_t *Sv_RegisterAddMobj(cregister_t *reg, thid_t id)
 {
     DENG2_ASSERT(reg);
-    mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(id)];
+    mobjregister_t &mobjs = reg->mobjs;
 
     // Try to find an existing register-mobj.
-    if (reg_mobj_t *newRegMo = Sv_RegisterFindMobj(reg, id))
-        return newRegMo;
-
-    // Allocate the new register-mobj.
-    auto *newRegMo = (reg_mobj_t *) Z_Calloc(sizeof(reg_mobj_t), PU_MAP, 0);
+    if (reg_mobj_t *existing = Sv_RegisterFindMobj(reg, id))
+        return existing;
 
-    // Link it to the end of the hash list.
-    if (hash.last)
+    // Keep the index at most half full.
+    if (!mobjs.slots)
+    {
+        Sv_RegisterRehashMobjs(mobjs, REG_MOBJ_MIN_SLOTS);
+    }
+    else if (duint(mobjs.count + 1) * 2 > mobjs.slotMask + 1)
     {
-        hash.last->next = newRegMo;
-        newRegMo->prev = hash.last;
+        Sv_RegisterRehashMobjs(mobjs, (mobjs.slotMask + 1) * 2);
     }
-    hash.last = newRegMo;
 
-    if (!hash.first)
+    // Do we need more room for the register-mobjs?
+    if (mobjs.count == mobjs.allocated)
     {
-        hash.first = newRegMo;
+        mobjs.allocated = de::max(2 * mobjs.allocated, REG_MOBJ_MIN_SLOTS / 2);
+        mobjs.mobjs = (reg_mobj_t *) Z_Realloc(mobjs.mobjs, sizeof(*mobjs.mobjs) * mobjs.allocated, PU_MAP);
     }
 
+    reg_mobj_t *newRegMo = &mobjs.mobjs[mobjs.count++];
+    std::memset(newRegMo, 0, sizeof(*newRegMo));
+    newRegMo->mo.thinker.id = id;
+
+    reg_mobjslot_t *slot = Sv_RegisterMobjSlot(mobjs, id);
+    slot->id    = id;
+    slot->index = duint(mobjs.count);
+
     return newRegMo;
 }
 
 /**
- * Removes a reg_mobj_t from the register's mobj hash.
+ * Removes a reg_mobj_t from the register's mobj table. The last register-mobj
+ * is moved to the place of the removed one.
  */
 void Sv_RegisterRemoveMobj(cregister_t *reg, reg_mobj_t *regMo)
 {
-    DENG2_ASSERT(regMo);
-    mobjhash_t &hash = reg->mobjs[Sv_RegisterHashFunction(regMo->mo.thinker.id)];
+    DENG2_ASSERT(reg && regMo);
+    mobjregister_t &mobjs = reg->mobjs;
 
-    // Update the first and last links.
-    if (hash.last == regMo)
-    {
-        hash.last = regMo->prev;
-    }
-    if (hash.first == regMo)
-    {
-        hash.first = regMo->next;
-    }
+    reg_mobjslot_t *slot = Sv_RegisterMobjSlot(mobjs, regMo->mo.thinker.id);
+    DENG2_ASSERT(slot->index && &mobjs.mobjs[slot->index - 1] == regMo);
+
+    dint const index = dint(slot->index) - 1;
 
-    // Link out of the list.
-    if (regMo->next)
+    // Shift the following slots of the probe sequence backward so that lookups
+    // don't need to step over deleted entries.
+    duint hole = duint(slot - mobjs.slots);
+    for (duint i = (hole + 1) & mobjs.slotMask; mobjs.slots[i].index; i = (i + 1) & mobjs.slotMask)
     {
-        regMo->next->prev = regMo->prev;
+        duint const home = Sv_RegisterHashFunction(mobjs.slots[i].id, mobjs.slotShift);
+
+        // The entry can be moved into the hole unless its home slot is
+        // cyclically within (hole, i].
+        if (((i - home) & mobjs.slotMask) >= ((i - hole) & mobjs.slotMask))
+        {
+            mobjs.slots[hole] = mobjs.slots[i];
+            hole = i;
+        }
     }
-    if (regMo->prev)
+    mobjs.slots[hole].index = 0;
+
+    // Fill the gap in the array with the last register-mobj.
+    if (index != mobjs.count - 1)
     {
-        regMo->prev->next = regMo->next;
+        std::memcpy(&mobjs.mobjs[index], &mobjs.mobjs[mobjs.count - 1], sizeof(reg_mobj_t));
+        Sv_RegisterMobjSlot(mobjs, mobjs.mobjs[index].mo.thinker.id)->index = duint(index) + 1;
     }
-
-    // Destroy the register-mobj.
-    Z_Free(regMo);
+    mobjs.count--;
 }
 
 /**
@@ -1004,8 +1093,8 @@ void Sv_UpdateOwnerInfo(pool_t *pool)
 
     // The acknowledgement threshold is a multiple of the average ack time of the
     // client. If an unacked delta is not acked within the threshold, it'll be
-    // re-included in the ratings.
-    info->ackThreshold = 0; //Net_GetAckThreshold(pool->owner);
+    // re-included in the ratings. Frames sent over TCP are acked immediately.
+    info->ackThreshold = Sv_GetAckThreshold(pool->owner);
 }
 
 /**
@@ -1106,13 +1195,12 @@ dd_bool Sv_IsSameDelta(void const *delta1, void const *delta2)
 }
 
 /**
- * Makes a copy of the delta.
+ * @return  Size of the delta structure of the given type, in bytes. Zero is
+ *          returned for unknown types.
  */
-void* Sv_CopyDelta(void* deltaPtr)
+size_t Sv_DeltaSize(delta_t const *delta)
 {
-    void*               newDelta;
-    delta_t*            delta = (delta_t *) deltaPtr;
-    size_t              size =
+    return
         ( delta->type == DT_MOBJ ?         sizeof(mobjdelta_t)
         : delta->type == DT_PLAYER ?       sizeof(playerdelta_t)
         : delta->type == DT_SECTOR ?       sizeof(sectordelta_t)
@@ -1125,6 +1213,16 @@ void* Sv_CopyDelta(void* deltaPtr)
         : delta->type == DT_POLY_SOUND ?   sizeof(sounddelta_t)
          /* : delta->type == DT_LUMP?   sizeof(lumpdelta_t) */
         : 0);
+}
+
+/**
+ * Makes a copy of the delta.
+ */
+void* Sv_CopyDelta(void* deltaPtr)
+{
+    void*               newDelta;
+    delta_t*            delta = (delta_t *) deltaPtr;
+    size_t              size = Sv_DeltaSize(delta);
 
     if (size == 0)
     {
@@ -1634,6 +1732,9 @@ void Sv_RemoveDelta(pool_t* pool, void* deltaPtr)
     delta_t*            delta = (delta_t *) deltaPtr;
     deltalink_t*        hash = Sv_PoolHash(pool, delta->id);
 
+    // The queue must not point to removed deltas.
+    Sv_PoolQueueRemove(pool, delta);
+
     // Update first and last links.
     if (hash->last == delta)
     {
@@ -1678,6 +1779,7 @@ void Sv_DrainPool(uint clientNumber)
     pool->resendDealer = 0;
 
     Sv_PoolQueueClear(pool);
+    V3d_Set(pool->ratedOrigin, DDMAXFLOAT, DDMAXFLOAT, DDMAXFLOAT);
 
     // Free all deltas stored in the hash.
     for (i = 0; i < POOL_HASH_SIZE; ++i)
@@ -1878,6 +1980,9 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
                     Sv_RemoveDelta(pool, iter);
                     continue;
                 }
+
+                // The contents changed, so it needs to be rated again.
+                Sv_PoolQueueRemove(pool, iter);
             }
         }
     }
@@ -1891,6 +1996,11 @@ void Sv_AddDelta(pool_t* pool, void* deltaPtr)
             // The existing delta must be removed.
             Sv_RemoveDelta(pool, existingNew);
         }
+        else
+        {
+            // The merged delta needs to be rated again.
+            Sv_PoolQueueRemove(pool, existingNew);
+        }
     }
     else
     {
@@ -1928,6 +2038,106 @@ void Sv_AddDeltaToPools(void* deltaPtr, pool_t** targets)
     }
 }
 
+/**
+ * Deltas produced by one comparison of a register against the world, kept in
+ * the order they were generated. The comparison is done once on the calling
+ * thread; adding the deltas to the target pools is independent for each pool
+ * and is therefore done concurrently. Because every pool still receives the
+ * deltas in generation order, the pool contents are identical to adding each
+ * delta to all the pools one at a time.
+ */
+class FrameDeltas
+{
+public:
+    FrameDeltas(pool_t **targets) : _targets(targets)
+    {
+        for (_numTargets = 0; targets[_numTargets]; ++_numTargets) {}
+    }
+
+    pool_t **targets() const
+    {
+        return _targets;
+    }
+
+    /**
+     * Takes a copy of the delta. The delta is not yet added to any pool.
+     */
+    void add(void const *deltaPtr)
+    {
+        if (!_numTargets) return;
+
+        size_t const size = Sv_DeltaSize((delta_t const *) deltaPtr);
+        DENG2_ASSERT(size > 0);
+
+        // Keep the copies suitably aligned.
+        size_t const offset = (_data.size() + 7) & ~size_t(7);
+        _data.resize(offset + size);
+        std::memcpy(&_data[offset], deltaPtr, size);
+        _offsets.push_back(offset);
+    }
+
+    /**
+     * Adds all the collected deltas to the target pools. Returns when all
+     * the pools have been updated.
+     */
+    void distribute()
+    {
+        if (_offsets.empty()) return;
+
+        if (_numTargets == 1)
+        {
+            addToPool(*_targets[0]);
+        }
+        else
+        {
+            TaskPool tasks;
+            for (pool_t **pool = _targets; *pool; pool++)
+            {
+                pool_t *target = *pool;
+                tasks.start([this, target] () { addToPool(*target); },
+                            TaskPool::HighPriority);
+            }
+            tasks.waitForDone();
+        }
+        _data.clear();
+        _offsets.clear();
+    }
+
+private:
+    void addToPool(pool_t &pool) const
+    {
+        // Sv_AddDelta temporarily modifies the delta it is given, so each
+        // pool works on its own copy.
+        alignas(mobjdelta_t) dbyte buf[sizeof(mobjdelta_t)];
+
+        // The mobj delta is the largest one (see Sv_DeltaSize()).
+        static_assert(sizeof(playerdelta_t) <= sizeof(buf) &&
+                      sizeof(sectordelta_t) <= sizeof(buf) &&
+                      sizeof(sidedelta_t)   <= sizeof(buf) &&
+                      sizeof(polydelta_t)   <= sizeof(buf) &&
+                      sizeof(sounddelta_t)  <= sizeof(buf),
+                      "delta copy buffer is too small for all delta types");
+        static_assert(alignof(playerdelta_t) <= alignof(mobjdelta_t) &&
+                      alignof(sectordelta_t) <= alignof(mobjdelta_t) &&
+                      alignof(sidedelta_t)   <= alignof(mobjdelta_t) &&
+                      alignof(polydelta_t)   <= alignof(mobjdelta_t) &&
+                      alignof(sounddelta_t)  <= alignof(mobjdelta_t),
+                      "delta copy buffer is not aligned for all delta types");
+
+        for (size_t offset : _offsets)
+        {
+            auto const *delta = reinterpret_cast<delta_t const *>(&_data[offset]);
+            std::memcpy(buf, delta, Sv_DeltaSize(delta));
+            Sv_AddDelta(&pool, buf);
+        }
+    }
+
+    pool_t **_targets;
+    dint _numTargets;
+    std::vector<dbyte> _data;
+    std::vector<size_t> _offsets;
+};
+
 /**
  * All NEW deltas for the mobj are removed from the pool as obsolete.
  */
@@ -2051,41 +2261,36 @@ int Sv_GetTargetPools(pool_t** targets, int clientsMask)
 
 /**
  * Null deltas are generated for mobjs that have been destroyed.
- * The register's mobj hash is scanned to see which mobjs no longer exist.
+ * The register's mobj table is scanned to see which mobjs no longer exist.
  *
  * When updating, the destroyed mobjs are removed from the register.
  */
-void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, FrameDeltas &frame)
 {
-    int i;
-    mobjhash_t *hash;
-    reg_mobj_t *obj, *next = 0;
     mobjdelta_t null;
 
-    for (i = 0, hash = reg->mobjs; i < REG_MOBJ_HASH_SIZE; ++i, hash++)
+    // Removal moves the last register-mobj into the removed one's place, so
+    // iterate backwards.
+    for (dint i = reg->mobjs.count - 1; i >= 0; --i)
     {
-        for (obj = hash->first; obj; obj = next)
-        {
-            // This reg_mobj_t might be removed.
-            next = obj->next;
+        reg_mobj_t *obj = &reg->mobjs.mobjs[i];
 
-            /// @todo Do not assume mobj is from the CURRENT map.
-            if (!worldSys().map().thinkers().isUsedMobjId(obj->mo.thinker.id))
-            {
-                // This object no longer exists!
-                Sv_NewDelta(&null, DT_MOBJ, obj->mo.thinker.id);
-                null.delta.flags = MDFC_NULL;
+        /// @todo Do not assume mobj is from the CURRENT map.
+        if (!worldSys().map().thinkers().isUsedMobjId(obj->mo.thinker.id))
+        {
+            // This object no longer exists!
+            Sv_NewDelta(&null, DT_MOBJ, obj->mo.thinker.id);
+            null.delta.flags = MDFC_NULL;
 
-                // We need all the data for positioning.
-                memcpy(&null.mo, &obj->mo, sizeof(dt_mobj_t));
+            // We need all the data for positioning.
+            memcpy(&null.mo, &obj->mo, sizeof(dt_mobj_t));
 
-                Sv_AddDeltaToPools(&null, targets);
+            frame.add(&null);
 
-                if (doUpdate)
-                {
-                    // Keep the register up to date.
-                    Sv_RegisterRemoveMobj(reg, obj);
-                }
+            if (doUpdate)
+            {
+                // Keep the register up to date.
+                Sv_RegisterRemoveMobj(reg, obj);
             }
         }
     }
@@ -2094,10 +2299,10 @@ void Sv_NewNullDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
 /**
  * Mobj deltas are generated for all mobjs that have changed.
  */
-void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, FrameDeltas &frame)
 {
     worldSys().map().thinkers().forAll(reinterpret_cast<thinkfunc_t>(gx.MobjThinker),
-                                       0x1 /*public*/, [&reg, &doUpdate, &targets] (thinker_t *th)
+                                       0x1 /*public*/, [&reg, &doUpdate, &frame] (thinker_t *th)
     {
         auto &mob = *reinterpret_cast<mobj_t *>(th);
 
@@ -2108,7 +2313,7 @@ void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
             mobjdelta_t delta;
             if (Sv_RegisterCompareMobj(reg, &mob, &delta))
             {
-                Sv_AddDeltaToPools(&delta, targets);
+                frame.add(&delta);
 
                 if (doUpdate)
                 {
@@ -2124,7 +2329,7 @@ void Sv_NewMobjDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
 /**
  * Player deltas are generated for changed player data.
  */
-void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
+void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, FrameDeltas &frame)
 {
     playerdelta_t player;
     uint i;
@@ -2150,7 +2355,7 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
                 }
             }
 
-            Sv_AddDeltaToPools(&player, targets);
+            frame.add(&player);
         }
 
         if (doUpdate)
@@ -2159,7 +2364,7 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
         }
 
         // What about forced deltas?
-        if (Sv_IsPoolTargeted(Sv_GetPool(i), targets))
+        if (Sv_IsPoolTargeted(Sv_GetPool(i), frame.targets()))
         {
 #if 0
             if (DD_Player(i).flags & DDPF_FIXANGLES)
@@ -2205,7 +2410,7 @@ void Sv_NewPlayerDeltas(cregister_t* reg, dd_bool doUpdate, pool_t** targets)
 /**
  * Sector deltas are generated for changed sectors.
  */
-void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, FrameDeltas &frame)
 {
     sectordelta_t delta;
 
@@ -2213,7 +2418,7 @@ void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
     {
         if (Sv_RegisterCompareSector(reg, i, &delta, doUpdate))
         {
-            Sv_AddDeltaToPools(&delta, targets);
+            frame.add(&delta);
         }
     }
 }
@@ -2223,7 +2428,7 @@ void Sv_NewSectorDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
  * Changes in sides (textures) are so rare that all sides need not be
  * checked on every tic.
  */
-void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, FrameDeltas &frame)
 {
     static uint numShifts = 2, shift = 0;
 
@@ -2253,7 +2458,7 @@ void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
     {
         if (Sv_RegisterCompareSide(reg, i, &delta, doUpdate))
         {
-            Sv_AddDeltaToPools(&delta, targets);
+            frame.add(&delta);
         }
     }
 }
@@ -2261,7 +2466,7 @@ void Sv_NewSideDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
 /**
  * Poly deltas are generated for changed polyobjs.
  */
-void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
+void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, FrameDeltas &frame)
 {
     LOG_AS("Sv_NewPolyDeltas");
 
@@ -2274,7 +2479,7 @@ void Sv_NewPolyDeltas(cregister_t *reg, dd_bool doUpdate, pool_t **targets)
         {
             LOGDEV_NET_XVERBOSE_DEBUGONLY("Change in poly %i", i);
 
-            Sv_AddDeltaToPools(&delta, targets);
+            frame.add(&delta);
         }
 
         if (doUpdate)
@@ -2417,23 +2622,30 @@ void Sv_GenerateNewDeltas(cregister_t* reg, int clientNumber, dd_bool doUpdate)
         Sv_UpdateOwnerInfo(*pool);
     }
 
+    // The world is compared against the register only once; the resulting
+    // deltas are then added to each of the target pools.
+    FrameDeltas frame(targets);
+
     // Generate null deltas (removed mobjs).
-    Sv_NewNullDeltas(reg, doUpdate, targets);
+    Sv_NewNullDeltas(reg, doUpdate, frame);
 
     // Generate mobj deltas.
-    Sv_NewMobjDeltas(reg, doUpdate, targets);
+    Sv_NewMobjDeltas(reg, doUpdate, frame);
 
     // Generate player deltas.
-    Sv_NewPlayerDeltas(reg, doUpdate, targets);
+    Sv_NewPlayerDeltas(reg, doUpdate, frame);
 
     // Generate sector deltas.
-    Sv_NewSectorDeltas(reg, doUpdate, targets);
+    Sv_NewSectorDeltas(reg, doUpdate, frame);
 
     // Generate side deltas.
-    Sv_NewSideDeltas(reg, doUpdate, targets);
+    Sv_NewSideDeltas(reg, doUpdate, frame);
 
     // Generate poly deltas.
-    Sv_NewPolyDeltas(reg, doUpdate, targets);
+    Sv_NewPolyDeltas(reg, doUpdate, frame);
+
+    // Update the pools.
+    frame.distribute();
 
     if (doUpdate)
     {
@@ -2456,9 +2668,22 @@ void Sv_GenerateFrameDeltas(void)
  */
 void Sv_PoolQueueClear(pool_t* pool)
 {
+    for (int i = 0; i < pool->queueSize; ++i)
+    {
+        pool->queue[i]->queuePos = 0;
+    }
     pool->queueSize = 0;
 }
 
+/**
+ * Places the delta at the given position in the queue.
+ */
+static inline void Sv_PoolQueueSet(pool_t* pool, int index, delta_t* delta)
+{
+    pool->queue[index] = delta;
+    delta->queuePos = index + 1;
+}
+
 /**
  * Exchanges two elements in the queue.
  */
@@ -2466,8 +2691,64 @@ void Sv_PoolQueueExchange(pool_t* pool, int index1, int index2)
 {
     delta_t *temp = pool->queue[index1];
 
-    pool->queue[index1] = pool->queue[index2];
-    pool->queue[index2] = temp;
+    Sv_PoolQueueSet(pool, index1, pool->queue[index2]);
+    Sv_PoolQueueSet(pool, index2, temp);
+}
+
+/**
+ * Moves the element at @a index up in the heap until the correct place is found.
+ *
+ * @return  New index of the element.
+ */
+static int Sv_PoolQueueRise(pool_t* pool, int i)
+{
+    while (i > 0)
+    {
+        int parent = HEAP_PARENT(i);
+
+        // Is it good now?
+        if (pool->queue[parent]->score >= pool->queue[i]->score)
+            break;
+
+        // Exchange with the parent.
+        Sv_PoolQueueExchange(pool, parent, i);
+
+        i = parent;
+    }
+    return i;
+}
+
+/**
+ * Moves the element at @a index down in the heap until the correct place is found.
+ * This is O(log n).
+ */
+static void Sv_PoolQueueSink(pool_t* pool, int i)
+{
+    for (;;)
+    {
+        int left = HEAP_LEFT(i);
+        int right = HEAP_RIGHT(i);
+        int big = i;
+
+        // Which child is more important?
+        if (left < pool->queueSize &&
+           pool->queue[left]->score > pool->queue[i]->score)
+        {
+            big = left;
+        }
+        if (right < pool->queueSize &&
+           pool->queue[right]->score > pool->queue[big]->score)
+        {
+            big = right;
+        }
+
+        // Can we stop now?
+        if (big == i) break;
+
+        // Exchange and continue.
+        Sv_PoolQueueExchange(pool, i, big);
+        i = big;
+    }
 }
 
 /**
@@ -2476,7 +2757,7 @@ void Sv_PoolQueueExchange(pool_t* pool, int index1, int index2)
  */
 void Sv_PoolQueueAdd(pool_t* pool, delta_t* delta)
 {
-    int                 i, parent;
+    DENG2_ASSERT(!delta->queuePos);
 
     // Do we need more memory?
     if (pool->allocatedSize == pool->queueSize)
@@ -2507,24 +2788,38 @@ void Sv_PoolQueueAdd(pool_t* pool, delta_t* delta)
         pool->queue = newQueue;
     }
 
-    // Add the new delta to the end of the queue array.
-    i = pool->queueSize;
-    pool->queue[i] = delta;
-    ++pool->queueSize;
+    // Add the new delta to the end of the queue array and let it rise in
+    // the heap.
+    Sv_PoolQueueSet(pool, pool->queueSize, delta);
+    Sv_PoolQueueRise(pool, pool->queueSize++);
+}
 
-    // Rise in the heap until the correct place is found.
-    while (i > 0)
-    {
-        parent = HEAP_PARENT(i);
+/**
+ * Restores the heap order after the score of a queued delta has changed.
+ */
+void Sv_PoolQueueUpdate(pool_t* pool, delta_t* delta)
+{
+    DENG2_ASSERT(delta->queuePos > 0 && pool->queue[delta->queuePos - 1] == delta);
 
-        // Is it good now?
-        if (pool->queue[parent]->score >= delta->score)
-            break;
+    Sv_PoolQueueSink(pool, Sv_PoolQueueRise(pool, delta->queuePos - 1));
+}
 
-        // Exchange with the parent.
-        Sv_PoolQueueExchange(pool, parent, i);
+/**
+ * Removes the delta from the priority queue, if it is queued.
+ */
+void Sv_PoolQueueRemove(pool_t* pool, delta_t* delta)
+{
+    if (!delta->queuePos) return;
 
-        i = parent;
+    int const index = delta->queuePos - 1;
+    DENG2_ASSERT(pool->queue[index] == delta);
+    delta->queuePos = 0;
+
+    // Fill the hole with the last element.
+    if (index != --pool->queueSize)
+    {
+        Sv_PoolQueueSet(pool, index, pool->queue[pool->queueSize]);
+        Sv_PoolQueueSink(pool, Sv_PoolQueueRise(pool, index));
     }
 }
 
@@ -2535,10 +2830,6 @@ void Sv_PoolQueueAdd(pool_t* pool, delta_t* delta)
  */
 delta_t* Sv_PoolQueueExtract(pool_t* pool)
 {
-    delta_t*            max;
-    int                 i, left, right, big;
-    dd_bool             isDone;
-
     if (!pool->queueSize)
     {
         // There is nothing in the queue.
@@ -2546,46 +2837,8 @@ delta_t* Sv_PoolQueueExtract(pool_t* pool)
     }
 
     // This is what we'll return.
-    max = pool->queue[0];
-
-    // Remove the first element from the queue.
-    pool->queue[0] = pool->queue[--pool->queueSize];
-
-    // Heapify the heap. This is O(log n).
-    i = 0;
-    isDone = false;
-    while (!isDone)
-    {
-        left = HEAP_LEFT(i);
-        right = HEAP_RIGHT(i);
-        big = i;
-
-        // Which child is more important?
-        if (left < pool->queueSize &&
-           pool->queue[left]->score > pool->queue[i]->score)
-        {
-            big = left;
-        }
-        if (right < pool->queueSize &&
-           pool->queue[right]->score > pool->queue[big]->score)
-        {
-            big = right;
-        }
-
-        // Can we stop now?
-        if (big != i)
-        {
-            // Exchange and continue.
-            Sv_PoolQueueExchange(pool, i, big);
-            i = big;
-        }
-        else
-        {
-            // Heapifying is complete.
-            isDone = true;
-        }
-    }
-
+    delta_t *max = pool->queue[0];
+    Sv_PoolQueueRemove(pool, max);
     return max;
 }
 
@@ -2747,12 +3000,18 @@ dd_bool Sv_RateDelta(void* deltaPtr, ownerinfo_t* info)
  * Calculate a priority score for each delta and build the priority queue.
  * The most important deltas will be included in a frame packet.
  * A pool is rated after new deltas have been generated.
+ *
+ * The queue is kept between frames. Only deltas that are not in the queue
+ * (new or modified ones) and deltas whose score is outdated are rated; if
+ * the owner of the pool has moved far enough, all deltas are re-rated.
  */
 void Sv_RatePool(pool_t* pool)
 {
 #ifdef _DEBUG
     player_t*           plr = DD_Player(pool->owner);
 #endif
+    ownerinfo_t*        info = &pool->ownerInfo;
+    uint const          now = Sv_GetTimeStamp();
     delta_t*            delta;
     int                 i;
 
@@ -2763,23 +3022,68 @@ void Sv_RatePool(pool_t* pool)
     }
 #endif
 
-    // Clear the queue.
-    Sv_PoolQueueClear(pool);
+    // Distances to all the deltas change when the owner moves.
+    if (V3d_Distance(info->origin, pool->ratedOrigin) > POOL_RERATE_DISTANCE)
+    {
+        Sv_PoolQueueClear(pool);
+        V3d_Copy(pool->ratedOrigin, info->origin);
+    }
 
-    // We will rate all the deltas in the pool. After each delta
-    // has been rated, it's added to the priority queue.
     for (i = 0; i < POOL_HASH_SIZE; ++i)
     {
         for (delta = pool->hash[i].first; delta; delta = delta->next)
         {
-            if (Sv_RateDelta(delta, &pool->ownerInfo))
+            if (delta->queuePos && now - delta->ratedAt < DELTA_RERATE_INTERVAL)
+            {
+                // The score is still valid.
+                continue;
+            }
+
+            if (Sv_RateDelta(delta, info))
             {
-                Sv_PoolQueueAdd(pool, delta);
+                delta->ratedAt = now;
+
+                if (delta->queuePos)
+                {
+                    Sv_PoolQueueUpdate(pool, delta);
+                }
+                else
+                {
+                    Sv_PoolQueueAdd(pool, delta);
+                }
+            }
+            else
+            {
+                // Not included at this time; will be rated again next time.
+                Sv_PoolQueueRemove(pool, delta);
             }
         }
     }
 }
 
+/**
+ * Rates all the pools in the NULL-terminated array. Pools are rated
+ * concurrently when there is more than one of them.
+ */
+void Sv_RatePools(pool_t **pools)
+{
+    if (!pools[0]) return;
+
+    if (!pools[1])
+    {
+        Sv_RatePool(pools[0]);
+        return;
+    }
+
+    TaskPool tasks;
+    for (; *pools; pools++)
+    {
+        pool_t *pool = *pools;
+        tasks.start([pool] () { Sv_RatePool(pool); }, TaskPool::HighPriority);
+    }
+    tasks.waitForDone();
+}
+
 /**
  * Do special things that need to be done when the delta has been acked.
  */
@@ -2803,8 +3107,8 @@ void Sv_AckDelta(pool_t* pool, delta_t* delta)
  * Acknowledged deltas are removed from the pool, never to be seen again.
  * Clients ack deltas to tell the server they've received them.
  *
- * @note This is obsolete: deltas no longer need to be acknowledged as
- * they are sent over TCP.
+ * @note Frames sent over TCP are acked by the server itself right after
+ * sending. Only clients receiving frames as datagrams send acks.
  *
  * @param clientNumber  Client whose deltas to ack.
  * @param set           Delta set number.
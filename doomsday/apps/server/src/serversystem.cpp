@@ -37,6 +37,7 @@
 #include "server/sv_def.h"
 #include "server/sv_frame.h"
 
+#include "network/datagramchannel.h"
 #include "network/net_main.h"
 #include "network/net_buf.h"
 #include "network/net_event.h"
@@ -49,6 +50,8 @@
 #include "world/map.h"
 #include "world/p_players.h"
 
+#include <QUuid>
+
 using namespace de;
 
 char *nptIPAddress = (char *) ""; ///< Public domain for clients to connect to (cvar).
@@ -69,10 +72,17 @@ DENG2_PIMPL(ServerSystem)
 
     ListenSocket *serverSock = nullptr;
 
+    /// Frames and client coordinates are sent as datagrams, if possible.
+    DatagramChannel datagrams;
+
     QHash<Id, RemoteUser *> users;
     ShellUsers shellUsers;
 
-    Impl(Public *i) : Base(i) {}
+    Impl(Public *i) : Base(i)
+    {
+        QObject::connect(&datagrams, SIGNAL(messageReceived(de::Address, de::duint32, de::Block)),
+                         thisPublic, SLOT(handleDatagram(de::Address, de::duint32, de::Block)));
+    }
     ~Impl() { deinit(); }
 
     bool isStarted() const
@@ -98,6 +108,8 @@ DENG2_PIMPL(ServerSystem)
         // Update the beacon with the new port.
         beacon.start(port);
 
+        openDatagrams(port);
+
         App_World().audienceForMapChange() += shellUsers;
 
         inited = true;
@@ -125,6 +137,7 @@ DENG2_PIMPL(ServerSystem)
         }
 
         beacon.stop();
+        datagrams.close();
 
         // Close the listening socket.
         delete serverSock;
@@ -133,6 +146,37 @@ DENG2_PIMPL(ServerSystem)
         clearUsers();
     }
 
+    /**
+     * Opens the datagram channel next to the listening port. The beacon uses the
+     * same UDP port number as the listening TCP port.
+     */
+    void openDatagrams(duint16 listenPort)
+    {
+        for (duint16 port : { duint16(listenPort + 1), duint16(0) })
+        {
+            try
+            {
+                datagrams.open(port);
+                LOG_NET_NOTE("Server receiving datagrams on UDP port %i") << datagrams.port();
+                return;
+            }
+            catch (Error const &er)
+            {
+                LOGDEV_NET_WARNING("%s") << er.asText();
+            }
+        }
+        LOG_NET_WARNING("Datagrams are not available; all game traffic will use TCP");
+    }
+
+    RemoteUser *findUserByDatagramToken(duint32 token) const
+    {
+        for (RemoteUser *user : users)
+        {
+            if (user->datagramToken() == token) return user;
+        }
+        return nullptr;
+    }
+
     RemoteUser &findUser(Id const &id) const
     {
         DENG2_ASSERT(users.contains(id));
@@ -176,6 +220,10 @@ DENG2_PIMPL(ServerSystem)
         if (serverSock)
         {
             LOG_NOTE("SERVER: Listening on TCP port %i") << serverSock->port();
+            if (datagrams.isOpen())
+            {
+                LOG_NOTE("SERVER: Datagrams on UDP port %i") << datagrams.port();
+            }
         }
         else
         {
@@ -218,6 +266,19 @@ DENG2_PIMPL(ServerSystem)
                     << (shellUsers.count() == 1? "" : "s");
         }
 
+        Socket::Statistics const sockStats = Socket::statistics();
+        if (sockStats.messagesEncoded)
+        {
+            LOG_MSG("Compressed %i messages (%i KB => %i KB) in %.1f ms; "
+                    "%i broadcast sends reused them, saving %.1f ms")
+                    << sockStats.messagesEncoded
+                    << sockStats.bytesEncoded / 1024
+                    << sockStats.bytesCompressed / 1024
+                    << sockStats.encodingTime * 1000
+                    << sockStats.encodingsReused
+                    << sockStats.encodingTimeSaved * 1000;
+        }
+
         N_PrintBufferInfo();
 
         LOG_MSG(_E(b) "Configuration:");
@@ -258,6 +319,72 @@ RemoteUser &ServerSystem::user(Id const &id) const
     return *d->users[id];
 }
 
+void ServerSystem::broadcast(IByteArray const &data, QList<Id> const &recipients)
+{
+    if (recipients.isEmpty()) return;
+
+    Socket::EncodedMessage const message(data);
+    for (Id const &id : recipients)
+    {
+        if (RemoteUser *user = d->users.value(id))
+        {
+            try
+            {
+                user->send(message);
+            }
+            catch (Error const &er)
+            {
+                LOGDEV_NET_WARNING("Broadcast to user %s failed: %s") << id << er.asText();
+            }
+        }
+    }
+}
+
+duint32 ServerSystem::offerDatagramChannel(Id const &id)
+{
+    RemoteUser *user = d->users.value(id);
+    if (!user || !d->datagrams.isOpen()) return 0;
+
+    if (!user->datagramToken())
+    {
+        duint32 token = 0;
+        while (!token || d->findUserByDatagramToken(token))
+        {
+            token = QUuid::createUuid().data1;
+        }
+        user->setDatagramToken(token);
+    }
+    return user->datagramToken();
+}
+
+duint16 ServerSystem::datagramPort() const
+{
+    return d->datagrams.port();
+}
+
+bool ServerSystem::hasDatagramChannel(Id const &id) const
+{
+    RemoteUser const *user = d->users.value(id);
+    return user && !user->datagramAddress().isNull();
+}
+
+bool ServerSystem::sendDatagram(Id const &id, IByteArray const &message)
+{
+    RemoteUser const *user = d->users.value(id);
+    if (!user || user->datagramAddress().isNull()) return false;
+
+    return d->datagrams.send(user->datagramAddress(), user->datagramToken(), message);
+}
+
+void ServerSystem::closeDatagramChannel(Id const &id)
+{
+    if (RemoteUser *user = d->users.value(id))
+    {
+        user->setDatagramToken(0);
+        user->setDatagramAddress(Address());
+    }
+}
+
 bool ServerSystem::isUserAllowedToJoin(RemoteUser &/*user*/) const
 {
     if (!CVar_Byte(Con_FindVariable("server-allowjoin"))) return false;
@@ -265,6 +392,48 @@ bool ServerSystem::isUserAllowedToJoin(RemoteUser &/*user*/) const
     return (Sv_GetNumConnected() < svMaxPlayers);
 }
 
+void ServerSystem::handleDatagram(Address from, duint32 token, Block message)
+{
+    LOG_AS("ServerSystem");
+
+    RemoteUser *user = (token? d->findUserByDatagramToken(token) : nullptr);
+    if (!user || !user->isJoined() || message.isEmpty()) return;
+
+    switch (dbyte(message.at(0)))
+    {
+    case PKT_DATAGRAM_HELLO:
+        // The token alone is not enough: anyone who sees it could redirect the
+        // user's frames elsewhere. Only the port may differ from the TCP
+        // connection, as NAT may map the datagrams to another port.
+        if (!DatagramChannel::isSameHost(from, user->address()))
+        {
+            LOGDEV_NET_VERBOSE("Ignoring datagram channel hello for user %s from %s; "
+                               "the user is connected from %s")
+                    << user->id() << from << user->address();
+            break;
+        }
+        if (!(user->datagramAddress() == from))
+        {
+            LOG_NET_MSG("Datagram channel to user %s opened from %s") << user->id() << from;
+            user->setDatagramAddress(from);
+        }
+        // Let the client know the channel works.
+        d->datagrams.send(from, token, message);
+        break;
+
+    case PKT_COORDS:
+        if (user->datagramAddress() == from)
+        {
+            user->postMessage(message);
+        }
+        break;
+
+    default:
+        // Other messages are only accepted over TCP.
+        break;
+    }
+}
+
 void ServerSystem::convertToShellUser(RemoteUser *user)
 {
     DENG2_ASSERT(user);
@@ -95,6 +95,24 @@ void ShellUser::sendInitialUpdate()
 }
 
 void ShellUser::sendGameState()
+{
+    QScopedPointer<Packet> packet(newGameStatePacket());
+    *this << *packet;
+}
+
+void ShellUser::sendMapOutline()
+{
+    QScopedPointer<Packet> packet(newMapOutlinePacket());
+    if (packet) *this << *packet;
+}
+
+void ShellUser::sendPlayerInfo()
+{
+    QScopedPointer<Packet> packet(newPlayerInfoPacket());
+    if (packet) *this << *packet;
+}
+
+Packet *ShellUser::newGameStatePacket() // static
 {
     String mode = App_CurrentGame().id();
 
@@ -126,24 +144,23 @@ void ShellUser::sendGameState()
         mapTitle = Con_GetString("map-name");
     }
 
-    QScopedPointer<RecordPacket> packet(protocol().newGameState(mode, rules, mapId, mapTitle));
-    *this << *packet;
+    return shell::Protocol().newGameState(mode, rules, mapId, mapTitle);
 }
 
-void ShellUser::sendMapOutline()
+Packet *ShellUser::newMapOutlinePacket() // static
 {
-    if (!App_World().hasMap()) return;
+    if (!App_World().hasMap()) return nullptr;
 
-    shell::MapOutlinePacket packet;
-    App_World().map().initMapOutlinePacket(packet);
-    *this << packet;
+    auto *packet = new shell::MapOutlinePacket;
+    App_World().map().initMapOutlinePacket(*packet);
+    return packet;
 }
 
-void ShellUser::sendPlayerInfo()
+Packet *ShellUser::newPlayerInfoPacket() // static
 {
-    if (!App_World().hasMap()) return;
+    if (!App_World().hasMap()) return nullptr;
 
-    QScopedPointer<shell::PlayerInfoPacket> packet(new shell::PlayerInfoPacket);
+    auto *packet = new shell::PlayerInfoPacket;
 
     for (uint i = 1; i < DDMAXPLAYERS; ++i)
     {
@@ -169,7 +186,7 @@ void ShellUser::sendPlayerInfo()
         packet->add(info);
     }
 
-    *this << *packet;
+    return packet;
 }
 
 void ShellUser::handleIncomingPackets()
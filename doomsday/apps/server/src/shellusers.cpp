@@ -19,6 +19,7 @@
 
 #include "shellusers.h"
 #include "dd_main.h"
+#include <de/Writer>
 #include <QTimer>
 
 using namespace de;
@@ -40,6 +41,25 @@ DENG2_PIMPL_NOREF(ShellUsers)
     {
         delete infoTimer;
     }
+
+    /**
+     * Sends a packet to all users. The packet is compressed only once.
+     *
+     * @param packet  Packet to send. Ownership taken.
+     */
+    void broadcast(Packet *packet)
+    {
+        QScopedPointer<Packet> owned(packet);
+        if (!packet || users.isEmpty()) return;
+
+        Block data;
+        Writer(data) << *packet;
+        Socket::EncodedMessage const message(data);
+        foreach (ShellUser *user, users)
+        {
+            user->send(message);
+        }
+    }
 };
 
 ShellUsers::ShellUsers() : d(new Impl)
@@ -76,20 +96,18 @@ int ShellUsers::count() const
 
 void ShellUsers::worldMapChanged()
 {
-    foreach (ShellUser *user, d->users)
-    {
-        user->sendGameState();
-        user->sendMapOutline();
-        user->sendPlayerInfo();
-    }
+    if (d->users.isEmpty()) return;
+
+    d->broadcast(ShellUser::newGameStatePacket());
+    d->broadcast(ShellUser::newMapOutlinePacket());
+    d->broadcast(ShellUser::newPlayerInfoPacket());
 }
 
 void ShellUsers::sendPlayerInfoToAll()
 {
-    foreach (ShellUser *user, d->users)
-    {
-        user->sendPlayerInfo();
-    }
+    if (d->users.isEmpty()) return;
+
+    d->broadcast(ShellUser::newPlayerInfoPacket());
 }
 
 void ShellUsers::userDisconnected()
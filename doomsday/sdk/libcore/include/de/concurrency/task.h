@@ -20,6 +20,7 @@
 #define LIBDENG2_TASK_H
 
 #include <QRunnable>
+#include <QAtomicInt>
 
 #include "../libcore.h"
 #include "../TaskPool"
@@ -30,6 +31,9 @@ namespace de {
  * Concurrent task that will be executed asynchronously by a TaskPool. Override
  * runTask() in a derived class.
  *
+ * A task may have child tasks (see TaskPool::start()). The task is considered
+ * finished only after both its own runTask() and all of its children have finished.
+ *
  * @ingroup concurrency
  */
 class DENG2_PUBLIC Task : public QRunnable
@@ -46,9 +50,13 @@ public:
     virtual void runTask() = 0;
 
 private:
+    void finished();
+
     friend class TaskPool;
 
     TaskPool::IPool *_pool;
+    Task *_parent;
+    QAtomicInt _pending; ///< Unfinished children, plus one for the task itself.
 };
 
 } // namespace de
@@ -20,6 +20,7 @@
 #define LIBDENG2_TASKPOOL_H
 
 #include "../Observers"
+#include "../Range"
 #include <QObject>
 #include <functional>
 
@@ -35,6 +36,12 @@ class Task;
  * TaskPool instance for each group of concurrent tasks whose state needs to be
  * observed as a whole.
  *
+ * The background threads are scheduled with work stealing: each thread has its
+ * own queue of tasks. Tasks started from within a running task are placed in the
+ * current thread's queue and executed in last-in-first-out order, while idle
+ * threads steal the oldest tasks from other threads. Tasks started from other
+ * threads are queued according to their priority.
+ *
  * While TaskPool allows the user to monitor whether all tasks are done and
  * block until that time arrives (TaskPool::waitForDone()), no facilities are
  * provided for interrupting any of the started tasks. If that is required, the
@@ -86,9 +93,29 @@ public:
 
     void start(TaskFunction taskFunction, Priority priority = LowPriority);
 
+    /**
+     * Starts a new concurrent task as a child of another task. The parent task is
+     * considered finished only when all of its children have finished, so waiting
+     * for the parent's pool also waits for the children.
+     *
+     * Children must be added before the parent has finished, for instance in the
+     * parent's Task::runTask() or in another child of the same parent.
+     *
+     * @param task      Task instance. Ownership given.
+     * @param parent    Parent task.
+     * @param priority  Priority of the task.
+     */
+    void start(Task *task, Task &parent, Priority priority = LowPriority);
+
+    void start(TaskFunction taskFunction, Task &parent, Priority priority = LowPriority);
+
     /**
      * Blocks execution until all running tasks have finished. A Task is considered
-     * finished when it has exited its Task::runTask() method.
+     * finished when it has exited its Task::runTask() method and all its children
+     * have finished.
+     *
+     * If called in a background thread, the thread executes the pool's own queued
+     * tasks while waiting. Tasks of other pools are left for the other threads.
      */
     void waitForDone();
 
@@ -97,6 +124,28 @@ public:
      */
     bool isDone() const;
 
+    /**
+     * Calls a function for each index of a range. The range is divided into chunks
+     * that are executed concurrently in the background threads. The calling thread
+     * processes chunks of the same loop until all of them are done, so this can be
+     * used from within running tasks as well.
+     *
+     * If @a func throws an exception, the remaining chunks are skipped and the first
+     * exception is rethrown in the calling thread after all chunks have finished.
+     *
+     * @param range      Range of indices.
+     * @param func       Function to call with each index.
+     * @param grainSize  Minimum number of indices in a chunk. If zero, chosen
+     *                   automatically according to the number of threads.
+     */
+    static void parallelFor(Rangei const &range, std::function<void (dint)> func,
+                            dint grainSize = 0);
+
+    /**
+     * Returns the number of background threads used for running tasks.
+     */
+    static dint threadCount();
+
 signals:
     void allTasksDone();
 
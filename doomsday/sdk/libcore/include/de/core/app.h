@@ -282,6 +282,8 @@ public:
      */
     static MetadataBank &metadataBank();
 
+    static bool metadataBankExists();
+
     /**
      * Returns the root folder of the file system.
      */
@@ -36,15 +36,16 @@ namespace codec {
  *
  * @return Encoded block of bits.
  */
-Block huffmanEncode(Block const &data);
+DENG2_PUBLIC Block huffmanEncode(Block const &data);
 
 /**
- * Decodes the coded message using the Huffman tree.
+ * Decodes the coded message. Bits at the end that do not form a complete code
+ * are ignored.
  * @param codedData  Block of Huffman-coded data.
  *
  * @return Decoded block of data.
  */
-Block huffmanDecode(Block const &codedData);
+DENG2_PUBLIC Block huffmanDecode(Block const &codedData);
 
 } // namespace codec
 } // namespace de
@@ -41,6 +41,11 @@ class File;
  * http://dengine.net/dew/index.php?title=Info
  *
  * This implementation is based on a C++ port of cfparser.py from Snowberry.
+ *
+ * Parsed files of at least 1 KB are kept in the metadata cache (MetadataBank),
+ * identified by a hash of the content. When the same file is parsed again, the
+ * elements are restored from the cache. Files that include other documents are
+ * not cached.
  * @ingroup data
  *
  * @todo Should use de::Lex internally.
@@ -404,6 +409,12 @@ public:
     static String sourceLocation(duint32 lineId);
     static SourceLineTable const &sourceLineTable();
 
+    /**
+     * Logs how many Info files have been parsed and how many were restored from
+     * the metadata cache, and the time spent on each.
+     */
+    static void printParseStatistics();
+
 private:
     DENG2_PRIVATE(d)
 };
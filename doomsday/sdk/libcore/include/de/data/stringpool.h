@@ -46,8 +46,10 @@ namespace de {
  * Each string can also have an associated, custom user-defined uint32 value
  * and/or void *data pointer.
  *
- * The implementation has, at worst, O(log n) complexity for addition, removal,
- * string lookup, and user value/pointer set/get.
+ * The strings are kept in an open-addressed hash table keyed by a case-folded
+ * hash that is computed once per string. Addition, removal, and string lookup
+ * have O(1) average complexity (addition is amortized over the growth of the
+ * table). Looking up a string or user value/pointer by Id is O(1).
  *
  * @todo Add case-sensitive mode.
  *
@@ -23,6 +23,8 @@
 #include "../libcore.h"
 #include "../IByteArray"
 #include "../Address"
+#include "../Block"
+#include "../Time"
 #include "../Transmitter"
 
 #include <QTcpSocket>
@@ -71,6 +73,52 @@ public:
     };
     Q_DECLARE_FLAGS(HeaderFlags, HeaderFlag)
 
+    /**
+     * Message that has been compressed and serialized with a header, ready to be
+     * written to any number of sockets. When the same message is sent to many
+     * recipients, encoding it once avoids compressing it again for every socket.
+     */
+    class DENG2_PUBLIC EncodedMessage
+    {
+    public:
+        /**
+         * Encodes a message.
+         *
+         * @param packet  Message payload.
+         */
+        EncodedMessage(IByteArray const &packet);
+
+        /// Returns the serialized header and compressed payload.
+        Block const &bytes() const;
+
+        /// Returns the size of the payload before compression.
+        dsize payloadSize() const;
+
+        /// Returns the time it took to encode the message.
+        TimeDelta encodingTime() const;
+
+    private:
+        Block _bytes;
+        dsize _payloadSize;
+        TimeDelta _encodingTime;
+        mutable dint _sendCount;
+
+        friend class Socket;
+    };
+
+    /**
+     * Counters of the messages compressed for sending by all sockets.
+     */
+    struct Statistics
+    {
+        duint64 messagesEncoded   = 0; ///< Messages compressed.
+        duint64 bytesEncoded      = 0; ///< Payload bytes before compression.
+        duint64 bytesCompressed   = 0; ///< Serialized bytes after compression.
+        ddouble encodingTime      = 0; ///< Seconds spent compressing.
+        duint64 encodingsReused   = 0; ///< Sends of already encoded messages.
+        ddouble encodingTimeSaved = 0; ///< Seconds that recompressing would have taken.
+    };
+
 public:
     Socket();
 
@@ -142,6 +190,14 @@ public:
      */
     Socket &operator << (IByteArray const &data);
 
+    /**
+     * Sends a message that has already been encoded. The same EncodedMessage can
+     * be sent to any number of sockets.
+     *
+     * @param message  Encoded message.
+     */
+    void send(EncodedMessage const &message);
+
     /**
      * Returns the next received message. If nothing has been received,
      * returns @c NULL.
@@ -201,6 +257,14 @@ public:
      */
     void setQuiet(bool noLogOutput);
 
+public:
+    /**
+     * Returns the counters accumulated since the last call to resetStatistics().
+     */
+    static Statistics statistics();
+
+    static void resetStatistics();
+
 signals:
     void addressResolved();
     void connected();
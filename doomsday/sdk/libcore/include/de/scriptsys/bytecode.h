@@ -0,0 +1,81 @@
+/*
+ * The Doomsday Engine Project -- libcore
+ *
+ * Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef LIBDENG2_BYTECODE_H
+#define LIBDENG2_BYTECODE_H
+
+#include "../libcore.h"
+
+namespace de {
+
+class Evaluator;
+class Expression;
+class Value;
+
+/**
+ * Compiled form of an expression that operates on constants and variable values
+ * using arithmetic, comparison, and logical operators.
+ *
+ * Bytecode is executed on a small fixed-size stack of unboxed operands, so the
+ * intermediate results of the expression do not need to be allocated. Constant
+ * subexpressions are folded during compilation. If the values encountered during
+ * execution are not ones the bytecode can handle (for instance, text is being
+ * concatenated), execution is abandoned and the expression must be evaluated by
+ * walking the expression tree instead. Expressions compiled to bytecode have no
+ * side effects, so abandoning the execution is always possible.
+ *
+ * @ingroup script
+ */
+class DENG2_PUBLIC Bytecode
+{
+public:
+    /**
+     * Compiles an expression to bytecode.
+     *
+     * @param expression  Expression to compile.
+     *
+     * @return  Compiled bytecode, or @c nullptr if the expression contains
+     * constructs that cannot be compiled. Caller gets ownership.
+     */
+    static Bytecode *compile(Expression const &expression);
+
+    /**
+     * Executes the bytecode.
+     *
+     * @param evaluator  Evaluator whose namespaces are used for looking up variables.
+     *
+     * @return  Result of the expression, or @c nullptr if the values of the operands
+     * could not be handled by the bytecode. Caller gets ownership.
+     */
+    Value *execute(Evaluator &evaluator) const;
+
+    /**
+     * Returns the number of instructions in the bytecode.
+     */
+    dint size() const;
+
+private:
+    Bytecode();
+
+    DENG2_PRIVATE(d)
+};
+
+} // namespace de
+
+#endif // LIBDENG2_BYTECODE_H
@@ -48,6 +48,9 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    /// Returns the constant value of the expression.
+    Value const &value() const;
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
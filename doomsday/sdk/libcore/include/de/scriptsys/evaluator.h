@@ -28,6 +28,7 @@
 
 namespace de {
 
+class Bytecode;
 class Context;
 class Process;
 class Expression;
@@ -117,6 +118,20 @@ public:
      *                    Evaluator takes ownership of this value.
      */
     void push(Expression const *expression, Value *scope = 0);
+
+    /**
+     * Insert an expression to the top of the expression stack so that it will be
+     * evaluated by executing its compiled bytecode. If the bytecode cannot handle
+     * the operand values at that point, the expression is evaluated normally
+     * instead.
+     *
+     * @param expression  Expression to push on the stack.
+     * @param bytecode    Compiled form of @a expression.
+     *
+     * @return  @c true, if the expression was pushed. @c false, if bytecode is not
+     * used for the expression at the moment and it should be pushed normally.
+     */
+    bool pushBytecode(Expression const *expression, Bytecode const &bytecode);
     
     /**
      * Push a value onto the result stack.
@@ -167,6 +182,14 @@ public:
      */
     Value &result();
 
+    /**
+     * Enables or disables the use of compiled bytecode for evaluating expressions
+     * (enabled by default). This applies to all evaluators.
+     */
+    static void setBytecodeEnabled(bool enabled);
+
+    static bool isBytecodeEnabled();
+
 private:
     DENG2_PRIVATE(d)
 };
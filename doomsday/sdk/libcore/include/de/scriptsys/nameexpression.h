@@ -20,6 +20,7 @@
 #ifndef LIBDENG2_NAMEEXPRESSION_H
 #define LIBDENG2_NAMEEXPRESSION_H
 
+#include "../Evaluator"
 #include "../Expression"
 #include "../String"
 
@@ -27,6 +28,8 @@
 
 namespace de {
 
+class Variable;
+
 /**
  * Responsible for referencing, creating, and deleting variables and record
  * references based an textual identifier.
@@ -57,8 +60,21 @@ public:
     /// Returns the identifier in the name expression.
     String const &identifier() const;
 
+    /// Returns the identifier of the explicit scope, if one was specified.
+    String const &scopeIdentifier() const;
+
     Value *evaluate(Evaluator &evaluator) const;
 
+    /**
+     * Looks up the variable identified by the expression, ignoring the flags
+     * that would create, import, or export variables.
+     *
+     * @param spaces  Namespaces to look in.
+     *
+     * @return  The variable, or @c nullptr if it does not exist.
+     */
+    Variable *findVariable(Evaluator::Namespaces const &spaces) const;
+
     // Implements ISerializable.
     void operator >> (Writer &to) const;
     void operator << (Reader &from);
@@ -26,6 +26,7 @@
 
 namespace de {
 
+class Bytecode;
 class Evaluator;
 class Value;
 
@@ -80,6 +81,19 @@ public:
 
     Value *evaluate(Evaluator &evaluator) const;
 
+    Operator op() const;
+    Expression const *leftOperand() const;
+    Expression const *rightOperand() const;
+
+    /**
+     * Returns the expression compiled to bytecode. The expression is compiled
+     * when this is first called.
+     *
+     * @return  Bytecode, or @c nullptr if the expression cannot be compiled or
+     * the bytecode has been unable to handle the operands.
+     */
+    Bytecode const *bytecode() const;
+
     /**
      * Verifies that @a value can be used as the l-value of an operator that
      * does assignment.
@@ -103,6 +117,9 @@ private:
     Operator _op;
     Expression *_leftOperand;
     Expression *_rightOperand;
+    mutable Bytecode *_bytecode;
+    mutable bool _compiled;
+    mutable bool _bytecodeFailed; ///< Operands were not ones the bytecode handles.
 };
 
 } // namespace de
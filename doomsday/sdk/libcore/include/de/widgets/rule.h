@@ -40,6 +40,11 @@ DENG2_DECLARE_AUDIENCE(RuleInvalidation, void ruleInvalidated())
  * - When a rule is invalid, its current value will be updated (i.e., validated).
  * - Reference counting is used for lifetime management.
  *
+ * Invalidated rules are queued and updated in dependency order when
+ * updateInvalidRules() is called (once per frame by RootWidget), so that each
+ * rule is updated only once even if it was invalidated through many paths. An
+ * invalid rule whose value is needed before that is updated on demand.
+ *
  * @ingroup widgets
  */
 class DENG2_PUBLIC Rule : public Counted, public DENG2_AUDIENCE_INTERFACE(RuleInvalidation)
@@ -60,6 +65,15 @@ public:
         MAX_SEMANTICS
     };
 
+    /// Counters for evaluating how much work the rules are doing.
+    struct Statistics
+    {
+        duint invalidated       = 0; ///< Rules marked invalid.
+        duint evaluated         = 0; ///< Rules updated by updateInvalidRules().
+        duint updatedOnDemand   = 0; ///< Invalid rules updated when their value was needed.
+        duint invalidationDepth = 0; ///< Longest chain of dependants invalidated at once.
+    };
+
 public:
     Rule();
 
@@ -132,6 +146,20 @@ public:
      */
     static bool invalidRulesExist();
 
+    /**
+     * Updates all the rules that have been invalidated and not updated since.
+     * The rules are updated in dependency order: a rule is updated after all of
+     * its invalid dependencies, so each rule's update() is called only once.
+     */
+    static void updateInvalidRules();
+
+    /**
+     * Returns the counters accumulated since the last call to resetStatistics().
+     */
+    static Statistics const &statistics();
+
+    static void resetStatistics();
+
 protected:
     ~Rule(); // Counted
 
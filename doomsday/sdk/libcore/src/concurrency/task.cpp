@@ -22,7 +22,7 @@
 
 namespace de {
 
-Task::Task() : _pool(nullptr)
+Task::Task() : _pool(nullptr), _parent(nullptr), _pending(1)
 {}
 
 void Task::run()
@@ -37,11 +37,25 @@ void Task::run()
         LOG_WARNING("Aborted due to exception: ") << er.asText();
     }
 
-    // Cleanup.
-    if (_pool) _pool->taskFinishedRunning(*this);
-    
+    finished();
+
     // The thread's log is not disposed because task threads are pooled (by TaskPool)
     // and the log object will be reused in future tasks.
 }
 
+void Task::finished()
+{
+    // Children may still be running.
+    if (!_pending.deref())
+    {
+        Task *parent = _parent;
+
+        // Cleanup.
+        if (_pool) _pool->taskFinishedRunning(*this);
+        if (autoDelete()) delete this;
+
+        if (parent) parent->finished();
+    }
+}
+
 } // namespace de
@@ -20,8 +20,13 @@
 #include "de/Task"
 #include "de/Guard"
 
-#include <QThreadPool>
+#include <QMutex>
 #include <QSet>
+#include <QThread>
+#include <QWaitCondition>
+#include <deque>
+#include <exception>
+#include <memory>
 #include <de/Lockable>
 #include <de/Loop>
 #include <de/Waitable>
@@ -38,6 +43,314 @@ namespace internal
     private:
         TaskPool::TaskFunction _func;
     };
+
+    /// Decides which queued tasks a waiting thread may run. Empty accepts all tasks.
+    typedef std::function<bool (Task *)> TaskFilter;
+
+    static Task *takeFirst(std::deque<Task *> &tasks, TaskFilter const &filter)
+    {
+        for (auto i = tasks.begin(); i != tasks.end(); ++i)
+        {
+            if (!filter || filter(*i))
+            {
+                Task *task = *i;
+                tasks.erase(i);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * State shared by the threads running a parallelFor loop. Chunks are claimed
+     * in order, so the calling thread only ever runs chunks of its own loop.
+     */
+    struct ParallelLoop
+    {
+        Rangei range;
+        dint grainSize;
+        dint chunkCount;
+        std::function<void (dint)> func;
+        QAtomicInt nextChunk;
+        QAtomicInt remaining;
+        QAtomicInt failed;
+        QMutex mutex;
+        QWaitCondition allDone;
+        std::exception_ptr error; ///< First exception thrown by @a func.
+
+        ParallelLoop(Rangei const &range, dint grainSize, std::function<void (dint)> func)
+            : range(range)
+            , grainSize(grainSize)
+            , chunkCount((range.size() + grainSize - 1) / grainSize)
+            , func(std::move(func))
+            , remaining(chunkCount)
+        {}
+
+        /// Runs unclaimed chunks until there are none left.
+        void work()
+        {
+            forever
+            {
+                dint const chunk = nextChunk.fetchAndAddOrdered(1);
+                if (chunk >= chunkCount) return;
+
+                // After a failure, the rest of the chunks are only counted as done.
+                if (!failed.load())
+                {
+                    dint const start = range.start + chunk * grainSize;
+                    dint const end   = de::min(start + grainSize, range.end);
+                    try
+                    {
+                        for (dint i = start; i < end; ++i) func(i);
+                    }
+                    catch (...)
+                    {
+                        QMutexLocker locker(&mutex);
+                        if (!error) error = std::current_exception();
+                        failed.store(1);
+                    }
+                }
+                if (!remaining.deref())
+                {
+                    QMutexLocker locker(&mutex);
+                    allDone.wakeAll();
+                }
+            }
+        }
+
+        /// Blocks until all chunks are done, and rethrows the loop's exception.
+        void waitAndRethrow()
+        {
+            QMutexLocker locker(&mutex);
+            while (remaining.load())
+            {
+                allDone.wait(&mutex);
+            }
+            if (error) std::rethrow_exception(error);
+        }
+    };
+
+    /**
+     * Work-stealing scheduler that runs the tasks of all TaskPools.
+     *
+     * Each worker thread has a double-ended queue. The owner pushes and pops tasks
+     * at the back of its own queue, while other threads steal from the front. Tasks
+     * started outside the worker threads are placed in shared queues, one for each
+     * priority level.
+     */
+    class Scheduler
+    {
+    public:
+        class Worker : public QThread
+        {
+        public:
+            Worker(Scheduler &scheduler) : _scheduler(scheduler) {}
+
+            void push(Task *task)
+            {
+                QMutexLocker locker(&_mutex);
+                _tasks.push_back(task);
+            }
+
+            /// Removes the most recently pushed task that is accepted by @a filter.
+            Task *pop(TaskFilter const &filter)
+            {
+                QMutexLocker locker(&_mutex);
+                for (auto i = _tasks.rbegin(); i != _tasks.rend(); ++i)
+                {
+                    if (!filter || filter(*i))
+                    {
+                        Task *task = *i;
+                        _tasks.erase(std::next(i).base());
+                        return task;
+                    }
+                }
+                return nullptr;
+            }
+
+            /// Removes the oldest task that is accepted by @a filter.
+            Task *steal(TaskFilter const &filter)
+            {
+                QMutexLocker locker(&_mutex);
+                return takeFirst(_tasks, filter);
+            }
+
+            void run() override
+            {
+                _scheduler.work(this);
+            }
+
+        private:
+            Scheduler &_scheduler;
+            QMutex _mutex;
+            std::deque<Task *> _tasks;
+        };
+
+        Scheduler()
+        {
+            dint const count = de::max(1, QThread::idealThreadCount());
+            for (dint i = 0; i < count; ++i)
+            {
+                _workers << new Worker(*this);
+            }
+            for (Worker *worker : _workers)
+            {
+                worker->start();
+            }
+        }
+
+        ~Scheduler()
+        {
+            // Remaining tasks are run before the workers exit.
+            _mutex.lock();
+            _stopping = true;
+            _wakeup.wakeAll();
+            _mutex.unlock();
+
+            for (Worker *worker : _workers)
+            {
+                worker->wait();
+            }
+            qDeleteAll(_workers);
+        }
+
+        static Scheduler &get()
+        {
+            static Scheduler scheduler;
+            return scheduler;
+        }
+
+        dint workerCount() const
+        {
+            return _workers.size();
+        }
+
+        /**
+         * Returns the worker running in the current thread, or @c nullptr if called
+         * in some other thread.
+         */
+        Worker *currentWorker() const
+        {
+            auto *worker = dynamic_cast<Worker *>(QThread::currentThread());
+            if (worker && _workers.contains(worker)) return worker;
+            return nullptr;
+        }
+
+        void submit(Task *task, TaskPool::Priority priority)
+        {
+            _queued.ref();
+            if (Worker *worker = currentWorker())
+            {
+                worker->push(task);
+            }
+            else
+            {
+                QMutexLocker locker(&_queueMutex);
+                _queues[priority].push_back(task);
+            }
+
+            // Wake up an idle worker.
+            QMutexLocker locker(&_mutex);
+            _wakeup.wakeOne();
+        }
+
+        /**
+         * Executes queued tasks accepted by @a filter in the calling thread until
+         * @a isDone returns @c true. Other tasks are left for the other threads, so
+         * unrelated work never runs nested inside the caller.
+         */
+        void helpUntil(std::function<bool ()> const &isDone, TaskFilter const &filter)
+        {
+            DENG2_ASSERT(filter);
+            Worker *self = currentWorker();
+            while (!isDone())
+            {
+                if (Task *task = take(self, filter))
+                {
+                    task->run();
+                    continue;
+                }
+                // Nothing to do; wait until something changes.
+                QMutexLocker locker(&_mutex);
+                if (!isDone())
+                {
+                    _progress.wait(&_mutex, 1);
+                }
+            }
+        }
+
+        /**
+         * Wakes up the threads helping in helpUntil(), so that they can check if
+         * what they are waiting for has completed.
+         */
+        void notifyAll()
+        {
+            QMutexLocker locker(&_mutex);
+            _progress.wakeAll();
+        }
+
+        void work(Worker *self)
+        {
+            forever
+            {
+                if (Task *task = take(self, TaskFilter()))
+                {
+                    task->run();
+                    continue;
+                }
+                QMutexLocker locker(&_mutex);
+                if (_queued.load()) continue;
+                if (_stopping) break;
+                _wakeup.wait(&_mutex);
+            }
+        }
+
+    private:
+        Task *take(Worker *self, TaskFilter const &filter)
+        {
+            if (!_queued.load()) return nullptr;
+
+            Task *task = nullptr;
+
+            // Our own tasks are the most recently started ones.
+            if (self) task = self->pop(filter);
+
+            // Tasks started outside the workers, in priority order.
+            if (!task)
+            {
+                QMutexLocker locker(&_queueMutex);
+                for (dint i = TaskPool::HighPriority; i >= TaskPool::LowPriority && !task; --i)
+                {
+                    task = takeFirst(_queues[i], filter);
+                }
+            }
+
+            // Steal from other workers, starting from a different one each time.
+            if (!task)
+            {
+                dint const count = _workers.size();
+                dint const first = dint(duint(_nextVictim.fetchAndAddRelaxed(1)) % duint(count));
+                for (dint i = 0; i < count && !task; ++i)
+                {
+                    Worker *victim = _workers.at((first + i) % count);
+                    if (victim != self) task = victim->steal(filter);
+                }
+            }
+
+            if (task) _queued.deref();
+            return task;
+        }
+
+        QList<Worker *> _workers;
+        QMutex _queueMutex;
+        std::deque<Task *> _queues[3]; ///< Indexed by priority.
+        QAtomicInt _queued;            ///< Total number of queued tasks.
+        QAtomicInt _nextVictim;
+        QMutex _mutex;
+        QWaitCondition _wakeup;   ///< Idle workers wait for new tasks.
+        QWaitCondition _progress; ///< Helping threads wait for their tasks to finish.
+        bool _stopping = false;
+    };
 }
 
 DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
@@ -117,6 +430,7 @@ DENG2_PIMPL(TaskPool), public Lockable, public Waitable, public TaskPool::IPool
             }
             else
             {
+                internal::Scheduler::get().notifyAll();
                 try
                 {
                     emit self().allTasksDone();
@@ -154,7 +468,7 @@ TaskPool::~TaskPool()
 void TaskPool::start(Task *task, Priority priority)
 {
     d->add(task);
-    QThreadPool::globalInstance()->start(task, int(priority));
+    internal::Scheduler::get().submit(task, priority);
 }
 
 void TaskPool::start(TaskFunction taskFunction, Priority priority)
@@ -162,9 +476,36 @@ void TaskPool::start(TaskFunction taskFunction, Priority priority)
     start(new internal::CallbackTask(taskFunction), priority);
 }
 
+void TaskPool::start(Task *task, Task &parent, Priority priority)
+{
+    // The parent must still be unfinished.
+    DENG2_ASSERT(parent._pending.load() > 0);
+
+    parent._pending.ref();
+    task->_parent = &parent;
+    start(task, priority);
+}
+
+void TaskPool::start(TaskFunction taskFunction, Task &parent, Priority priority)
+{
+    start(new internal::CallbackTask(taskFunction), parent, priority);
+}
+
 void TaskPool::waitForDone()
 {
-    d->waitForEmpty();
+    auto &scheduler = internal::Scheduler::get();
+    if (scheduler.currentWorker())
+    {
+        // Blocking a worker could leave the pool's tasks without a thread, so
+        // the pool's own queued tasks are run here while waiting.
+        IPool const *pool = d.get();
+        scheduler.helpUntil([this] () { return d->isEmpty(); },
+                            [pool] (Task *task) { return task->_pool == pool; });
+    }
+    else
+    {
+        d->waitForEmpty();
+    }
 }
 
 bool TaskPool::isDone() const
@@ -172,4 +513,38 @@ bool TaskPool::isDone() const
     return d->isEmpty();
 }
 
+void TaskPool::parallelFor(Rangei const &range, std::function<void (dint)> func, dint grainSize)
+{
+    if (range.isEmpty()) return;
+
+    auto &scheduler = internal::Scheduler::get();
+
+    if (grainSize <= 0)
+    {
+        // A few chunks per thread lets the faster threads steal the remainder.
+        grainSize = de::max(1, range.size() / (4 * (scheduler.workerCount() + 1)));
+    }
+    if (range.size() <= grainSize)
+    {
+        for (dint i = range.start; i < range.end; ++i) func(i);
+        return;
+    }
+
+    // The calling thread works through the chunks itself, and the helper tasks
+    // let idle workers join in. Helpers that start late find nothing left to do.
+    auto loop = std::make_shared<internal::ParallelLoop>(range, grainSize, std::move(func));
+    dint const helpers = de::min(scheduler.workerCount(), loop->chunkCount - 1);
+    for (dint i = 0; i < helpers; ++i)
+    {
+        scheduler.submit(new internal::CallbackTask([loop] () { loop->work(); }), HighPriority);
+    }
+    loop->work();
+    loop->waitAndRethrow();
+}
+
+dint TaskPool::threadCount()
+{
+    return internal::Scheduler::get().workerCount();
+}
+
 } // namespace de
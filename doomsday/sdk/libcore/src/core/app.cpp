@@ -30,6 +30,7 @@
 #include "de/EscapeParser"
 #include "de/FileLogSink"
 #include "de/FileSystem"
+#include "de/Info"
 #include "de/LibraryFile"
 #include "de/Log"
 #include "de/LogBuffer"
@@ -412,6 +413,8 @@ App::~App()
 {
     LOG_AS("~App");
 
+    Info::printParseStatistics();
+
     d.reset();
 
     singletonApp = 0;
@@ -844,6 +847,11 @@ MetadataBank &App::metadataBank()
     return *DENG2_APP->d->metaBank;
 }
 
+bool App::metadataBankExists()
+{
+    return bool(DENG2_APP->d->metaBank);
+}
+
 PackageLoader &App::packageLoader()
 {
     return DENG2_APP->d->packageLoader;
@@ -5,6 +5,11 @@
  * Uses predetermined, fixed frequencies optimized for short (size < 128)
  * messages.
  *
+ * The codes are written least significant bit first. Decoding is done with a
+ * lookup table indexed by the next bits of the input: each entry lists the
+ * (one or more) symbols whose codes fit completely in those bits, so several
+ * symbols are usually decoded per lookup.
+ *
  * @authors Copyright © 2003-2017 Jaakko Keränen <jaakko.keranen@iki.fi>
  * @authors Copyright © 2006-2013 Daniel Swanson <danij@dengine.net>
  *
@@ -25,7 +30,9 @@
 #include "de/data/huffman.h"
 #include "de/App"
 #include "de/Log"
-#include "de/ByteRefArray"
+
+#include <cstring>
+#include <vector>
 
 // Heap relations.
 #define HEAP_PARENT(i)  (((i) + 1)/2 - 1)
@@ -123,23 +130,33 @@ struct HuffCode {
     duint length;
 };
 
-struct HuffBuffer {
-    dbyte *data;
-    dsize size;
+/// Maximum number of symbols decoded with one table lookup.
+static int const MAX_STEP_SYMBOLS = 4;
+
+/**
+ * Decoding table entry: the symbols that the indexed bits begin with.
+ */
+struct HuffDecodeStep {
+    dbyte symbols[MAX_STEP_SYMBOLS];
+    dbyte count;
+    dbyte bits;               // Total length of the symbols' codes.
 };
 
 struct Huffman
 {
-    // The root of the Huffman tree.
-    HuffNode *huffRoot;
-
     // The lookup table for encoding.
     HuffCode huffCodes[256];
 
+    duint minCodeLength;
+    duint maxCodeLength;
+
+    // The lookup table for decoding, indexed by the next maxCodeLength bits.
+    std::vector<HuffDecodeStep> decodeTable;
+
     /**
-     * Builds the Huffman tree and initializes the code lookup.
+     * Builds the Huffman tree and initializes the code lookups.
      */
-    Huffman() : huffRoot(0)
+    Huffman() : minCodeLength(0), maxCodeLength(0)
     {
         zap(huffCodes);
 
@@ -169,10 +186,13 @@ struct Huffman
         }
 
         // The root is the last node left in the queue.
-        huffRoot = Huff_QueueExtract(&queue);
+        HuffNode *huffRoot = Huff_QueueExtract(&queue);
 
-        // Fill in the code lookup table.
+        // Fill in the code lookup tables. The tree itself is no longer needed
+        // after this.
         Huff_BuildLookup(huffRoot, 0, 0);
+        Huff_DestroyNode(huffRoot);
+        Huff_BuildDecodeTable();
 
 #if 0
         if (qApp->arguments().contains("-huffcodes"))
@@ -199,15 +219,6 @@ struct Huffman
 #endif
     }
 
-    /**
-     * Free all resources allocated for Huffman codes.
-     */
-    ~Huffman()
-    {
-        Huff_DestroyNode(huffRoot);
-        huffRoot = NULL;
-    }
-
     /**
      * Exchange two nodes in the queue.
      */
@@ -307,6 +318,9 @@ struct Huffman
             // This is a leaf.
             huffCodes[node->value].code = code;
             huffCodes[node->value].length = length;
+
+            if (!minCodeLength || length < minCodeLength) minCodeLength = length;
+            if (length > maxCodeLength) maxCodeLength = length;
             return;
         }
 
@@ -327,19 +341,45 @@ struct Huffman
     }
 
     /**
-     * Checks if the encoding/decoding buffer can hold the given number of
-     * bytes. If not, reallocates the buffer.
+     * Builds the decoding table from the code lookup. Because the tree is full,
+     * every combination of maxCodeLength bits begins with a complete code.
      */
-    void Huff_ResizeBuffer(HuffBuffer *buffer, dsize neededSize)
+    void Huff_BuildDecodeTable()
     {
-        while (neededSize > buffer->size)
+        // The fixed frequencies produce codes of at most 10 bits.
+        DENG2_ASSERT(maxCodeLength <= 16);
+
+        duint const tableSize = 1u << maxCodeLength;
+
+        // First find out which symbol each combination of bits begins with.
+        std::vector<dbyte> firstSymbol(tableSize);
+        for (int i = 0; i < 256; ++i)
+        {
+            for (duint k = huffCodes[i].code; k < tableSize; k += 1u << huffCodes[i].length)
+            {
+                firstSymbol[k] = dbyte(i);
+            }
+        }
+
+        // Then decode as many symbols as fit in each combination. The bits past
+        // the end of the index are zero, so a symbol is only accepted if its
+        // code ends within the index.
+        decodeTable.resize(tableSize);
+        for (duint k = 0; k < tableSize; ++k)
         {
-            if (!buffer->size)
-                buffer->size = qMax(dsize(1024), neededSize);
-            else
-                buffer->size *= 2;
+            HuffDecodeStep &step = decodeTable[k];
+            zap(step);
+            while (step.count < MAX_STEP_SYMBOLS)
+            {
+                dbyte const value = firstSymbol[k >> step.bits];
+                if (step.bits + huffCodes[value].length > maxCodeLength)
+                    break;
+
+                step.symbols[step.count++] = value;
+                step.bits += huffCodes[value].length;
+            }
+            DENG2_ASSERT(step.count > 0);
         }
-        buffer->data = (dbyte *) realloc(buffer->data, buffer->size);
     }
 
     /**
@@ -355,146 +395,112 @@ struct Huffman
         }
     }
 
-    /**
-     * Free the buffer.
-     */
-    void Huff_DestroyBuffer(HuffBuffer *buffer)
-    {
-        free(buffer->data);
-        zapPtr(buffer);
-    }
-
-    dbyte *encode(dbyte const *data, dsize size, dsize *encodedSize)
+    Block encode(dbyte const *data, dsize size) const
     {
-        HuffBuffer huffEnc;
-        dsize i;
-        duint code;
-        int remaining, fits;
-        dbyte *out, bit;
-
-        zap(huffEnc);
-
-        // The encoded message is never twice the original size
-        // (longest codes are currently 11 bits).
-        Huff_ResizeBuffer(&huffEnc, 2 * size);
-
         // First three bits of the encoded data contain the number of bits (-1)
-        // in the last dbyte of the encoded data. It's written when we have
+        // in the last dbyte of the encoded data. They are written when we have
         // finished the encoding.
-        bit = 3;
+        Block encoded((3 + dsize(maxCodeLength) * size + 7) / 8);
+        dbyte *out = encoded.data();
 
-        // Clear the first dbyte of the result.
-        out = huffEnc.data;
-        *out = 0;
+        // Codes are collected in a 64-bit accumulator and written out 32 bits
+        // at a time.
+        duint64 bits = 0;
+        duint bitCount = 3;
+        dsize outBits = 3;
 
-        for (i = 0; i < size; ++i)
+        for (dsize i = 0; i < size; ++i)
         {
-            remaining = huffCodes[data[i]].length;
-            code = huffCodes[data[i]].code;
+            HuffCode const &hc = huffCodes[data[i]];
+            bits |= duint64(hc.code) << bitCount;
+            bitCount += hc.length;
+            outBits += hc.length;
 
-            while (remaining > 0)
+            if (bitCount >= 32)
             {
-                fits = 8 - bit;
-                if (fits > remaining)
-                    fits = remaining;
-
-                // Write the bits that fit the current dbyte.
-                *out |= code << bit;
-                code >>= fits;
-                remaining -= fits;
-
-                // Advance the bit position.
-                bit += fits;
-                if (bit == 8)
-                {
-                    bit = 0;
-                    *++out = 0;
-                }
+                out[0] = dbyte(bits);
+                out[1] = dbyte(bits >> 8);
+                out[2] = dbyte(bits >> 16);
+                out[3] = dbyte(bits >> 24);
+                out += 4;
+                bits >>= 32;
+                bitCount -= 32;
             }
         }
 
-        // If the last dbyte is empty, back up.
-        if (bit == 0)
+        // Write the remaining bits.
+        for (duint i = 0; i < (bitCount + 7) / 8; ++i)
         {
-            out--;
-            bit = 8;
+            *out++ = dbyte(bits >> (8 * i));
         }
 
-        if (encodedSize)
-            *encodedSize = out - huffEnc.data + 1;
+        dsize const encodedSize = (outBits + 7) / 8;
+        DENG2_ASSERT(dsize(out - encoded.data()) == encodedSize);
+        encoded.resize(encodedSize);
 
         // The number of valid bits - 1 in the last dbyte.
-        huffEnc.data[0] |= bit - 1;
+        encoded.data()[0] |= ((outBits - 1) & 7);
 
-        return huffEnc.data;
+        return encoded;
     }
 
-    dbyte *decode(dbyte const *data, dsize size, dsize *decodedSize)
+    Block decode(dbyte const *data, dsize size) const
     {
-        HuffBuffer huffDec;
-        HuffNode *node;
-        dsize outBytes = 0;
-        dbyte const *in = data;
-        dbyte const *lastIn = in + size - 1;
-        dbyte bit = 3, lastByteBits;
+        if (!data || size == 0) return Block();
 
-        if (!data || size == 0) return nullptr;
-        
-        zap(huffDec);
-        Huff_ResizeBuffer(&huffDec, 256);
+        dbyte const *in = data + 1;
+        dbyte const *end = data + size;
 
         // The first three bits contain the number of valid bits in
         // the last dbyte.
-        lastByteBits = (*in & 7) + 1;
-
-        // Start from the root node.
-        node = huffRoot;
-
-        while (in < lastIn || bit < lastByteBits)
+        dsize const lastByteBits = (*data & 7) + 1;
+        if (size == 1 && lastByteBits < 3) return Block();
+        dsize remaining = (size - 1) * 8 + lastByteBits - 3;
+
+        // Every decoded dbyte uses at least minCodeLength bits. All symbols of a
+        // decoding step are copied at once, so leave room for that.
+        Block decoded(remaining / minCodeLength + MAX_STEP_SYMBOLS);
+        dbyte *out = decoded.data();
+
+        // Input bits are read into an accumulator. Past the end of the data
+        // there are only zeros.
+        duint64 bits = *data >> 3;
+        duint bitCount = 5;
+        duint64 const mask = (duint64(1) << maxCodeLength) - 1;
+
+        while (remaining > 0)
         {
-            // Go left or right?
-            if (*in & (1 << bit))
-            {
-                node = node->right;
-            }
-            else
+            while (bitCount <= 56 && in != end)
             {
-                node = node->left;
+                bits |= duint64(*in++) << bitCount;
+                bitCount += 8;
             }
 
-            // Did we arrive at a leaf?
-            DENG2_ASSERT(node);
-            if (!node->left && !node->right)
+            HuffDecodeStep const &step = decodeTable[bits & mask];
+            if (step.bits <= remaining)
             {
-                // This node represents a value.
-                huffDec.data[outBytes++] = node->value;
-
-                // Should we allocate more memory?
-                if (outBytes == huffDec.size)
-                {
-                    Huff_ResizeBuffer(&huffDec, 2 * huffDec.size);
-                }
-
-                // Back to the root.
-                node = huffRoot;
+                std::memcpy(out, step.symbols, MAX_STEP_SYMBOLS);
+                out += step.count;
+                bits >>= step.bits;
+                bitCount -= step.bits;
+                remaining -= step.bits;
+                continue;
             }
 
-            // Advance bit position.
-            if (++bit == 8)
+            // These are the final bits of the message. Leftover bits that don't
+            // form a complete code are ignored.
+            for (int i = 0; i < step.count; ++i)
             {
-                bit = 0;
-                ++in;
-
-                // Out of buffer?
-                if (in > lastIn)
-                    break;
+                duint const length = huffCodes[step.symbols[i]].length;
+                if (length > remaining) break;
+                *out++ = step.symbols[i];
+                remaining -= length;
             }
+            break;
         }
-        if (decodedSize)
-        {
-            *decodedSize = outBytes;
-        }
-        return huffDec.data;
+
+        decoded.resize(out - decoded.data());
+        return decoded;
     }
 };
 
@@ -504,28 +510,12 @@ static internal::Huffman huff;
 
 Block codec::huffmanEncode(Block const &data)
 {
-    Block result;
-    dsize size = 0;
-    dbyte *coded = huff.encode(data.data(), data.size(), &size);
-    if (coded)
-    {
-        result.copyFrom(ByteRefArray(coded, size), 0, size);
-        free(coded);
-    }
-    return result;
+    return huff.encode(data.data(), data.size());
 }
 
 Block codec::huffmanDecode(Block const &codedData)
 {
-    Block result;
-    dsize size = 0;
-    dbyte *decoded = huff.decode(codedData.data(), codedData.size(), &size);
-    if (decoded)
-    {
-        result.copyFrom(ByteRefArray(decoded, size), 0, size);
-        free(decoded);
-    }
-    return result;
+    return huff.decode(codedData.data(), codedData.size());
 }
 
 } // namespace de
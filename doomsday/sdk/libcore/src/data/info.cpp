@@ -20,10 +20,15 @@
 #include "de/Info"
 #include "de/App"
 #include "de/Folder"
+#include "de/Guard"
 #include "de/Log"
 #include "de/LogBuffer"
+#include "de/MetadataBank"
+#include "de/Reader"
 #include "de/ScriptLex"
 #include "de/SourceLineTable"
+#include "de/Time"
+#include "de/Writer"
 
 #include <QFile>
 
@@ -36,12 +41,32 @@ static QString const INCLUDE_TOKEN = "@include";
 static QString const SCRIPT_TOKEN = "script";
 static String const GROUP_TOKEN = "group";
 
+static String const CACHE_CATEGORY = "Info";
+
+/// Format of the parsed documents in the metadata cache. Increment when the format
+/// or the parser's behavior changes.
+static duint const CACHE_VERSION = 1;
+
+/// Smaller documents are always parsed from source. They are quick to parse and
+/// would just clutter the cache.
+static dsize const CACHE_MIN_SIZE = 1024;
+
 static SourceLineTable sourceLineTable;
 
+/// Time spent on parsing Info files, and on restoring them from the metadata cache.
+static struct ParseStatistics : public Lockable
+{
+    int parsedCount = 0;
+    TimeDelta parseTime;
+    int cachedCount = 0;
+    TimeDelta cacheTime;
+} parseStats;
+
 DENG2_PIMPL(Info)
 {
     DENG2_ERROR(OutOfElements);
     DENG2_ERROR(EndOfFile);
+    DENG2_ERROR(CorruptCacheError);
 
     struct DefaultIncludeFinder : public IIncludeFinder
     {
@@ -66,6 +91,7 @@ DENG2_PIMPL(Info)
     int tokenStartOffset = 0;
     String currentToken;
     BlockElement rootBlock;
+    bool hasInclusions = false; ///< Other documents were included while parsing.
     DefaultIncludeFinder defaultFinder;
     IIncludeFinder const *finder = &defaultFinder;
 
@@ -85,6 +111,7 @@ DENG2_PIMPL(Info)
     void init(String const &source)
     {
         rootBlock.clear();
+        hasInclusions = false;
 
         // The source data. Add an extra newline so the character reader won't
         // get confused.
@@ -627,6 +654,7 @@ DENG2_PIMPL(Info)
 
             // Move the contents of the resulting root block to our root block.
             included.d->rootBlock.moveContents(rootBlock);
+            hasInclusions = true;
         }
         catch (Error const &er)
         {
@@ -662,7 +690,187 @@ DENG2_PIMPL(Info)
     void parse(File const &file)
     {
         sourcePath = file.path();
-        parse(String::fromUtf8(Block(file)));
+        Block const source(file);
+
+        bool const useCache = source.size() >= CACHE_MIN_SIZE &&
+                              App::appExists() && App::metadataBankExists();
+        Block id;
+        Time startedAt;
+
+        if (useCache)
+        {
+            id = cacheId(source);
+            try
+            {
+                if (Block const cached = MetadataBank::get().check(CACHE_CATEGORY, id))
+                {
+                    Block const data = cached.decompressed();
+                    Reader reader(data);
+                    rootBlock.clear();
+                    readContents(reader, rootBlock);
+
+                    DENG2_GUARD(parseStats);
+                    parseStats.cachedCount++;
+                    parseStats.cacheTime += startedAt.since();
+                    return;
+                }
+            }
+            catch (Error const &er)
+            {
+                LOGDEV_RES_WARNING("Corrupt cached Info document \"%s\": %s")
+                        << sourcePath << er.asText();
+            }
+            startedAt = Time();
+        }
+
+        parse(String::fromUtf8(source));
+        {
+            DENG2_GUARD(parseStats);
+            parseStats.parsedCount++;
+            parseStats.parseTime += startedAt.since();
+        }
+
+        // Included documents may change independently, so the result can only be
+        // reused if there were no inclusions.
+        if (useCache && !hasInclusions)
+        {
+            Block buf;
+            Writer writer(buf);
+            writeContents(writer, rootBlock);
+            MetadataBank::get().setMetadata(CACHE_CATEGORY, id, buf.compressed());
+        }
+    }
+
+    /**
+     * Identifies a parsed document in the metadata cache. The source path and the
+     * parser settings affect the resulting elements, so they are part of the ID.
+     */
+    Block cacheId(Block const &source) const
+    {
+        Block id = source;
+        id += String("\n%1\n%2\n%3\n%4\n%5")
+                .arg(CACHE_VERSION)
+                .arg(sourcePath)
+                .arg(implicitBlockType)
+                .arg(scriptBlockTypes.join(","))
+                .arg(allowDuplicateBlocksOfType.join(","))
+                .toUtf8();
+        return id.md5Hash();
+    }
+
+    static void writeValue(Writer &to, InfoValue const &value)
+    {
+        to << value.text << dbyte(value.flags);
+    }
+
+    static InfoValue readValue(Reader &from)
+    {
+        String text;
+        dbyte flags;
+        from >> text >> flags;
+        return InfoValue(text, InfoValue::Flags(QFlag(flags)));
+    }
+
+    static void writeContents(Writer &to, BlockElement const &block)
+    {
+        to << duint32(block.contentsInOrder().size());
+        for (Element const *elem : block.contentsInOrder())
+        {
+            writeElement(to, *elem);
+        }
+    }
+
+    void readContents(Reader &from, BlockElement &block)
+    {
+        duint32 count;
+        from >> count;
+        while (count--)
+        {
+            block.add(readElement(from));
+        }
+    }
+
+    /**
+     * Writes an element and its contents. Line numbers are written instead of the
+     * source line IDs, which are only valid during this session.
+     */
+    static void writeElement(Writer &to, Element const &elem)
+    {
+        to << dbyte(elem.type())
+           << elem.name()
+           << duint32(de::sourceLineTable.sourcePathAndLineNumber(elem.sourceLineId()).second);
+
+        switch (elem.type())
+        {
+        case Element::Key: {
+            auto const &key = elem.as<KeyElement>();
+            writeValue(to, key.value());
+            to << dbyte(key.flags());
+            break; }
+
+        case Element::List: {
+            auto const values = elem.values();
+            to << duint32(values.size());
+            for (InfoValue const &value : values)
+            {
+                writeValue(to, value);
+            }
+            break; }
+
+        case Element::Block:
+            to << elem.as<BlockElement>().blockType();
+            writeContents(to, elem.as<BlockElement>());
+            break;
+
+        default:
+            DENG2_ASSERT(!"Info: Unknown element type");
+            break;
+        }
+    }
+
+    Element *readElement(Reader &from)
+    {
+        dbyte type;
+        String name;
+        duint32 line;
+        from >> type >> name >> line;
+
+        std::unique_ptr<Element> elem;
+        switch (type)
+        {
+        case Element::Key: {
+            InfoValue const value = readValue(from);
+            dbyte flags;
+            from >> flags;
+            elem.reset(new KeyElement(name, value, KeyElement::Flags(QFlag(flags))));
+            break; }
+
+        case Element::List: {
+            auto *list = new ListElement(name);
+            elem.reset(list);
+            duint32 count;
+            from >> count;
+            while (count--)
+            {
+                list->add(readValue(from));
+            }
+            break; }
+
+        case Element::Block: {
+            String blockType;
+            from >> blockType;
+            auto *block = new BlockElement(blockType, name, self());
+            elem.reset(block);
+            readContents(from, *block);
+            break; }
+
+        default:
+            throw CorruptCacheError("Info::readElement",
+                                    QString("Unknown element type %1").arg(int(type)));
+        }
+
+        elem->setSourceLocation(sourcePath, int(line));
+        return elem.release();
     }
 };
 
@@ -937,4 +1145,12 @@ SourceLineTable const &Info::sourceLineTable() // static
     return de::sourceLineTable;
 }
 
+void Info::printParseStatistics() // static
+{
+    DENG2_GUARD(parseStats);
+    LOG_RES_VERBOSE("Info files: %i parsed in %.3f seconds, %i restored from cache in %.3f seconds")
+            << parseStats.parsedCount << parseStats.parseTime
+            << parseStats.cachedCount << parseStats.cacheTime;
+}
+
 } // namespace de
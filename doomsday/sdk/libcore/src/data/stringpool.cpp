@@ -22,10 +22,10 @@
 #include "de/Writer"
 #include "de/Lockable"
 #include "de/Guard"
+#include "de/math.h"
 
 #include <vector>
 #include <list>
-#include <set>
 #include <algorithm>
 #ifdef DENG2_DEBUG
 #  include <stdio.h>  /// @todo should use C++
@@ -43,6 +43,44 @@ static String const nullString = "(nullptr)";
 
 typedef uint InternalId;
 
+/**
+ * Hash of a text string that ignores case: the characters are case folded the same
+ * way as in a case-insensitive QString comparison, so strings that compare equal
+ * always have the same hash.
+ */
+static duint32 caselessHash(String const &text)
+{
+    // FNV-1a of the case folded UTF-16 code units.
+    duint32 hash = 0x811c9dc5;
+    QChar const *chars = text.constData();
+    int const len = text.size();
+    for (int i = 0; i < len; ++i)
+    {
+        duint c = chars[i].unicode();
+        if (c < 0x80)
+        {
+            if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+        }
+        else if (chars[i].isHighSurrogate() && i + 1 < len && chars[i + 1].isLowSurrogate())
+        {
+            c = QChar::toCaseFolded(QChar::surrogateToUcs4(chars[i], chars[i + 1]));
+            ++i;
+        }
+        else
+        {
+            c = QChar::toCaseFolded(ushort(c));
+        }
+        hash = (hash ^ c) * 0x01000193;
+    }
+    // Mix the bits so that the lowest ones can be used as the table index.
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
 /**
  * Case-insensitive text string (String).
  */
@@ -50,21 +88,18 @@ class CaselessString : public ISerializable
 {
 public:
     CaselessString()
-        : _str(), _id(0), _userValue(0), _userPointer(0)
+        : _str(), _hash(0), _id(0), _userValue(0), _userPointer(0)
     {}
 
-    CaselessString(QString text)
-        : _str(text), _id(0), _userValue(0), _userPointer(0)
+    CaselessString(QString text, duint32 hash)
+        : _str(text), _hash(hash), _id(0), _userValue(0), _userPointer(0)
     {}
 
     CaselessString(CaselessString const &other)
-        : ISerializable(), _str(other._str), _id(other._id), _userValue(other._userValue), _userPointer(0)
+        : ISerializable(), _str(other._str), _hash(other._hash), _id(other._id)
+        , _userValue(other._userValue), _userPointer(0)
     {}
 
-    void setText(String &text)
-    {
-        _str = text;
-    }
     operator String const *() const {
         return &_str;
     }
@@ -74,8 +109,11 @@ public:
     bool operator < (CaselessString const &other) const {
         return _str.compare(other, Qt::CaseInsensitive) < 0;
     }
-    bool operator == (CaselessString const &other) const {
-        return !_str.compare(other, Qt::CaseInsensitive);
+    bool equals(duint32 hash, String const &text) const {
+        return _hash == hash && !_str.compare(text, Qt::CaseInsensitive);
+    }
+    duint32 hash() const {
+        return _hash;
     }
     InternalId id() const {
         return _id;
@@ -101,59 +139,41 @@ public:
     }
     void operator << (Reader &from) {
         from >> _str >> _id >> _userValue;
+        _hash = caselessHash(_str);
     }
 
 private:
     String _str;
+    duint32 _hash;  ///< Precomputed caselessHash() of the string.
     InternalId _id; ///< The id that refers to this string.
     uint _userValue;
     void *_userPointer;
 };
 
 /**
- * Utility class that acts as the value type for the std::set of interned
- * strings. Only points to CaselessString instances. The less-than operator
- * is needed by std::set to keep the strings ordered.
+ * Slot in the open-addressed hash table of interned strings. The hash is duplicated
+ * here so that probing does not need to touch the strings themselves.
  */
-class CaselessStringRef {
-public:
-    CaselessStringRef(CaselessString const *s = 0) {
-        _str = s;
-    }
-    CaselessStringRef(CaselessStringRef const &other) {
-        _str = other._str;
-    }
-    CaselessString *toStr() const {
-        return const_cast<CaselessString *>(_str);
-    }
-    InternalId id() const {
-        DENG2_ASSERT(_str);
-        return _str->id();
-    }
-    bool operator < (CaselessStringRef const &other) const {
-        DENG2_ASSERT(_str);
-        DENG2_ASSERT(other._str);
-        return *_str < *other._str;
-    }
-    bool operator == (CaselessStringRef const &other) const {
-        DENG2_ASSERT(_str);
-        DENG2_ASSERT(other._str);
-        return *_str == *other._str;
-    }
-private:
-    CaselessString const *_str;
+struct InternSlot
+{
+    duint32 hash;
+    duint32 ref;  ///< InternalId + 1, or zero if the slot is unused.
 };
 
-typedef std::set<CaselessStringRef> Interns;
+typedef std::vector<InternSlot> Interns;
 typedef std::vector<CaselessString *> IdMap;
 typedef std::list<InternalId> AvailableIds;
 
+static dsize const NO_SLOT = dsize(-1);
+
 DENG2_PIMPL_NOREF(StringPool), public Lockable
 {
-    /// Interned strings (owns the CaselessString instances).
+    /// Interned strings, hashed by caselessHash() using linear probing. The number
+    /// of slots is a power of two.
     Interns interns;
 
     /// InternId => CaselessString*. Only one id can refer to the each CaselessString*.
+    /// Owns the CaselessString instances.
     IdMap idMap;
 
     /// Number of strings in the pool (must always be idMap.size() - available.size()).
@@ -190,37 +210,108 @@ DENG2_PIMPL_NOREF(StringPool), public Lockable
 
     inline void assertCount() const
     {
-        DENG2_ASSERT(count == interns.size());
         DENG2_ASSERT(count == idMap.size() - available.size());
     }
 
-    Interns::iterator findIntern(String text)
+    inline dsize slotMask() const
+    {
+        return interns.size() - 1;
+    }
+
+    /**
+     * Finds the slot of an interned string.
+     *
+     * @param text  Text to look for (case insensitively).
+     * @param hash  caselessHash() of @a text.
+     *
+     * @return Slot index, or NO_SLOT if the string is not interned.
+     */
+    dsize findIntern(String const &text, duint32 hash) const // O(1)
+    {
+        if (interns.empty()) return NO_SLOT;
+
+        for (dsize i = hash & slotMask(); interns[i].ref; i = (i + 1) & slotMask())
+        {
+            InternSlot const &slot = interns[i];
+            if (slot.hash == hash && idMap[slot.ref - 1]->equals(hash, text))
+            {
+                return i;
+            }
+        }
+        return NO_SLOT;
+    }
+
+    /**
+     * Adds a string to the hash table. The string must not already be there.
+     */
+    void insertIntern(CaselessString const &str) // O(1) (amortized)
     {
-        CaselessString const key(text);
-        return interns.find(CaselessStringRef(&key)); // O(log n)
+        // Keep the load factor under 3/4. The string already has an id, so it gets
+        // hashed along with the rest.
+        if (count * 4 > interns.size() * 3)
+        {
+            rehash(de::max(dsize(64), interns.size() * 2));
+            return;
+        }
+        placeIntern(str);
     }
 
-    Interns::const_iterator findIntern(String text) const
+    void placeIntern(CaselessString const &str)
     {
-        CaselessString const key(text);
-        return interns.find(CaselessStringRef(&key)); // O(log n)
+        dsize i = str.hash() & slotMask();
+        while (interns[i].ref) i = (i + 1) & slotMask();
+        interns[i].hash = str.hash();
+        interns[i].ref  = str.id() + 1;
+    }
+
+    /**
+     * Removes the string in slot @a index from the hash table. The following strings
+     * in the same run of slots are moved back so that no probe sequence is broken.
+     */
+    void removeIntern(dsize index) // O(1)
+    {
+        dsize hole = index;
+        for (dsize i = (index + 1) & slotMask(); interns[i].ref; i = (i + 1) & slotMask())
+        {
+            // Can this string be moved to the hole? Only if its home slot is not
+            // between the hole and its current slot.
+            dsize const home = interns[i].hash & slotMask();
+            if (((i - home) & slotMask()) >= ((i - hole) & slotMask()))
+            {
+                interns[hole] = interns[i];
+                hole = i;
+            }
+        }
+        interns[hole].ref = 0;
+    }
+
+    void rehash(dsize slotCount)
+    {
+        interns.assign(slotCount, InternSlot{0, 0});
+        for (CaselessString const *str : idMap)
+        {
+            if (str) placeIntern(*str);
+        }
     }
 
     /**
      * Before this is called make sure there is no duplicate of @a text in
-     * the interns set.
+     * the interns.
      *
      * @param text  Text string to add to the interned strings. A copy is
      *              made of this.
+     * @param hash  caselessHash() of @a text.
      */
-    InternalId copyAndAssignUniqueId(String const &text)
+    InternalId copyAndAssignUniqueId(String const &text, duint32 hash)
     {
-        CaselessString *str = new CaselessString(text);
+        CaselessString *str = new CaselessString(text, hash);
+
+        InternalId const id = assignUniqueId(str);
 
         // This is a new string that is added to the pool.
-        interns.insert(str); // O(log n)
+        insertIntern(*str); // O(1) (amortized)
 
-        return assignUniqueId(str);
+        return id;
     }
 
     InternalId assignUniqueId(CaselessString *str) // O(1)
@@ -255,24 +346,27 @@ DENG2_PIMPL_NOREF(StringPool), public Lockable
         return idx;
     }
 
-    void releaseAndDestroy(InternalId id, Interns::iterator *iterToErase = 0)
+    /**
+     * Removes a string from the pool.
+     *
+     * @param slot  Slot of the string in the interns.
+     */
+    void releaseAndDestroy(dsize slot) // O(1)
     {
+        InternalId const id = interns[slot].ref - 1;
         DENG2_ASSERT(id < idMap.size());
 
         CaselessString *interned = idMap[id];
         DENG2_ASSERT(interned != 0);
 
+        removeIntern(slot);
+
         idMap[id] = 0;
         available.push_back(id);
 
         // Delete the string itself, no one refers to it any more.
         delete interned;
 
-        // If the caller already located the interned string, let's use it
-        // to erase the string in O(1) time. Otherwise it's up to the
-        // caller to make sure it gets removed from the interns.
-        if (iterToErase) interns.erase(*iterToErase); // O(1) (amortized)
-
         // One less string.
         count--;
         assertCount();
@@ -316,13 +410,14 @@ StringPool::Id StringPool::intern(String str)
 {
     DENG2_GUARD(d);
     
-    Interns::iterator found = d->findIntern(str); // O(log n)
-    if (found != d->interns.end())
+    duint32 const hash = caselessHash(str);
+    dsize const found = d->findIntern(str, hash); // O(1)
+    if (found != NO_SLOT)
     {
         // Already got this one.
-        return EXPORT_ID(found->id());
+        return EXPORT_ID(d->interns[found].ref - 1);
     }
-    return EXPORT_ID(d->copyAndAssignUniqueId(str)); // O(log n)
+    return EXPORT_ID(d->copyAndAssignUniqueId(str, hash)); // O(1) (amortized)
 }
 
 String StringPool::internAndRetrieve(String str)
@@ -393,10 +488,10 @@ StringPool::Id StringPool::isInterned(String str) const
 {
     DENG2_GUARD(d);
 
-    Interns::const_iterator found = d->findIntern(str); // O(log n)
-    if (found != d->interns.end())
+    dsize const found = d->findIntern(str, caselessHash(str)); // O(1)
+    if (found != NO_SLOT)
     {
-        return EXPORT_ID(found->id());
+        return EXPORT_ID(d->interns[found].ref - 1);
     }
     // Not found.
     return 0;
@@ -431,10 +526,10 @@ bool StringPool::remove(String str)
 {
     DENG2_GUARD(d);
 
-    Interns::iterator found = d->findIntern(str); // O(log n)
-    if (found != d->interns.end())
+    dsize const found = d->findIntern(str, caselessHash(str)); // O(1)
+    if (found != NO_SLOT)
     {
-        d->releaseAndDestroy(found->id(), &found); // O(1) (amortized)
+        d->releaseAndDestroy(found); // O(1)
         return true;
     }
     return false;
@@ -447,13 +542,12 @@ bool StringPool::removeById(Id id)
     DENG2_GUARD(d);
 
     InternalId const internalId = IMPORT_ID(id);
-    if (id >= d->idMap.size()) return false;
+    if (internalId >= d->idMap.size()) return false;
 
     CaselessString *str = d->idMap[internalId];
     if (!str) return false;
 
-    d->interns.erase(str); // O(log n)
-    d->releaseAndDestroy(str->id());
+    d->releaseAndDestroy(d->findIntern(*str, str->hash())); // O(1)
     return true;
 }
 
@@ -479,11 +573,20 @@ void StringPool::operator >> (Writer &to) const
     // Number of strings altogether (includes unused ids).
     to << duint32(d->idMap.size());
 
-    // Write the interns.
-    to << duint32(d->interns.size());
-    for (Interns::const_iterator i = d->interns.begin(); i != d->interns.end(); ++i)
+    // Write the interns in case-insensitive order.
+    std::vector<CaselessString const *> sorted;
+    sorted.reserve(d->count);
+    for (CaselessString const *str : d->idMap)
     {
-        to << *i->toStr();
+        if (str) sorted.push_back(str);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [] (CaselessString const *a, CaselessString const *b) { return *a < *b; });
+
+    to << duint32(sorted.size());
+    for (CaselessString const *str : sorted)
+    {
+        to << *str;
     }
 }
 
@@ -505,7 +608,6 @@ void StringPool::operator << (Reader &from)
     {
         CaselessString *str = new CaselessString;
         from >> *str;
-        d->interns.insert(str);
 
         // Update the id map.
         d->idMap[str->id()] = str;
@@ -513,6 +615,11 @@ void StringPool::operator << (Reader &from)
         d->count++;
     }
 
+    // Hash the interns.
+    dsize slotCount = 64;
+    while (d->count * 4 > slotCount * 3) slotCount *= 2;
+    d->rehash(slotCount);
+
     // Update the available ids.
     for (uint i = 0; i < d->idMap.size(); ++i)
     {
@@ -70,6 +70,7 @@
 #include "de/Message"
 #include "de/Writer"
 #include "de/Reader"
+#include "de/Guard"
 #include "de/data/huffman.h"
 
 namespace de {
@@ -178,10 +179,117 @@ struct MessageHeader : public ISerializable
     }
 };
 
+/**
+ * Compresses a message payload and serializes it with a message header.
+ */
+static Block encodeMessage(IByteArray const &packet)
+{
+    Block payload(packet);
+    Block huffData;
+    MessageHeader header;
+
+    // Let's find the appropriate compression method of the payload. First see
+    // if the encoded contents are under 128 bytes as Huffman codes.
+    if (payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
+    {
+        huffData = codec::huffmanEncode(payload);
+        if (int(huffData.size()) <= MAX_SIZE_SMALL)
+        {
+            // We'll use this.
+            header.isHuffmanCoded = true;
+            header.size = huffData.size();
+            payload = huffData;
+        }
+        // Even if that didn't seem suitable, we'll keep it to compare against
+        // the deflated payload.
+    }
+
+    if (!header.size) // Try deflate.
+    {
+        int const level = (payload.size() < 10*MAX_SIZE_MEDIUM? 1 /*fast*/ : 9 /*best*/);
+        Block const deflated = payload.compressed(level);
+
+        if (!deflated.size())
+        {
+            throw Socket::ProtocolError("Socket::send:", "Failed to deflate message payload");
+        }
+        if (deflated.size() > MAX_SIZE_LARGE)
+        {
+            throw Socket::ProtocolError("Socket::send",
+                                        QString("Compressed payload is too large (%1 bytes)").arg(deflated.size()));
+        }
+
+        // Choose the smallest compression.
+        if (huffData.size() && huffData.size() <= deflated.size() && int(huffData.size()) <= MAX_SIZE_MEDIUM)
+        {
+            // Huffman yielded smaller payload.
+            header.isHuffmanCoded = true;
+            header.size = huffData.size();
+            payload = huffData;
+        }
+        else
+        {
+            // Use the deflated payload.
+            header.isDeflated = true;
+            header.size = deflated.size();
+            payload = deflated;
+        }
+    }
+
+    // The message header is followed by the payload.
+    Block dest;
+    Writer(dest) << header;
+    dest += payload;
+    return dest;
+}
+
+/// Counters of all sockets (may be sent from multiple threads).
+struct SocketStatistics : public Lockable
+{
+    Socket::Statistics counters;
+};
+
+static SocketStatistics &socketStats()
+{
+    static SocketStatistics stats;
+    return stats;
+}
+
 } // namespace internal
 
 using namespace internal;
 
+Socket::EncodedMessage::EncodedMessage(IByteArray const &packet)
+    : _payloadSize(packet.size())
+    , _sendCount(0)
+{
+    Time const startedAt;
+    _bytes = encodeMessage(packet);
+    _encodingTime = startedAt.since();
+
+    SocketStatistics &stats = socketStats();
+    DENG2_GUARD(stats);
+    stats.counters.messagesEncoded++;
+    stats.counters.bytesEncoded    += _payloadSize;
+    stats.counters.bytesCompressed += _bytes.size();
+    stats.counters.encodingTime    += _encodingTime;
+}
+
+Block const &Socket::EncodedMessage::bytes() const
+{
+    return _bytes;
+}
+
+dsize Socket::EncodedMessage::payloadSize() const
+{
+    return _payloadSize;
+}
+
+TimeDelta Socket::EncodedMessage::encodingTime() const
+{
+    return _encodingTime;
+}
+
 DENG2_PIMPL_NOREF(Socket)
 {
     Address target;
@@ -225,75 +333,13 @@ DENG2_PIMPL_NOREF(Socket)
         foreach (Message *msg, receivedMessages) delete msg;
     }
 
-    void serializeAndSendMessage(IByteArray const &packet)
+    void sendBytes(Block const &bytes)
     {
-        Block payload(packet);
-        Block huffData;
-        MessageHeader header;
-
-        // Let's find the appropriate compression method of the payload. First see
-        // if the encoded contents are under 128 bytes as Huffman codes.
-        if (payload.size() <= MAX_HUFFMAN_INPUT_SIZE) // Potentially short enough.
-        {
-            huffData = codec::huffmanEncode(payload);
-            if (int(huffData.size()) <= MAX_SIZE_SMALL)
-            {
-                // We'll use this.
-                header.isHuffmanCoded = true;
-                header.size = huffData.size();
-                payload = huffData;
-            }
-            // Even if that didn't seem suitable, we'll keep it to compare against
-            // the deflated payload.
-        }
-
-        /// @todo Messages broadcasted to multiple recipients are separately
-        /// compressed for each TCP send -- should do only one compression per
-        /// message.
-
-        if (!header.size) // Try deflate.
-        {
-            int const level = (payload.size() < 10*MAX_SIZE_MEDIUM? 1 /*fast*/ : 9 /*best*/);
-            Block const deflated = payload.compressed(level);
-
-            if (!deflated.size())
-            {
-                throw ProtocolError("Socket::send:", "Failed to deflate message payload");
-            }
-            if (deflated.size() > MAX_SIZE_LARGE)
-            {
-                throw ProtocolError("Socket::send",
-                                    QString("Compressed payload is too large (%1 bytes)").arg(deflated.size()));
-            }
-
-            // Choose the smallest compression.
-            if (huffData.size() && huffData.size() <= deflated.size() && int(huffData.size()) <= MAX_SIZE_MEDIUM)
-            {
-                // Huffman yielded smaller payload.
-                header.isHuffmanCoded = true;
-                header.size = huffData.size();
-                payload = huffData;
-            }
-            else
-            {
-                // Use the deflated payload.
-                header.isDeflated = true;
-                header.size = deflated.size();
-                payload = deflated;
-            }
-        }
-
-        // Write the message header.
-        Block dest;
-        Writer(dest) << header;
-        socket->write(dest);
+        socket->write(bytes);
 
         // Update totals (for statistics).
-        dsize total = dest.size() + payload.size();
-        bytesToBeWritten += total;
-        totalBytesWritten += total;
-
-        socket->write(payload);
+        bytesToBeWritten += bytes.size();
+        totalBytesWritten += bytes.size();
     }
 
     /**
@@ -553,7 +599,41 @@ void Socket::send(IByteArray const &packet, duint /*channel*/)
         throw DisconnectedError("Socket::send", "Socket is unavailable");
     }
 
-    d->serializeAndSendMessage(packet);
+    EncodedMessage const message(packet);
+    message._sendCount = 1;
+    d->sendBytes(message.bytes());
+}
+
+void Socket::send(EncodedMessage const &message)
+{
+    if (!d->socket)
+    {
+        /// @throw DisconnectedError Sending is not possible because the socket has been closed.
+        throw DisconnectedError("Socket::send", "Socket is unavailable");
+    }
+
+    if (message._sendCount++ > 0)
+    {
+        SocketStatistics &stats = socketStats();
+        DENG2_GUARD(stats);
+        stats.counters.encodingsReused++;
+        stats.counters.encodingTimeSaved += message._encodingTime;
+    }
+    d->sendBytes(message.bytes());
+}
+
+Socket::Statistics Socket::statistics() // static
+{
+    SocketStatistics &stats = socketStats();
+    DENG2_GUARD(stats);
+    return stats.counters;
+}
+
+void Socket::resetStatistics() // static
+{
+    SocketStatistics &stats = socketStats();
+    DENG2_GUARD(stats);
+    stats.counters = Statistics();
 }
 
 void Socket::readIncomingBytes()
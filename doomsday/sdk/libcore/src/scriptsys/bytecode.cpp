@@ -0,0 +1,516 @@
+/*
+ * The Doomsday Engine Project -- libcore
+ *
+ * Copyright © 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * LGPL: http://www.gnu.org/licenses/lgpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details. You should have received a copy of
+ * the GNU Lesser General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "de/Bytecode"
+#include "de/ConstantExpression"
+#include "de/Evaluator"
+#include "de/NameExpression"
+#include "de/NumberValue"
+#include "de/OperatorExpression"
+#include "de/Variable"
+#include "de/math.h"
+
+#include <QVector>
+
+namespace de {
+
+DENG2_PIMPL_NOREF(Bytecode)
+{
+    /// Maximum depth of the operand stack.
+    static dint const MAX_STACK = 16;
+
+    enum Opcode
+    {
+        PushNumber,     ///< Push a number constant.
+        PushValue,      ///< Push a constant that is not a number.
+        PushVariable,   ///< Push the value of a variable.
+        Negate,
+        Not,
+        Truth,          ///< Replace the topmost operand with its truth value.
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Modulo,
+        Equal,
+        NotEqual,
+        Less,
+        Greater,
+        LessOrEqual,
+        GreaterOrEqual,
+        JumpIfFalse,    ///< If false, replace with False and jump; otherwise pop.
+        JumpIfTrue      ///< If true, replace with True and jump; otherwise pop.
+    };
+
+    struct Instruction
+    {
+        Opcode op;
+        dint arg;                           ///< Constant/name index, or jump target.
+        Value::Number number;               ///< PushNumber: the number.
+        NumberValue::SemanticHints hints;   ///< PushNumber: semantics of the number.
+
+        Instruction(Opcode op, dint arg = 0)
+            : op(op), arg(arg), number(0), hints(NumberValue::Generic) {}
+    };
+
+    /// Unboxed value on the operand stack.
+    struct Operand
+    {
+        Value const *value;   ///< @c nullptr, if the operand is a plain number.
+        Value::Number number;
+        NumberValue::SemanticHints hints;
+        bool isVariable;      ///< Value is owned by a variable.
+
+        void setNumber(Value::Number num, NumberValue::SemanticHints semantic)
+        {
+            value  = nullptr;
+            number = num;
+            hints  = semantic;
+        }
+        void setBoolean(bool isTrue)
+        {
+            setNumber(isTrue? NumberValue::True : NumberValue::False, NumberValue::Boolean);
+        }
+        void setValue(Value const *val, bool ofVariable)
+        {
+            value      = val;
+            isVariable = ofVariable;
+        }
+        bool isTrue() const
+        {
+            return value? value->isTrue() : (number != 0);
+        }
+        bool isFalse() const
+        {
+            return value? value->isFalse() : (number == 0);
+        }
+    };
+
+    QVector<Instruction> code;
+    QVector<Value const *> values;          ///< Owned by constant expressions.
+    QVector<NameExpression const *> names;
+    dint depth = 0;
+    dint maxDepth = 0;
+
+    void add(Instruction const &inst)
+    {
+        switch (inst.op)
+        {
+        case PushNumber:
+        case PushValue:
+        case PushVariable:
+            maxDepth = de::max(maxDepth, ++depth);
+            break;
+
+        case Add: case Subtract: case Multiply: case Divide: case Modulo:
+        case Equal: case NotEqual: case Less: case Greater: case LessOrEqual:
+        case GreaterOrEqual:
+        case JumpIfFalse:
+        case JumpIfTrue:
+            --depth;
+            break;
+
+        default:
+            break;
+        }
+        code.append(inst);
+    }
+
+    void addNumber(Value::Number number, NumberValue::SemanticHints hints)
+    {
+        Instruction inst(PushNumber);
+        inst.number = number;
+        inst.hints  = hints;
+        add(inst);
+    }
+
+    /// Checks if the code starting at @a start only pushes constant numbers.
+    bool isConstant(dint start, dint count) const
+    {
+        if (code.size() != start + count) return false;
+        for (dint i = start; i < code.size(); ++i)
+        {
+            if (code.at(i).op != PushNumber) return false;
+        }
+        return true;
+    }
+
+    Operand constantOperand(dint pos) const
+    {
+        Operand op;
+        op.setNumber(code.at(pos).number, code.at(pos).hints);
+        return op;
+    }
+
+    /// Replaces the code starting at @a start with a single constant.
+    void replaceWithConstant(dint start, Operand const &constant)
+    {
+        depth -= code.size() - start;
+        code.resize(start);
+        addNumber(constant.number, constant.hints);
+    }
+
+    /**
+     * Emits an instruction for a unary operator, folding it if the operand is
+     * constant.
+     */
+    void addUnary(Opcode op, dint start)
+    {
+        if (isConstant(start, 1))
+        {
+            Operand operand = constantOperand(start);
+            if (applyUnary(op, operand))
+            {
+                replaceWithConstant(start, operand);
+                return;
+            }
+        }
+        add(op);
+    }
+
+    /**
+     * Emits an instruction for a binary operator, folding it if both operands
+     * are constant.
+     */
+    void addBinary(Opcode op, dint start)
+    {
+        if (isConstant(start, 2))
+        {
+            Operand left = constantOperand(start);
+            if (applyBinary(op, left, constantOperand(start + 1)))
+            {
+                replaceWithConstant(start, left);
+                return;
+            }
+        }
+        add(op);
+    }
+
+    bool compile(Expression const &expr)
+    {
+        if (auto const *constant = dynamic_cast<ConstantExpression const *>(&expr))
+        {
+            Value const &value = constant->value();
+            if (auto const *number = dynamic_cast<NumberValue const *>(&value))
+            {
+                addNumber(number->asNumber(), number->semanticHints());
+            }
+            else
+            {
+                values.append(&value);
+                add(Instruction(PushValue, values.size() - 1));
+            }
+            return true;
+        }
+        if (auto const *name = dynamic_cast<NameExpression const *>(&expr))
+        {
+            // Only plain lookups of existing variables, which have no side effects.
+            Expression::Flags const flags = name->flags();
+            if ((flags && flags != Expression::Flags(Expression::ByValue)) ||
+                !name->scopeIdentifier().isEmpty())
+            {
+                return false;
+            }
+            names.append(name);
+            add(Instruction(PushVariable, names.size() - 1));
+            return true;
+        }
+        if (auto const *opExpr = dynamic_cast<OperatorExpression const *>(&expr))
+        {
+            return compileOperator(*opExpr);
+        }
+        return false;
+    }
+
+    bool compileOperator(OperatorExpression const &expr)
+    {
+        dint const start = code.size();
+        Expression const *left  = expr.leftOperand();
+        Expression const *right = expr.rightOperand();
+        Opcode op;
+
+        switch (expr.op())
+        {
+        case PLUS:
+        case MINUS:
+            if (!left)
+            {
+                if (!compile(*right)) return false;
+                // Unary plus is a no-op.
+                if (expr.op() == MINUS) addUnary(Negate, start);
+                return true;
+            }
+            op = (expr.op() == PLUS? Add : Subtract);
+            break;
+
+        case NOT:
+            if (!compile(*right)) return false;
+            addUnary(Not, start);
+            return true;
+
+        case AND:
+        case OR:
+            return compileLogical(expr.op() == AND, *left, *right);
+
+        case MULTIPLY:  op = Multiply;       break;
+        case DIVIDE:    op = Divide;         break;
+        case MODULO:    op = Modulo;         break;
+        case EQUAL:     op = Equal;          break;
+        case NOT_EQUAL: op = NotEqual;       break;
+        case LESS:      op = Less;           break;
+        case GREATER:   op = Greater;        break;
+        case LEQUAL:    op = LessOrEqual;    break;
+        case GEQUAL:    op = GreaterOrEqual; break;
+
+        default:
+            return false;
+        }
+
+        DENG2_ASSERT(left && right);
+        if (!compile(*left) || !compile(*right)) return false;
+        addBinary(op, start);
+        return true;
+    }
+
+    bool compileLogical(bool isAnd, Expression const &left, Expression const &right)
+    {
+        dint const start = code.size();
+        if (!compile(left)) return false;
+
+        if (isConstant(start, 1))
+        {
+            // The outcome of the left side is known beforehand.
+            bool const leftIsTrue = constantOperand(start).isTrue();
+            depth -= 1;
+            code.resize(start);
+            if (leftIsTrue != isAnd)
+            {
+                addNumber(isAnd? NumberValue::False : NumberValue::True, NumberValue::Boolean);
+                return true;
+            }
+            if (!compile(right)) return false;
+            addUnary(Truth, start);
+            return true;
+        }
+
+        dint const jump = code.size();
+        add(Instruction(isAnd? JumpIfFalse : JumpIfTrue));
+        if (!compile(right)) return false;
+        add(Truth);
+        code[jump].arg = code.size();
+        return true;
+    }
+
+    static dint compareNumbers(Value::Number a, Value::Number b)
+    {
+        if (fequal(a, b)) return 0;
+        return cmp(a, b);
+    }
+
+    static dint compare(Operand const &left, Operand const &right)
+    {
+        if (!left.value && !right.value)
+        {
+            return compareNumbers(left.number, right.number);
+        }
+        // Compare as values. Numbers are boxed on the stack.
+        NumberValue const leftNumber(left.number, left.hints);
+        NumberValue const rightNumber(right.number, right.hints);
+        Value const &a = (left.value?  *left.value  : leftNumber);
+        Value const &b = (right.value? *right.value : rightNumber);
+        return a.compare(b);
+    }
+
+    /**
+     * Applies a unary operator on the operand.
+     *
+     * @return @c false, if the operator cannot be applied by the bytecode.
+     */
+    static bool applyUnary(Opcode op, Operand &operand)
+    {
+        switch (op)
+        {
+        case Negate:
+            if (operand.value) return false;
+            operand.number = -operand.number;
+            break;
+
+        case Not:
+            operand.setBoolean(operand.isFalse());
+            break;
+
+        case Truth:
+            operand.setBoolean(operand.isTrue());
+            break;
+
+        default:
+            DENG2_ASSERT(false); // Not a unary operator.
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Applies a binary operator. The result is placed in @a left.
+     *
+     * @return @c false, if the operator cannot be applied by the bytecode.
+     */
+    static bool applyBinary(Opcode op, Operand &left, Operand const &right)
+    {
+        switch (op)
+        {
+        case Equal:          left.setBoolean(compare(left, right) == 0); return true;
+        case NotEqual:       left.setBoolean(compare(left, right) != 0); return true;
+        case Less:           left.setBoolean(compare(left, right) <  0); return true;
+        case Greater:        left.setBoolean(compare(left, right) >  0); return true;
+        case LessOrEqual:    left.setBoolean(compare(left, right) <= 0); return true;
+        case GreaterOrEqual: left.setBoolean(compare(left, right) >= 0); return true;
+        default:
+            break;
+        }
+
+        // Arithmetic is only done on numbers. The result keeps the semantics of
+        // the left operand, like NumberValue does.
+        if (left.value || right.value) return false;
+
+        switch (op)
+        {
+        case Add:      left.number += right.number; break;
+        case Subtract: left.number -= right.number; break;
+        case Multiply: left.number *= right.number; break;
+        case Divide:   left.number /= right.number; break;
+
+        case Modulo:
+            // Modulo is done with integers.
+            if (!int(right.number)) return false;
+            left.number = int(left.number) % int(right.number);
+            break;
+
+        default:
+            DENG2_ASSERT(false); // Not a binary operator.
+            return false;
+        }
+        return true;
+    }
+
+    Value *execute(Evaluator &evaluator) const
+    {
+        Operand stack[MAX_STACK];
+        dint top = -1;
+
+        Evaluator::Namespaces spaces;
+        bool haveSpaces = false;
+
+        for (dint pc = 0; pc < code.size(); ++pc)
+        {
+            Instruction const &inst = code.at(pc);
+            switch (inst.op)
+            {
+            case PushNumber:
+                stack[++top].setNumber(inst.number, inst.hints);
+                break;
+
+            case PushValue:
+                stack[++top].setValue(values.at(inst.arg), false);
+                break;
+
+            case PushVariable: {
+                if (!haveSpaces)
+                {
+                    evaluator.namespaces(spaces);
+                    haveSpaces = true;
+                }
+                Variable const *var = names.at(inst.arg)->findVariable(spaces);
+                if (!var) return nullptr; // Let the tree walker report the error.
+
+                Value const &value = var->value();
+                if (auto const *number = dynamic_cast<NumberValue const *>(&value))
+                {
+                    stack[++top].setNumber(number->asNumber(), number->semanticHints());
+                }
+                else
+                {
+                    stack[++top].setValue(&value, true);
+                }
+                break; }
+
+            case Negate:
+            case Not:
+            case Truth:
+                if (!applyUnary(inst.op, stack[top])) return nullptr;
+                break;
+
+            case JumpIfFalse:
+            case JumpIfTrue:
+                if (stack[top].isTrue() == (inst.op == JumpIfTrue))
+                {
+                    stack[top].setBoolean(inst.op == JumpIfTrue);
+                    pc = inst.arg - 1;
+                }
+                else
+                {
+                    --top;
+                }
+                break;
+
+            default:
+                if (!applyBinary(inst.op, stack[top - 1], stack[top])) return nullptr;
+                --top;
+                break;
+            }
+        }
+
+        DENG2_ASSERT(top == 0);
+        Operand const &result = stack[0];
+        if (!result.value)
+        {
+            return new NumberValue(result.number, result.hints);
+        }
+        // Variables evaluate to references to their data (see NameExpression).
+        return result.isVariable? result.value->duplicateAsReference()
+                                : result.value->duplicate();
+    }
+};
+
+Bytecode::Bytecode() : d(new Impl)
+{}
+
+Bytecode *Bytecode::compile(Expression const &expression)
+{
+    std::unique_ptr<Bytecode> bytecode(new Bytecode);
+    auto &d = *bytecode->d;
+    if (!d.compile(expression) || d.maxDepth > Impl::MAX_STACK)
+    {
+        return nullptr;
+    }
+    DENG2_ASSERT(d.depth == 1);
+    return bytecode.release();
+}
+
+Value *Bytecode::execute(Evaluator &evaluator) const
+{
+    return d->execute(evaluator);
+}
+
+dint Bytecode::size() const
+{
+    return d->code.size();
+}
+
+} // namespace de
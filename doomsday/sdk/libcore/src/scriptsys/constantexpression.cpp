@@ -43,6 +43,12 @@ Value *ConstantExpression::evaluate(Evaluator &) const
     return _value->duplicate();
 }
 
+Value const &ConstantExpression::value() const
+{
+    DENG2_ASSERT(_value != 0);
+    return *_value;
+}
+
 ConstantExpression *ConstantExpression::None()
 {
     return new ConstantExpression(new NoneValue());
@@ -18,6 +18,7 @@
  */
 
 #include "de/Evaluator"
+#include "de/Bytecode"
 #include "de/Expression"
 #include "de/Value"
 #include "de/Context"
@@ -27,6 +28,8 @@
 
 namespace de {
 
+static bool evaluatorBytecodeEnabled = true;
+
 DENG2_PIMPL(Evaluator)
 {
     /// The context that owns this evaluator.
@@ -35,9 +38,10 @@ DENG2_PIMPL(Evaluator)
     struct ScopedExpression {
         Expression const *expression;
         Value *scope; // owned
+        Bytecode const *bytecode; // owned by the expression
 
-        ScopedExpression(Expression const *e = 0, Value *s = 0)
-            : expression(e), scope(s)
+        ScopedExpression(Expression const *e = 0, Value *s = 0, Bytecode const *b = 0)
+            : expression(e), scope(s), bytecode(b)
         {}
         Record *names() const
         {
@@ -61,6 +65,9 @@ DENG2_PIMPL(Evaluator)
     /// Namespace for the current expression.
     Record *names;
 
+    /// Expression whose bytecode could not be used; it is being pushed normally.
+    Expression const *bytecodeFallback;
+
     Expressions expressions;
     Results results;
 
@@ -72,6 +79,7 @@ DENG2_PIMPL(Evaluator)
         , context(owner)
         , current(0)
         , names(0)
+        , bytecodeFallback(0)
     {}
 
     ~Impl()
@@ -158,6 +166,19 @@ DENG2_PIMPL(Evaluator)
             names = top.names();
             /*qDebug() << "Evaluator: Evaluating latest scoped expression" << top.expression
                      << "in" << (top.scope? names->asText() : "null scope");*/
+            if (top.bytecode)
+            {
+                if (Value *value = top.bytecode->execute(self()))
+                {
+                    pushResult(value);
+                    continue;
+                }
+                // Evaluate the expression tree instead.
+                bytecodeFallback = top.expression;
+                top.expression->push(self());
+                bytecodeFallback = nullptr;
+                continue;
+            }
             pushResult(top.expression->evaluate(self()), top.scope);
         }
 
@@ -249,6 +270,16 @@ void Evaluator::push(Expression const *expression, Value *scope)
     d->expressions.push_back(Impl::ScopedExpression(expression, scope));
 }
 
+bool Evaluator::pushBytecode(Expression const *expression, Bytecode const &bytecode)
+{
+    if (!evaluatorBytecodeEnabled || d->bytecodeFallback == expression)
+    {
+        return false;
+    }
+    d->expressions.push_back(Impl::ScopedExpression(expression, nullptr, &bytecode));
+    return true;
+}
+
 void Evaluator::pushResult(Value *value)
 {
     d->pushResult(value);
@@ -274,4 +305,14 @@ Value *Evaluator::popResult(Value **evaluationScope)
     return result.result;
 }
 
+void Evaluator::setBytecodeEnabled(bool enabled)
+{
+    evaluatorBytecodeEnabled = enabled;
+}
+
+bool Evaluator::isBytecodeEnabled()
+{
+    return evaluatorBytecodeEnabled;
+}
+
 } // namespace de
@@ -128,6 +128,18 @@ String const &NameExpression::identifier() const
     return d->identifier;
 }
 
+String const &NameExpression::scopeIdentifier() const
+{
+    return d->scopeIdentifier;
+}
+
+Variable *NameExpression::findVariable(Evaluator::Namespaces const &spaces) const
+{
+    Record *foundInNamespace = 0;
+    return d->findInNamespaces(d->identifier, spaces, flags().testFlag(LocalOnly),
+                               foundInNamespace);
+}
+
 Value *NameExpression::evaluate(Evaluator &evaluator) const
 {
     //LOG_AS("NameExpression::evaluate");
@@ -18,6 +18,7 @@
  */
 
 #include "de/OperatorExpression"
+#include "de/Bytecode"
 #include "de/Evaluator"
 #include "de/Value"
 #include "de/NumberValue"
@@ -35,11 +36,12 @@ namespace de {
 /// Used for popping a result and checking if it's True.
 static OperatorExpression isResultTrue(RESULT_TRUE, nullptr);
 
-OperatorExpression::OperatorExpression() : _op(NONE), _leftOperand(0), _rightOperand(0)
+OperatorExpression::OperatorExpression()
+    : _op(NONE), _leftOperand(0), _rightOperand(0), _bytecode(0), _compiled(false), _bytecodeFailed(false)
 {}
 
 OperatorExpression::OperatorExpression(Operator op, Expression *operand)
-    : _op(op), _leftOperand(0), _rightOperand(operand)
+    : _op(op), _leftOperand(0), _rightOperand(operand), _bytecode(0), _compiled(false), _bytecodeFailed(false)
 {
     if (!isUnary(op))
     {
@@ -50,6 +52,7 @@ OperatorExpression::OperatorExpression(Operator op, Expression *operand)
 
 OperatorExpression::OperatorExpression(Operator op, Expression *leftOperand, Expression *rightOperand)
     : _op(op), _leftOperand(leftOperand), _rightOperand(rightOperand)
+    , _bytecode(0), _compiled(false), _bytecodeFailed(false)
 {
     if (!isBinary(op))
     {
@@ -60,12 +63,52 @@ OperatorExpression::OperatorExpression(Operator op, Expression *leftOperand, Exp
 
 OperatorExpression::~OperatorExpression()
 {
+    delete _bytecode;
     delete _leftOperand;
     delete _rightOperand;
 }
 
+Operator OperatorExpression::op() const
+{
+    return _op;
+}
+
+Expression const *OperatorExpression::leftOperand() const
+{
+    return _leftOperand;
+}
+
+Expression const *OperatorExpression::rightOperand() const
+{
+    return _rightOperand;
+}
+
+Bytecode const *OperatorExpression::bytecode() const
+{
+    if (!_compiled)
+    {
+        _bytecode = Bytecode::compile(*this);
+        _compiled = true;
+    }
+    return _bytecodeFailed? nullptr : _bytecode;
+}
+
 void OperatorExpression::push(Evaluator &evaluator, Value *scope) const
 {
+    // Expressions that only operate on constants and variables can be evaluated
+    // without walking the tree.
+    if (!scope && Evaluator::isBytecodeEnabled())
+    {
+        if (Bytecode const *code = bytecode())
+        {
+            if (evaluator.pushBytecode(this, *code)) return;
+
+            // The bytecode was already tried and it could not handle the operands.
+            // They are likely to be of the same kind the next time, too.
+            _bytecodeFailed = true;
+        }
+    }
+
     Expression::push(evaluator);
 
     if (_op == MEMBER)
@@ -371,8 +414,12 @@ void OperatorExpression::operator << (Reader &from)
 
     delete _leftOperand;
     delete _rightOperand;
+    delete _bytecode;
     _leftOperand = 0;
     _rightOperand = 0;
+    _bytecode = 0;
+    _compiled = false;
+    _bytecodeFailed = false;
 
     _rightOperand = Expression::constructFrom(from);
     if (header & HAS_LEFT_OPERAND)
@@ -154,6 +154,7 @@ void RootWidget::update()
 #if defined (DENG_MOBILE)
     DENG2_GUARD(this);
 #endif
+    Rule::updateInvalidRules();
     notifyTree(&Widget::update);
 }
 
@@ -162,6 +163,7 @@ void RootWidget::draw()
 #if defined (DENG_MOBILE)
     DENG2_GUARD(this);
 #endif
+    Rule::updateInvalidRules(); // Changed during update().
     notifyTree(notifyArgsForDraw());
     Rule::markRulesValid(); // All done for this frame.
 }
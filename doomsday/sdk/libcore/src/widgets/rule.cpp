@@ -21,10 +21,41 @@
 #include "de/math.h"
 #include "de/PointerSet"
 
+#include <utility>
+#include <vector>
+
 namespace de {
 
 bool Rule::_invalidRulesExist = false;
 
+namespace internal {
+
+/**
+ * Invalidated rules waiting to be updated, and invalidated rules whose dependants
+ * have not yet been notified. Like the rest of the rule state, these are only
+ * accessed in the main thread.
+ */
+struct RuleQueues
+{
+    std::vector<Rule *> pending;
+    std::vector<std::pair<Rule *, duint>> notified; // rule, invalidation depth
+    bool notifying = false;
+    duint notifyDepth = 0;
+    std::vector<Rule *> evalStack;
+    Rule::Statistics stats;
+
+    static RuleQueues &get()
+    {
+        // Rules may be destroyed during static destruction, so this is never deleted.
+        static RuleQueues *queues = new RuleQueues;
+        return *queues;
+    }
+};
+
+} // namespace internal
+
+using internal::RuleQueues;
+
 DENG2_PIMPL_NOREF(Rule)
 {
     typedef PointerSetT<Rule> Dependencies;
@@ -36,6 +67,12 @@ DENG2_PIMPL_NOREF(Rule)
     /// The value is valid.
     bool isValid;
 
+    /// Position in RuleQueues::pending, or -1 if not queued for updating.
+    dint pendingIndex = -1;
+
+    /// The invalid dependencies are being updated (see updateInvalidRules()).
+    bool isVisited = false;
+
     Impl() : value(0), isValid(false)
     {}
 
@@ -55,7 +92,17 @@ Rule::Rule(float initialValue) : d(new Impl(initialValue))
 {}
 
 Rule::~Rule()
-{}
+{
+    if (d->pendingIndex >= 0)
+    {
+        // Move the last pending rule to this one's place.
+        auto &pending = RuleQueues::get().pending;
+        Rule *last = pending.back();
+        pending[d->pendingIndex] = last;
+        last->d->pendingIndex = d->pendingIndex;
+        pending.pop_back();
+    }
+}
 
 float Rule::value() const
 {
@@ -63,6 +110,7 @@ float Rule::value() const
     {
         // Force an update.
         const_cast<Rule *>(this)->update();
+        RuleQueues::get().stats.updatedOnDemand++;
     }
 
     // It must be valid now, after the update.
@@ -97,6 +145,63 @@ bool Rule::invalidRulesExist()
     return _invalidRulesExist;
 }
 
+void Rule::updateInvalidRules()
+{
+    auto &queues = RuleQueues::get();
+    auto &stack  = queues.evalStack;
+
+    // Rules invalidated during the updates are also handled, but not indefinitely
+    // in case an update invalidates its own rule.
+    for (dsize count = queues.pending.size(); count > 0 && !queues.pending.empty(); --count)
+    {
+        Rule *rule = queues.pending.back();
+        queues.pending.pop_back();
+        rule->d->pendingIndex = -1;
+
+        // Depth-first traversal of the invalid dependencies; a rule is updated
+        // when it is popped after all of its dependencies have been updated.
+        DENG2_ASSERT(stack.empty());
+        stack.push_back(rule);
+        while (!stack.empty())
+        {
+            Rule *top = stack.back();
+            if (top->d->isValid)
+            {
+                stack.pop_back();
+            }
+            else if (!top->d->isVisited)
+            {
+                top->d->isVisited = true;
+                for (Rule *dep : top->d->dependencies)
+                {
+                    // Dependencies already being visited would form a cycle.
+                    if (!dep->d->isValid && !dep->d->isVisited)
+                    {
+                        stack.push_back(dep);
+                    }
+                }
+            }
+            else
+            {
+                stack.pop_back();
+                top->d->isVisited = false;
+                top->update();
+                queues.stats.evaluated++;
+            }
+        }
+    }
+}
+
+Rule::Statistics const &Rule::statistics()
+{
+    return RuleQueues::get().stats;
+}
+
+void Rule::resetStatistics()
+{
+    RuleQueues::get().stats = Statistics();
+}
+
 float Rule::cachedValue() const
 {
     return d->value;
@@ -150,7 +255,35 @@ void Rule::invalidate()
         // Also set the global flag.
         Rule::_invalidRulesExist = true;
 
-        DENG2_FOR_AUDIENCE(RuleInvalidation, i) i->ruleInvalidated();
+        auto &queues = RuleQueues::get();
+        queues.stats.invalidated++;
+        if (d->pendingIndex < 0)
+        {
+            d->pendingIndex = dint(queues.pending.size());
+            queues.pending.push_back(this);
+        }
+
+        // The dependants are notified breadth-first without recursing, as the
+        // chains of dependent rules may be very long.
+        duint const depth = (queues.notifying? queues.notifyDepth + 1 : 1);
+        queues.notified.emplace_back(this, depth);
+        if (!queues.notifying)
+        {
+            queues.notifying = true;
+            for (dsize i = 0; i < queues.notified.size(); ++i)
+            {
+                auto const next = queues.notified[i];
+                queues.notifyDepth = next.second;
+                queues.stats.invalidationDepth = de::max(queues.stats.invalidationDepth, next.second);
+                DENG2_FOR_EACH_OBSERVER(RuleInvalidationAudience, k,
+                                        next.first->audienceForRuleInvalidation)
+                {
+                    k->ruleInvalidated();
+                }
+            }
+            queues.notified.clear();
+            queues.notifying = false;
+        }
     }
 }
 
@@ -23,6 +23,18 @@
  * It is not necessary to explicitly call Z_Free() on >= PU_PURGELEVEL blocks
  * because they will be automatically freed when the rover encounters them.
  *
+ * @par Slabs
+ * Small blocks (up to MAX_SLAB_SIZE bytes) with the PU_APPSTATIC, PU_GAMESTATIC
+ * and PU_MAP tags are not allocated with the rover. Instead, they are taken
+ * from slabs: zone blocks that are divided into equally sized elements. Each
+ * combination of tag and size class has its own slab cache with a free list
+ * and a mutex of its own, so these allocations neither scan the volumes nor
+ * contend on the zone lock. Slab elements have a regular memblock_t header, so
+ * the user pointer and tag of the element work as usual; Z_FreeTags() frees
+ * elements according to their own tags and returns emptied slabs to the zone.
+ * An element that is given a purgable tag is freed when the rover passes its
+ * slab, and so is the slab if it has no other elements.
+ *
  * @par Block Sequences
  * The PU_MAPSTATIC purge tag has a special purpose. It works like PU_MAP so
  * that it is purged on a per map basis, but blocks allocated as PU_MAPSTATIC
@@ -69,6 +81,22 @@
 /// Special user pointer for blocks that are in use but have no single owner.
 #define MEMBLOCK_USER_ANONYMOUS    ((void *) 2)
 
+#ifndef LIBDENG_FAKE_MEMORY_ZONE
+#  define LIBDENG_ZONE_SLABS
+#endif
+
+/// Special user pointer for zone blocks that are divided into slab elements.
+#define MEMBLOCK_USER_SLAB         ((void *) 3)
+
+// Size of one slab (a zone block divided into elements).
+#define SLAB_SIZE           0x4000      // 16 Kb
+
+// Largest block size allocated from slabs.
+#define MAX_SLAB_SIZE       256
+
+#define NUM_SLAB_SIZES      8
+#define NUM_SLAB_TAGS       3
+
 // Used for block allocation of memory from the zone.
 typedef struct zblockset_block_s {
     /// Maximum number of elements.
@@ -84,6 +112,37 @@ typedef struct zblockset_block_s {
     void *elements;
 } zblockset_block_t;
 
+#ifdef LIBDENG_ZONE_SLABS
+/**
+ * A slab is allocated from the zone as a single block. The slab header is
+ * followed by the elements. An element's header is a memblock_t whose
+ * @c volume is NULL, @c next points to the slab, and @c prev links the element
+ * to the free list of the cache when the element is not in use.
+ */
+typedef struct zslab_s {
+    struct zslab_s *next;
+    struct zslabcache_s *cache;  ///< NULL when the slab is being released.
+    unsigned int count;          ///< Number of elements.
+    unsigned int used;           ///< Number of allocated elements.
+    unsigned int purgable;       ///< Allocated elements with a purgable tag.
+} zslab_t;
+
+typedef struct zslabcache_s {
+    mutex_t mutex;
+    int tag;
+    size_t elementSize;          ///< Including the block header.
+    zslab_t *slabs;
+    memblock_t *freeList;
+    unsigned int slabCount;
+    unsigned int hits;           ///< Allocations served from the free list.
+    unsigned int misses;         ///< Allocations that needed a new slab.
+} zslabcache_t;
+
+static size_t const slabSizes[NUM_SLAB_SIZES] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+static zslabcache_t slabCaches[NUM_SLAB_TAGS][NUM_SLAB_SIZES];
+#endif
+
 static memvolume_t *volumeRoot;
 static memvolume_t *volumeLast;
 
@@ -177,9 +236,47 @@ dd_bool Z_IsInited(void)
     return zoneMutex != 0;
 }
 
+#ifdef LIBDENG_ZONE_SLABS
+static void initSlabCaches(void)
+{
+    int const tags[NUM_SLAB_TAGS] = { PU_APPSTATIC, PU_GAMESTATIC, PU_MAP };
+    int i, k;
+
+    for (i = 0; i < NUM_SLAB_TAGS; ++i)
+    {
+        for (k = 0; k < NUM_SLAB_SIZES; ++k)
+        {
+            zslabcache_t *cache = &slabCaches[i][k];
+            memset(cache, 0, sizeof(*cache));
+            cache->mutex       = Sys_CreateMutex("ZONE_SLAB_MUTEX");
+            cache->tag         = tags[i];
+            cache->elementSize = sizeof(memblock_t) + slabSizes[k];
+        }
+    }
+}
+
+static void shutdownSlabCaches(void)
+{
+    int i, k;
+
+    // The slabs themselves are released along with the volumes.
+    for (i = 0; i < NUM_SLAB_TAGS; ++i)
+    {
+        for (k = 0; k < NUM_SLAB_SIZES; ++k)
+        {
+            Sys_DestroyMutex(slabCaches[i][k].mutex);
+            memset(&slabCaches[i][k], 0, sizeof(slabCaches[i][k]));
+        }
+    }
+}
+#endif
+
 int Z_Init(void)
 {
     zoneMutex = Sys_CreateMutex("ZONE_MUTEX");
+#ifdef LIBDENG_ZONE_SLABS
+    initSlabCaches();
+#endif
 
     // Create the first volume.
     createVolume(MEMORY_VOLUME_SIZE);
@@ -215,6 +312,10 @@ void Z_Shutdown(void)
     App_Log(DE2_LOG_NOTE,
             "Z_Shutdown: Used %i volumes, total %u bytes.", numVolumes, totalMemory);
 
+#ifdef LIBDENG_ZONE_SLABS
+    shutdownSlabCaches();
+#endif
+
     Sys_DestroyMutex(zoneMutex);
     zoneMutex = 0;
 }
@@ -242,6 +343,280 @@ memblock_t *Z_GetBlock(void *ptr)
 }
 #endif
 
+#ifdef LIBDENG_ZONE_SLABS
+/**
+ * Returns the slab cache for blocks of the given size and tag, or NULL if the
+ * block should be allocated normally.
+ */
+static zslabcache_t *slabCacheFor(size_t size, int tag)
+{
+    int tagIndex, i;
+
+    if (size > MAX_SLAB_SIZE) return NULL;
+
+    switch (tag)
+    {
+    case PU_APPSTATIC:  tagIndex = 0; break;
+    case PU_GAMESTATIC: tagIndex = 1; break;
+    case PU_MAP:        tagIndex = 2; break;
+    default:
+        return NULL;
+    }
+
+    for (i = 0; i < NUM_SLAB_SIZES; ++i)
+    {
+        if (size <= slabSizes[i])
+        {
+            return &slabCaches[tagIndex][i];
+        }
+    }
+    return NULL;
+}
+
+static __inline dd_bool isSlabElement(memblock_t const *block)
+{
+    // Blocks allocated from volumes always know their volume.
+    return block->id == LIBDENG_ZONEID && !block->volume;
+}
+
+/**
+ * Divides a new slab into elements and puts them in the free list of the cache.
+ * The cache must be locked.
+ */
+static void addSlabToCache(zslabcache_t *cache, zslab_t *slab)
+{
+    byte *elements = (byte *) slab + ALIGNED(sizeof(zslab_t));
+    unsigned int i;
+
+    slab->cache = cache;
+    slab->count = (SLAB_SIZE - ALIGNED(sizeof(zslab_t))) / cache->elementSize;
+    slab->used  = 0;
+    slab->purgable = 0;
+    slab->next  = cache->slabs;
+    cache->slabs = slab;
+    cache->slabCount++;
+
+    for (i = slab->count; i-- > 0; )
+    {
+        memblock_t *block = (memblock_t *) (elements + i * cache->elementSize);
+        memset(block, 0, sizeof(*block));
+        block->size = cache->elementSize;
+        block->next = (memblock_t *) slab;
+        block->prev = cache->freeList;
+        cache->freeList = block;
+    }
+}
+
+static void *allocFromSlab(zslabcache_t *cache, void *user)
+{
+    memblock_t *block;
+
+    Sys_Lock(cache->mutex);
+    if (cache->freeList)
+    {
+        cache->hits++;
+    }
+    else
+    {
+        zslab_t *slab;
+
+        // The slab is allocated from the zone, which must not be locked while
+        // the cache is locked (the zone lock is always acquired first).
+        Sys_Unlock(cache->mutex);
+        slab = Z_Malloc(SLAB_SIZE, cache->tag, NULL);
+        Z_ChangeUser(slab, MEMBLOCK_USER_SLAB);
+        Sys_Lock(cache->mutex);
+
+        addSlabToCache(cache, slab);
+        cache->misses++;
+    }
+
+    block = cache->freeList;
+    cache->freeList = block->prev;
+    block->prev = NULL;
+    ((zslab_t *) block->next)->used++;
+
+    block->tag = cache->tag;
+    block->id  = LIBDENG_ZONEID;
+    if (user)
+    {
+        block->user = user;
+        *(void **) user = (void *) ((byte *) block + sizeof(memblock_t));
+    }
+    else
+    {
+        block->user = MEMBLOCK_USER_ANONYMOUS;
+    }
+    Sys_Unlock(cache->mutex);
+
+    return (void *) ((byte *) block + sizeof(memblock_t));
+}
+
+/**
+ * Marks a slab element unused. The cache of the element must be locked.
+ */
+static void releaseSlabElement(zslabcache_t *cache, memblock_t *block)
+{
+    if (block->tag >= PU_PURGELEVEL)
+        ((zslab_t *) block->next)->purgable--;
+    if (block->user > (void **) 0x100) // Smaller values are not pointers.
+        *block->user = 0; // Clear the user's mark.
+    block->user = NULL;
+    block->tag = 0;
+    block->id = 0;
+
+    block->prev = cache->freeList;
+    cache->freeList = block;
+    ((zslab_t *) block->next)->used--;
+}
+
+static void freeSlabElement(memblock_t *block)
+{
+    zslabcache_t *cache = ((zslab_t *) block->next)->cache;
+
+    Sys_Lock(cache->mutex);
+    releaseSlabElement(cache, block);
+    Sys_Unlock(cache->mutex);
+}
+
+/**
+ * Releases the elements of a slab whose tags are in the given range. The cache
+ * of the slab must be locked.
+ */
+static void releaseSlabTags(zslabcache_t *cache, zslab_t *slab, int lowTag, int highTag)
+{
+    byte *elements = (byte *) slab + ALIGNED(sizeof(zslab_t));
+    unsigned int n;
+
+    for (n = 0; n < slab->count && slab->used > 0; ++n)
+    {
+        memblock_t *block = (memblock_t *) (elements + n * cache->elementSize);
+        if (block->user && block->tag >= lowTag && block->tag <= highTag)
+        {
+            releaseSlabElement(cache, block);
+        }
+    }
+}
+
+/**
+ * Removes the elements of detached slabs from the free list of the cache.
+ * The cache must be locked.
+ */
+static void pruneSlabFreeList(zslabcache_t *cache)
+{
+    memblock_t *block, **freeLink;
+
+    for (freeLink = &cache->freeList; *freeLink; )
+    {
+        block = *freeLink;
+        if (!((zslab_t *) block->next)->cache)
+        {
+            *freeLink = block->prev;
+        }
+        else
+        {
+            freeLink = &block->prev;
+        }
+    }
+}
+
+/**
+ * Frees all slab elements whose tags are in the given range. Slabs that become
+ * empty are returned to the zone.
+ */
+static void freeSlabTags(int lowTag, int highTag)
+{
+    int i, k;
+
+    for (i = 0; i < NUM_SLAB_TAGS; ++i)
+    {
+        for (k = 0; k < NUM_SLAB_SIZES; ++k)
+        {
+            zslabcache_t *cache = &slabCaches[i][k];
+            zslab_t *released = NULL;
+            zslab_t *slab, **link;
+
+            Sys_Lock(cache->mutex);
+
+            for (slab = cache->slabs; slab; slab = slab->next)
+            {
+                releaseSlabTags(cache, slab, lowTag, highTag);
+            }
+
+            // Detach the empty slabs.
+            for (link = &cache->slabs; *link; )
+            {
+                slab = *link;
+                if (!slab->used)
+                {
+                    *link = slab->next;
+                    slab->cache = NULL;
+                    slab->next = released;
+                    released = slab;
+                    cache->slabCount--;
+                }
+                else
+                {
+                    link = &slab->next;
+                }
+            }
+
+            // The free list must not refer to the detached slabs.
+            if (released)
+            {
+                pruneSlabFreeList(cache);
+            }
+
+            Sys_Unlock(cache->mutex);
+
+            while (released)
+            {
+                slab = released;
+                released = slab->next;
+                Z_Free(slab);
+            }
+        }
+    }
+}
+
+/**
+ * Frees the purgable elements of a slab that the rover has come across. Slab
+ * elements may have been given a purgable tag with Z_ChangeTag2() after they
+ * were allocated. The zone must be locked.
+ *
+ * @return  @c true, if the slab became empty and was detached from its cache.
+ * The caller must then free the slab's zone block.
+ */
+static dd_bool purgeSlab(zslab_t *slab)
+{
+    zslabcache_t *cache = slab->cache;
+    dd_bool detached = false;
+
+    // Most slabs have nothing to purge.
+    if (!cache || !slab->purgable) return false;
+
+    Sys_Lock(cache->mutex);
+    if (slab->cache == cache) // Not being released by freeSlabTags().
+    {
+        releaseSlabTags(cache, slab, PU_PURGELEVEL, DDMAXINT);
+
+        if (!slab->used)
+        {
+            zslab_t **link;
+            for (link = &cache->slabs; *link != slab; link = &(*link)->next) {}
+            *link = slab->next;
+            slab->cache = NULL;
+            cache->slabCount--;
+            pruneSlabFreeList(cache);
+            detached = true;
+        }
+    }
+    Sys_Unlock(cache->mutex);
+
+    return detached;
+}
+#endif // LIBDENG_ZONE_SLABS
+
 /**
  * Frees a block of memory allocated with Z_Malloc.
  *
@@ -256,6 +631,14 @@ static void freeBlock(void *ptr, memblock_t **tracked)
 
     if (!ptr) return;
 
+#ifdef LIBDENG_ZONE_SLABS
+    if (isSlabElement(Z_GetBlock(ptr)))
+    {
+        freeSlabElement(Z_GetBlock(ptr));
+        return;
+    }
+#endif
+
     lockZone();
 
     block = Z_GetBlock(ptr);
@@ -458,6 +841,17 @@ void *Z_Malloc(size_t size, int tag, void *user)
         return NULL;
     }
 
+#ifdef LIBDENG_ZONE_SLABS
+    {
+        // Small blocks are allocated from slabs.
+        zslabcache_t *cache = slabCacheFor(ALIGNED(size), tag);
+        if (cache)
+        {
+            return allocFromSlab(cache, user);
+        }
+    }
+#endif
+
     lockZone();
 
     // Align to pointer size.
@@ -539,6 +933,16 @@ void *Z_Malloc(size_t size, int tag, void *user)
                     freeBlock((byte *) old + sizeof(memblock_t), &start);
 #endif
                 }
+#ifdef LIBDENG_ZONE_SLABS
+                else if (iter->user == MEMBLOCK_USER_SLAB &&
+                         purgeSlab((zslab_t *) ((byte *) iter + sizeof(memblock_t))))
+                {
+                    // All the elements were purgable, so the slab is free, too.
+                    memblock_t *old = iter;
+                    iter = iter->prev; // Step back.
+                    freeBlock((byte *) old + sizeof(memblock_t), &start);
+                }
+#endif
                 else
                 {
                     if (iter->seqFirst)
@@ -684,6 +1088,12 @@ void Z_FreeTags(int lowTag, int highTag)
             "MemoryZone: Freeing all blocks in tag range:[%i, %i)",
             lowTag, highTag+1);
 
+#ifdef LIBDENG_ZONE_SLABS
+    // Slab elements are freed according to their own tags. Slabs that still
+    // contain elements must not be freed.
+    freeSlabTags(lowTag, highTag);
+#endif
+
     for (volume = volumeRoot; volume; volume = volume->next)
     {
         for (block = volume->zone->blockList.next;
@@ -692,7 +1102,7 @@ void Z_FreeTags(int lowTag, int highTag)
         {
             next = block->next;
 
-            if (block->user) // An allocated block?
+            if (block->user && block->user != MEMBLOCK_USER_SLAB) // An allocated block?
             {
                 if (block->tag >= lowTag && block->tag <= highTag)
 #ifdef LIBDENG_FAKE_MEMORY_ZONE
@@ -827,6 +1237,23 @@ void Z_ChangeTag2(void *ptr, int tag)
             App_Log(DE2_LOG_ERROR,
                 "Z_ChangeTag: An owner is required for purgable blocks.");
         }
+#ifdef LIBDENG_ZONE_SLABS
+        else if (isSlabElement(block))
+        {
+            // The rover purges the elements of a slab only if it knows there are
+            // purgable ones.
+            zslab_t *slab = (zslab_t *) block->next;
+            zslabcache_t *cache = slab->cache;
+
+            Sys_Lock(cache->mutex);
+            if (block->tag < PU_PURGELEVEL && tag >= PU_PURGELEVEL)
+                slab->purgable++;
+            else if (block->tag >= PU_PURGELEVEL && tag < PU_PURGELEVEL)
+                slab->purgable--;
+            block->tag = tag;
+            Sys_Unlock(cache->mutex);
+        }
+#endif
         else
         {
             block->tag = tag;
@@ -1046,6 +1473,30 @@ void Z_PrintStatus(void)
     App_Log(DE2_LOG_DEBUG,
             "Memory zone status: %u volumes, %u bytes allocated, %u bytes free (%f%% in use)",
             Z_VolumeCount(), (uint)allocated, (uint)wasted, (float)allocated/(float)(allocated+wasted)*100.f);
+
+#ifdef LIBDENG_ZONE_SLABS
+    {
+        uint slabCount = 0, hits = 0, misses = 0;
+        int i, k;
+
+        for (i = 0; i < NUM_SLAB_TAGS; ++i)
+        {
+            for (k = 0; k < NUM_SLAB_SIZES; ++k)
+            {
+                zslabcache_t *cache = &slabCaches[i][k];
+                Sys_Lock(cache->mutex);
+                slabCount += cache->slabCount;
+                hits      += cache->hits;
+                misses    += cache->misses;
+                Sys_Unlock(cache->mutex);
+            }
+        }
+
+        App_Log(DE2_LOG_DEBUG,
+                "Memory zone slabs: %u slabs in use, %u allocation hits, %u misses (%f%% hit rate)",
+                slabCount, hits, misses, hits + misses? (float)hits/(float)(hits + misses)*100.f : 0.f);
+    }
+#endif
 }
 
 void Garbage_Trash(void *ptr)
@@ -106,6 +106,14 @@ public:
     // Transmitter.
     void send(IByteArray const &data);
 
+    /**
+     * Sends a message that has already been encoded for sending, for instance
+     * because the same message is being sent over many links.
+     *
+     * @param message  Encoded message.
+     */
+    void send(Socket::EncodedMessage const &message);
+
 protected:
     virtual Packet *interpret(Message const &msg) = 0;
 
@@ -162,6 +162,11 @@ void AbstractLink::send(IByteArray const &data)
     d->socket->send(data);
 }
 
+void AbstractLink::send(Socket::EncodedMessage const &message)
+{
+    d->socket->send(message);
+}
+
 void AbstractLink::socketConnected()
 {
     LOG_AS("AbstractLink");
@@ -0,0 +1,223 @@
+/**
+ * @file main.cpp
+ *
+ * Angle clipper range backend tests. @ingroup tests
+ *
+ * Feeds the same sequences of clipped ranges to ClipRangeList and ClipRangeBitmap
+ * and checks that both give identical visibility results.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "render/clipranges.h"
+
+#include <de/Time>
+#include <QDebug>
+#include <QList>
+
+using namespace de;
+
+/**
+ * Recorded operation on the clip ranges, as done by AngleClipper during a frame.
+ */
+struct RangeOp
+{
+    enum Type { Add, CheckRange, CheckAngle, CheckFull };
+    Type type;
+    binangle_t from;
+    binangle_t to;
+};
+
+typedef QList<RangeOp> RangeSequence;
+
+/// Deterministic pseudorandom numbers (the sequences must be the same on every run).
+static duint32 nextRandom(duint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+ * Generates a frame's worth of operations: mostly short ranges, as produced by the
+ * walls of BSP leafs seen from the viewer, checked before they are added. Some of
+ * the ranges wrap around and some have zero length.
+ *
+ * @param seed        Random number state.
+ * @param rangeCount  Number of ranges.
+ * @param longRanges  Include occasional ranges of up to 180 degrees.
+ * @param maxLength   Maximum length of the short ranges. Shorter ranges are merged
+ *                    less, so more of them remain separate.
+ */
+static RangeSequence generateFrame(duint32 &seed, int rangeCount, bool longRanges, int maxLength)
+{
+    RangeSequence seq;
+    for (int i = 0; i < rangeCount; ++i)
+    {
+        duint32 const kind = nextRandom(seed) % 16;
+        binangle_t const from = binangle_t(nextRandom(seed));
+        binangle_t len;
+        if (kind == 0)      len = 0;
+        else if (kind == 1 && longRanges) len = binangle_t(nextRandom(seed) % BANG_180);
+        else                len = binangle_t(nextRandom(seed) % duint32(maxLength));
+        binangle_t const to = binangle_t(from + len);
+
+        seq << RangeOp{ RangeOp::CheckRange, from, to };
+        seq << RangeOp{ RangeOp::CheckRange, binangle_t(from - 3), binangle_t(to + 3) };
+        seq << RangeOp{ RangeOp::CheckAngle, from, from };
+        seq << RangeOp{ RangeOp::CheckAngle, binangle_t(from + len / 2), 0 };
+        if (nextRandom(seed) % 3)
+        {
+            seq << RangeOp{ RangeOp::Add, from, to };
+        }
+        seq << RangeOp{ RangeOp::CheckFull, 0, 0 };
+    }
+    return seq;
+}
+
+/**
+ * Ranges that touch, nearly touch, or sit at the ends of the circle.
+ */
+static RangeSequence edgeCases()
+{
+    RangeSequence seq;
+    auto add = [&seq] (binangle_t from, binangle_t to) {
+        seq << RangeOp{ RangeOp::Add, from, to };
+        for (int d = -2; d <= 2; ++d)
+        {
+            seq << RangeOp{ RangeOp::CheckRange, binangle_t(from + d), binangle_t(from + d) };
+            seq << RangeOp{ RangeOp::CheckRange, binangle_t(to + d),   binangle_t(to + d)   };
+            seq << RangeOp{ RangeOp::CheckRange, binangle_t(from + d), binangle_t(to - d)   };
+            seq << RangeOp{ RangeOp::CheckAngle, binangle_t(from + d), 0 };
+            seq << RangeOp{ RangeOp::CheckAngle, binangle_t(to + d),   0 };
+        }
+        seq << RangeOp{ RangeOp::CheckFull, 0, 0 };
+    };
+    add(100, 200);
+    add(201, 300);      // Adjacent, but not touching.
+    add(150, 250);      // Bridges the previous two.
+    add(300, 300);      // Zero-length at the end of a range.
+    add(400, 400);      // Isolated zero-length range.
+    add(399, 401);
+    add(BANG_MAX - 10, 5);  // Wraps around.
+    add(0, 0);
+    add(BANG_MAX, BANG_MAX);
+    add(64 * 3 - 1, 64 * 3);  // Straddles a bitmap word.
+    add(64 * 70, 64 * 140);   // Spans full bitmap words.
+    add(64 * 70 + 1, 64 * 139);
+    add(500, BANG_MAX - 20);
+    add(200, 600);
+    add(BANG_MAX - 25, BANG_MAX - 15);
+    add(BANG_MAX - 21, BANG_MAX - 9);  // Now everything is covered.
+    return seq;
+}
+
+/**
+ * Runs the operations and returns the results of the checks.
+ */
+static QList<bool> run(ClipRanges &ranges, RangeSequence const &seq)
+{
+    QList<bool> results;
+    ranges.clear();
+    for (RangeOp const &op : seq)
+    {
+        switch (op.type)
+        {
+        case RangeOp::Add:        ranges.safeAddRange(op.from, op.to); break;
+        case RangeOp::CheckRange: results << ranges.safeCheckRange(op.from, op.to); break;
+        case RangeOp::CheckAngle: results << ranges.isAngleVisible(op.from); break;
+        case RangeOp::CheckFull:  results << ranges.isFull(); break;
+        }
+    }
+    return results;
+}
+
+/**
+ * Returns the time spent on running all the sequences, in seconds.
+ */
+static ddouble benchmark(ClipRanges &ranges, QList<RangeSequence> const &frames)
+{
+    Time const startedAt;
+    duint visible = 0;
+    for (RangeSequence const &seq : frames)
+    {
+        ranges.clear();
+        for (RangeOp const &op : seq)
+        {
+            switch (op.type)
+            {
+            case RangeOp::Add:        ranges.safeAddRange(op.from, op.to); break;
+            case RangeOp::CheckRange: visible += ranges.safeCheckRange(op.from, op.to); break;
+            case RangeOp::CheckAngle: visible += ranges.isAngleVisible(op.from); break;
+            case RangeOp::CheckFull:  visible += ranges.isFull(); break;
+            }
+        }
+    }
+    DENG2_UNUSED(visible);
+    return startedAt.since();
+}
+
+int main(int, char **)
+{
+    int mismatches = 0;
+    try
+    {
+        ClipRangeList   list;
+        ClipRangeBitmap bitmap;
+
+        QList<RangeSequence> frames;
+        frames << edgeCases();
+        duint32 seed = 1;
+        for (int i = 0; i < 300; ++i)
+        {
+            frames << generateFrame(seed, 10 + i * 2, true, 1500);
+        }
+        for (int i = 0; i < 50; ++i)
+        {
+            // Many distant walls.
+            frames << generateFrame(seed, 1500, false, 120);
+        }
+
+        for (int i = 0; i < frames.size(); ++i)
+        {
+            QList<bool> const expected = run(list, frames.at(i));
+            QList<bool> const results  = run(bitmap, frames.at(i));
+            DENG2_ASSERT(expected.size() == results.size());
+            for (int k = 0; k < expected.size(); ++k)
+            {
+                if (expected.at(k) != results.at(k))
+                {
+                    qWarning() << "Sequence" << i << "check" << k << "differs: list says"
+                               << expected.at(k) << "bitmap says" << results.at(k);
+                    ++mismatches;
+                }
+            }
+        }
+        DENG2_ASSERT(!mismatches);
+        qDebug() << "Checked" << frames.size() << "sequences," << mismatches << "mismatches";
+
+        qDebug() << "List:  " << benchmark(list,   frames) * 1000 << "ms";
+        qDebug() << "Bitmap:" << benchmark(bitmap, frames) * 1000 << "ms";
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return mismatches? 1 : 0;
+}
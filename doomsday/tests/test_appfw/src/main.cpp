@@ -18,6 +18,7 @@
 
 #include "testapp.h"
 #include "mainwindow.h"
+#include "rulebenchmark.h"
 #include <de/EscapeParser>
 #include <QMessageBox>
 #include <QDebug>
@@ -30,6 +31,11 @@ int main(int argc, char **argv)
     try
     {
         app.initialize();
+        if (App::commandLine().has("--rulebench"))
+        {
+            benchmarkRules();
+            return 0;
+        }
         return app.execLoop();
     }
     catch (Error const &er)
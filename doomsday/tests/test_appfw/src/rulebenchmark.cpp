@@ -0,0 +1,113 @@
+/** @file rulebenchmark.cpp  Benchmark for evaluating layout rules.
+ *
+ * @authors Copyright (c) 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#include "rulebenchmark.h"
+
+#include <de/ConstantRule>
+#include <de/GridLayout>
+#include <de/GuiWidget>
+#include <de/OperatorRule>
+#include <de/SequentialLayout>
+#include <de/Time>
+
+using namespace de;
+
+static int const DIALOG_COUNT   = 40;
+static int const CELLS_PER_ROW  = 4;
+static int const CELL_COUNT     = 60; // per dialog
+static int const RESIZE_COUNT   = 100;
+
+/**
+ * Resizes the view @a RESIZE_COUNT times and reads the positions of all the
+ * @a cells after each resize, as happens when drawing a frame.
+ */
+static void resizeRepeatedly(ConstantRule &viewWidth, QList<GuiWidget *> const &cells,
+                             bool batched)
+{
+    Rule::updateInvalidRules();
+    Rule::resetStatistics();
+
+    float sum = 0;
+    Time const startedAt;
+    for (int i = 0; i < RESIZE_COUNT; ++i)
+    {
+        viewWidth.set(1024 + i);
+        if (batched)
+        {
+            Rule::updateInvalidRules();
+        }
+        for (GuiWidget const *cell : cells)
+        {
+            sum += cell->rule().rect().topLeft.x;
+        }
+    }
+    ddouble const elapsed = startedAt.since();
+
+    Rule::Statistics const &stats = Rule::statistics();
+    LOG_MSG("%s: %.1f ms per resize; per resize: %i invalidated, %i evaluated in order, "
+            "%i updated on demand; invalidation depth %i (checksum %f)")
+            << (batched? "Batched updates" : "Updates on demand")
+            << elapsed * 1000 / RESIZE_COUNT
+            << stats.invalidated / RESIZE_COUNT
+            << stats.evaluated / RESIZE_COUNT
+            << stats.updatedOnDemand / RESIZE_COUNT
+            << stats.invalidationDepth
+            << sum;
+}
+
+void benchmarkRules()
+{
+    ConstantRule *viewWidth = new ConstantRule(1024);
+    GuiWidget *container = new GuiWidget("rulebench");
+    QList<GuiWidget *> cells;
+    {
+        // The dialogs are stacked on top of each other, and each one lays out
+        // its cells in a grid whose columns depend on the width of the view.
+        SequentialLayout dialogs(Const(0), Const(0), ui::Down);
+        for (int i = 0; i < DIALOG_COUNT; ++i)
+        {
+            GuiWidget *dialog = new GuiWidget;
+            container->add(dialog);
+
+            GridLayout grid(dialog->rule().left(), dialog->rule().top());
+            grid.setGridSize(CELLS_PER_ROW, 0);
+            grid.setColumnPadding(Const(4));
+            grid.setRowPadding(Const(4));
+            grid.setOverrideWidth((*viewWidth - CELLS_PER_ROW * 4) / CELLS_PER_ROW);
+            for (int k = 0; k < CELL_COUNT; ++k)
+            {
+                GuiWidget *cell = new GuiWidget;
+                cell->rule().setInput(Rule::Height, Const(16 + k % 3 * 4));
+                dialog->add(cell);
+                grid << *cell;
+                cells << cell;
+            }
+            dialog->rule().setSize(grid.width(), grid.height());
+            dialogs << *dialog;
+        }
+    }
+
+    LOG_MSG("Rule benchmark: %i widgets in %i dialogs")
+            << cells.size() + DIALOG_COUNT << DIALOG_COUNT;
+
+    resizeRepeatedly(*viewWidth, cells, false);
+    resizeRepeatedly(*viewWidth, cells, true);
+
+    GuiWidget::destroy(container);
+    releaseRef(viewWidth);
+}
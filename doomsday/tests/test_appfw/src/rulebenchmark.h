@@ -0,0 +1,29 @@
+/** @file rulebenchmark.h  Benchmark for evaluating layout rules.
+ *
+ * @authors Copyright (c) 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, see:
+ * http://www.gnu.org/licenses</small>
+ */
+
+#ifndef APPFW_TEST_RULEBENCHMARK_H
+#define APPFW_TEST_RULEBENCHMARK_H
+
+/**
+ * Builds a large tree of widgets positioned with GridLayout and SequentialLayout,
+ * and measures how long it takes to resize it repeatedly, with the rules updated
+ * on demand and with Rule::updateInvalidRules(). The results are logged.
+ */
+void benchmarkRules();
+
+#endif // APPFW_TEST_RULEBENCHMARK_H
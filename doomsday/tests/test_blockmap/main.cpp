@@ -0,0 +1,201 @@
+/**
+ * @file main.cpp
+ *
+ * Blockmap tests. @ingroup tests
+ *
+ * Moves objects around in a blockmap the way map objects move during play, and
+ * checks that the cells always contain the right objects, also when objects are
+ * relinked while a cell is being iterated. Measures the time taken by moving the
+ * objects with and without remembering their positions in the cells.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "world/blockmap.h"
+
+#include <de/Time>
+#include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+using namespace de;
+using namespace world;
+
+struct TestObject
+{
+    Vector2d origin;
+    dint slot = -1;
+};
+
+/// Deterministic pseudorandom numbers (the moves must be the same on every run).
+static duint32 nextRandom(duint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static AABoxd const BOUNDS(0, 0, 8192, 8192);
+
+static Vector2d randomPoint(duint32 &seed)
+{
+    return Vector2d(nextRandom(seed) % 8192, nextRandom(seed) % 8192);
+}
+
+/**
+ * Moves the object a short distance, staying inside the blockmap.
+ */
+static void moveObject(TestObject &obj, duint32 &seed)
+{
+    Vector2d const step(dint(nextRandom(seed) % 65) - 32, dint(nextRandom(seed) % 65) - 32);
+    obj.origin = (obj.origin + step).max(Vector2d(0, 0)).min(Vector2d(8191, 8191));
+}
+
+/**
+ * Returns the number of cells whose contents differ from the objects' positions.
+ */
+static int checkCells(Blockmap const &bmap, QVector<TestObject> const &objects)
+{
+    QHash<dint, QSet<void const *>> expected;
+    for (TestObject const &obj : objects)
+    {
+        Blockmap::Cell const cell = bmap.toCell(obj.origin);
+        expected[bmap.toCellIndex(cell.x, cell.y)].insert(&obj);
+    }
+
+    int errors = 0;
+    Blockmap::Cell cell;
+    for (cell.y = 0; cell.y < bmap.height(); ++cell.y)
+    for (cell.x = 0; cell.x < bmap.width(); ++cell.x)
+    {
+        QSet<void const *> found;
+        bmap.forAllInCell(cell, [&found] (void *object)
+        {
+            found.insert(object);
+            return LoopContinue;
+        });
+        QSet<void const *> const wanted = expected.value(bmap.toCellIndex(cell.x, cell.y));
+        if (found != wanted || bmap.cellElementCount(cell) != wanted.size())
+        {
+            qWarning() << "Cell" << cell.asText() << "has" << found.size() << "objects instead of"
+                       << wanted.size();
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+/**
+ * Moves all the objects, unlinking each from its old cell and linking it in the new
+ * one. Returns the time spent, in seconds.
+ */
+static ddouble moveAll(Blockmap &bmap, QVector<TestObject> &objects, duint32 &seed,
+                       bool useSlots)
+{
+    Time const startedAt;
+    for (TestObject &obj : objects)
+    {
+        dint *slot = (useSlots? &obj.slot : nullptr);
+        bmap.unlink(bmap.toCell(obj.origin), &obj, slot);
+        moveObject(obj, seed);
+        bmap.link(bmap.toCell(obj.origin), &obj, slot);
+    }
+    return startedAt.since();
+}
+
+/**
+ * Moves objects while iterating the cells, as objects are moved by the callbacks
+ * of blockmap iterations during play.
+ */
+static void moveWhileIterating(Blockmap &bmap, QVector<TestObject> &objects, duint32 &seed)
+{
+    TestObject *begin = objects.data();
+    TestObject *end   = begin + objects.size();
+    Blockmap::Cell cell;
+    for (cell.y = 0; cell.y < bmap.height(); cell.y += 3)
+    for (cell.x = 0; cell.x < bmap.width(); cell.x += 3)
+    {
+        bmap.forAllInCell(cell, [&] (void *object)
+        {
+            auto *obj = static_cast<TestObject *>(object);
+            DENG2_ASSERT(obj >= begin && obj < end);
+            DENG2_UNUSED2(begin, end);
+            bmap.unlink(bmap.toCell(obj->origin), obj, &obj->slot);
+            moveObject(*obj, seed);
+            bmap.link(bmap.toCell(obj->origin), obj, &obj->slot);
+            return LoopContinue;
+        });
+    }
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    try
+    {
+        Blockmap bmap(BOUNDS, 128);
+        QVector<TestObject> objects(20000);
+        duint32 seed = 1;
+        for (TestObject &obj : objects)
+        {
+            obj.origin = randomPoint(seed);
+            bmap.link(bmap.toCell(obj.origin), &obj, &obj.slot);
+        }
+        errors += checkCells(bmap, objects);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            moveAll(bmap, objects, seed, true);
+            errors += checkCells(bmap, objects);
+            moveAll(bmap, objects, seed, false);
+            errors += checkCells(bmap, objects);
+            moveWhileIterating(bmap, objects, seed);
+            errors += checkCells(bmap, objects);
+        }
+
+        // Objects crowded into a few cells, e.g. a horde in a small room.
+        for (TestObject &obj : objects)
+        {
+            bmap.unlink(bmap.toCell(obj.origin), &obj, &obj.slot);
+            obj.origin = Vector2d(4000 + nextRandom(seed) % 400, 4000 + nextRandom(seed) % 400);
+            bmap.link(bmap.toCell(obj.origin), &obj, &obj.slot);
+        }
+        errors += checkCells(bmap, objects);
+
+        ddouble withSlots = 0, withoutSlots = 0;
+        for (int i = 0; i < 20; ++i)
+        {
+            withSlots    += moveAll(bmap, objects, seed, true);
+            withoutSlots += moveAll(bmap, objects, seed, false);
+        }
+        errors += checkCells(bmap, objects);
+
+        DENG2_ASSERT(!errors);
+        qDebug() << errors << "errors";
+        qDebug() << "Moving" << objects.size() << "crowded objects 20 times:";
+        qDebug() << "  with slots:   " << withSlots * 1000 << "ms";
+        qDebug() << "  searching cells:" << withoutSlots * 1000 << "ms";
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
@@ -0,0 +1,294 @@
+/**
+ * @file main.cpp
+ *
+ * Datagram channel tests. @ingroup tests
+ *
+ * Checks how the source addresses of datagrams are matched to the host of a
+ * TCP connection. Then starts a copy of itself as a client process, which opens
+ * the channel to this process over loopback and sends a sequence of messages,
+ * while both ends drop a share of their outgoing datagrams. The server side
+ * only accepts datagrams that carry the right token and come from the client's
+ * host, like ServerSystem does.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "network/datagramchannel.h"
+
+#include <de/Reader>
+#include <de/TextApp>
+#include <de/Writer>
+#include <QDebug>
+#include <QEventLoop>
+#include <QProcess>
+#include <QSet>
+#include <QTimer>
+
+using namespace de;
+
+static dbyte const MSG_HELLO = 1;
+static dbyte const MSG_DATA  = 2;
+
+static duint32 const TOKEN         = 0x5ca1ab1e;
+static int const LOSS_PERCENT      = 25;
+static int const HELLO_COUNT       = 40;
+static duint32 const MESSAGE_COUNT = 1000;
+
+/// Messages sent with a wrong token have sequence numbers starting from here.
+static duint32 const FORGED_SEQUENCE = 100000;
+
+static int testHostMatching()
+{
+    struct Case { char const *a; char const *b; bool same; };
+    Case const cases[] = {
+        { "127.0.0.1",        "127.0.0.1",        true  },
+        { "::ffff:127.0.0.1", "127.0.0.1",        true  }, // IPv4-mapped IPv6.
+        { "192.168.1.20",     "::ffff:c0a8:114",  true  },
+        { "192.168.1.20",     "192.168.1.21",     false },
+        { "::ffff:10.0.0.1",  "10.0.0.2",         false },
+        { "::1",              "::1",              true  },
+        { "::1",              "127.0.0.1",        false },
+        { "2001:db8::1",      "2001:db8::2",      false },
+    };
+
+    int errors = 0;
+    for (Case const &c : cases)
+    {
+        // The port of the TCP connection is different.
+        if (DatagramChannel::isSameHost(Address(c.a, 13209), Address(c.b, 44111)) != c.same)
+        {
+            qWarning() << c.a << "and" << c.b << "should" << (c.same? "" : "not")
+                       << "be the same host";
+            errors++;
+        }
+    }
+    if (DatagramChannel::isSameHost(Address(), Address()))
+    {
+        qWarning() << "Null addresses should not match";
+        errors++;
+    }
+    return errors;
+}
+
+static Block dataMessage(duint32 seq)
+{
+    Block message;
+    Writer(message) << MSG_DATA << seq;
+    // Every fifth message is large enough to be Huffman coded.
+    int const size = (seq % 5 == 0? 1200 : 40);
+    for (int i = 0; i < size; ++i)
+    {
+        message.append(char((seq + i / 16) & 0xff));
+    }
+    return message;
+}
+
+/**
+ * Client process: repeats the hello until the server echoes it, and then sends
+ * the messages. Also sends a few messages with the wrong token.
+ */
+static int runClient(duint16 serverPort)
+{
+    Address const server("127.0.0.1", serverPort);
+    DatagramChannel channel;
+    channel.open();
+
+    QEventLoop loop;
+    bool answered = false;
+    QObject::connect(&channel, &DatagramChannel::messageReceived,
+                     [&] (Address from, duint32 token, Block message)
+    {
+        if (!answered && token == TOKEN && DatagramChannel::isSameHost(from, server) &&
+            !message.isEmpty() && dbyte(message.at(0)) == MSG_HELLO)
+        {
+            answered = true;
+            loop.quit();
+        }
+    });
+
+    int hellosLeft = HELLO_COUNT;
+    QTimer helloTimer;
+    helloTimer.setInterval(50);
+    QObject::connect(&helloTimer, &QTimer::timeout, [&] ()
+    {
+        if (hellosLeft-- <= 0)
+        {
+            loop.quit();
+            return;
+        }
+        Block hello;
+        hello.append(char(MSG_HELLO));
+        channel.send(server, TOKEN, hello);
+    });
+    helloTimer.start();
+    loop.exec();
+    helloTimer.stop();
+
+    if (!answered)
+    {
+        qWarning() << "Client: the server did not answer" << HELLO_COUNT << "hellos";
+        return 1;
+    }
+
+    // A few messages at a time, so the receive buffer won't overflow.
+    duint32 seq = 0;
+    QTimer sendTimer;
+    sendTimer.setInterval(1);
+    QObject::connect(&sendTimer, &QTimer::timeout, [&] ()
+    {
+        for (int i = 0; i < 10 && seq < MESSAGE_COUNT; ++i, ++seq)
+        {
+            if (!channel.send(server, TOKEN, dataMessage(seq)))
+            {
+                qWarning() << "Client: message" << seq << "could not be sent";
+            }
+        }
+        if (seq == MESSAGE_COUNT)
+        {
+            for (duint32 i = 0; i < 10; ++i)
+            {
+                channel.send(server, TOKEN + 1, dataMessage(FORGED_SEQUENCE + i));
+            }
+            sendTimer.stop();
+            loop.quit();
+        }
+    });
+    sendTimer.start();
+    loop.exec();
+    return 0;
+}
+
+/**
+ * Server process: answers hellos from the client's host and receives the
+ * messages. Checks that the channel opened, no messages were damaged, and the
+ * number of messages received corresponds to the simulated loss.
+ */
+static int runServer()
+{
+    Address const clientHost("127.0.0.1");
+    DatagramChannel channel;
+    channel.open();
+
+    int errors = 0;
+    int hellos = 0;
+    int rejected = 0;
+    QSet<duint32> received;
+    QObject::connect(&channel, &DatagramChannel::messageReceived,
+                     [&] (Address from, duint32 token, Block message)
+    {
+        if (token != TOKEN || !DatagramChannel::isSameHost(from, clientHost) ||
+            message.isEmpty())
+        {
+            rejected++;
+            return;
+        }
+        if (dbyte(message.at(0)) == MSG_HELLO)
+        {
+            hellos++;
+            channel.send(from, token, message);
+            return;
+        }
+        dbyte type;
+        duint32 seq;
+        Reader(message) >> type >> seq;
+        if (seq >= MESSAGE_COUNT)
+        {
+            qWarning() << "Server: accepted a message with the wrong token";
+            errors++;
+        }
+        else if (message != dataMessage(seq))
+        {
+            qWarning() << "Server: message" << seq << "is damaged";
+            errors++;
+        }
+        else if (received.contains(seq))
+        {
+            qWarning() << "Server: message" << seq << "was received twice";
+            errors++;
+        }
+        received.insert(seq);
+    });
+
+    QProcess client;
+    client.setProcessChannelMode(QProcess::ForwardedChannels);
+    client.start(QCoreApplication::applicationFilePath(),
+                 QStringList() << "--client" << QString::number(channel.port()));
+
+    QEventLoop loop;
+    QObject::connect(&client, SIGNAL(finished(int)), &loop, SLOT(quit()));
+    QTimer::singleShot(30000, &loop, SLOT(quit()));
+    loop.exec();
+
+    // Datagrams still waiting to be read.
+    QTimer::singleShot(500, &loop, SLOT(quit()));
+    loop.exec();
+
+    if (client.state() != QProcess::NotRunning)
+    {
+        qWarning() << "Server: the client did not finish";
+        client.kill();
+        client.waitForFinished();
+        return errors + 1;
+    }
+    if (client.exitCode() != 0)
+    {
+        qWarning() << "Server: the client failed";
+        errors++;
+    }
+
+    // With the loss the count should be about 750 (the standard deviation is 14).
+    int const expected = int(MESSAGE_COUNT) * (100 - LOSS_PERCENT) / 100;
+    if (received.size() < expected - 100 || received.size() > expected + 100)
+    {
+        qWarning() << "Server: received" << received.size() << "messages, expected about"
+                   << expected;
+        errors++;
+    }
+    qDebug() << "Server:" << hellos << "hellos," << received.size() << "of" << MESSAGE_COUNT
+             << "messages received," << rejected << "rejected with" << LOSS_PERCENT
+             << "% loss";
+    return errors;
+}
+
+int main(int argc, char **argv)
+{
+    int errors = 0;
+    try
+    {
+        TextApp app(argc, argv);
+        netSimulatedDatagramLoss = LOSS_PERCENT;
+
+        if (argc == 3 && String(argv[1]) == "--client")
+        {
+            // The server process owns the runtime folder.
+            return runClient(duint16(String(argv[2]).toInt()));
+        }
+        app.initSubsystems(App::DisablePlugins);
+
+        errors += testHostMatching();
+        errors += runServer();
+        qDebug() << errors << "errors";
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
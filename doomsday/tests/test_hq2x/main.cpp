@@ -0,0 +1,180 @@
+/**
+ * @file main.cpp
+ *
+ * hq2x filter tests. @ingroup tests
+ *
+ * Filters pseudorandom images with the client's hq2x filter and with the
+ * previous implementation (reference.cpp), and checks that the outputs are
+ * identical pixel for pixel in all the wrap modes. Images of at least 64x64
+ * pixels are filtered in parallel bands. Measures the time taken by both
+ * implementations on a 1024x1024 image.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "resource/hq2xfilter.h"
+
+#include <de/Time>
+#include <QDebug>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace de;
+
+// reference.cpp
+void Reference_InitSmartFilterHQ2x();
+uint8_t *Reference_SmartFilterHQ2x(uint8_t const *src, int width, int height, bool wrapH, bool wrapV);
+
+typedef std::vector<uint8_t> Bytes;
+
+/// Deterministic pseudorandom numbers (the images must be the same on every run).
+static uint32_t nextRandom(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+ * Generates an image that resembles a game texture: areas of a few similar
+ * colors with sharp edges and fully transparent parts, plus some noise.
+ */
+static Bytes randomImage(int width, int height, uint32_t &seed)
+{
+    uint32_t palette[16];
+    for (uint32_t &color : palette)
+    {
+        color = nextRandom(seed) | 0xff000000;
+    }
+    palette[0] = 0; // Transparent.
+
+    Bytes image(size_t(width * height * 4));
+    int const blockSize = 1 + int(nextRandom(seed) % 8);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            uint32_t color = palette[((x / blockSize) * 7 + (y / blockSize) * 3 +
+                                      (x * y) / (blockSize * blockSize + 3)) % 16];
+            switch (nextRandom(seed) % 8)
+            {
+            case 0: // Slightly different shade.
+                color ^= nextRandom(seed) & 0x070707;
+                break;
+            case 1: // Any color and opacity.
+                color = nextRandom(seed) | (nextRandom(seed) << 24);
+                break;
+            default:
+                break;
+            }
+            uint8_t *pixel = &image[size_t((y * width + x) * 4)];
+            pixel[0] = uint8_t(color);
+            pixel[1] = uint8_t(color >> 8);
+            pixel[2] = uint8_t(color >> 16);
+            pixel[3] = uint8_t(color >> 24);
+        }
+    }
+    return image;
+}
+
+static Bytes filter(Bytes const &image, int width, int height, bool wrapH, bool wrapV)
+{
+    Bytes out(image.size() * 4);
+    std::vector<uint32_t> yuv(size_t(width * height));
+    HQ2x_Filter(&out[0], &image[0], &yuv[0], width, height, wrapH, wrapV);
+    return out;
+}
+
+static Bytes filterReference(Bytes const &image, int width, int height, bool wrapH, bool wrapV)
+{
+    uint8_t *out = Reference_SmartFilterHQ2x(&image[0], width, height, wrapH, wrapV);
+    Bytes result(out, out + image.size() * 4);
+    free(out);
+    return result;
+}
+
+static int compareToReference()
+{
+    int errors = 0;
+    uint32_t seed = 1;
+    for (int i = 0; i < 400; ++i)
+    {
+        // Mostly small images, like sprites and flats, and some larger ones
+        // that are filtered in parallel.
+        int const maxSize = (i % 10 == 0? 300 : 100);
+        int const width   = 1 + int(nextRandom(seed) % maxSize);
+        int const height  = 1 + int(nextRandom(seed) % maxSize);
+        Bytes const image = randomImage(width, height, seed);
+
+        for (int wrap = 0; wrap < 4; ++wrap)
+        {
+            bool const wrapH = (wrap & 1) != 0;
+            bool const wrapV = (wrap & 2) != 0;
+            if (filter(image, width, height, wrapH, wrapV) !=
+                filterReference(image, width, height, wrapH, wrapV))
+            {
+                qWarning() << "Output differs for image" << i << "of" << width << "x" << height
+                           << "pixels with wrapH" << wrapH << "wrapV" << wrapV;
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+static void benchmark()
+{
+    int const size = 1024;
+    uint32_t seed = 2;
+    Bytes const image = randomImage(size, size, seed);
+    int const repeat = 5;
+
+    Time startedAt;
+    for (int i = 0; i < repeat; ++i) filterReference(image, size, size, false, false);
+    double const reference = startedAt.since() * 1000 / repeat;
+
+    startedAt = Time();
+    for (int i = 0; i < repeat; ++i) filter(image, size, size, false, false);
+    double const current = startedAt.since() * 1000 / repeat;
+
+    qDebug() << "Filtering a" << size << "x" << size << "image:";
+    qDebug() << "  previous:" << reference << "ms";
+    qDebug() << "  current: " << current << "ms";
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    try
+    {
+        HQ2x_InitLookupTable();
+        Reference_InitSmartFilterHQ2x();
+
+        errors += compareToReference();
+        qDebug() << errors << "errors";
+
+        benchmark();
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file main.cpp
+ *
+ * Huffman codec tests. @ingroup tests
+ *
+ * Checks that random messages survive the round trip through the codec, that
+ * the encoding matches the one used by earlier versions (it is part of the
+ * network protocol), and measures the throughput with messages resembling game
+ * traffic.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/data/huffman.h>
+#include <de/Time>
+#include <QDebug>
+#include <QList>
+
+using namespace de;
+
+/// Deterministic pseudorandom numbers (the messages must be the same on every run).
+static duint32 nextRandom(duint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/**
+ * Generates a message. Game messages are dominated by zeros and small numbers
+ * (deltas, flags, short ids), so most of the bytes are drawn from those; the
+ * rest are uniformly random.
+ */
+static Block generateMessage(duint32 &seed, dsize size, bool uniform)
+{
+    Block msg(size);
+    for (dsize i = 0; i < size; ++i)
+    {
+        duint32 const r = nextRandom(seed);
+        if (uniform || r % 8 == 0)
+        {
+            msg.data()[i] = dbyte(r >> 4);
+        }
+        else
+        {
+            msg.data()[i] = (r % 8 < 4? 0 : dbyte((r >> 4) % 16));
+        }
+    }
+    return msg;
+}
+
+/**
+ * Returns the number of messages that did not come back the same from the codec.
+ */
+static int checkRoundTrips()
+{
+    int failures = 0;
+    duint32 seed = 1;
+    for (int i = 0; i < 20000; ++i)
+    {
+        dsize const size = (i % 100 == 0? nextRandom(seed) % 5000 : nextRandom(seed) % 130);
+        Block const msg = generateMessage(seed, size, i % 3 == 0);
+        if (codec::huffmanDecode(codec::huffmanEncode(msg)) != msg)
+        {
+            qWarning() << "Message" << i << "of" << size << "bytes differs after decoding";
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+/**
+ * Returns the number of messages whose encoding differs from the one of earlier
+ * versions of the codec.
+ */
+static int checkCompatibility()
+{
+    struct Sample { char const *message; dsize size; char const *encoded; dsize encodedSize; };
+    Sample const samples[] = {
+        { "", 0, "\x02", 1 },
+        { "Doomsday Engine", 15,
+          "\x2e\x42\x84\xc4\x72\xcd\x9f\x28\x98\x28\xce\x8d\xd2\xa0\xdd\xa8\x5c", 17 },
+        { "\x00\x00\x00\x12\x00\x44\x43\x80\x00\x00\x00\x00\x01\x02\x03\xff", 16,
+          "\xfc\xf1\xea\xfa\xcf\x67\x9d\x8f\x11", 9 },
+    };
+    int failures = 0;
+    for (Sample const &sample : samples)
+    {
+        Block const msg(sample.message, sample.size);
+        Block const encoded(sample.encoded, sample.encodedSize);
+        if (codec::huffmanEncode(msg) != encoded || codec::huffmanDecode(encoded) != msg)
+        {
+            qWarning() << "Encoding of" << msg.asHexadecimalText() << "has changed";
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+/**
+ * Decodes corrupted and random data. The results are meaningless, but decoding
+ * must not fail.
+ */
+static void decodeGarbage()
+{
+    duint32 seed = 2;
+    for (int i = 0; i < 20000; ++i)
+    {
+        Block data = codec::huffmanEncode(generateMessage(seed, nextRandom(seed) % 130, false));
+        data.data()[nextRandom(seed) % data.size()] ^= dbyte(1 << (nextRandom(seed) % 8));
+        codec::huffmanDecode(data);
+        codec::huffmanDecode(generateMessage(seed, nextRandom(seed) % 40, true));
+    }
+}
+
+static void benchmark()
+{
+    // Socket uses Huffman codes for messages shorter than 128 bytes.
+    QList<Block> messages;
+    QList<Block> encoded;
+    dsize totalSize = 0;
+    duint32 seed = 3;
+    for (int i = 0; i < 10000; ++i)
+    {
+        messages << generateMessage(seed, 8 + nextRandom(seed) % 120, false);
+        encoded  << codec::huffmanEncode(messages.last());
+        totalSize += messages.last().size();
+    }
+
+    int const rounds = 20;
+    dsize outputSize = 0;
+    Time startedAt;
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (Block const &msg : messages) outputSize += codec::huffmanEncode(msg).size();
+    }
+    ddouble const encodeTime = startedAt.since();
+
+    startedAt = Time();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (Block const &msg : encoded) outputSize += codec::huffmanDecode(msg).size();
+    }
+    ddouble const decodeTime = startedAt.since();
+    DENG2_UNUSED(outputSize);
+
+    ddouble const megabytes = ddouble(totalSize) * rounds / 1.0e6;
+    qDebug() << "Encoding:" << megabytes / encodeTime << "MB/s";
+    qDebug() << "Decoding:" << megabytes / decodeTime << "MB/s";
+}
+
+int main(int, char **)
+{
+    int failures = 0;
+    try
+    {
+        failures += checkCompatibility();
+        failures += checkRoundTrips();
+        decodeGarbage();
+        DENG2_ASSERT(!failures);
+        qDebug() << failures << "failures";
+
+        benchmark();
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return failures? 1 : 0;
+}
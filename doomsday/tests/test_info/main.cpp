@@ -18,6 +18,7 @@
  */
 
 #include <de/TextApp>
+#include <de/Info>
 #include <de/LogBuffer>
 #include <de/ScriptedInfo>
 #include <de/FS>
@@ -25,6 +26,39 @@
 
 using namespace de;
 
+/// Checks that two parsed Info blocks have the same contents.
+static bool isSameBlock(Info::BlockElement const &a, Info::BlockElement const &b)
+{
+    if (a.blockType() != b.blockType() ||
+        a.contentsInOrder().size() != b.contentsInOrder().size())
+    {
+        return false;
+    }
+    for (int i = 0; i < a.contentsInOrder().size(); ++i)
+    {
+        Info::Element const *x = a.contentsInOrder().at(i);
+        Info::Element const *y = b.contentsInOrder().at(i);
+        if (x->type() != y->type() || x->name() != y->name() ||
+            x->sourceLocation() != y->sourceLocation())
+        {
+            return false;
+        }
+        if (x->isBlock())
+        {
+            if (!isSameBlock(x->as<Info::BlockElement>(), y->as<Info::BlockElement>())) return false;
+            continue;
+        }
+        Info::Element::ValueList const xs = x->values();
+        Info::Element::ValueList const ys = y->values();
+        if (xs.size() != ys.size()) return false;
+        for (int k = 0; k < xs.size(); ++k)
+        {
+            if (xs[k].text != ys[k].text || xs[k].flags != ys[k].flags) return false;
+        }
+    }
+    return true;
+}
+
 int main(int argc, char **argv)
 {
     try
@@ -34,6 +68,17 @@ int main(int argc, char **argv)
 
         ScriptedInfo dei;
         dei.parse(app.fileSystem().find("test_info.dei"));
+
+        // Elements restored from the metadata cache must match the parsed ones.
+        File const &file = app.fileSystem().find("test_info.dei");
+        Info parsed(file);
+        Info cached(file);
+        if (!isSameBlock(parsed.root(), cached.root()))
+        {
+            qWarning() << "Info restored from the cache differs from the parsed one";
+            return 1;
+        }
+        Info::printParseStatistics();
     }
     catch (Error const &err)
     {
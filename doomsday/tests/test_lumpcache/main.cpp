@@ -0,0 +1,231 @@
+/**
+ * @file main.cpp
+ *
+ * Lump cache tests. @ingroup tests
+ *
+ * Checks that a lump stays in the cache until every holder has unlocked it, also
+ * when several threads lock and unlock the same lumps while the budget forces
+ * evictions. Measures the hit rate and the cost of cache accesses with a few
+ * different budgets.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "doomsday/filesys/lumpcache.h"
+
+#include <de/liblegacy.h>
+#include <de/memoryzone.h>
+#include <de/TaskPool>
+#include <de/Time>
+#include <QAtomicInt>
+#include <QDebug>
+#include <QMutex>
+#include <cstring>
+
+using namespace de;
+
+static uint const LUMP_COUNT = 256;
+
+/// Deterministic pseudorandom numbers (the accesses must be the same on every run).
+static duint32 nextRandom(duint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static size_t lumpSize(uint lumpIdx)
+{
+    return 1024 + (lumpIdx % 16) * 512;
+}
+
+/// Allocates a lump whose every byte identifies the lump.
+static uint8_t *makeLump(uint lumpIdx)
+{
+    size_t const size = lumpSize(lumpIdx);
+    auto *data = (uint8_t *) Z_Malloc(size, PU_APPSTATIC, 0);
+    std::memset(data, int(lumpIdx & 0xff), size);
+    return data;
+}
+
+static bool isIntact(uint8_t const *data, uint lumpIdx)
+{
+    for (size_t i = 0; i < lumpSize(lumpIdx); ++i)
+    {
+        if (data[i] != uint8_t(lumpIdx & 0xff)) return false;
+    }
+    return true;
+}
+
+/**
+ * Returns the data of a lump, inserting it on a miss. @a mutex serializes the
+ * insertions like the containers do in Wad::cacheLump() and Zip::cacheLump().
+ */
+static uint8_t const *cacheLump(LumpCache &cache, QMutex &mutex, uint lumpIdx)
+{
+    if (uint8_t const *data = cache.data(lumpIdx)) return data;
+
+    QMutexLocker locker(&mutex);
+    if (uint8_t const *data = cache.data(lumpIdx)) return data;
+    uint8_t *data = makeLump(lumpIdx);
+    cache.insert(lumpIdx, data, lumpSize(lumpIdx));
+    return data;
+}
+
+static int testLockCounting()
+{
+    int errors = 0;
+    LumpCache::setBudget(0); // Unlocked lumps are evicted immediately.
+
+    LumpCache cache(LUMP_COUNT);
+    cache.insert(0, makeLump(0), lumpSize(0)); // First holder.
+    uint8_t const *second = cache.data(0);     // Second holder.
+
+    cache.unlock(0); // The first holder is done.
+    if (!cache.data(0) || !isIntact(second, 0))
+    {
+        qWarning() << "Lump was released while still locked";
+        errors++;
+    }
+    cache.unlock(0); // data() above.
+    cache.unlock(0); // The second holder is done.
+    if (cache.data(0))
+    {
+        qWarning() << "Unlocked lump was not evicted";
+        errors++;
+        cache.unlock(0);
+    }
+    if (LumpCache::stats().lockedBytes)
+    {
+        qWarning() << "Locked bytes remain after unlocking";
+        errors++;
+    }
+
+    // Extra unlocks must not affect the data inserted later.
+    cache.unlock(1);
+    cache.insert(1, makeLump(1), lumpSize(1));
+    cache.unlock(1);
+    cache.unlock(1);
+    if (cache.data(1))
+    {
+        qWarning() << "Extra unlock changed the lock count";
+        errors++;
+    }
+    return errors;
+}
+
+static int testConcurrentHolders()
+{
+    LumpCache::setBudget(16 * 1024); // Much less than the total.
+
+    LumpCache cache(LUMP_COUNT);
+    QMutex insertMutex;
+    QAtomicInt damaged;
+
+    TaskPool::parallelFor(Rangei(0, 64), [&] (int thread)
+    {
+        duint32 seed = duint32(thread + 1);
+        for (int i = 0; i < 2000; ++i)
+        {
+            // A few lumps are shared by all threads, so one thread unlocking
+            // must not release the data others are still reading.
+            uint const lumpIdx = nextRandom(seed) % 8;
+            uint8_t const *data = cacheLump(cache, insertMutex, lumpIdx);
+            if (!isIntact(data, lumpIdx)) damaged.ref();
+            if (nextRandom(seed) % 4 == 0)
+            {
+                // Another, private lump while still holding the first one.
+                uint const otherIdx = 8 + nextRandom(seed) % (LUMP_COUNT - 8);
+                cacheLump(cache, insertMutex, otherIdx);
+                cache.unlock(otherIdx);
+            }
+            if (!isIntact(data, lumpIdx)) damaged.ref();
+            cache.unlock(lumpIdx);
+        }
+    }, 1);
+
+    if (damaged.load())
+    {
+        qWarning() << damaged.load() << "reads of released lump data";
+        return 1;
+    }
+    if (LumpCache::stats().lockedBytes)
+    {
+        qWarning() << "Locked bytes remain after all threads are done";
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Accesses lumps with a skewed distribution (a few lumps are used much more than
+ * the rest, like the lumps of the current map compared to other resources).
+ */
+static void benchmark(size_t budget)
+{
+    LumpCache::setBudget(budget);
+
+    LumpCache cache(LUMP_COUNT);
+    QMutex insertMutex;
+    LumpCache::Stats const before = LumpCache::stats();
+
+    int const count = 1000000;
+    duint32 seed = 1;
+    Time startedAt;
+    for (int i = 0; i < count; ++i)
+    {
+        duint32 const r = nextRandom(seed) % LUMP_COUNT;
+        uint const lumpIdx = r * r / LUMP_COUNT;
+        cacheLump(cache, insertMutex, lumpIdx);
+        cache.unlock(lumpIdx);
+    }
+    TimeDelta const elapsed = startedAt.since();
+
+    LumpCache::Stats const after = LumpCache::stats();
+    duint64 const hits = after.hits - before.hits;
+    duint64 const lookups = hits + after.misses - before.misses;
+    qDebug() << "Budget" << budget / 1024 << "KB:"
+             << elapsed * 1.0e9 / count << "ns per access,"
+             << "hit rate" << 100.0 * hits / lookups << "%,"
+             << after.evictions - before.evictions << "evictions";
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    Libdeng_Init();
+    try
+    {
+        errors += testLockCounting();
+        errors += testConcurrentHolders();
+
+        qDebug() << errors << "errors";
+
+        // All of the lumps take about 1 MB.
+        benchmark(64 * 1024);
+        benchmark(256 * 1024);
+        benchmark(1024 * 1024);
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+    Libdeng_Shutdown();
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file main.cpp
+ *
+ * Memory zone tests. @ingroup tests
+ *
+ * Checks that small blocks, which are allocated from slabs, are purged like any
+ * other block after they have been given a purgable tag: both by Z_FreeTags()
+ * and by the rover when Z_Malloc() needs space.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/liblegacy.h>
+#include <de/memoryzone.h>
+#include <QDebug>
+#include <cstring>
+
+static size_t const SMALL_SIZE = 48;    ///< Allocated from a slab.
+static size_t const LARGE_SIZE = 3 << 20;
+
+static void *allocSmall(void *user, int fill)
+{
+    void *ptr = Z_Malloc(SMALL_SIZE, PU_APPSTATIC, user);
+    std::memset(ptr, fill, SMALL_SIZE);
+    return ptr;
+}
+
+static bool isIntact(void const *ptr, int fill)
+{
+    if (!ptr) return false;
+    for (size_t i = 0; i < SMALL_SIZE; ++i)
+    {
+        if (static_cast<uint8_t const *>(ptr)[i] != uint8_t(fill)) return false;
+    }
+    return true;
+}
+
+static int testFreeTags()
+{
+    int errors = 0;
+    void *purgable = nullptr;
+    void *kept = nullptr;
+    allocSmall(&purgable, 1);
+    allocSmall(&kept, 2);
+
+    Z_ChangeTag2(purgable, PU_PURGELEVEL);
+    Z_FreeTags(PU_PURGELEVEL, PU_PURGELEVEL);
+
+    if (purgable)
+    {
+        qWarning() << "Z_FreeTags did not free a small block with a purgable tag";
+        errors++;
+    }
+    if (!isIntact(kept, 2))
+    {
+        qWarning() << "Z_FreeTags damaged a static small block";
+        errors++;
+    }
+    Z_Free(kept);
+    return errors;
+}
+
+static int testRoverPurge()
+{
+    int errors = 0;
+    void *purgable = nullptr;
+    void *kept = nullptr;
+    void *restored = nullptr;
+    allocSmall(&purgable, 3);
+    allocSmall(&kept, 4);
+    allocSmall(&restored, 5);
+
+    Z_ChangeTag2(purgable, PU_PURGELEVEL);
+    Z_ChangeTag2(restored, PU_PURGELEVEL);
+    Z_ChangeTag2(restored, PU_APPSTATIC);
+
+    // Large purgable blocks are allocated with the rover. Once the volume is
+    // full, the rover goes around purging blocks to make room.
+    void *large[64] = {};
+    int count = 0;
+    for (; count < 64 && purgable; ++count)
+    {
+        Z_Malloc(LARGE_SIZE, PU_PURGELEVEL, &large[count]);
+    }
+    qDebug() << "Rover purged the small block after" << count << "large allocations";
+
+    if (purgable)
+    {
+        qWarning() << "Rover did not purge a small block with a purgable tag";
+        errors++;
+    }
+    if (!isIntact(kept, 4) || !isIntact(restored, 5))
+    {
+        qWarning() << "Rover purged or damaged a static small block";
+        errors++;
+    }
+
+    // The purged element can be reused.
+    void *reused = nullptr;
+    allocSmall(&reused, 6);
+    if (!isIntact(reused, 6) || !isIntact(kept, 4))
+    {
+        qWarning() << "Small block allocated after the purge overlaps another one";
+        errors++;
+    }
+
+    Z_CheckHeap();
+    Z_Free(reused);
+    Z_Free(kept);
+    Z_Free(restored);
+    Z_FreeTags(PU_PURGELEVEL, PU_PURGELEVEL);
+    for (int i = 0; i < count; ++i)
+    {
+        if (large[i])
+        {
+            qWarning() << "Z_FreeTags did not free a large purgable block";
+            errors++;
+            break;
+        }
+    }
+    return errors;
+}
+
+/**
+ * A slab whose only element is purged is returned to the zone, and the space
+ * can be used for other blocks.
+ */
+static int testEmptySlabPurge()
+{
+    int errors = 0;
+    void *purgable = nullptr;
+    Z_Malloc(200, PU_MAP, &purgable); // The only block of its size class.
+    Z_ChangeTag2(purgable, PU_PURGELEVEL);
+
+    void *large[64] = {};
+    int count = 0;
+    for (; count < 64 && purgable; ++count)
+    {
+        Z_Malloc(LARGE_SIZE, PU_PURGELEVEL, &large[count]);
+    }
+    if (purgable)
+    {
+        qWarning() << "Rover did not purge the only element of a slab";
+        errors++;
+    }
+
+    Z_CheckHeap();
+    Z_FreeTags(PU_PURGELEVEL, PU_PURGELEVEL);
+
+    // Allocating from a new slab of the same size class.
+    void *again = Z_Malloc(200, PU_MAP, nullptr);
+    std::memset(again, 7, 200);
+    Z_Free(again);
+    Z_CheckHeap();
+    return errors;
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    Libdeng_Init();
+
+    errors += testFreeTags();
+    errors += testRoverPurge();
+    errors += testEmptySlabPurge();
+    qDebug() << errors << "errors";
+
+    Libdeng_Shutdown();
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
@@ -0,0 +1,528 @@
+/**
+ * @file main.cpp
+ *
+ * Server register mobj table tests. @ingroup tests
+ *
+ * The mobj table of the server's world register (sv_pool.cpp) depends on the
+ * whole world, so the table is copied here as is, with a mobj of about the same
+ * size. The previous table, a hash of 1024 linked lists with one allocation per
+ * mobj, is included for comparison.
+ *
+ * Runs the same sequence of operations on both tables and checks that the same
+ * mobjs are found. Then measures the operations the server does on the table:
+ * registering the mobjs of a map, comparing the mobjs with the register on each
+ * delta generation cycle (find by ID), iterating the register for removed mobjs,
+ * and removing the mobjs.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/liblegacy.h>
+#include <de/memoryzone.h>
+#include <de/Time>
+#include <QDebug>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace de;
+
+/// Stands in for mobj_t, which is a few hundred bytes.
+struct dt_mobj_t
+{
+    struct { thid_t id; } thinker;
+    char state[380];
+};
+
+/// Deterministic pseudorandom numbers (the runs must be the same every time).
+static uint32_t nextRandom(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/*
+ * The current table: mobjs in an array, found with an open-addressed index.
+ */
+namespace current {
+
+#define REG_MOBJ_MIN_SLOTS          ( 256 )
+
+struct reg_mobj_t
+{
+    dt_mobj_t mo;
+};
+
+struct reg_mobjslot_t
+{
+    thid_t id;
+    uint32_t index;
+};
+
+struct mobjregister_t
+{
+    reg_mobj_t *mobjs;
+    int count;
+    int allocated;
+
+    reg_mobjslot_t *slots;
+    uint32_t slotMask;
+    int slotShift;
+};
+
+static uint32_t hashFunction(thid_t id, int shift)
+{
+    return (uint32_t(id) * 2654435769u) >> shift;
+}
+
+static reg_mobjslot_t *mobjSlot(mobjregister_t const &reg, thid_t id)
+{
+    for (uint32_t i = hashFunction(id, reg.slotShift); ; i = (i + 1) & reg.slotMask)
+    {
+        reg_mobjslot_t *slot = &reg.slots[i];
+        if (!slot->index || slot->id == id) return slot;
+    }
+}
+
+static void rehashMobjs(mobjregister_t &reg, uint32_t numSlots)
+{
+    Z_Free(reg.slots);
+    reg.slots    = (reg_mobjslot_t *) Z_Calloc(sizeof(*reg.slots) * numSlots, PU_MAP, 0);
+    reg.slotMask = numSlots - 1;
+    reg.slotShift = 32;
+    for (uint32_t n = numSlots; n > 1; n >>= 1) reg.slotShift--;
+
+    for (int i = 0; i < reg.count; ++i)
+    {
+        reg_mobjslot_t *slot = mobjSlot(reg, reg.mobjs[i].mo.thinker.id);
+        slot->id    = reg.mobjs[i].mo.thinker.id;
+        slot->index = uint32_t(i) + 1;
+    }
+}
+
+static reg_mobj_t *findMobj(mobjregister_t const &mobjs, thid_t id)
+{
+    if (!mobjs.count) return nullptr;
+
+    reg_mobjslot_t const *slot = mobjSlot(mobjs, id);
+    if (slot->index)
+    {
+        return &mobjs.mobjs[slot->index - 1];
+    }
+    return nullptr;
+}
+
+static reg_mobj_t *addMobj(mobjregister_t &mobjs, thid_t id)
+{
+    if (reg_mobj_t *existing = findMobj(mobjs, id))
+        return existing;
+
+    if (!mobjs.slots)
+    {
+        rehashMobjs(mobjs, REG_MOBJ_MIN_SLOTS);
+    }
+    else if (uint32_t(mobjs.count + 1) * 2 > mobjs.slotMask + 1)
+    {
+        rehashMobjs(mobjs, (mobjs.slotMask + 1) * 2);
+    }
+
+    if (mobjs.count == mobjs.allocated)
+    {
+        mobjs.allocated = std::max(2 * mobjs.allocated, REG_MOBJ_MIN_SLOTS / 2);
+        mobjs.mobjs = (reg_mobj_t *) Z_Realloc(mobjs.mobjs, sizeof(*mobjs.mobjs) * mobjs.allocated, PU_MAP);
+    }
+
+    reg_mobj_t *newRegMo = &mobjs.mobjs[mobjs.count++];
+    std::memset(newRegMo, 0, sizeof(*newRegMo));
+    newRegMo->mo.thinker.id = id;
+
+    reg_mobjslot_t *slot = mobjSlot(mobjs, id);
+    slot->id    = id;
+    slot->index = uint32_t(mobjs.count);
+
+    return newRegMo;
+}
+
+static void removeMobj(mobjregister_t &mobjs, reg_mobj_t *regMo)
+{
+    reg_mobjslot_t *slot = mobjSlot(mobjs, regMo->mo.thinker.id);
+    int const index = int(slot->index) - 1;
+
+    uint32_t hole = uint32_t(slot - mobjs.slots);
+    for (uint32_t i = (hole + 1) & mobjs.slotMask; mobjs.slots[i].index; i = (i + 1) & mobjs.slotMask)
+    {
+        uint32_t const home = hashFunction(mobjs.slots[i].id, mobjs.slotShift);
+        if (((i - home) & mobjs.slotMask) >= ((i - hole) & mobjs.slotMask))
+        {
+            mobjs.slots[hole] = mobjs.slots[i];
+            hole = i;
+        }
+    }
+    mobjs.slots[hole].index = 0;
+
+    if (index != mobjs.count - 1)
+    {
+        std::memcpy(&mobjs.mobjs[index], &mobjs.mobjs[mobjs.count - 1], sizeof(reg_mobj_t));
+        mobjSlot(mobjs, mobjs.mobjs[index].mo.thinker.id)->index = uint32_t(index) + 1;
+    }
+    mobjs.count--;
+}
+
+struct Register
+{
+    mobjregister_t mobjs {};
+
+    ~Register()
+    {
+        Z_Free(mobjs.mobjs);
+        Z_Free(mobjs.slots);
+    }
+    dt_mobj_t *find(thid_t id)
+    {
+        reg_mobj_t *regMo = findMobj(mobjs, id);
+        return regMo? &regMo->mo : nullptr;
+    }
+    dt_mobj_t *add(thid_t id)
+    {
+        return &addMobj(mobjs, id)->mo;
+    }
+    void remove(thid_t id)
+    {
+        removeMobj(mobjs, findMobj(mobjs, id));
+    }
+    template <typename Func>
+    void forAll(Func func)
+    {
+        // Removing the current mobj moves the last one in its place.
+        for (int i = 0; i < mobjs.count; )
+        {
+            if (!func(mobjs.mobjs[i].mo)) ++i;
+        }
+    }
+};
+
+} // namespace current
+
+/*
+ * The previous table: a hash of linked lists.
+ */
+namespace previous {
+
+#define REG_MOBJ_HASH_SIZE          ( 1024 )
+#define REG_MOBJ_HASH_FUNCTION_MASK ( 0x3ff )
+
+struct reg_mobj_t
+{
+    reg_mobj_t *next;
+    reg_mobj_t *prev;
+    dt_mobj_t mo;
+};
+
+struct mobjhash_t
+{
+    reg_mobj_t *first, *last;
+};
+
+static uint32_t hashFunction(thid_t id)
+{
+    return uint32_t(id) & REG_MOBJ_HASH_FUNCTION_MASK;
+}
+
+static reg_mobj_t *findMobj(mobjhash_t const *mobjs, thid_t id)
+{
+    mobjhash_t const &hash = mobjs[hashFunction(id)];
+    for (reg_mobj_t *it = hash.first; it; it = it->next)
+    {
+        if (it->mo.thinker.id == id) return it;
+    }
+    return nullptr;
+}
+
+static reg_mobj_t *addMobj(mobjhash_t *mobjs, thid_t id)
+{
+    mobjhash_t &hash = mobjs[hashFunction(id)];
+
+    if (reg_mobj_t *newRegMo = findMobj(mobjs, id))
+        return newRegMo;
+
+    auto *newRegMo = (reg_mobj_t *) Z_Calloc(sizeof(reg_mobj_t), PU_MAP, 0);
+
+    if (hash.last)
+    {
+        hash.last->next = newRegMo;
+        newRegMo->prev = hash.last;
+    }
+    hash.last = newRegMo;
+
+    if (!hash.first)
+    {
+        hash.first = newRegMo;
+    }
+
+    // The server stores the whole mobj (with the ID) right after adding.
+    newRegMo->mo.thinker.id = id;
+    return newRegMo;
+}
+
+static void removeMobj(mobjhash_t *mobjs, reg_mobj_t *regMo)
+{
+    mobjhash_t &hash = mobjs[hashFunction(regMo->mo.thinker.id)];
+
+    if (hash.last == regMo)
+    {
+        hash.last = regMo->prev;
+    }
+    if (hash.first == regMo)
+    {
+        hash.first = regMo->next;
+    }
+    if (regMo->next)
+    {
+        regMo->next->prev = regMo->prev;
+    }
+    if (regMo->prev)
+    {
+        regMo->prev->next = regMo->next;
+    }
+    Z_Free(regMo);
+}
+
+struct Register
+{
+    mobjhash_t mobjs[REG_MOBJ_HASH_SIZE] {};
+
+    ~Register()
+    {
+        for (mobjhash_t &hash : mobjs)
+        {
+            while (hash.first) removeMobj(mobjs, hash.first);
+        }
+    }
+    dt_mobj_t *find(thid_t id)
+    {
+        reg_mobj_t *regMo = findMobj(mobjs, id);
+        return regMo? &regMo->mo : nullptr;
+    }
+    dt_mobj_t *add(thid_t id)
+    {
+        return &addMobj(mobjs, id)->mo;
+    }
+    void remove(thid_t id)
+    {
+        removeMobj(mobjs, findMobj(mobjs, id));
+    }
+    template <typename Func>
+    void forAll(Func func)
+    {
+        for (mobjhash_t &hash : mobjs)
+        {
+            reg_mobj_t *next;
+            for (reg_mobj_t *obj = hash.first; obj; obj = next)
+            {
+                next = obj->next;
+                func(obj->mo);
+            }
+        }
+    }
+};
+
+} // namespace previous
+
+/**
+ * Thinker IDs of a map: mostly consecutive, with the IDs of destroyed thinkers
+ * reused in random order.
+ */
+struct MapIds
+{
+    std::vector<thid_t> live;
+    std::vector<thid_t> freed;
+    thid_t next = 1;
+    uint32_t seed;
+
+    MapIds(uint32_t seed) : seed(seed) {}
+
+    thid_t spawn()
+    {
+        thid_t id;
+        if (!freed.empty() && (next == 0xffff || nextRandom(seed) % 2))
+        {
+            id = freed.back();
+            freed.pop_back();
+        }
+        else
+        {
+            id = next++;
+        }
+        live.push_back(id);
+        return id;
+    }
+    thid_t destroy()
+    {
+        size_t const pos = nextRandom(seed) % live.size();
+        thid_t const id = live[pos];
+        live[pos] = live.back();
+        live.pop_back();
+        freed.push_back(id);
+        return id;
+    }
+};
+
+static int testSameResults()
+{
+    current::Register cur;
+    previous::Register prev;
+    MapIds ids(11);
+
+    int errors = 0;
+    for (int round = 0; round < 20000 && !errors; ++round)
+    {
+        if (ids.live.size() < 500 || nextRandom(ids.seed) % 3)
+        {
+            thid_t const id = ids.spawn();
+            cur.add(id)->state[0]  = char(round);
+            prev.add(id)->state[0] = char(round);
+        }
+        else
+        {
+            thid_t const id = ids.destroy();
+            cur.remove(id);
+            prev.remove(id);
+        }
+        if (round % 1000) continue;
+
+        // Check every live and freed ID.
+        for (thid_t id = 1; id < ids.next; ++id)
+        {
+            dt_mobj_t const *a = cur.find(id);
+            dt_mobj_t const *b = prev.find(id);
+            if (!a != !b || (a && (a->thinker.id != id || a->state[0] != b->state[0])))
+            {
+                qWarning() << "Tables disagree about mobj" << id << "after" << round << "operations";
+                errors++;
+                break;
+            }
+        }
+    }
+
+    int count = 0;
+    cur.forAll([&count] (dt_mobj_t &) { count++; return false; });
+    if (count != int(ids.live.size()))
+    {
+        qWarning() << "The current table has" << count << "mobjs, expected" << ids.live.size();
+        errors++;
+    }
+    return errors;
+}
+
+/**
+ * Runs a map with @a mobjCount mobjs through the register for a number of delta
+ * generation cycles, and returns the times taken in milliseconds.
+ */
+template <typename RegisterType>
+static void benchmark(char const *name, int mobjCount)
+{
+    int const tics  = 200;
+    int const churn = std::max(1, mobjCount / 100); // Spawned and destroyed per tic.
+    double registerTime = 0, compareTime = 0, iterateTime = 0, removeTime = 0;
+    long found = 0;
+    {
+        RegisterType reg;
+        MapIds ids(5);
+
+        // Sv_RegisterWorld(), when the map is loaded.
+        Time startedAt;
+        for (int i = 0; i < mobjCount; ++i)
+        {
+            reg.add(ids.spawn())->state[0] = 1;
+        }
+        registerTime = startedAt.since() * 1000;
+
+        for (int tic = 0; tic < tics; ++tic)
+        {
+            // Some mobjs are spawned and some are destroyed. IDs are reused
+            // only after the register has been updated.
+            for (int i = 0; i < churn; ++i) ids.spawn();
+            std::vector<thid_t> destroyed;
+            for (int i = 0; i < churn; ++i) destroyed.push_back(ids.destroy());
+
+            // Sv_RegisterCompareMobj(): the world's mobjs are looked up in the
+            // register, and new ones are added.
+            startedAt = Time();
+            for (thid_t id : ids.live)
+            {
+                if (dt_mobj_t *mo = reg.find(id))
+                {
+                    mo->state[1]++;
+                    found++;
+                }
+                else
+                {
+                    reg.add(id)->state[0] = 1;
+                }
+            }
+            compareTime += startedAt.since() * 1000;
+
+            // Sv_NewNullDeltas(): the register is checked for mobjs that no
+            // longer exist, and they are removed.
+            std::sort(destroyed.begin(), destroyed.end());
+            startedAt = Time();
+            reg.forAll([&reg, &destroyed] (dt_mobj_t &mo)
+            {
+                if (!std::binary_search(destroyed.begin(), destroyed.end(), mo.thinker.id))
+                {
+                    return false;
+                }
+                reg.remove(mo.thinker.id);
+                return true;
+            });
+            iterateTime += startedAt.since() * 1000;
+        }
+
+        // All the mobjs removed one by one.
+        startedAt = Time();
+        for (thid_t id : ids.live)
+        {
+            reg.remove(id);
+        }
+        removeTime = startedAt.since() * 1000;
+    }
+    qDebug() << "  " << name << ": register" << registerTime << "ms, compare"
+             << compareTime / tics << "ms/tic, iterate and remove" << iterateTime / tics
+             << "ms/tic, remove all" << removeTime << "ms (found" << found << ")";
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    Libdeng_Init();
+
+    errors += testSameResults();
+    qDebug() << errors << "errors";
+
+    for (int mobjCount : { 1000, 10000, 30000 })
+    {
+        qDebug() << "Register with" << mobjCount << "mobjs:";
+        benchmark<previous::Register>("previous hash", mobjCount);
+        benchmark<current::Register>("current table", mobjCount);
+    }
+
+    Libdeng_Shutdown();
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
@@ -22,10 +22,51 @@
 #include <de/Script>
 #include <de/FS>
 #include <de/Process>
+#include <de/Time>
+#include <de/math.h>
 #include <QDebug>
 
 using namespace de;
 
+/**
+ * Runs an arithmetic-heavy loop with and without compiled bytecode, and checks
+ * that both give the same result.
+ */
+static void benchmarkBytecode()
+{
+    String const source =
+            "a = 3; b = 4.5; i = 0; total = 0\n"
+            "while i < 50000\n"
+            "    total = total + (a * b - i % 7) / 2 + (i > 10 and a < b) - (2 * 3 + 1)\n"
+            "    if not (i % 1000 == 0 or total < 0): total = total - 1\n"
+            "    i = i + 1\n"
+            "end\n"
+            "total\n";
+
+    Value::Number results[2];
+    for (int compiled = 0; compiled < 2; ++compiled)
+    {
+        Evaluator::setBytecodeEnabled(compiled != 0);
+
+        Script script(source);
+        Process proc(script);
+        Time startedAt;
+        proc.execute();
+        TimeDelta const elapsed = startedAt.since();
+
+        results[compiled] = proc.context().evaluator().result().asNumber();
+        LOG_MSG("%s: result %f in %.3f seconds")
+                << (compiled? "Bytecode" : "Expression tree")
+                << results[compiled] << elapsed;
+    }
+    Evaluator::setBytecodeEnabled(true);
+
+    if (!fequal(results[0], results[1]))
+    {
+        throw Error("benchmarkBytecode", "Bytecode gives a different result");
+    }
+}
+
 int main(int argc, char **argv)
 {
     try
@@ -49,6 +90,8 @@ int main(int argc, char **argv)
 
         LOG_MSG("------------------------------------------------------------------------------");
         LOG_MSG("Final result value is: ") << proc.context().evaluator().result().asText();
+
+        benchmarkBytecode();
     }
     catch (Error const &err)
     {
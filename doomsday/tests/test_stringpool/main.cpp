@@ -24,7 +24,10 @@
 #include <de/StringPool>
 #include <de/Reader>
 #include <de/Writer>
+#include <de/Time>
+#include <de/math.h>
 #include <QDebug>
+#include <QList>
 
 using namespace de;
 
@@ -103,6 +106,47 @@ int main(int, char **)
 
         p.clear();
         DENG2_ASSERT(p.empty());
+
+        // Throughput.
+        {
+            int const count = 100000;
+            QList<String> names, upperNames;
+            for (int i = 0; i < count; ++i)
+            {
+                names      << String("Textures:Flats/Flat_%1/Variant").arg(i);
+                upperNames << names.last().toUpper();
+            }
+
+            StringPool big;
+            Time startedAt;
+            for (String const &name : names) big.intern(name);
+            TimeDelta const internTime = startedAt.since();
+            DENG2_ASSERT(big.size() == dsize(count));
+
+            startedAt = Time();
+            duint64 idSum = 0;
+            for (String const &name : upperNames) idSum += big.isInterned(name);
+            TimeDelta const lookupTime = startedAt.since();
+            DENG2_ASSERT(idSum == duint64(count) * (count + 1) / 2);
+            DENG2_UNUSED(idSum);
+
+            startedAt = Time();
+            for (int i = 0; i < count; i += 2) big.remove(names.at(i));
+            TimeDelta const removeTime = startedAt.since();
+            DENG2_ASSERT(big.size() == dsize(count / 2));
+            DENG2_ASSERT(!big.isInterned(upperNames.at(0)));
+            DENG2_ASSERT(big.isInterned(upperNames.at(1)) == 2);
+
+            auto perSecond = [] (int n, TimeDelta const &elapsed) {
+                return int(n / de::max(ddouble(elapsed), 1.0e-6));
+            };
+            qDebug() << "Interned" << count << "strings:"
+                     << perSecond(count, internTime) << "per second";
+            qDebug() << "Looked up" << count << "strings:"
+                     << perSecond(count, lookupTime) << "per second";
+            qDebug() << "Removed" << count / 2 << "strings:"
+                     << perSecond(count / 2, removeTime) << "per second";
+        }
     }
     catch (Error const &err)
     {
@@ -0,0 +1,204 @@
+/*
+ * The Doomsday Engine Project
+ *
+ * Copyright (c) 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <de/TextApp>
+#include <de/Task>
+#include <de/TaskPool>
+#include <de/Time>
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QThread>
+#include <QVector>
+#include <cmath>
+#include <stdexcept>
+
+using namespace de;
+
+/**
+ * Task that starts a tree of child tasks.
+ */
+class TreeTask : public Task
+{
+public:
+    TreeTask(TaskPool &pool, QAtomicInt &counter, int depth)
+        : _pool(pool), _counter(counter), _depth(depth)
+    {}
+
+    void runTask() override
+    {
+        _counter.ref();
+        if (_depth > 0)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                _pool.start(new TreeTask(_pool, _counter, _depth - 1), *this);
+            }
+        }
+    }
+
+private:
+    TaskPool &_pool;
+    QAtomicInt &_counter;
+    int _depth;
+};
+
+static void check(bool condition, char const *what)
+{
+    if (!condition) throw Error("test_taskpool", what);
+}
+
+static void stressTest()
+{
+    // Many small independent tasks.
+    {
+        QAtomicInt counter;
+        TaskPool pool;
+        for (int i = 0; i < 100000; ++i)
+        {
+            pool.start([&counter] () { counter.ref(); },
+                       TaskPool::Priority(i % 3));
+        }
+        pool.waitForDone();
+        check(counter.load() == 100000, "Not all tasks were run");
+    }
+
+    // Tasks with children: the parents finish only after their children.
+    {
+        QAtomicInt counter;
+        TaskPool pool;
+        for (int i = 0; i < 8; ++i)
+        {
+            pool.start(new TreeTask(pool, counter, 5));
+        }
+        pool.waitForDone();
+        // Each tree has 1 + 4 + 16 + ... + 4^5 tasks.
+        check(counter.load() == 8 * 1365, "Child tasks were not waited for");
+    }
+
+    // Waiting for a pool inside a running task.
+    {
+        QAtomicInt finished;
+        TaskPool pool;
+        pool.start([&finished] ()
+        {
+            // Start a nested pool inside a task; waiting helps run the tasks.
+            TaskPool inner;
+            for (int i = 0; i < 100; ++i)
+            {
+                inner.start([&finished] ()
+                {
+                    QThread::usleep(100);
+                    finished.ref();
+                });
+            }
+            inner.waitForDone();
+        });
+        pool.waitForDone();
+        check(finished.load() == 100, "Nested pool was not waited for");
+    }
+
+    // Nested parallel loops.
+    {
+        QVector<int> values(1000);
+        TaskPool::parallelFor(Rangei(0, 100), [&values] (int i)
+        {
+            TaskPool::parallelFor(Rangei(i * 10, i * 10 + 10), [&values] (int k)
+            {
+                values[k] = k * 2;
+            }, 1);
+        });
+        for (int i = 0; i < values.size(); ++i)
+        {
+            check(values.at(i) == i * 2, "parallelFor skipped an index");
+        }
+    }
+
+    // Exceptions thrown in a parallel loop end up in the calling thread.
+    {
+        bool caught = false;
+        try
+        {
+            TaskPool::parallelFor(Rangei(0, 1000), [] (int i)
+            {
+                if (i == 500) throw std::runtime_error("loop body failed");
+            }, 10);
+        }
+        catch (std::runtime_error const &)
+        {
+            caught = true;
+        }
+        check(caught, "parallelFor did not rethrow the exception");
+    }
+}
+
+static void benchmark()
+{
+    // Latency of starting a task and waiting for it.
+    {
+        int const count = 10000;
+        Time startedAt;
+        for (int i = 0; i < count; ++i)
+        {
+            TaskPool pool;
+            pool.start([] () {});
+            pool.waitForDone();
+        }
+        TimeDelta const elapsed = startedAt.since();
+        LOG_MSG("Start/wait round trip: %.2f us") << elapsed * 1.0e6 / count;
+    }
+
+    // Throughput of a parallel loop compared to a serial one.
+    {
+        int const count = 4000000;
+        QVector<double> values(count);
+        auto kernel = [&values] (int i) { values[i] = std::sqrt(double(i)) * 0.5; };
+
+        Time startedAt;
+        for (int i = 0; i < count; ++i) kernel(i);
+        TimeDelta const serial = startedAt.since();
+
+        startedAt = Time();
+        TaskPool::parallelFor(Rangei(0, count), kernel);
+        TimeDelta const parallel = startedAt.since();
+
+        LOG_MSG("parallelFor over %i indices with %i threads: serial %.2f ms, parallel %.2f ms")
+                << count << TaskPool::threadCount() << serial * 1000 << parallel * 1000;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        TextApp app(argc, argv);
+        app.initSubsystems(App::DisablePlugins);
+
+        stressTest();
+        benchmark();
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText();
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...";
+    return 0;
+}
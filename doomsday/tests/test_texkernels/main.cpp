@@ -0,0 +1,320 @@
+/**
+ * @file main.cpp
+ *
+ * Texture kernel tests. @ingroup tests
+ *
+ * Runs the scalar, SSE2 and AVX2 versions of the client's texture kernels on the
+ * same pseudorandom images and checks that the results are identical. The
+ * floating point resampling kernels are allowed to differ by rounding only.
+ * Measures the time taken by each kernel on a 2048x2048 image.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "gl/gl_texkernels.h"
+
+#include <de/Time>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace de;
+
+typedef std::vector<uint8_t> Bytes;
+typedef std::vector<float> Floats;
+
+static char const *levelName(TexKernels::Level level)
+{
+    switch (level)
+    {
+    case TexKernels::SSE2: return "SSE2";
+    case TexKernels::AVX2: return "AVX2";
+    default:               return "Scalar";
+    }
+}
+
+/// Deterministic pseudorandom numbers (the images must be the same on every run).
+static uint32_t nextRandom(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static Bytes randomBytes(size_t count, uint32_t seed)
+{
+    Bytes bytes(count);
+    for (uint8_t &b : bytes) b = uint8_t(nextRandom(seed));
+    return bytes;
+}
+
+static Floats randomFloats(size_t count, uint32_t seed)
+{
+    Floats values(count);
+    for (float &v : values) v = float(nextRandom(seed) % 25600) / 100.f;
+    return values;
+}
+
+/// Largest difference between the values, relative to their magnitude.
+static float maxDifference(Floats const &a, Floats const &b)
+{
+    float maxDiff = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        float const diff = std::fabs(a[i] - b[i]) / std::max(1.f, std::fabs(a[i]));
+        maxDiff = std::max(maxDiff, diff);
+    }
+    return maxDiff;
+}
+
+/**
+ * Compares the results of the @a test kernels to the scalar ones. The image sizes
+ * are odd so that the vector loops also need their scalar tails.
+ */
+static int compareKernels(TexKernels const &ref, TexKernels const &test)
+{
+    int errors = 0;
+    auto fail = [&errors, &test] (char const *kernel, int comps)
+    {
+        qWarning() << levelName(test.level) << kernel << "differs with" << comps << "components";
+        errors++;
+    };
+
+    int const width = 203, height = 67;
+    for (int comps = 3; comps <= 4; ++comps)
+    {
+        Bytes const image = randomBytes(size_t(width * height * comps), 1);
+        long const count  = long(image.size());
+
+        // downMipmap
+        {
+            Bytes a = image, b = image;
+            ref .downMipmap(&a[0], &a[0], width, width / 2, height / 2, comps);
+            test.downMipmap(&b[0], &b[0], width, width / 2, height / 2, comps);
+            if (a != b) fail("downMipmap", comps);
+        }
+
+        // sumRgb
+        {
+            long a[3], b[3];
+            ref .sumRgb(&image[0], width * height, comps, a);
+            test.sumRgb(&image[0], width * height, comps, b);
+            if (std::memcmp(a, b, sizeof(a))) fail("sumRgb", comps);
+        }
+
+        // lumaRange (also with a count that is not a multiple of the vector size)
+        for (long len : { count, count - 13 })
+        {
+            uint8_t minA, maxA, minB, maxB;
+            long sumA, sumB;
+            ref .lumaRange(&image[0] + 5, len - 5, &minA, &maxA, &sumA);
+            test.lumaRange(&image[0] + 5, len - 5, &minB, &maxB, &sumB);
+            if (minA != minB || maxA != maxB || sumA != sumB) fail("lumaRange", comps);
+        }
+
+        // equalizeLuma
+        {
+            Bytes a = image, b = image;
+            ref .equalizeLuma(&a[0], count, 1.3f, 1.7f, 0.6f);
+            test.equalizeLuma(&b[0], count, 1.3f, 1.7f, 0.6f);
+            if (a != b) fail("equalizeLuma", comps);
+        }
+
+        // sharpenRow
+        {
+            Bytes a(image.size()), b(image.size());
+            float const A = 0.5f, B = .70710678f * A, C = 1 + 4*A + 4*B;
+            for (int y = 1; y < height - 1; ++y)
+            {
+                size_t const offset = size_t(y * width * comps);
+                ref .sharpenRow(&a[offset], &image[offset], width, comps, A, B, C);
+                test.sharpenRow(&b[offset], &image[offset], width, comps, A, B, C);
+            }
+            if (a != b) fail("sharpenRow", comps);
+        }
+
+        // bytesToFloats and floatsToBytes
+        {
+            Floats a(image.size()), b(image.size());
+            ref .bytesToFloats(&a[0], &image[0], count);
+            test.bytesToFloats(&b[0], &image[0], count);
+            if (a != b) fail("bytesToFloats", comps);
+
+            Floats const values = randomFloats(image.size(), 2);
+            Bytes c(image.size()), d(image.size());
+            ref .floatsToBytes(&c[0], &values[0], count);
+            test.floatsToBytes(&d[0], &values[0], count);
+            if (c != d) fail("floatsToBytes", comps);
+        }
+
+        // magnifyRow and shrinkRow
+        {
+            Floats const row0 = randomFloats(size_t(width * comps), 3);
+            Floats const row1 = randomFloats(size_t(width * comps), 4);
+
+            int const magWidth = width * 3 + 1;
+            float const magSx  = float(width - 1) / float(magWidth - 1);
+            Floats a(size_t(magWidth * comps)), b(a.size());
+            ref .magnifyRow(&a[0], &row0[0], &row1[0], width, magWidth, magSx, 0.3f, comps);
+            test.magnifyRow(&b[0], &row0[0], &row1[0], width, magWidth, magSx, 0.3f, comps);
+            if (maxDifference(a, b) > 1.0e-5f) fail("magnifyRow", comps);
+
+            int const shrinkWidth = width / 3;
+            float const shrinkSx  = float(width - 1) / float(shrinkWidth - 1);
+            for (int rows = 1; rows <= 2; ++rows)
+            {
+                Floats c(size_t(shrinkWidth * comps)), d(c.size());
+                ref .shrinkRow(&c[0], &row0[0], &row1[0], width, shrinkWidth, shrinkSx, rows, comps);
+                test.shrinkRow(&d[0], &row0[0], &row1[0], width, shrinkWidth, shrinkSx, rows, comps);
+                if (maxDifference(c, d) > 1.0e-5f) fail("shrinkRow", comps);
+            }
+        }
+
+        // lerpLine (a column of the image, as in the vertical pass of scaleLine())
+        {
+            int const outLen = height * 3;
+            int32_t const delta = (0x10000 * (height - 1)) / (outLen - 1);
+            Bytes a(size_t(outLen * comps)), b(a.size());
+            int32_t const endA = ref .lerpLine(&a[0], comps, &image[0], width * comps,
+                                               outLen - 2, delta, delta, comps);
+            int32_t const endB = test.lerpLine(&b[0], comps, &image[0], width * comps,
+                                               outLen - 2, delta, delta, comps);
+            if (a != b || endA != endB) fail("lerpLine", comps);
+        }
+    }
+    return errors;
+}
+
+/**
+ * Runs each kernel over a 2048x2048 RGBA image, the size of a large upscaled or
+ * high-resolution texture.
+ */
+static void benchmark(TexKernels const &kernels)
+{
+    int const size  = 2048;
+    long const count = long(size) * size;
+    Bytes const image = randomBytes(size_t(count * 4), 5);
+    Bytes work(image.size());
+    Floats floats(image.size());
+    int const repeat = 5;
+
+    auto measure = [&kernels, repeat] (char const *what, std::function<void ()> func)
+    {
+        func(); // Warm up.
+        Time startedAt;
+        for (int i = 0; i < repeat; ++i) func();
+        qDebug() << "  " << levelName(kernels.level) << what
+                 << startedAt.since() * 1000 / repeat << "ms";
+    };
+
+    measure("downMipmap", [&] () {
+        work = image;
+        kernels.downMipmap(&work[0], &work[0], size, size / 2, size / 2, 4);
+    });
+    measure("sumRgb", [&] () {
+        long sums[3];
+        kernels.sumRgb(&image[0], count, 4, sums);
+    });
+    measure("lumaRange", [&] () {
+        uint8_t min, max;
+        long sum;
+        kernels.lumaRange(&image[0], count, &min, &max, &sum);
+    });
+    measure("equalizeLuma", [&] () {
+        work = image;
+        kernels.equalizeLuma(&work[0], count, 1.3f, 1.7f, 0.6f);
+    });
+    measure("sharpenRow", [&] () {
+        float const A = 0.5f, B = .70710678f * A, C = 1 + 4*A + 4*B;
+        for (int y = 1; y < size - 1; ++y)
+        {
+            kernels.sharpenRow(&work[size_t(y * size * 4)], &image[size_t(y * size * 4)],
+                               size, 4, A, B, C);
+        }
+    });
+    measure("bytesToFloats", [&] () {
+        kernels.bytesToFloats(&floats[0], &image[0], count * 4);
+    });
+    measure("floatsToBytes", [&] () {
+        kernels.floatsToBytes(&work[0], &floats[0], count * 4);
+    });
+    measure("magnifyRow", [&] () {
+        // Upscaling a 1024 pixels wide image to 2048.
+        float const sx = 1023.f / 2047.f;
+        for (int y = 0; y < size; ++y)
+        {
+            kernels.magnifyRow(&floats[size_t(y * size * 4)], &floats[0], &floats[1024 * 4],
+                               1024, size, sx, 0.5f, 4);
+        }
+    });
+    measure("shrinkRow", [&] () {
+        // Downscaling a 2048 pixels wide image to 1024.
+        Floats out(1024 * 4);
+        float const sx = 2047.f / 1023.f;
+        for (int y = 0; y < size - 1; ++y)
+        {
+            kernels.shrinkRow(&out[0], &floats[size_t(y * size * 4)],
+                              &floats[size_t((y + 1) * size * 4)], size, 1024, sx, 2, 4);
+        }
+    });
+    measure("lerpLine", [&] () {
+        // Vertical pass of scaling 1024 rows to 2048.
+        int32_t const delta = (0x10000 * 1023) / 2047;
+        for (int x = 0; x < size; ++x)
+        {
+            kernels.lerpLine(&work[size_t(x * 4)], size * 4, &image[size_t(x * 4)], size * 4,
+                             size - 2, delta, delta, 4);
+        }
+    });
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    try
+    {
+        TexKernels const &scalar = TexKernels::forLevel(TexKernels::Scalar);
+        for (auto level : { TexKernels::SSE2, TexKernels::AVX2 })
+        {
+            TexKernels const &kernels = TexKernels::forLevel(level);
+            if (kernels.level != level)
+            {
+                qDebug() << levelName(level) << "is not supported; skipped";
+                continue;
+            }
+            errors += compareKernels(scalar, kernels);
+        }
+        qDebug() << errors << "errors";
+
+        qDebug() << "Kernels on a 2048x2048 RGBA image:";
+        for (auto level : { TexKernels::Scalar, TexKernels::SSE2, TexKernels::AVX2 })
+        {
+            TexKernels const &kernels = TexKernels::forLevel(level);
+            if (kernels.level == level) benchmark(kernels);
+        }
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
@@ -0,0 +1,380 @@
+/**
+ * @file main.cpp
+ *
+ * Thinker list tests. @ingroup tests
+ *
+ * Thinkers::runAll() (client/src/world/base/thinkers.cpp) needs a map and a
+ * game, so the way it stores and runs the thinkers is copied here: an array of
+ * thinker pointers per think function. The previous storage, a linked list per
+ * think function walked with Thinkers::forAll(), is included for comparison.
+ *
+ * Both run the same population of zone-allocated thinkers, with some thinkers
+ * removed and spawned on every tic, and must run each thinker the same number
+ * of times. The time per tic is measured for populations of various sizes. The
+ * thinkers are linked in a different order than they were allocated in, like
+ * after a map has been running for a while and memory has been recycled.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include <de/liblegacy.h>
+#include <de/memoryzone.h>
+#include <de/Time>
+#include <QDebug>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace de;
+
+typedef void (*thinkfunc_t) (void *);
+
+#define THINKF_DISABLED 0x2
+
+/// The thinker header of libdoomsday.
+struct thinker_t
+{
+    thinker_t *prev, *next;
+    thinkfunc_t function;
+    uint32_t _flags;
+    thid_t id;
+    void *d;
+};
+
+/// Stands in for a mobj, which is a few hundred bytes.
+struct mobj_t
+{
+    thinker_t thinker;
+    int thinkCount;
+    char state[380];
+};
+
+static void mobjThinker(void *th)   { static_cast<mobj_t *>(th)->thinkCount++; }
+static void moverThinker(void *th)  { static_cast<mobj_t *>(th)->thinkCount++; }
+static void lightThinker(void *th)  { static_cast<mobj_t *>(th)->thinkCount++; }
+
+static thinkfunc_t const thinkFuncs[] = { mobjThinker, moverThinker, lightThinker };
+
+static bool inStasis(thinker_t const *th)
+{
+    return (th->_flags & THINKF_DISABLED) != 0;
+}
+
+/// Deterministic pseudorandom numbers (the runs must be the same every time).
+static uint32_t nextRandom(uint32_t &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+/*
+ * The current storage: an array of thinker pointers per think function.
+ */
+namespace current {
+
+struct ThinkerList
+{
+    thinkfunc_t function;
+    QVector<thinker_t *> thinkers;
+    bool needsCompaction = false;
+
+    ThinkerList(thinkfunc_t func) : function(func) {}
+
+    void link(thinker_t &th)
+    {
+        thinkers.append(&th);
+    }
+
+    void compact()
+    {
+        if (!needsCompaction) return;
+        thinkers.erase(std::remove(thinkers.begin(), thinkers.end(), nullptr), thinkers.end());
+        needsCompaction = false;
+    }
+};
+
+struct Thinkers
+{
+    std::vector<ThinkerList *> lists;
+
+    ~Thinkers()
+    {
+        for (ThinkerList *list : lists) delete list;
+    }
+
+    ThinkerList &listForThinkFunc(thinkfunc_t func)
+    {
+        for (ThinkerList *list : lists)
+        {
+            if (list->function == func) return *list;
+        }
+        lists.push_back(new ThinkerList(func));
+        return *lists.back();
+    }
+
+    void add(thinker_t &th)
+    {
+        listForThinkFunc(th.function).link(th);
+    }
+
+    void runList(ThinkerList &list)
+    {
+        for (int i = 0; i < list.thinkers.size(); ++i)
+        {
+            thinker_t *th = list.thinkers.at(i);
+            if (!th) continue;
+            if (inStasis(th)) continue;
+
+            if (th->function == (thinkfunc_t) -1)
+            {
+                list.thinkers[i] = nullptr;
+                list.needsCompaction = true;
+                Z_Free(th);
+            }
+            else if (th->function)
+            {
+                th->function(th);
+            }
+        }
+        list.compact();
+    }
+
+    void runAll()
+    {
+        for (size_t i = 0; i < lists.size(); ++i)
+        {
+            runList(*lists[i]);
+        }
+    }
+};
+
+} // namespace current
+
+/*
+ * The previous storage: a linked list per think function.
+ */
+namespace previous {
+
+struct ThinkerList
+{
+    thinker_t sentinel;
+
+    ThinkerList(thinkfunc_t func)
+    {
+        std::memset(&sentinel, 0, sizeof(sentinel));
+        sentinel.function = func;
+        sentinel._flags |= THINKF_DISABLED;
+        sentinel.prev = sentinel.next = &sentinel;
+    }
+
+    void link(thinker_t &th)
+    {
+        sentinel.prev->next = &th;
+        th.next = &sentinel;
+        th.prev = sentinel.prev;
+        sentinel.prev = &th;
+    }
+};
+
+static void unlinkThinkerFromList(thinker_t *th)
+{
+    th->next->prev = th->prev;
+    th->prev->next = th->next;
+}
+
+struct Thinkers
+{
+    std::vector<ThinkerList *> lists;
+
+    ~Thinkers()
+    {
+        for (ThinkerList *list : lists) delete list;
+    }
+
+    ThinkerList &listForThinkFunc(thinkfunc_t func)
+    {
+        for (ThinkerList *list : lists)
+        {
+            if (list->sentinel.function == func) return *list;
+        }
+        lists.push_back(new ThinkerList(func));
+        return *lists.back();
+    }
+
+    void add(thinker_t &th)
+    {
+        listForThinkFunc(th.function).link(th);
+    }
+
+    bool forAll(std::function<bool (thinker_t *)> func) const
+    {
+        for (size_t i = 0; i < lists.size(); ++i)
+        {
+            ThinkerList *list = lists[i];
+            thinker_t *th = list->sentinel.next;
+            while (th != &list->sentinel && th)
+            {
+                thinker_t *next = th->next;
+                if (func(th)) return true;
+                th = next;
+            }
+        }
+        return false;
+    }
+
+    /// Thinker_Run() as it was.
+    void runAll()
+    {
+        forAll([] (thinker_t *th)
+        {
+            if (inStasis(th)) return false;
+
+            if (th->function == (thinkfunc_t) -1)
+            {
+                unlinkThinkerFromList(th);
+                Z_Free(th);
+            }
+            else if (th->function)
+            {
+                th->function(th);
+            }
+            return false;
+        });
+    }
+};
+
+} // namespace previous
+
+/**
+ * Population of thinkers. Most of them are mobjs.
+ */
+struct Population
+{
+    std::vector<mobj_t *> live;
+    long thinkCount = 0;    ///< Thinks of the removed thinkers.
+    uint32_t seed;
+
+    Population(uint32_t seed) : seed(seed) {}
+
+    mobj_t *newThinker()
+    {
+        auto *mo = (mobj_t *) Z_Calloc(sizeof(mobj_t), PU_MAP, 0);
+        uint32_t const kind = nextRandom(seed) % 10;
+        mo->thinker.function = thinkFuncs[kind < 8? 0 : kind - 7];
+        if (kind == 0) mo->thinker._flags |= THINKF_DISABLED;
+        return mo;
+    }
+
+    /// Spawns @a count thinkers, which are linked in random order.
+    template <typename ThinkersType>
+    void spawn(ThinkersType &thinkers, int count)
+    {
+        std::vector<mobj_t *> spawned;
+        for (int i = 0; i < count; ++i) spawned.push_back(newThinker());
+        for (int i = count - 1; i > 0; --i)
+        {
+            std::swap(spawned[i], spawned[nextRandom(seed) % (i + 1)]);
+        }
+        for (mobj_t *mo : spawned)
+        {
+            thinkers.add(mo->thinker);
+            live.push_back(mo);
+        }
+    }
+
+    /// Marks @a count thinkers for removal (Thinkers::remove()).
+    void remove(int count)
+    {
+        for (int i = 0; i < count && !live.empty(); ++i)
+        {
+            size_t const pos = nextRandom(seed) % live.size();
+            mobj_t *mo = live[pos];
+            if (inStasis(&mo->thinker)) continue; // Would never be removed.
+            thinkCount += mo->thinkCount;
+            mo->thinker.function = (thinkfunc_t) -1;
+            live[pos] = live.back();
+            live.pop_back();
+        }
+    }
+
+    long totalThinkCount() const
+    {
+        long total = thinkCount;
+        for (mobj_t const *mo : live) total += mo->thinkCount;
+        return total;
+    }
+};
+
+/**
+ * Runs @a thinkerCount thinkers for a number of tics. Returns the total number of
+ * times the thinkers were run.
+ */
+template <typename ThinkersType>
+static long benchmark(char const *name, int thinkerCount)
+{
+    int const tics  = 200;
+    int const churn = std::max(1, thinkerCount / 100);
+    long total = 0;
+    double runTime = 0;
+    {
+        ThinkersType thinkers;
+        Population pop(9);
+        pop.spawn(thinkers, thinkerCount);
+
+        for (int tic = 0; tic < tics; ++tic)
+        {
+            pop.remove(churn);
+
+            Time startedAt;
+            thinkers.runAll();
+            runTime += startedAt.since() * 1000;
+
+            pop.spawn(thinkers, churn);
+        }
+        total = pop.totalThinkCount();
+    }
+    Z_FreeTags(PU_MAP, PU_MAP);
+
+    qDebug() << "  " << name << ":" << runTime / tics << "ms/tic";
+    return total;
+}
+
+int main(int, char **)
+{
+    int errors = 0;
+    Libdeng_Init();
+
+    for (int thinkerCount : { 1000, 10000, 50000 })
+    {
+        qDebug() << "runAll() with" << thinkerCount << "thinkers:";
+        long const prevThinks = benchmark<previous::Thinkers>("previous list walk", thinkerCount);
+        long const curThinks  = benchmark<current::Thinkers>("current arrays", thinkerCount);
+        if (prevThinks != curThinks)
+        {
+            qWarning() << "Thinkers were run" << curThinks << "times, expected" << prevThinks;
+            errors++;
+        }
+    }
+    qDebug() << errors << "errors";
+
+    Libdeng_Shutdown();
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}
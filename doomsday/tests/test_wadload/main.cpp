@@ -0,0 +1,336 @@
+/**
+ * @file main.cpp
+ *
+ * WAD load time benchmark. @ingroup tests
+ *
+ * Writes a large synthetic WAD with a number of big maps and graphics lumps, and
+ * loads it the way Wad does: the map data lumps are read into buffers like the
+ * map converter reads them with Wad::readLump(), and the graphics lumps are
+ * accessed like Wad::cacheLump() returns them. This is done with lumps accessed
+ * in the memory-mapped file (FileHandle::mappedData()), and then with -nommap,
+ * when lumps are read with fread as before. The data of both must be identical.
+ *
+ * The file has just been written, so it is in the page cache in both cases.
+ *
+ * @author Copyright &copy; 2017 Jaakko Keränen <jaakko.keranen@iki.fi>
+ *
+ * @par License
+ * GPL: http://www.gnu.org/licenses/gpl.html
+ *
+ * <small>This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version. This program is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+ * of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details. You should have received a copy of the GNU
+ * General Public License along with this program; if not, write to the Free
+ * Software Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA</small>
+ */
+
+#include "doomsday/filesys/filehandle.h"
+
+#include <de/memory.h>
+#include <de/TextApp>
+#include <de/Time>
+#include <QDebug>
+#include <QDir>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace de;
+
+static int const MAP_COUNT      = 8;
+static int const GRAPHICS_COUNT = 2000;
+static int const REPEAT         = 3;
+
+/// Map data lumps and their sizes in a large map.
+static struct { char const *name; size_t size; } const mapLumps[] = {
+    { "THINGS",   10 *  12000 },
+    { "LINEDEFS", 14 *  40000 },
+    { "SIDEDEFS", 30 *  70000 },
+    { "VERTEXES",  4 *  38000 },
+    { "SEGS",     12 * 110000 },
+    { "SSECTORS",  4 *  36000 },
+    { "NODES",    28 *  36000 },
+    { "SECTORS",  26 *   6000 },
+    { "REJECT",   6000 * 6000 / 8 },
+    { "BLOCKMAP", 700000 },
+};
+
+struct Lump
+{
+    char name[9];
+    duint32 offset;
+    duint32 size;
+    bool isMapData;
+};
+typedef std::vector<Lump> Lumps;
+typedef std::vector<uint8_t> Bytes;
+
+/// Deterministic pseudorandom numbers (the file must be the same on every run).
+static duint32 nextRandom(duint32 &state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static void writeLittleEndian(FILE *file, duint32 value)
+{
+    uint8_t const bytes[4] = { uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16),
+                               uint8_t(value >> 24) };
+    fwrite(bytes, 1, 4, file);
+}
+
+static duint32 readLittleEndian(uint8_t const *bytes)
+{
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (duint32(bytes[3]) << 24);
+}
+
+/**
+ * Writes the WAD and returns its size in bytes.
+ */
+static size_t writeWad(char const *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file) return 0;
+
+    Lumps lumps;
+    duint32 seed = 17;
+    duint32 offset = 12;
+    auto addLump = [&] (char const *name, size_t size, bool isMapData)
+    {
+        Lump lump;
+        std::memset(lump.name, 0, sizeof(lump.name));
+        std::strncpy(lump.name, name, 8);
+        lump.offset    = offset;
+        lump.size      = duint32(size);
+        lump.isMapData = isMapData;
+        lumps.push_back(lump);
+        offset += lump.size;
+    };
+    for (int map = 0; map < MAP_COUNT; ++map)
+    {
+        char name[9];
+        sprintf(name, "MAP%02d", map + 1);
+        addLump(name, 0, false);
+        for (auto const &mapLump : mapLumps)
+        {
+            addLump(mapLump.name, mapLump.size, true);
+        }
+    }
+    for (int i = 0; i < GRAPHICS_COUNT; ++i)
+    {
+        char name[9];
+        sprintf(name, "GFX%05d", i);
+        addLump(name, 2048 + nextRandom(seed) % 30000, false);
+    }
+
+    // Header.
+    fwrite("PWAD", 1, 4, file);
+    writeLittleEndian(file, duint32(lumps.size()));
+    writeLittleEndian(file, offset);
+
+    // Contents.
+    Bytes data;
+    for (Lump const &lump : lumps)
+    {
+        data.resize(lump.size);
+        for (uint8_t &b : data) b = uint8_t(nextRandom(seed));
+        fwrite(data.data(), 1, data.size(), file);
+    }
+
+    // Directory.
+    for (Lump const &lump : lumps)
+    {
+        writeLittleEndian(file, lump.offset);
+        writeLittleEndian(file, lump.size);
+        fwrite(lump.name, 1, 8, file);
+    }
+    size_t const size = size_t(ftell(file));
+    fclose(file);
+    return size;
+}
+
+/**
+ * Reads the directory of the WAD like the Wad constructor does.
+ */
+static Lumps readDirectory(FileHandle &hndl)
+{
+    uint8_t header[12];
+    hndl.seek(0, SeekSet);
+    hndl.read(header, 12);
+    duint32 const count  = readLittleEndian(header + 4);
+    duint32 const offset = readLittleEndian(header + 8);
+
+    Lumps lumps(count);
+    hndl.seek(offset, SeekSet);
+    for (Lump &lump : lumps)
+    {
+        uint8_t entry[16];
+        hndl.read(entry, 16);
+        lump.offset = readLittleEndian(entry);
+        lump.size   = readLittleEndian(entry + 4);
+        std::memcpy(lump.name, entry + 8, 8);
+        lump.name[8] = 0;
+        lump.isMapData = false;
+        for (auto const &mapLump : mapLumps)
+        {
+            if (!std::strcmp(lump.name, mapLump.name)) lump.isMapData = true;
+        }
+    }
+    return lumps;
+}
+
+/// Returns the data of a lump in the mapped file (cf. Wad::Impl::mappedLump()).
+static uint8_t const *mappedLump(FileHandle &hndl, Lump const &lump)
+{
+    size_t mappedSize;
+    uint8_t const *mapped = hndl.mappedData(&mappedSize);
+    if (!mapped || lump.offset + lump.size > mappedSize) return nullptr;
+    return mapped + lump.offset;
+}
+
+static duint32 checksum(uint8_t const *data, size_t size, duint32 sum)
+{
+    for (size_t i = 0; i < size; i += 64) sum = sum * 31 + data[i];
+    return sum;
+}
+
+struct LoadResult
+{
+    double directoryTime = 0;
+    double mapTime = 0;
+    double graphicsTime = 0;
+    duint32 sum = 0;
+    bool mapped = false;
+};
+
+/**
+ * Opens the WAD and accesses all its lumps.
+ */
+static LoadResult loadWad(char const *path)
+{
+    LoadResult result;
+    FILE *file = fopen(path, "rb");
+    if (!file) return result;
+    FileHandle *hndl = FileHandle::fromNativeFile(*file, 0);
+
+    Time startedAt;
+    Lumps const lumps = readDirectory(*hndl);
+    result.directoryTime = startedAt.since() * 1000;
+
+    // Maps are converted from lumps read into buffers (Wad::readLump()).
+    startedAt = Time();
+    Bytes buffer;
+    for (Lump const &lump : lumps)
+    {
+        if (!lump.isMapData) continue;
+        buffer.resize(lump.size);
+        if (uint8_t const *mapped = mappedLump(*hndl, lump))
+        {
+            std::memcpy(buffer.data(), mapped, lump.size);
+            result.mapped = true;
+        }
+        else
+        {
+            hndl->seek(lump.offset, SeekSet);
+            hndl->read(buffer.data(), lump.size);
+        }
+        result.sum = checksum(buffer.data(), buffer.size(), result.sum);
+    }
+    result.mapTime = startedAt.since() * 1000;
+
+    // Graphics are used from the lump cache (Wad::cacheLump()). Without the
+    // mapping, each lump is allocated and read first.
+    startedAt = Time();
+    for (Lump const &lump : lumps)
+    {
+        if (lump.isMapData || !lump.size) continue;
+        if (uint8_t const *mapped = mappedLump(*hndl, lump))
+        {
+            result.sum = checksum(mapped, lump.size, result.sum);
+        }
+        else
+        {
+            auto *data = (uint8_t *) M_Malloc(lump.size);
+            hndl->seek(lump.offset, SeekSet);
+            hndl->read(data, lump.size);
+            result.sum = checksum(data, lump.size, result.sum);
+            M_Free(data);
+        }
+    }
+    result.graphicsTime = startedAt.since() * 1000;
+
+    delete hndl; // Closes the file.
+    return result;
+}
+
+static LoadResult measure(char const *path, char const *what)
+{
+    LoadResult best;
+    for (int i = 0; i < REPEAT; ++i)
+    {
+        LoadResult const result = loadWad(path);
+        if (!i || result.mapTime + result.graphicsTime < best.mapTime + best.graphicsTime)
+        {
+            best = result;
+        }
+    }
+    qDebug() << "  " << what << ": directory" << best.directoryTime << "ms, map lumps"
+             << best.mapTime << "ms, graphics lumps" << best.graphicsTime << "ms";
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    int errors = 0;
+    try
+    {
+        TextApp app(argc, argv);
+
+        QByteArray const path = QDir::temp().filePath("test_wadload.wad").toLocal8Bit();
+        size_t const size = writeWad(path.constData());
+        if (!size)
+        {
+            qWarning() << "Could not write" << path;
+            return 1;
+        }
+        qDebug() << "Loading a WAD of" << size / 1000000 << "MB with" << MAP_COUNT << "maps and"
+                 << GRAPHICS_COUNT << "graphics lumps:";
+
+        LoadResult const mapped = measure(path.constData(), "mapped");
+        if (!mapped.mapped)
+        {
+            qWarning() << "The WAD could not be mapped";
+            errors++;
+        }
+
+        // The same with the fread path.
+        app.commandLine().append("-nommap");
+        LoadResult const read = measure(path.constData(), "-nommap");
+        if (read.mapped)
+        {
+            qWarning() << "The WAD was mapped despite -nommap";
+            errors++;
+        }
+        if (read.sum != mapped.sum)
+        {
+            qWarning() << "The mapped lumps differ from the lumps read with fread";
+            errors++;
+        }
+
+        std::remove(path.constData());
+        qDebug() << errors << "errors";
+    }
+    catch (Error const &err)
+    {
+        qWarning() << err.asText() << "\n";
+        return 1;
+    }
+
+    qDebug() << "Exiting main()...\n";
+    return errors? 1 : 0;
+}